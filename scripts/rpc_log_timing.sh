@@ -0,0 +1,56 @@
+#! /bin/bash
+# SPDX-License-Identifier: Apache-2.0
+# (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved.
+#
+# Measure wall-clock time of the test packages issuing the largest
+# number of TAPI RPC calls, where the cost of formatting RPC arguments
+# for logging is most visible. Run it with the same options on both
+# trees being compared and compare the printed times.
+#
+
+set -e
+pushd "$(dirname "$(which "$0")")" >/dev/null
+RUNDIR="$(pwd -P)"
+popd >/dev/null
+
+test "$(basename $RUNDIR)" = "scripts" && RUNDIR="${RUNDIR}/.."
+
+TESTS="tcp/share_events_queue udp_rx/events_queue"
+RUNS=3
+
+usage() {
+cat <<EOF
+USAGE: rpc_log_timing.sh [--runs=<N>] [run.sh options]
+Options:
+  --runs=<N>                How many times to run each package
+                            (default ${RUNS})
+
+Packages: ${TESTS}
+Logs of every run are kept in the current directory.
+EOF
+exit 1
+}
+
+RUN_SH_OPTS=()
+while test -n "$1" ; do
+    case $1 in
+        --help) usage ;;
+        --runs=*) RUNS="${1#--runs=}" ;;
+        *) RUN_SH_OPTS+=("$1") ;;
+    esac
+    shift 1
+done
+
+for t in ${TESTS} ; do
+    for i in $(seq ${RUNS}) ; do
+        log="rpc_log_timing_${t//\//_}_${i}.txt"
+        start=$(date +%s.%N)
+        rc=0
+        "${RUNDIR}/run.sh" "--tester-run=zetaferno-ts/${t}" \
+            "${RUN_SH_OPTS[@]}" >"${log}" 2>&1 || rc=$?
+        end=$(date +%s.%N)
+        awk -v t="${t}" -v i="${i}" -v s="${start}" -v e="${end}" \
+            -v rc="${rc}" \
+            'BEGIN { printf("%s run %u: %.1f s (rc=%d)\n", t, i, e - s, rc) }'
+    done
+done
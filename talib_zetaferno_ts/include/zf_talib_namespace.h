@@ -32,6 +32,7 @@
 #define RPC_TYPE_NS_ZFT_HANDLE      "zft_handle"
 #define RPC_TYPE_NS_ZFT_MSG         "zft_msg"
 #define RPC_TYPE_NS_ZF_MUXER_SET    "zf_muxer_set"
+#define RPC_TYPE_NS_ZFTS_TX_TS_COLL "zfts_tx_ts_coll"
 
 /*@}*/
 
@@ -50,6 +51,7 @@ typedef rpc_ptr  rpc_zft_p;
 typedef rpc_ptr  rpc_zft_handle_p;
 typedef rpc_ptr  rpc_zft_msg_p;
 typedef rpc_ptr  rpc_zf_muxer_set_p;
+typedef rpc_ptr  rpc_zfts_tx_ts_coll_p;
 /*@}*/
 
 #endif /* !___ZF_TALIB_NAMESPACE_H__ */
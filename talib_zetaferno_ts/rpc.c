@@ -190,6 +190,18 @@ stack_iomux_enabled(void)
     ENV_GET_ENABLED_STATE("TE_RPC_ZF_STACK_FD_IOMUX_ENABLED");
 }
 
+/**
+ * Check whether profiling of zf_reactor_perform() calls made by
+ * the agent is enabled or not.
+ *
+ * @return @c TRUE if enabled, @c FALSE otherwise.
+ */
+static te_bool
+reactor_profile_enabled(void)
+{
+    ENV_GET_ENABLED_STATE("TE_RPC_ZF_REACTOR_PROFILE_ENABLED");
+}
+
 /**
  * Start routine of a thread calling zf_stack_has_pending_work()
  * on a given stack.
@@ -232,6 +244,30 @@ stack_thread_func(void *arg)
     return NULL;
 }
 
+/** Reactor profile of a stack. */
+typedef struct reactor_prof {
+    tarpc_zfts_reactor_hist events;       /**< zf_reactor_perform()
+                                               calls returning events */
+    tarpc_zfts_reactor_hist idle;         /**< zf_reactor_perform()
+                                               calls without events */
+    tarpc_zfts_reactor_hist has_pending;  /**< zf_stack_has_pending_work()
+                                               calls */
+} reactor_prof;
+
+/**
+ * Set once reactor profile is allocated for any stack, so that
+ * zf_reactor_perform() calls are not slowed down when profiling is
+ * disabled.
+ */
+static volatile te_bool reactor_prof_on = FALSE;
+
+/** List of ZF objects allocated on a stack via RPC. */
+typedef struct stack_obj_list {
+    const void    **objs;       /**< Object pointers. */
+    unsigned int    num;        /**< Number of objects. */
+    unsigned int    max;        /**< Number of elements in @p objs. */
+} stack_obj_list;
+
 /**
  * Structure associating ZF stack with auxiliary variables
  * (thread ID, iomux state, etc).
@@ -249,6 +285,15 @@ typedef struct stack_ctx {
                                              to poll stack fd. */
     iomux_funcs       iomux_f;          /**< Pointers to iomux functions. */
     iomux_state       iomux_st;         /**< Iomux context. */
+
+    reactor_prof     *prof;             /**< Reactor profile. */
+
+    stack_obj_list    zockets;          /**< Live zockets allocated
+                                             on the stack via RPC. */
+    stack_obj_list    muxers;           /**< Live muxer sets allocated
+                                             on the stack via RPC. */
+    unsigned int      alts_num;         /**< Number of allocated
+                                             alternatives. */
 } stack_ctx;
 
 /** Array of stack_ctx structures. */
@@ -435,6 +480,11 @@ add_stack_ctx(struct zf_stack *stack)
     }
 
     stack_contexts[i].stack = stack;
+    memset(&stack_contexts[i].zockets, 0,
+           sizeof(stack_contexts[i].zockets));
+    memset(&stack_contexts[i].muxers, 0,
+           sizeof(stack_contexts[i].muxers));
+    stack_contexts[i].alts_num = 0;
 
     if (stack_threads_enabled())
     {
@@ -448,6 +498,13 @@ add_stack_ctx(struct zf_stack *stack)
             goto cleanup;
     }
 
+    stack_contexts[i].prof = NULL;
+    if (reactor_profile_enabled())
+    {
+        stack_contexts[i].prof = TE_ALLOC(sizeof(reactor_prof));
+        reactor_prof_on = TRUE;
+    }
+
     rc = 0;
 
 cleanup:
@@ -516,6 +573,13 @@ del_stack_ctx(struct zf_stack *stack)
             goto cleanup;
     }
 
+    free(ctx->prof);
+    ctx->prof = NULL;
+    free(ctx->zockets.objs);
+    memset(&ctx->zockets, 0, sizeof(ctx->zockets));
+    free(ctx->muxers.objs);
+    memset(&ctx->muxers, 0, sizeof(ctx->muxers));
+    ctx->alts_num = 0;
     ctx->stack = NULL;
     rc = 0;
 
@@ -524,6 +588,579 @@ cleanup:
     return rc;
 }
 
+/**
+ * Find stack context of a given stack. Unlike get_stack_ctx(), it does
+ * not report an error if there is no such context, so that zockets of
+ * stacks allocated not via RPC are silently ignored.
+ *
+ * @note The function should be called with stack_contexts_lock held.
+ *
+ * @param stack     Pointer to ZF stack.
+ *
+ * @return Stack context pointer or @c NULL.
+ */
+static stack_ctx *
+find_stack_ctx(struct zf_stack *stack)
+{
+    int i;
+
+    for (i = 0; i < cur_stack_contexts_num; i++)
+    {
+        if (stack_contexts[i].stack == stack)
+            return &stack_contexts[i];
+    }
+
+    return NULL;
+}
+
+/**
+ * Find stack context having a given live object in one of its lists.
+ *
+ * @note The function should be called with stack_contexts_lock held.
+ *
+ * @param obj       Object pointer.
+ * @param muxer     If @c TRUE, look for a muxer set, otherwise for
+ *                  a zocket.
+ * @param idx       Where to save index of the object in the list.
+ *
+ * @return Stack context pointer or @c NULL if the object is not known.
+ */
+static stack_ctx *
+find_obj_stack_ctx(const void *obj, te_bool muxer, unsigned int *idx)
+{
+    stack_obj_list *list;
+    int             i;
+    unsigned int    j;
+
+    for (i = 0; i < cur_stack_contexts_num; i++)
+    {
+        if (stack_contexts[i].stack == NULL)
+            continue;
+
+        list = muxer ? &stack_contexts[i].muxers :
+                       &stack_contexts[i].zockets;
+        for (j = 0; j < list->num; j++)
+        {
+            if (list->objs[j] == obj)
+            {
+                *idx = j;
+                return &stack_contexts[i];
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Add an object to a list of live objects of a stack context.
+ *
+ * @note The function should be called with stack_contexts_lock held.
+ *
+ * @param list      List of objects.
+ * @param obj       Object pointer.
+ */
+static void
+stack_obj_list_add(stack_obj_list *list, const void *obj)
+{
+    if (list->num == list->max)
+    {
+        unsigned int  new_max = list->max * 2 + 8;
+        void         *p;
+
+        p = realloc(list->objs, new_max * sizeof(*list->objs));
+        if (p == NULL)
+        {
+            ERROR("Failed to allocate more memory for stack objects");
+            return;
+        }
+
+        list->objs = (const void **)p;
+        list->max = new_max;
+    }
+
+    list->objs[list->num++] = obj;
+}
+
+/**
+ * Add an object to a list of live objects of a given stack.
+ *
+ * @param stack     ZF stack.
+ * @param obj       Object pointer.
+ * @param muxer     If @c TRUE, the object is a muxer set, otherwise
+ *                  it is a zocket.
+ */
+static void
+stack_obj_add(struct zf_stack *stack, const void *obj, te_bool muxer)
+{
+    stack_ctx *ctx;
+
+    CHECK_LOCK(pthread_mutex_lock(&stack_contexts_lock));
+
+    ctx = find_stack_ctx(stack);
+    if (ctx != NULL)
+        stack_obj_list_add(muxer ? &ctx->muxers : &ctx->zockets, obj);
+
+    CHECK_LOCK(pthread_mutex_unlock(&stack_contexts_lock));
+}
+
+/**
+ * Remove an object from the list of live objects of its stack.
+ *
+ * @param obj       Object pointer.
+ * @param muxer     If @c TRUE, the object is a muxer set, otherwise
+ *                  it is a zocket.
+ */
+static void
+stack_obj_del(const void *obj, te_bool muxer)
+{
+    stack_ctx      *ctx;
+    stack_obj_list *list;
+    unsigned int    idx;
+
+    CHECK_LOCK(pthread_mutex_lock(&stack_contexts_lock));
+
+    ctx = find_obj_stack_ctx(obj, muxer, &idx);
+    if (ctx != NULL)
+    {
+        list = muxer ? &ctx->muxers : &ctx->zockets;
+        list->objs[idx] = list->objs[--list->num];
+    }
+
+    CHECK_LOCK(pthread_mutex_unlock(&stack_contexts_lock));
+}
+
+/* See description in zf_rpc.h */
+void
+zfts_stack_zocket_add(struct zf_stack *stack, const void *zocket)
+{
+    stack_obj_add(stack, zocket, FALSE);
+}
+
+/* See description in zf_rpc.h */
+void
+zfts_stack_zocket_add_sibling(const void *peer, const void *zocket)
+{
+    stack_ctx    *ctx;
+    unsigned int  idx;
+
+    CHECK_LOCK(pthread_mutex_lock(&stack_contexts_lock));
+
+    ctx = find_obj_stack_ctx(peer, FALSE, &idx);
+    if (ctx != NULL)
+        stack_obj_list_add(&ctx->zockets, zocket);
+
+    CHECK_LOCK(pthread_mutex_unlock(&stack_contexts_lock));
+}
+
+/* See description in zf_rpc.h */
+void
+zfts_stack_zocket_del(const void *zocket)
+{
+    stack_obj_del(zocket, FALSE);
+}
+
+/* See description in zf_rpc.h */
+void
+zfts_stack_muxer_add(struct zf_stack *stack, const void *muxer_set)
+{
+    stack_obj_add(stack, muxer_set, TRUE);
+}
+
+/* See description in zf_rpc.h */
+void
+zfts_stack_muxer_del(const void *muxer_set)
+{
+    stack_obj_del(muxer_set, TRUE);
+}
+
+/* See description in zf_rpc.h */
+void
+zfts_stack_alts_add(struct zf_stack *stack, int delta)
+{
+    stack_ctx *ctx;
+
+    CHECK_LOCK(pthread_mutex_lock(&stack_contexts_lock));
+
+    ctx = find_stack_ctx(stack);
+    if (ctx != NULL)
+    {
+        if (delta < 0 && ctx->alts_num < (unsigned int)-delta)
+            ctx->alts_num = 0;
+        else
+            ctx->alts_num += delta;
+    }
+
+    CHECK_LOCK(pthread_mutex_unlock(&stack_contexts_lock));
+}
+
+/** Maximum number of stacks parked in the stack pool */
+#define STACK_POOL_MAX_PARKED 4
+
+/** ZF stack allocated through the stack pool */
+typedef struct stack_pool_entry {
+    struct zf_stack    *stack;      /**< ZF stack */
+    tarpc_ptr           ptr;        /**< RPC pointer of the stack */
+    char               *zf_attr;    /**< Value of ZF_ATTR environment
+                                         variable the stack was
+                                         allocated with */
+    te_bool             parked;     /**< @c TRUE if no test uses
+                                         the stack */
+} stack_pool_entry;
+
+/** Stacks allocated through the pool and not released yet */
+static stack_pool_entry *stack_pool = NULL;
+/** Number of elements in stack_pool */
+static unsigned int stack_pool_len = 0;
+/** Statistics of the stack pool */
+static tarpc_zfts_stack_pool_stats stack_pool_stats;
+/** Lock protecting the stack pool */
+static pthread_mutex_t stack_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Get attributes a stack allocated now would have: tests allocate
+ * pooled stacks with default attributes, so they are determined by
+ * ZF_ATTR environment variable.
+ *
+ * @return Value of ZF_ATTR (empty string if it is not set).
+ */
+static const char *
+stack_pool_zf_attr(void)
+{
+    const char *val = getenv("ZF_ATTR");
+
+    return val == NULL ? "" : val;
+}
+
+/**
+ * Remove an entry from the stack pool. Should be called under
+ * stack_pool_lock.
+ *
+ * @param i       Index of the entry.
+ */
+static void
+stack_pool_remove(unsigned int i)
+{
+    free(stack_pool[i].zf_attr);
+    stack_pool[i] = stack_pool[--stack_pool_len];
+}
+
+/**
+ * Forget about a stack allocated through the stack pool when it is
+ * released directly with zf_stack_free().
+ *
+ * @param stack       Pointer to ZF stack.
+ */
+static void
+stack_pool_forget(struct zf_stack *stack)
+{
+    unsigned int i;
+
+    CHECK_LOCK(pthread_mutex_lock(&stack_pool_lock));
+
+    for (i = 0; i < stack_pool_len; i++)
+    {
+        if (stack_pool[i].stack == stack)
+        {
+            stack_pool_remove(i);
+            break;
+        }
+    }
+
+    CHECK_LOCK(pthread_mutex_unlock(&stack_pool_lock));
+}
+
+/**
+ * Take a parked stack allocated with the current ZF_ATTR value from
+ * the stack pool. Reactor profile of the stack is reset.
+ *
+ * @param ptr       Where to save RPC pointer of the stack
+ *                  (@c RPC_NULL if there is no such stack).
+ *
+ * @return @c 0.
+ */
+static int
+zfts_stack_pool_get(tarpc_ptr *ptr)
+{
+    const char   *zf_attr = stack_pool_zf_attr();
+    stack_ctx    *ctx;
+    unsigned int  i;
+
+    *ptr = RPC_NULL;
+
+    CHECK_LOCK(pthread_mutex_lock(&stack_pool_lock));
+
+    for (i = 0; i < stack_pool_len; i++)
+    {
+        if (stack_pool[i].parked &&
+            strcmp(stack_pool[i].zf_attr, zf_attr) == 0)
+        {
+            stack_pool[i].parked = FALSE;
+            stack_pool_stats.reuses++;
+            *ptr = stack_pool[i].ptr;
+
+            CHECK_LOCK(pthread_mutex_lock(&stack_contexts_lock));
+            ctx = get_stack_ctx(stack_pool[i].stack);
+            if (ctx != NULL && ctx->prof != NULL)
+                memset(ctx->prof, 0, sizeof(*ctx->prof));
+            CHECK_LOCK(pthread_mutex_unlock(&stack_contexts_lock));
+            break;
+        }
+    }
+
+    CHECK_LOCK(pthread_mutex_unlock(&stack_pool_lock));
+
+    return 0;
+}
+
+TARPC_FUNC_STATIC(zfts_stack_pool_get, {},
+{
+    MAKE_CALL(out->retval = func_ptr(&out->stack));
+})
+
+/**
+ * Allocate ZF stack and add it to the stack pool, so that it can be
+ * parked when a test does not need it anymore.
+ *
+ * @param attr      ZF attributes.
+ * @param ns        Namespace of RPC pointers to ZF stacks.
+ * @param ptr       Where to save RPC pointer of the stack.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_stack_pool_alloc(struct zf_attr *attr, rpc_ptr_id_namespace ns,
+                      tarpc_ptr *ptr)
+{
+    api_func_ptr        stack_alloc;
+    struct zf_stack    *stack;
+    stack_pool_entry   *p;
+    uint64_t            start;
+    uint64_t            elapsed;
+    int                 rc;
+
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_stack_alloc",
+                           (api_func *)&stack_alloc);
+
+    start = zfts_time_ns();
+    rc = stack_alloc(attr, &stack);
+    elapsed = zfts_time_ns() - start;
+    if (rc < 0)
+    {
+        te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                         "zf_stack_alloc() failed");
+        return -1;
+    }
+
+    if (add_stack_ctx(stack) != 0)
+        abort();
+    *ptr = RCF_PCH_MEM_INDEX_ALLOC(stack, ns);
+
+    CHECK_LOCK(pthread_mutex_lock(&stack_pool_lock));
+
+    p = realloc(stack_pool, (stack_pool_len + 1) * sizeof(*stack_pool));
+    if (p != NULL)
+    {
+        stack_pool = p;
+        stack_pool[stack_pool_len].stack = stack;
+        stack_pool[stack_pool_len].ptr = *ptr;
+        stack_pool[stack_pool_len].zf_attr = strdup(stack_pool_zf_attr());
+        stack_pool[stack_pool_len].parked = FALSE;
+        if (stack_pool[stack_pool_len].zf_attr != NULL)
+            stack_pool_len++;
+    }
+
+    stack_pool_stats.allocs++;
+    stack_pool_stats.alloc_ns += elapsed;
+
+    CHECK_LOCK(pthread_mutex_unlock(&stack_pool_lock));
+
+    return 0;
+}
+
+TARPC_FUNC_STATIC(zfts_stack_pool_alloc, {},
+{
+    static rpc_ptr_id_namespace stack_ns = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace attr_ns = RPC_PTR_ID_NS_INVALID;
+    struct zf_attr *attr;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&stack_ns,
+                                           RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&attr_ns, RPC_TYPE_NS_ZF_ATTR,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(attr, in->attr, attr_ns,);
+
+    MAKE_CALL(out->retval = func_ptr(attr, stack_ns, &out->stack));
+})
+
+/**
+ * Park a stack allocated through the stack pool if it is quiescent,
+ * has no live zockets, muxer sets or alternatives allocated via RPC
+ * and the pool is not full. If the stack is not parked, the caller
+ * should release it with zf_stack_free().
+ *
+ * @param stack     Pointer to ZF stack.
+ * @param parked    Where to save @c TRUE if the stack is parked.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_stack_pool_park(struct zf_stack *stack, tarpc_bool *parked)
+{
+    api_func_ptr  is_quiescent;
+    stack_ctx    *ctx;
+    unsigned int  zockets_num = 0;
+    unsigned int  muxers_num = 0;
+    unsigned int  alts_num = 0;
+    unsigned int  parked_num = 0;
+    unsigned int  i;
+    int           idx = -1;
+
+    *parked = FALSE;
+
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_stack_is_quiescent",
+                           (api_func *)&is_quiescent);
+
+    CHECK_LOCK(pthread_mutex_lock(&stack_contexts_lock));
+    ctx = find_stack_ctx(stack);
+    if (ctx != NULL)
+    {
+        zockets_num = ctx->zockets.num;
+        muxers_num = ctx->muxers.num;
+        alts_num = ctx->alts_num;
+    }
+    CHECK_LOCK(pthread_mutex_unlock(&stack_contexts_lock));
+
+    CHECK_LOCK(pthread_mutex_lock(&stack_pool_lock));
+
+    for (i = 0; i < stack_pool_len; i++)
+    {
+        if (stack_pool[i].parked)
+            parked_num++;
+        else if (stack_pool[i].stack == stack)
+            idx = i;
+    }
+
+    if (idx >= 0)
+    {
+        if (zockets_num > 0 || muxers_num > 0 || alts_num > 0)
+        {
+            WARN("%s(): stack has %u live zockets, %u muxer sets and "
+                 "%u alternatives, it is not parked", __FUNCTION__,
+                 zockets_num, muxers_num, alts_num);
+            stack_pool_stats.rejects++;
+            stack_pool_remove(idx);
+        }
+        else if (parked_num < STACK_POOL_MAX_PARKED &&
+                 is_quiescent(stack) != 0)
+        {
+            stack_pool[idx].parked = TRUE;
+            stack_pool_stats.parks++;
+            *parked = TRUE;
+        }
+        else
+        {
+            WARN("%s(): stack is %s, it is not parked", __FUNCTION__,
+                 parked_num < STACK_POOL_MAX_PARKED ?
+                        "not quiescent" : "not needed as the pool is full");
+            stack_pool_stats.rejects++;
+            stack_pool_remove(idx);
+        }
+    }
+
+    CHECK_LOCK(pthread_mutex_unlock(&stack_pool_lock));
+
+    return 0;
+}
+
+TARPC_FUNC_STATIC(zfts_stack_pool_park, {},
+{
+    static rpc_ptr_id_namespace ns = RPC_PTR_ID_NS_INVALID;
+    struct zf_stack *stack;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns, RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns,);
+
+    MAKE_CALL(out->retval = func_ptr(stack, &out->parked));
+})
+
+/**
+ * Release all the parked stacks, calling zf_deinit() for every one of
+ * them since tests do not call it when parking a stack.
+ *
+ * @param ns        Namespace of RPC pointers to ZF stacks.
+ * @param stats     Where to save statistics of the stack pool.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_stack_pool_drain(rpc_ptr_id_namespace ns,
+                      tarpc_zfts_stack_pool_stats *stats)
+{
+    api_func_ptr        stack_free;
+    api_func_void       deinit;
+    struct zf_stack    *stack;
+    uint64_t            start;
+    unsigned int        i;
+    int                 rc;
+    int                 result = 0;
+
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_stack_free",
+                           (api_func *)&stack_free);
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_deinit", (api_func *)&deinit);
+
+    CHECK_LOCK(pthread_mutex_lock(&stack_pool_lock));
+
+    for (i = 0; i < stack_pool_len; )
+    {
+        if (!stack_pool[i].parked)
+        {
+            i++;
+            continue;
+        }
+
+        stack = stack_pool[i].stack;
+        if (del_stack_ctx(stack) != 0)
+            abort();
+        zfts_tx_ts_collectors_forget(stack, NULL);
+
+        start = zfts_time_ns();
+        rc = stack_free(stack);
+        stack_pool_stats.free_ns += zfts_time_ns() - start;
+        stack_pool_stats.frees++;
+        if (rc != 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_stack_free() failed for a parked stack");
+            result = -1;
+        }
+        else
+        {
+            RCF_PCH_MEM_INDEX_FREE(stack_pool[i].ptr, ns);
+        }
+
+        deinit();
+        stack_pool_remove(i);
+    }
+
+    *stats = stack_pool_stats;
+
+    CHECK_LOCK(pthread_mutex_unlock(&stack_pool_lock));
+
+    return result;
+}
+
+TARPC_FUNC_STATIC(zfts_stack_pool_drain, {},
+{
+    static rpc_ptr_id_namespace ns = RPC_PTR_ID_NS_INVALID;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns, RPC_TYPE_NS_ZF_STACK,);
+
+    MAKE_CALL(out->retval = func_ptr(ns, &out->stats));
+})
+
 /* See the function description in zf.h */
 TARPC_FUNC(zf_stack_alloc, {},
 {
@@ -561,6 +1198,8 @@ TARPC_FUNC(zf_stack_free, {},
 
     if (del_stack_ctx(stack) != 0)
         abort();
+    stack_pool_forget(stack);
+    zfts_tx_ts_collectors_forget(stack, NULL);
 
     MAKE_CALL(out->retval = func_ptr(stack));
     TE_RPC_CONVERT_NEGATIVE_ERR(out->retval);
@@ -760,38 +1399,76 @@ zfts_call_stack_fd_iomux(struct zf_stack *stack, int timeout,
 }
 
 /**
- * Call zf_reactor_perform(); call zf_stack_has_pending_work() before
- * that if required.
- *
- * @param stack             Pointer to ZF stack.
- * @param reactor_ptr       Pointer to zf_reactor_perform() function
- *                          pointer (if it points to NULL value, it will
- *                          be updated by this function).
- * @param has_pending_ptr   Pointer to zf_stack_has_pending_work() function
- *                          pointer (if it points to NULL value, it will
- *                          be updated by this function).
- *
- * @return Return value of zf_reactor_perform() on success,
- *         negative value in case of failure.
+ * Get reactor profile of a stack.
+ *
+ * @param stack     Pointer to ZF stack.
+ *
+ * @return Pointer to the profile, or @c NULL if profiling is disabled.
  */
-static int
-zfts_call_zf_reactor_perform(struct zf_stack *stack,
-                             api_func_ptr *reactor_ptr,
-                             api_func_ptr *has_pending_ptr)
+static reactor_prof *
+get_reactor_prof(struct zf_stack *stack)
 {
-    api_func_ptr  reactor_func = NULL;
-    api_func_ptr  has_pending_func = NULL;
-    int           rc;
+    stack_ctx    *ctx;
+    reactor_prof *prof = NULL;
+
+    CHECK_LOCK(pthread_mutex_lock(&stack_contexts_lock));
+    ctx = get_stack_ctx(stack);
+    if (ctx != NULL)
+        prof = ctx->prof;
+    CHECK_LOCK(pthread_mutex_unlock(&stack_contexts_lock));
+
+    return prof;
+}
+
+/**
+ * Account duration of a call in a reactor profile histogram;
+ * bucket @c i counts calls which took [2^i, 2^(i+1)) TSC ticks.
+ *
+ * @param hist      Histogram.
+ * @param ticks     Duration of the call.
+ */
+static inline void
+reactor_hist_add(tarpc_zfts_reactor_hist *hist, uint64_t ticks)
+{
+    unsigned int bucket;
+
+    bucket = ticks == 0 ? 0 : 63 - __builtin_clzll(ticks);
+
+    hist->calls++;
+    hist->ticks += ticks;
+    if (ticks > hist->max)
+        hist->max = ticks;
+    hist->buckets[bucket]++;
+}
 
-    if (reactor_ptr != NULL)
-        reactor_func = *reactor_ptr;
-    if (has_pending_ptr != NULL)
-        has_pending_func = *has_pending_ptr;
+/* See description in zf_rpc.h */
+int
+zfts_call_zf_reactor_perform(struct zf_stack *stack, zfts_reactor_ctx *ctx)
+{
+    zfts_reactor_ctx  tmp_ctx = ZFTS_REACTOR_CTX_INIT;
+    reactor_prof     *prof = NULL;
+    uint64_t          tsc = 0;
+    int               rc;
 
-    if (reactor_func == NULL)
+    if (ctx == NULL)
+        ctx = &tmp_ctx;
+
+    /*
+     * Reactor profile of a stack is allocated together with its
+     * context and is not moved until the stack is released, so it is
+     * looked up under the lock only once per caller context.
+     */
+    if (ctx->stack != stack)
+    {
+        ctx->stack = stack;
+        ctx->prof = reactor_prof_on ? get_reactor_prof(stack) : NULL;
+    }
+    prof = ctx->prof;
+
+    if (ctx->reactor_func == NULL)
     {
         rc = tarpc_find_func(FALSE, "zf_reactor_perform",
-                             (api_func *)&reactor_func);
+                             (api_func *)&ctx->reactor_func);
         if (rc != 0)
         {
             te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_ENOENT),
@@ -802,10 +1479,10 @@ zfts_call_zf_reactor_perform(struct zf_stack *stack,
 
     if (has_pending_reactor_enabled())
     {
-        if (has_pending_func == NULL)
+        if (ctx->has_pending_func == NULL)
         {
             rc = tarpc_find_func(FALSE, "zf_stack_has_pending_work",
-                                 (api_func *)&has_pending_func);
+                                 (api_func *)&ctx->has_pending_func);
             if (rc != 0)
             {
                 te_rpc_error_set(
@@ -815,7 +1492,11 @@ zfts_call_zf_reactor_perform(struct zf_stack *stack,
             }
         }
 
-        rc = has_pending_func(stack);
+        if (prof != NULL)
+            tsc = zfts_tsc();
+        rc = ctx->has_pending_func(stack);
+        if (prof != NULL)
+            reactor_hist_add(&prof->has_pending, zfts_tsc() - tsc);
         if (rc < 0)
         {
             te_rpc_error_set(
@@ -825,12 +1506,18 @@ zfts_call_zf_reactor_perform(struct zf_stack *stack,
         }
     }
 
-    if (reactor_ptr != NULL)
-        *reactor_ptr = reactor_func;
-    if (has_pending_ptr != NULL)
-        *has_pending_ptr = has_pending_func;
+    if (prof != NULL)
+        tsc = zfts_tsc();
+    rc = ctx->reactor_func(stack);
+    if (prof != NULL)
+    {
+        reactor_hist_add(rc > 0 ? &prof->events : &prof->idle,
+                         zfts_tsc() - tsc);
+    }
+    if (rc >= 0)
+        zfts_tx_ts_collectors_drain(stack);
 
-    return reactor_func(stack);
+    return rc;
 }
 
 /* See the function description in zf_reactor.h */
@@ -838,15 +1525,99 @@ TARPC_FUNC(zf_reactor_perform, {},
 {
     static rpc_ptr_id_namespace ns = RPC_PTR_ID_NS_INVALID;
     struct zf_stack* stack;
+    zfts_reactor_ctx reactor_ctx = ZFTS_REACTOR_CTX_INIT;
 
     out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
     RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns, RPC_TYPE_NS_ZF_STACK,);
     RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns,);
 
-    MAKE_CALL(out->retval =
-                  zfts_call_zf_reactor_perform(stack,
-                                               (api_func_ptr *)&func_ptr,
-                                               NULL));
+    reactor_ctx.reactor_func = (api_func_ptr)func_ptr;
+    MAKE_CALL(out->retval = zfts_call_zf_reactor_perform(stack,
+                                                         &reactor_ctx));
+})
+
+/**
+ * Estimate frequency of the counter returned by zfts_tsc().
+ *
+ * @return Ticks per second.
+ */
+static uint64_t
+zfts_tsc_hz(void)
+{
+    static uint64_t hz = 0;
+
+    uint64_t ns_start;
+    uint64_t tsc_start;
+    uint64_t ns;
+
+    if (hz == 0)
+    {
+        ns_start = zfts_time_ns();
+        tsc_start = zfts_tsc();
+        do {
+            ns = zfts_time_ns() - ns_start;
+        } while (ns < ZFTS_NSEC_PER_SEC / 100);
+        hz = (zfts_tsc() - tsc_start) * ZFTS_NSEC_PER_SEC / ns;
+    }
+
+    return hz;
+}
+
+/**
+ * Get reactor profile of a stack and optionally reset it.
+ *
+ * @param stack     Pointer to ZF stack.
+ * @param reset     Whether to reset the profile.
+ * @param out       Where to save the profile.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_reactor_profile_get(struct zf_stack *stack, te_bool reset,
+                         tarpc_zfts_reactor_profile *out)
+{
+    stack_ctx *ctx;
+    int        rc = -1;
+
+    CHECK_LOCK(pthread_mutex_lock(&stack_contexts_lock));
+
+    ctx = get_stack_ctx(stack);
+    if (ctx == NULL)
+        goto cleanup;
+
+    if (ctx->prof == NULL)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_ENOENT),
+                         "reactor profiling is disabled, set "
+                         "TE_RPC_ZF_REACTOR_PROFILE_ENABLED to enable it");
+        goto cleanup;
+    }
+
+    out->events = ctx->prof->events;
+    out->idle = ctx->prof->idle;
+    out->has_pending = ctx->prof->has_pending;
+    if (reset)
+        memset(ctx->prof, 0, sizeof(*ctx->prof));
+    rc = 0;
+
+cleanup:
+    CHECK_LOCK(pthread_mutex_unlock(&stack_contexts_lock));
+
+    if (rc == 0)
+        out->tsc_hz = zfts_tsc_hz();
+    return rc;
+}
+
+TARPC_FUNC_STATIC(zfts_reactor_profile_get, {},
+{
+    static rpc_ptr_id_namespace ns = RPC_PTR_ID_NS_INVALID;
+    struct zf_stack *stack;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns, RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns,);
+
+    MAKE_CALL(out->retval = func_ptr(stack, in->reset, &out->prof));
 })
 
 /**
@@ -862,8 +1633,7 @@ zf_wait_for_event(struct zf_stack *stack)
     int     rc;
     te_bool first_iomux_call = TRUE;
 
-    api_func_ptr reactor_func = NULL;
-    api_func_ptr has_pending_func = NULL;
+    zfts_reactor_ctx reactor_ctx = ZFTS_REACTOR_CTX_INIT;
 
     do {
         if (stack_iomux_enabled())
@@ -882,9 +1652,7 @@ zf_wait_for_event(struct zf_stack *stack)
                 continue;
         }
 
-        rc = zfts_call_zf_reactor_perform(stack,
-                                          &reactor_func,
-                                          &has_pending_func);
+        rc = zfts_call_zf_reactor_perform(stack, &reactor_ctx);
     } while (rc == 0);
 
     if (rc < 0)
@@ -918,12 +1686,10 @@ zf_process_events(struct zf_stack *stack)
     int rc = 0;
     int count = 0;
 
-    api_func_ptr reactor_func = NULL;
-    api_func_ptr has_pending_func = NULL;
+    zfts_reactor_ctx reactor_ctx = ZFTS_REACTOR_CTX_INIT;
 
     while ((rc = zfts_call_zf_reactor_perform(stack,
-                                              &reactor_func,
-                                              &has_pending_func)) > 0)
+                                              &reactor_ctx)) > 0)
         count += rc;
 
     if (rc < 0)
@@ -964,8 +1730,7 @@ zf_process_events_long(struct zf_stack *st,
     struct timeval tv_start;
     struct timeval tv_now;
 
-    api_func_ptr reactor_func = NULL;
-    api_func_ptr has_pending_func = NULL;
+    zfts_reactor_ctx reactor_ctx = ZFTS_REACTOR_CTX_INIT;
 
     gettimeofday(&tv_start, NULL);
 
@@ -987,9 +1752,7 @@ zf_process_events_long(struct zf_stack *st,
                 continue;
         }
 
-        rc = zfts_call_zf_reactor_perform(st,
-                                          &reactor_func,
-                                          &has_pending_func);
+        rc = zfts_call_zf_reactor_perform(st, &reactor_ctx);
         if (rc >= 0)
             events_count += rc;
         else
@@ -1211,6 +1974,241 @@ TARPC_FUNC_STATIC(zf_many_threads_alloc_free_stack, {},
                                      in->wait_after_alloc));
 })
 
+/** Arguments passed to stack_alloc_bench_thread() */
+typedef struct stack_alloc_bench_args {
+    api_func_ptr        stack_alloc;    /**< Pointer to zf_stack_alloc() */
+    api_func_ptr        stack_free;     /**< Pointer to zf_stack_free() */
+    struct zf_attr     *attr;           /**< Pointer to ZF attributes */
+    int                 iterations;     /**< Number of alloc/free
+                                             iterations */
+    pthread_mutex_t    *lock;           /**< Lock protecting @p state */
+    pthread_cond_t     *cond;           /**< Signalled when @p state
+                                             changes */
+    int                *state;          /**< @c 0 - wait, @c 1 - run,
+                                             @c -1 - terminate */
+    tarpc_zfts_stack_alloc_stats *stats;    /**< Where to save
+                                                 latencies */
+    int                 rc;             /**< Error returned by
+                                             zf_stack_free() */
+} stack_alloc_bench_args;
+
+/**
+ * Main function of a thread allocating and releasing ZF stack
+ * a given number of times and measuring every call with TSC.
+ * All the threads start looping at the same time, when the state
+ * becomes @c 1.
+ *
+ * @param arg     Pointer to stack_alloc_bench_args structure.
+ *
+ * @return @c NULL.
+ */
+static void *
+stack_alloc_bench_thread(void *arg)
+{
+    stack_alloc_bench_args *args = (stack_alloc_bench_args *)arg;
+    struct zf_stack *stack;
+    uint64_t tsc;
+    uint64_t ticks;
+    int state;
+    int i;
+    int rc;
+
+    pthread_mutex_lock(args->lock);
+    while ((state = *args->state) == 0)
+        pthread_cond_wait(args->cond, args->lock);
+    pthread_mutex_unlock(args->lock);
+
+    for (i = 0; i < args->iterations && state > 0; i++)
+    {
+        tsc = zfts_tsc();
+        rc = args->stack_alloc(args->attr, &stack);
+        ticks = zfts_tsc() - tsc;
+        if (rc < 0)
+        {
+            if (rc != -ENOMEM)
+            {
+                ERROR("zf_stack_alloc() returned unexpected error "
+                      "%d (-%r)", rc, te_rc_os2te(-rc));
+            }
+            args->stats->failed++;
+            continue;
+        }
+        reactor_hist_add(&args->stats->alloc, ticks);
+
+        tsc = zfts_tsc();
+        rc = args->stack_free(stack);
+        ticks = zfts_tsc() - tsc;
+        if (rc != 0)
+        {
+            ERROR("zf_stack_free() returned %d (-%r)", rc,
+                  te_rc_os2te(-rc));
+            args->rc = rc;
+            break;
+        }
+        reactor_hist_add(&args->stats->free, ticks);
+    }
+
+    return NULL;
+}
+
+/**
+ * Measure latency of zf_stack_alloc() and zf_stack_free(): keep
+ * a number of live stacks allocated, then let every thread allocate
+ * and release a stack a given number of times concurrently.
+ *
+ * @param attr              ZF attributes.
+ * @param threads_num       Number of threads.
+ * @param iterations        Number of iterations of every thread.
+ * @param live_stacks       Number of stacks to keep allocated while
+ *                          the threads run.
+ * @param stats             Where to save latencies, one element per
+ *                          thread.
+ * @param live_allocated    Where to save number of live stacks which
+ *                          were actually allocated (allocation stops
+ *                          at the first failure).
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_stack_alloc_free_bench(struct zf_attr *attr, int threads_num,
+                            int iterations, int live_stacks,
+                            tarpc_zfts_stack_alloc_stats *stats,
+                            int *live_allocated)
+{
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t  cond = PTHREAD_COND_INITIALIZER;
+    int             state = 0;
+
+    stack_alloc_bench_args *args = NULL;
+    pthread_t              *threads = NULL;
+    struct zf_stack       **live = NULL;
+    api_func_ptr            stack_alloc;
+    api_func_ptr            stack_free;
+    int                     threads_created = 0;
+    int                     i;
+    int                     rc;
+    int                     result = 0;
+
+    *live_allocated = 0;
+
+    if (threads_num <= 0 || iterations < 0 || live_stacks < 0)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "invalid number of threads, iterations or "
+                         "live stacks");
+        return -1;
+    }
+
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_stack_alloc",
+                           (api_func *)&stack_alloc);
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_stack_free",
+                           (api_func *)&stack_free);
+
+    threads = TE_ALLOC(threads_num * sizeof(*threads));
+    args = TE_ALLOC(threads_num * sizeof(*args));
+    live = TE_ALLOC(MAX(live_stacks, 1) * sizeof(*live));
+
+    for (i = 0; i < live_stacks; i++)
+    {
+        rc = stack_alloc(attr, &live[i]);
+        if (rc < 0)
+        {
+            WARN("%s(): only %d of %d live stacks were allocated, "
+                 "zf_stack_alloc() returned %d (-%r)", __FUNCTION__, i,
+                 live_stacks, rc, te_rc_os2te(-rc));
+            break;
+        }
+    }
+    *live_allocated = i;
+
+    for (i = 0; i < threads_num; i++)
+    {
+        args[i].stack_alloc = stack_alloc;
+        args[i].stack_free = stack_free;
+        args[i].attr = attr;
+        args[i].iterations = iterations;
+        args[i].lock = &lock;
+        args[i].cond = &cond;
+        args[i].state = &state;
+        args[i].stats = &stats[i];
+
+        rc = pthread_create(&threads[i], NULL, &stack_alloc_bench_thread,
+                            &args[i]);
+        if (rc != 0)
+        {
+            ERROR("%s(): failed to create thread %d", __FUNCTION__, i);
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, rc),
+                             "pthread_create() failed");
+            result = -1;
+            break;
+        }
+
+        threads_created++;
+    }
+
+    pthread_mutex_lock(&lock);
+    state = result == 0 ? 1 : -1;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&lock);
+
+    for (i = 0; i < threads_created; i++)
+    {
+        rc = pthread_join(threads[i], NULL);
+        if (rc != 0)
+        {
+            ERROR("%s(): failed to join thread %d", __FUNCTION__, i);
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, rc),
+                             "pthread_join() failed");
+            result = -1;
+        }
+        else if (args[i].rc != 0 && result == 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -args[i].rc),
+                             "zf_stack_free() failed");
+            result = -1;
+        }
+    }
+
+    for (i = 0; i < *live_allocated; i++)
+    {
+        rc = stack_free(live[i]);
+        if (rc != 0 && result == 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_stack_free() failed for a live stack");
+            result = -1;
+        }
+    }
+
+    free(threads);
+    free(args);
+    free(live);
+
+    return result;
+}
+
+TARPC_FUNC_STATIC(zfts_stack_alloc_free_bench, {},
+{
+    struct zf_attr *attr;
+    static rpc_ptr_id_namespace attr_ns = RPC_PTR_ID_NS_INVALID;
+
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&attr_ns, RPC_TYPE_NS_ZF_ATTR,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(attr, in->attr, attr_ns,);
+
+    if (in->threads_num > 0)
+    {
+        out->stats.stats_val = TE_ALLOC(in->threads_num *
+                                        sizeof(*out->stats.stats_val));
+        out->stats.stats_len = in->threads_num;
+    }
+    out->tsc_hz = zfts_tsc_hz();
+
+    MAKE_CALL(out->retval = func_ptr(attr, in->threads_num,
+                                     in->iterations, in->live_stacks,
+                                     out->stats.stats_val,
+                                     &out->live_allocated));
+})
+
 /* See description in zf_rpc.h */
 int
 prepare_pkt_reports(struct zf_pkt_report **reps_out,
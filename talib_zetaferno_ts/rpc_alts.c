@@ -53,6 +53,8 @@ TARPC_FUNC(zf_alternatives_alloc, {},
     MAKE_CALL(out->retval = func_ptr(stack, attr, &alt_out));
     TE_RPC_CONVERT_NEGATIVE_ERR(out->retval);
     out->alt_out = alt_out;
+    if (out->retval == 0)
+        zfts_stack_alts_add(stack, 1);
 })
 
 TARPC_FUNC(zf_alternatives_release, {},
@@ -69,6 +71,8 @@ TARPC_FUNC(zf_alternatives_release, {},
 
     MAKE_CALL(out->retval = func_ptr(stack, in->alt));
     TE_RPC_CONVERT_NEGATIVE_ERR(out->retval);
+    if (out->retval == 0)
+        zfts_stack_alts_add(stack, -1);
 })
 
 TARPC_FUNC(zf_alternatives_send, {},
@@ -0,0 +1,1864 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/**
+ * @brief Bulk RPC routines implementation
+ *
+ * RPC routines creating, releasing and exercising many zockets or
+ * peer sockets in a single call.
+ *
+ * $Id$
+ */
+
+#define TE_LGR_USER     "SFC Zetaferno RPC Bulk"
+#include "te_config.h"
+#include "config.h"
+
+#include "logger_ta_lock.h"
+#include "rpc_server.h"
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include <fcntl.h>
+#include <poll.h>
+#include <netinet/tcp.h>
+
+#include "te_sockaddr.h"
+#include "zf_talib_namespace.h"
+#include "te_alloc.h"
+#include "te_dbuf.h"
+#include "te_tools.h"
+#include "zf_rpc.h"
+#include "te_rpc_sys_socket.h"
+
+#include <zf/zf.h>
+#include <zf/zf_udp.h>
+#include <zf/zf_tcp.h>
+
+/** Size of buffer used to read data from a socket in bulk */
+#define ZFTS_SOCKETS_BULK_CHUNK 16384
+
+/** ZF functions used to create and release zockets in bulk. */
+typedef struct bulk_zocket_funcs {
+    api_func_ptr    zfur_alloc;         /**< zfur_alloc() */
+    api_func_ptr    zfur_addr_bind;     /**< zfur_addr_bind() */
+    api_func_ptr    zfur_free;          /**< zfur_free() */
+    api_func_ptr_ret_ptr zfur_to_waitable; /**< zfur_to_waitable() */
+    api_func_ptr    zfut_alloc;         /**< zfut_alloc() */
+    api_func_ptr    zfut_free;          /**< zfut_free() */
+    api_func_ptr_ret_ptr zfut_to_waitable; /**< zfut_to_waitable() */
+    api_func_ptr    zftl_listen;        /**< zftl_listen() */
+    api_func_ptr    zftl_accept;        /**< zftl_accept() */
+    api_func_ptr    zftl_free;          /**< zftl_free() */
+    api_func_ptr_ret_ptr zftl_to_waitable; /**< zftl_to_waitable() */
+    api_func_ptr    zft_alloc;          /**< zft_alloc() */
+    api_func_ptr    zft_addr_bind;      /**< zft_addr_bind() */
+    api_func_ptr    zft_connect;        /**< zft_connect() */
+    api_func_ptr    zft_handle_free;    /**< zft_handle_free() */
+    api_func_ptr    zft_free;           /**< zft_free() */
+    api_func_ptr    zft_state;          /**< zft_state() */
+    api_func        zft_getname;        /**< zft_getname() */
+    api_func_ptr_ret_ptr zft_to_waitable; /**< zft_to_waitable() */
+    api_func_ptr    process_events;     /**< zf_process_events() */
+} bulk_zocket_funcs;
+
+/**
+ * Resolve ZF functions used to create and release zockets in bulk.
+ *
+ * @param funcs     Where to save function pointers.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+bulk_zocket_funcs_resolve(bulk_zocket_funcs *funcs)
+{
+#define BULK_FIND_FUNC(name_) \
+    TARPC_FIND_FUNC_RETURN(FALSE, #name_, (api_func *)&funcs->name_)
+
+    BULK_FIND_FUNC(zfur_alloc);
+    BULK_FIND_FUNC(zfur_addr_bind);
+    BULK_FIND_FUNC(zfur_free);
+    BULK_FIND_FUNC(zfur_to_waitable);
+    BULK_FIND_FUNC(zfut_alloc);
+    BULK_FIND_FUNC(zfut_free);
+    BULK_FIND_FUNC(zfut_to_waitable);
+    BULK_FIND_FUNC(zftl_listen);
+    BULK_FIND_FUNC(zftl_accept);
+    BULK_FIND_FUNC(zftl_free);
+    BULK_FIND_FUNC(zftl_to_waitable);
+    BULK_FIND_FUNC(zft_alloc);
+    BULK_FIND_FUNC(zft_addr_bind);
+    BULK_FIND_FUNC(zft_connect);
+    BULK_FIND_FUNC(zft_handle_free);
+    BULK_FIND_FUNC(zft_free);
+    BULK_FIND_FUNC(zft_state);
+    BULK_FIND_FUNC(zft_getname);
+    BULK_FIND_FUNC(zft_to_waitable);
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_process_events",
+                           (api_func *)&funcs->process_events);
+
+#undef BULK_FIND_FUNC
+    return 0;
+}
+
+/**
+ * Get namespace of RPC pointers of zockets of a given type.
+ *
+ * @param type      Zocket type.
+ * @param name      Where to save namespace name.
+ *
+ * @return Pointer to namespace ID, or @c NULL for unknown type.
+ */
+static rpc_ptr_id_namespace *
+bulk_zocket_ns(zfts_bulk_zocket_type type, const char **name)
+{
+    static rpc_ptr_id_namespace ns_zfur = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zfut = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zftl = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zft = RPC_PTR_ID_NS_INVALID;
+
+    switch (type)
+    {
+        case ZFTS_BULK_ZOCKET_URX:
+            *name = RPC_TYPE_NS_ZFUR;
+            return &ns_zfur;
+
+        case ZFTS_BULK_ZOCKET_UTX:
+            *name = RPC_TYPE_NS_ZFUT;
+            return &ns_zfut;
+
+        case ZFTS_BULK_ZOCKET_ZFTL:
+            *name = RPC_TYPE_NS_ZFTL;
+            return &ns_zftl;
+
+        case ZFTS_BULK_ZOCKET_ZFT_ACT:
+        case ZFTS_BULK_ZOCKET_ZFT_PAS:
+            *name = RPC_TYPE_NS_ZFT;
+            return &ns_zft;
+
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * Release a zocket created in bulk.
+ *
+ * @param funcs     ZF functions.
+ * @param type      Zocket type.
+ * @param zocket    Zocket.
+ *
+ * @return @c 0 on success, negative value on failure.
+ */
+static int
+bulk_zocket_free(bulk_zocket_funcs *funcs, zfts_bulk_zocket_type type,
+                 void *zocket)
+{
+    switch (type)
+    {
+        case ZFTS_BULK_ZOCKET_URX:
+            return funcs->zfur_free(zocket);
+
+        case ZFTS_BULK_ZOCKET_UTX:
+            zfts_tx_ts_collectors_forget(NULL, zocket);
+            return funcs->zfut_free(zocket);
+
+        case ZFTS_BULK_ZOCKET_ZFTL:
+            return funcs->zftl_free(zocket);
+
+        case ZFTS_BULK_ZOCKET_ZFT_ACT:
+        case ZFTS_BULK_ZOCKET_ZFT_PAS:
+            zfts_tx_ts_collectors_forget(NULL, zocket);
+            return funcs->zft_free(zocket);
+
+        default:
+            return -EINVAL;
+    }
+}
+
+/**
+ * Get address of the i-th zocket or socket: port of @p base is
+ * incremented by @p i if it is not zero.
+ *
+ * @param base      Base address.
+ * @param i         Zocket index.
+ * @param addr      Where to save the address.
+ */
+static void
+bulk_zocket_addr(const struct sockaddr *base, int i,
+                 struct sockaddr_storage *addr)
+{
+    uint16_t port;
+
+    memcpy(addr, base, te_sockaddr_get_size(base));
+    port = ntohs(te_sockaddr_get_port(base));
+    if (port != 0)
+        te_sockaddr_set_port(SA(addr), htons(port + i));
+}
+
+/**
+ * Create a number of zockets of the same type on a stack.
+ *
+ * If port of @p laddr is not zero, it is incremented for every next
+ * zocket. UDP zockets are bound to @p laddr and @p raddr (which is
+ * required for UDP TX zockets and optional for UDP RX ones); if port of
+ * @p raddr is not zero, it is incremented for every next zocket too.
+ * TCP listening zockets listen on @p laddr. Active TCP zockets are
+ * bound to @p laddr if its port is not zero, and all connect to the
+ * same @p raddr; after creating them the stack is processed until all
+ * of them are established or @p timeout expires.
+ *
+ * @param stack       ZF stack.
+ * @param attr        ZF attributes.
+ * @param type        Type of zockets.
+ * @param count       Number of zockets to create.
+ * @param laddr       Local address.
+ * @param raddr       Remote address.
+ * @param timeout     How long to wait for TCP connections establishment,
+ *                    milliseconds.
+ * @param zockets     Where to save created zockets.
+ * @param waitables   Where to save waitables of created zockets.
+ *
+ * @return @c 0 on success, @c -1 on failure (in which case all the
+ *         created zockets are released).
+ */
+int
+zfts_zockets_bulk_alloc(struct zf_stack *stack, struct zf_attr *attr,
+                        zfts_bulk_zocket_type type, int count,
+                        const struct sockaddr *laddr,
+                        const struct sockaddr *raddr, int timeout,
+                        void **zockets, struct zf_waitable **waitables)
+{
+    bulk_zocket_funcs       funcs;
+    struct sockaddr_storage addr;
+    struct sockaddr_storage peer;
+    struct zft_handle      *handle;
+    uint64_t                deadline;
+    int                     established;
+    int                     created;
+    int                     rc = 0;
+
+    if (bulk_zocket_funcs_resolve(&funcs) != 0)
+        return -1;
+
+    if (laddr == NULL || type == ZFTS_BULK_ZOCKET_ZFT_PAS ||
+        ((type == ZFTS_BULK_ZOCKET_UTX ||
+          type == ZFTS_BULK_ZOCKET_ZFT_ACT) && raddr == NULL))
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "zocket type or addresses are not valid");
+        return -1;
+    }
+
+    for (created = 0; created < count; created++)
+    {
+        bulk_zocket_addr(laddr, created, &addr);
+        if (raddr != NULL)
+            bulk_zocket_addr(raddr, created, &peer);
+
+        switch (type)
+        {
+            case ZFTS_BULK_ZOCKET_URX:
+                rc = funcs.zfur_alloc((struct zfur **)&zockets[created],
+                                      stack, attr);
+                if (rc < 0)
+                    break;
+
+                rc = funcs.zfur_addr_bind(zockets[created], SA(&addr),
+                                          te_sockaddr_get_size(SA(&addr)),
+                                          raddr == NULL ? NULL : SA(&peer),
+                                          raddr == NULL ? 0 :
+                                            te_sockaddr_get_size(raddr),
+                                          0);
+                if (rc < 0)
+                {
+                    funcs.zfur_free(zockets[created]);
+                    break;
+                }
+
+                waitables[created] =
+                    funcs.zfur_to_waitable(zockets[created]);
+                break;
+
+            case ZFTS_BULK_ZOCKET_UTX:
+                rc = funcs.zfut_alloc((struct zfut **)&zockets[created],
+                                      stack, SA(&addr),
+                                      te_sockaddr_get_size(SA(&addr)),
+                                      SA(&peer),
+                                      te_sockaddr_get_size(SA(&peer)),
+                                      0, attr);
+                if (rc < 0)
+                    break;
+
+                waitables[created] =
+                    funcs.zfut_to_waitable(zockets[created]);
+                break;
+
+            case ZFTS_BULK_ZOCKET_ZFTL:
+                rc = funcs.zftl_listen(stack, SA(&addr),
+                                       te_sockaddr_get_size(SA(&addr)),
+                                       attr,
+                                       (struct zftl **)&zockets[created]);
+                if (rc < 0)
+                    break;
+
+                waitables[created] =
+                    funcs.zftl_to_waitable(zockets[created]);
+                break;
+
+            case ZFTS_BULK_ZOCKET_ZFT_ACT:
+                rc = funcs.zft_alloc(stack, attr, &handle);
+                if (rc < 0)
+                    break;
+
+                if (te_sockaddr_get_port(laddr) != 0)
+                {
+                    rc = funcs.zft_addr_bind(handle, SA(&addr),
+                                             te_sockaddr_get_size(
+                                                            SA(&addr)),
+                                             0);
+                }
+                if (rc == 0)
+                {
+                    rc = funcs.zft_connect(handle, raddr,
+                                           te_sockaddr_get_size(raddr),
+                                           (struct zft **)&zockets[created]);
+                }
+                if (rc < 0)
+                {
+                    funcs.zft_handle_free(handle);
+                    break;
+                }
+
+                waitables[created] =
+                    funcs.zft_to_waitable(zockets[created]);
+                break;
+
+            default:
+                rc = -EINVAL;
+        }
+
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "failed to create zocket %d", created);
+            goto fail;
+        }
+    }
+
+    if (type != ZFTS_BULK_ZOCKET_ZFT_ACT)
+        return 0;
+
+    deadline = zfts_time_ns() + (uint64_t)timeout * 1000000ULL;
+    do {
+        rc = funcs.process_events(stack);
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_process_events() failed");
+            goto fail;
+        }
+
+        for (established = 0; established < count; established++)
+        {
+            if (funcs.zft_state(zockets[established]) != TCP_ESTABLISHED)
+                break;
+        }
+        if (established == count)
+            return 0;
+    } while (zfts_time_ns() < deadline);
+
+    te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_ETIMEDOUT),
+                     "only %d of %d connections were established",
+                     established, count);
+
+fail:
+    while (created-- > 0)
+        bulk_zocket_free(&funcs, type, zockets[created]);
+
+    return -1;
+}
+
+TARPC_FUNC_STATIC(zfts_zockets_bulk_alloc, {},
+{
+    static rpc_ptr_id_namespace ns_stack = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_attr = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zf_w = RPC_PTR_ID_NS_INVALID;
+
+    rpc_ptr_id_namespace *ns_zocket;
+    const char          *ns_name = NULL;
+    struct zf_stack     *stack = NULL;
+    struct zf_attr      *attr = NULL;
+    void               **zockets;
+    struct zf_waitable **waitables;
+    int                  i;
+
+    PREPARE_ADDR(laddr, in->laddr, 0);
+    PREPARE_ADDR(raddr, in->raddr, 0);
+
+    ns_zocket = bulk_zocket_ns(in->type, &ns_name);
+    if (ns_zocket == NULL || in->count <= 0)
+    {
+        out->common._errno = TE_RC(TE_TA_UNIX, TE_EINVAL);
+        out->retval = -1;
+        return;
+    }
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_stack,
+                                           RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_attr,
+                                           RPC_TYPE_NS_ZF_ATTR,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zf_w,
+                                           RPC_TYPE_NS_ZF_WAITABLE,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(ns_zocket, ns_name,);
+
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns_stack,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(attr, in->attr, ns_attr,);
+
+    zockets = TE_ALLOC(in->count * sizeof(*zockets));
+    waitables = TE_ALLOC(in->count * sizeof(*waitables));
+
+    MAKE_CALL(out->retval = func_ptr(stack, attr, in->type, in->count,
+                                     laddr, raddr, in->timeout,
+                                     zockets, waitables));
+
+    if (out->retval == 0)
+    {
+        out->zockets.zockets_len = in->count;
+        out->zockets.zockets_val =
+            TE_ALLOC(in->count * sizeof(*out->zockets.zockets_val));
+        out->waitables.waitables_len = in->count;
+        out->waitables.waitables_val =
+            TE_ALLOC(in->count * sizeof(*out->waitables.waitables_val));
+
+        for (i = 0; i < in->count; i++)
+        {
+            out->zockets.zockets_val[i] =
+                RCF_PCH_MEM_INDEX_ALLOC(zockets[i], *ns_zocket);
+            zfts_stack_zocket_add(stack, zockets[i]);
+            out->waitables.waitables_val[i] =
+                RCF_PCH_MEM_INDEX_ALLOC(waitables[i], ns_zf_w);
+        }
+    }
+
+    free(zockets);
+    free(waitables);
+})
+
+/**
+ * Release zockets created in bulk. All the zockets are processed even
+ * if releasing some of them fails.
+ *
+ * @param type      Zocket type.
+ * @param zockets   Array of zockets.
+ * @param count     Number of zockets.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+int
+zfts_zockets_bulk_free(zfts_bulk_zocket_type type, void **zockets,
+                       int count)
+{
+    bulk_zocket_funcs   funcs;
+    int                 result = 0;
+    int                 rc;
+    int                 i;
+
+    if (bulk_zocket_funcs_resolve(&funcs) != 0)
+        return -1;
+
+    for (i = 0; i < count; i++)
+    {
+        rc = bulk_zocket_free(&funcs, type, zockets[i]);
+        if (rc == 0)
+            zfts_stack_zocket_del(zockets[i]);
+        else if (rc < 0 && result == 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "failed to release zocket %d", i);
+            result = -1;
+        }
+    }
+
+    return result;
+}
+
+TARPC_FUNC_STATIC(zfts_zockets_bulk_free, {},
+{
+    static rpc_ptr_id_namespace ns_zf_w = RPC_PTR_ID_NS_INVALID;
+
+    rpc_ptr_id_namespace *ns_zocket;
+    const char   *ns_name = NULL;
+    void         *zocket;
+    void        **zockets;
+    unsigned int  i;
+
+    ns_zocket = bulk_zocket_ns(in->type, &ns_name);
+    if (ns_zocket == NULL)
+    {
+        out->common._errno = TE_RC(TE_TA_UNIX, TE_EINVAL);
+        out->retval = -1;
+        return;
+    }
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zf_w,
+                                           RPC_TYPE_NS_ZF_WAITABLE,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(ns_zocket, ns_name,);
+
+    /*
+     * Check pointers before allocating memory, otherwise it is leaked
+     * if some pointer is invalid.
+     */
+    for (i = 0; i < in->zockets.zockets_len; i++)
+    {
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(zocket, in->zockets.zockets_val[i],
+                                     *ns_zocket,);
+    }
+
+    /* Thousands of zockets may be passed, so do not use the stack. */
+    zockets = TE_ALLOC(MAX(in->zockets.zockets_len, 1) *
+                       sizeof(*zockets));
+    for (i = 0; i < in->zockets.zockets_len; i++)
+    {
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(zockets[i],
+                                     in->zockets.zockets_val[i],
+                                     *ns_zocket,);
+    }
+
+    MAKE_CALL(out->retval = func_ptr(in->type, zockets,
+                                     in->zockets.zockets_len));
+    free(zockets);
+
+    for (i = 0; i < in->zockets.zockets_len; i++)
+        RCF_PCH_MEM_INDEX_FREE(in->zockets.zockets_val[i], *ns_zocket);
+    for (i = 0; i < in->waitables.waitables_len; i++)
+        RCF_PCH_MEM_INDEX_FREE(in->waitables.waitables_val[i], ns_zf_w);
+})
+
+/**
+ * Bind a UDP RX zocket to a number of address tuples or unbind it from
+ * them, measuring every call. Processing stops at the first failed call,
+ * so that the caller can find out how many tuples could be bound.
+ *
+ * @param urx       UDP RX zocket.
+ * @param laddrs    Local addresses.
+ * @param raddrs    Remote addresses (the array or its elements may be
+ *                  @c NULL).
+ * @param count     Number of tuples.
+ * @param unbind    Call zfur_addr_unbind() instead of zfur_addr_bind().
+ * @param flags     Flags passed to every call.
+ * @param times     Where to save duration of every call, ns.
+ * @param done      Where to save number of successful calls.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+int
+zfts_zfur_bulk_bind(struct zfur *urx, const struct sockaddr **laddrs,
+                    const struct sockaddr **raddrs, int count,
+                    te_bool unbind, int flags, uint64_t *times, int *done)
+{
+    api_func_ptr            bind_f;
+    const struct sockaddr  *raddr;
+    uint64_t                start;
+    int                     rc;
+    int                     i;
+
+    if (unbind)
+    {
+        TARPC_FIND_FUNC_RETURN(FALSE, "zfur_addr_unbind",
+                               (api_func *)&bind_f);
+    }
+    else
+    {
+        TARPC_FIND_FUNC_RETURN(FALSE, "zfur_addr_bind",
+                               (api_func *)&bind_f);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        raddr = raddrs == NULL ? NULL : raddrs[i];
+
+        start = zfts_time_ns();
+        rc = bind_f(urx, laddrs[i], te_sockaddr_get_size(laddrs[i]),
+                    raddr,
+                    raddr == NULL ? 0 : te_sockaddr_get_size(raddr),
+                    flags);
+        times[i] = zfts_time_ns() - start;
+
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "%s() failed for tuple %d",
+                             unbind ? "zfur_addr_unbind" :
+                                      "zfur_addr_bind", i);
+            break;
+        }
+    }
+
+    *done = i;
+    return i == count ? 0 : -1;
+}
+
+TARPC_FUNC_STATIC(zfts_zfur_bulk_bind, {},
+{
+    static rpc_ptr_id_namespace ns_zfur = RPC_PTR_ID_NS_INVALID;
+
+    unsigned int             count = in->laddrs.laddrs_len;
+    struct zfur             *urx;
+    struct sockaddr_storage *addrs;
+    const struct sockaddr  **laddrs;
+    const struct sockaddr  **raddrs;
+    struct sockaddr         *addr;
+    socklen_t                addr_len;
+    te_bool                  with_raddrs;
+    int                      done = 0;
+    unsigned int             i;
+    te_errno                 rc = 0;
+
+    with_raddrs = (in->raddrs.raddrs_len != 0);
+    if (with_raddrs && in->raddrs.raddrs_len != count)
+    {
+        out->common._errno = TE_RC(TE_TA_UNIX, TE_EINVAL);
+        out->retval = -1;
+        return;
+    }
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zfur, RPC_TYPE_NS_ZFUR,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(urx, in->urx, ns_zfur,);
+
+    /* Thousands of tuples may be passed, so do not use the stack. */
+    addrs = TE_ALLOC(MAX(count, 1) * 2 * sizeof(*addrs));
+    laddrs = TE_ALLOC(MAX(count, 1) * 2 * sizeof(*laddrs));
+    raddrs = laddrs + MAX(count, 1);
+    for (i = 0; i < count && rc == 0; i++)
+    {
+        rc = sockaddr_rpc2h(&in->laddrs.laddrs_val[i], SA(&addrs[2 * i]),
+                            sizeof(addrs[2 * i]), &addr, &addr_len);
+        laddrs[i] = addr;
+        raddrs[i] = NULL;
+        if (rc == 0 && with_raddrs)
+        {
+            rc = sockaddr_rpc2h(&in->raddrs.raddrs_val[i],
+                                SA(&addrs[2 * i + 1]),
+                                sizeof(addrs[2 * i + 1]),
+                                &addr, &addr_len);
+            raddrs[i] = addr;
+        }
+    }
+    if (rc != 0)
+    {
+        free(addrs);
+        free(laddrs);
+        out->common._errno = rc;
+        out->retval = -1;
+        return;
+    }
+
+    out->times.times_val = TE_ALLOC(MAX(count, 1) *
+                                    sizeof(*out->times.times_val));
+
+    MAKE_CALL(out->retval = func_ptr(urx, laddrs,
+                                     with_raddrs ? raddrs : NULL, count,
+                                     in->unbind, in->flags,
+                                     out->times.times_val, &done));
+    out->times.times_len = done;
+
+    free(addrs);
+    free(laddrs);
+})
+
+/**
+ * Accept a number of connections on a TCP listening zocket, processing
+ * the stack until all of them are accepted or @p timeout expires.
+ *
+ * @param stack       ZF stack.
+ * @param zftl        TCP listening zocket.
+ * @param count       Number of connections to accept.
+ * @param timeout     How long to wait for connections, milliseconds.
+ * @param zockets     Where to save accepted zockets.
+ * @param waitables   Where to save waitables of accepted zockets.
+ * @param raddrs      Where to save remote addresses of accepted zockets.
+ *
+ * @return @c 0 on success, @c -1 on failure (in which case all the
+ *         accepted zockets are released).
+ */
+int
+zfts_zftl_bulk_accept(struct zf_stack *stack, struct zftl *zftl,
+                      int count, int timeout, void **zockets,
+                      struct zf_waitable **waitables,
+                      struct sockaddr_storage *raddrs)
+{
+    bulk_zocket_funcs   funcs;
+    socklen_t           raddrlen;
+    uint64_t            deadline;
+    int                 accepted = 0;
+    int                 rc;
+
+    if (bulk_zocket_funcs_resolve(&funcs) != 0)
+        return -1;
+
+    deadline = zfts_time_ns() + (uint64_t)timeout * 1000000ULL;
+    while (accepted < count)
+    {
+        rc = funcs.zftl_accept(zftl, (struct zft **)&zockets[accepted]);
+        if (rc == 0)
+        {
+            raddrlen = sizeof(raddrs[accepted]);
+            funcs.zft_getname(zockets[accepted], NULL, NULL,
+                              SA(&raddrs[accepted]), &raddrlen);
+            waitables[accepted] =
+                funcs.zft_to_waitable(zockets[accepted]);
+            accepted++;
+            continue;
+        }
+        if (rc != -EAGAIN)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zftl_accept() failed");
+            goto fail;
+        }
+
+        if (zfts_time_ns() >= deadline)
+        {
+            te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_ETIMEDOUT),
+                             "only %d of %d connections were accepted",
+                             accepted, count);
+            goto fail;
+        }
+
+        rc = funcs.process_events(stack);
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_process_events() failed");
+            goto fail;
+        }
+    }
+
+    return 0;
+
+fail:
+    while (accepted-- > 0)
+        funcs.zft_free(zockets[accepted]);
+
+    return -1;
+}
+
+TARPC_FUNC_STATIC(zfts_zftl_bulk_accept, {},
+{
+    static rpc_ptr_id_namespace ns_stack = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zftl = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zft = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zf_w = RPC_PTR_ID_NS_INVALID;
+
+    struct zf_stack         *stack = NULL;
+    struct zftl             *zftl = NULL;
+    void                   **zockets;
+    struct zf_waitable     **waitables;
+    struct sockaddr_storage *raddrs;
+    int                      i;
+
+    if (in->count <= 0)
+    {
+        out->common._errno = TE_RC(TE_TA_UNIX, TE_EINVAL);
+        out->retval = -1;
+        return;
+    }
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_stack,
+                                           RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zftl, RPC_TYPE_NS_ZFTL,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zft, RPC_TYPE_NS_ZFT,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zf_w,
+                                           RPC_TYPE_NS_ZF_WAITABLE,);
+
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns_stack,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(zftl, in->zftl, ns_zftl,);
+
+    zockets = TE_ALLOC(in->count * sizeof(*zockets));
+    waitables = TE_ALLOC(in->count * sizeof(*waitables));
+    raddrs = TE_ALLOC(in->count * sizeof(*raddrs));
+
+    MAKE_CALL(out->retval = func_ptr(stack, zftl, in->count, in->timeout,
+                                     zockets, waitables, raddrs));
+
+    if (out->retval == 0)
+    {
+        out->zockets.zockets_len = in->count;
+        out->zockets.zockets_val =
+            TE_ALLOC(in->count * sizeof(*out->zockets.zockets_val));
+        out->waitables.waitables_len = in->count;
+        out->waitables.waitables_val =
+            TE_ALLOC(in->count * sizeof(*out->waitables.waitables_val));
+        out->raddrs.raddrs_len = in->count;
+        out->raddrs.raddrs_val =
+            TE_ALLOC(in->count * sizeof(*out->raddrs.raddrs_val));
+
+        for (i = 0; i < in->count; i++)
+        {
+            out->zockets.zockets_val[i] =
+                RCF_PCH_MEM_INDEX_ALLOC(zockets[i], ns_zft);
+            zfts_stack_zocket_add(stack, zockets[i]);
+            out->waitables.waitables_val[i] =
+                RCF_PCH_MEM_INDEX_ALLOC(waitables[i], ns_zf_w);
+            sockaddr_output_h2rpc(SA(&raddrs[i]),
+                                  te_sockaddr_get_size(SA(&raddrs[i])),
+                                  te_sockaddr_get_size(SA(&raddrs[i])),
+                                  &out->raddrs.raddrs_val[i]);
+        }
+    }
+
+    free(zockets);
+    free(waitables);
+    free(raddrs);
+})
+
+/**
+ * Create a number of sockets of the same type.
+ *
+ * If @p laddr is not @c NULL, sockets are bound to it; if its port is
+ * not zero, it is incremented for every next socket. If @p raddr is
+ * not @c NULL, sockets are connected to it: datagram sockets are
+ * connected to @p raddr with port incremented for every next socket
+ * (if it is not zero), stream sockets start non-blocking connect to
+ * the same @p raddr (and are switched back to blocking mode after
+ * that).
+ *
+ * @param domain    Communication domain.
+ * @param type      Socket type.
+ * @param count     Number of sockets to create.
+ * @param laddr     Local address (may be @c NULL).
+ * @param raddr     Remote address (may be @c NULL).
+ * @param fds       Where to save created sockets.
+ *
+ * @return @c 0 on success, @c -1 on failure (in which case all the
+ *         created sockets are closed).
+ */
+int
+zfts_sockets_bulk_create(int domain, int type, int count,
+                         const struct sockaddr *laddr,
+                         const struct sockaddr *raddr, int *fds)
+{
+    struct sockaddr_storage addr;
+    int                     created;
+    int                     flags;
+    int                     rc;
+
+    for (created = 0; created < count; created++)
+    {
+        fds[created] = socket(domain, type, 0);
+        if (fds[created] < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                             "failed to create socket %d", created);
+            goto fail;
+        }
+
+        if (laddr != NULL)
+        {
+            bulk_zocket_addr(laddr, created, &addr);
+            if (bind(fds[created], SA(&addr),
+                     te_sockaddr_get_size(SA(&addr))) < 0)
+            {
+                te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                                 "failed to bind socket %d", created);
+                close(fds[created]);
+                goto fail;
+            }
+        }
+
+        if (raddr == NULL)
+            continue;
+
+        if (type == SOCK_DGRAM)
+        {
+            bulk_zocket_addr(raddr, created, &addr);
+            rc = connect(fds[created], SA(&addr),
+                         te_sockaddr_get_size(SA(&addr)));
+        }
+        else
+        {
+            flags = fcntl(fds[created], F_GETFL);
+            fcntl(fds[created], F_SETFL, flags | O_NONBLOCK);
+            rc = connect(fds[created], raddr, te_sockaddr_get_size(raddr));
+            if (rc < 0 && errno == EINPROGRESS)
+                rc = 0;
+            fcntl(fds[created], F_SETFL, flags);
+        }
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                             "failed to connect socket %d", created);
+            close(fds[created]);
+            goto fail;
+        }
+    }
+
+    return 0;
+
+fail:
+    while (created-- > 0)
+        close(fds[created]);
+
+    return -1;
+}
+
+TARPC_FUNC_STATIC(zfts_sockets_bulk_create, {},
+{
+    PREPARE_ADDR(laddr, in->laddr, 0);
+    PREPARE_ADDR(raddr, in->raddr, 0);
+
+    if (in->count <= 0)
+    {
+        out->common._errno = TE_RC(TE_TA_UNIX, TE_EINVAL);
+        out->retval = -1;
+        return;
+    }
+
+    out->fds.fds_val = TE_ALLOC(in->count * sizeof(*out->fds.fds_val));
+
+    MAKE_CALL(out->retval = func_ptr(domain_rpc2h(in->domain),
+                                     socktype_rpc2h(in->type),
+                                     in->count, laddr, raddr,
+                                     out->fds.fds_val));
+
+    if (out->retval == 0)
+    {
+        out->fds.fds_len = in->count;
+    }
+    else
+    {
+        free(out->fds.fds_val);
+        out->fds.fds_val = NULL;
+    }
+})
+
+/**
+ * Accept a number of connections on a listening socket.
+ *
+ * @param fd          Listening socket.
+ * @param count       Number of connections to accept.
+ * @param timeout     How long to wait for connections, milliseconds.
+ * @param fds         Where to save accepted sockets.
+ * @param raddrs      Where to save addresses of peers.
+ *
+ * @return @c 0 on success, @c -1 on failure (in which case all the
+ *         accepted sockets are closed).
+ */
+int
+zfts_sockets_bulk_accept(int fd, int count, int timeout, int *fds,
+                         struct sockaddr_storage *raddrs)
+{
+    struct pollfd   pfd = { .fd = fd, .events = POLLIN };
+    socklen_t       raddrlen;
+    uint64_t        deadline;
+    uint64_t        now;
+    int             accepted = 0;
+    int             rc;
+
+    deadline = zfts_time_ns() + (uint64_t)timeout * 1000000ULL;
+    while (accepted < count)
+    {
+        now = zfts_time_ns();
+        if (now >= deadline)
+        {
+            te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_ETIMEDOUT),
+                             "only %d of %d connections were accepted",
+                             accepted, count);
+            goto fail;
+        }
+
+        rc = poll(&pfd, 1, (deadline - now) / 1000000ULL + 1);
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                             "poll() failed");
+            goto fail;
+        }
+        if (rc == 0)
+            continue;
+
+        raddrlen = sizeof(raddrs[accepted]);
+        fds[accepted] = accept(fd, SA(&raddrs[accepted]), &raddrlen);
+        if (fds[accepted] < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                             "accept() failed");
+            goto fail;
+        }
+        accepted++;
+    }
+
+    return 0;
+
+fail:
+    while (accepted-- > 0)
+        close(fds[accepted]);
+
+    return -1;
+}
+
+TARPC_FUNC_STATIC(zfts_sockets_bulk_accept, {},
+{
+    struct sockaddr_storage *raddrs;
+    int                      i;
+
+    if (in->count <= 0)
+    {
+        out->common._errno = TE_RC(TE_TA_UNIX, TE_EINVAL);
+        out->retval = -1;
+        return;
+    }
+
+    out->fds.fds_val = TE_ALLOC(in->count * sizeof(*out->fds.fds_val));
+    raddrs = TE_ALLOC(in->count * sizeof(*raddrs));
+
+    MAKE_CALL(out->retval = func_ptr(in->fd, in->count, in->timeout,
+                                     out->fds.fds_val, raddrs));
+
+    if (out->retval == 0)
+    {
+        out->fds.fds_len = in->count;
+        out->raddrs.raddrs_len = in->count;
+        out->raddrs.raddrs_val =
+            TE_ALLOC(in->count * sizeof(*out->raddrs.raddrs_val));
+        for (i = 0; i < in->count; i++)
+        {
+            sockaddr_output_h2rpc(SA(&raddrs[i]),
+                                  te_sockaddr_get_size(SA(&raddrs[i])),
+                                  te_sockaddr_get_size(SA(&raddrs[i])),
+                                  &out->raddrs.raddrs_val[i]);
+        }
+    }
+    else
+    {
+        free(out->fds.fds_val);
+        out->fds.fds_val = NULL;
+    }
+
+    free(raddrs);
+})
+
+/**
+ * Send a data chunk from every socket in a list.
+ *
+ * @param fds       Sockets.
+ * @param dsts      Destination addresses (@c NULL if a socket is
+ *                  connected).
+ * @param count     Number of sockets.
+ * @param len       Number of bytes to send from every socket.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+int
+zfts_sockets_bulk_send(int *fds, const struct sockaddr **dsts, int count,
+                       size_t len)
+{
+    uint8_t    *buf;
+    ssize_t     rc;
+    int         i;
+
+    buf = TE_ALLOC(MAX(len, 1));
+    te_fill_buf(buf, len);
+
+    for (i = 0; i < count; i++)
+    {
+        if (dsts[i] == NULL)
+        {
+            rc = send(fds[i], buf, len, 0);
+        }
+        else
+        {
+            rc = sendto(fds[i], buf, len, 0, dsts[i],
+                        te_sockaddr_get_size(dsts[i]));
+        }
+
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                             "failed to send data from socket %d",
+                             fds[i]);
+            free(buf);
+            return -1;
+        }
+        if ((size_t)rc != len)
+        {
+            te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EFAIL),
+                             "data was sent incompletely from "
+                             "socket %d", fds[i]);
+            free(buf);
+            return -1;
+        }
+    }
+
+    free(buf);
+    return 0;
+}
+
+TARPC_FUNC_STATIC(zfts_sockets_bulk_send, {},
+{
+    unsigned int             count = in->peers.peers_len;
+    int                     *fds;
+    struct sockaddr_storage *addrs;
+    const struct sockaddr  **dsts;
+    struct sockaddr         *dst;
+    socklen_t                dst_len;
+    unsigned int             i;
+    te_errno                 rc;
+
+    /* Thousands of peers may be passed, so do not use the stack. */
+    fds = TE_ALLOC(MAX(count, 1) * sizeof(*fds));
+    addrs = TE_ALLOC(MAX(count, 1) * sizeof(*addrs));
+    dsts = TE_ALLOC(MAX(count, 1) * sizeof(*dsts));
+
+    for (i = 0; i < count; i++)
+    {
+        fds[i] = in->peers.peers_val[i].fd;
+        rc = sockaddr_rpc2h(&in->peers.peers_val[i].dst, SA(&addrs[i]),
+                            sizeof(addrs[i]), &dst, &dst_len);
+        if (rc != 0)
+        {
+            free(fds);
+            free(addrs);
+            free(dsts);
+            out->common._errno = rc;
+            out->retval = -1;
+            return;
+        }
+        dsts[i] = dst;
+    }
+
+    MAKE_CALL(out->retval = func_ptr(fds, dsts, count, in->len));
+    free(fds);
+    free(addrs);
+    free(dsts);
+})
+
+/**
+ * Close a number of sockets. All the sockets are processed even if
+ * closing some of them fails.
+ *
+ * @param fds       Sockets.
+ * @param count     Number of sockets.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+int
+zfts_sockets_bulk_close(int *fds, int count)
+{
+    int result = 0;
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (close(fds[i]) < 0 && result == 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                             "failed to close socket %d", fds[i]);
+            result = -1;
+        }
+    }
+
+    return result;
+}
+
+TARPC_FUNC_STATIC(zfts_sockets_bulk_close, {},
+{
+    MAKE_CALL(out->retval = func_ptr(in->fds.fds_val,
+                                     in->fds.fds_len));
+})
+
+/**
+ * Perform actions on peer sockets which invoke events on zockets.
+ *
+ * @ref ZFTS_SOCK_EVENT_SEND sends @p data from a (connected) socket.
+ * @ref ZFTS_SOCK_EVENT_CONNECT switches a socket to non-blocking mode,
+ * starts connecting it to the address from request and saves its local
+ * address in the result. @ref ZFTS_SOCK_EVENT_DRAIN reads all the data
+ * available on a socket and saves it in the result.
+ *
+ * @param reqs      Requests.
+ * @param count     Number of requests.
+ * @param data      Data to send.
+ * @param len       Length of @p data.
+ * @param results   Where to save results (array of @p count elements).
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+int
+zfts_sockets_bulk_invoke(tarpc_zfts_sock_event_req *reqs, int count,
+                         const uint8_t *data, size_t len,
+                         tarpc_zfts_sock_event_res *results)
+{
+    struct sockaddr_storage addr;
+    socklen_t               addrlen;
+    te_dbuf                 buf = TE_DBUF_INIT(0);
+    uint8_t                 chunk[ZFTS_SOCKETS_BULK_CHUNK];
+    ssize_t                 rc;
+    int                     i;
+
+    for (i = 0; i < count; i++)
+    {
+        switch (reqs[i].event)
+        {
+            case ZFTS_SOCK_EVENT_SEND:
+                rc = send(reqs[i].fd, data, len, 0);
+                if (rc < 0 || (size_t)rc != len)
+                {
+                    te_rpc_error_set(rc < 0 ?
+                                        TE_OS_RC(TE_TA_UNIX, errno) :
+                                        TE_RC(TE_TA_UNIX, TE_EFAIL),
+                                     "failed to send data from "
+                                     "socket %d", reqs[i].fd);
+                    return -1;
+                }
+                break;
+
+            case ZFTS_SOCK_EVENT_CONNECT:
+            {
+                struct sockaddr *dst;
+                socklen_t        dst_len;
+
+                if (sockaddr_rpc2h(&reqs[i].addr, SA(&addr), sizeof(addr),
+                                   &dst, &dst_len) != 0)
+                {
+                    te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                                     "invalid address for socket %d",
+                                     reqs[i].fd);
+                    return -1;
+                }
+
+                fcntl(reqs[i].fd, F_SETFL,
+                      fcntl(reqs[i].fd, F_GETFL) | O_NONBLOCK);
+                if (connect(reqs[i].fd, dst, dst_len) < 0 &&
+                    errno != EINPROGRESS)
+                {
+                    te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                                     "failed to connect socket %d",
+                                     reqs[i].fd);
+                    return -1;
+                }
+
+                addrlen = sizeof(addr);
+                if (getsockname(reqs[i].fd, SA(&addr), &addrlen) < 0)
+                {
+                    te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                                     "getsockname() failed for "
+                                     "socket %d", reqs[i].fd);
+                    return -1;
+                }
+                sockaddr_output_h2rpc(SA(&addr), addrlen, addrlen,
+                                      &results[i].addr);
+                break;
+            }
+
+            case ZFTS_SOCK_EVENT_DRAIN:
+                while ((rc = recv(reqs[i].fd, chunk, sizeof(chunk),
+                                  MSG_DONTWAIT)) > 0)
+                {
+                    te_dbuf_append(&buf, chunk, rc);
+                }
+                if (rc < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+                {
+                    te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                                     "failed to read data from "
+                                     "socket %d", reqs[i].fd);
+                    te_dbuf_free(&buf);
+                    return -1;
+                }
+
+                results[i].data.data_len = buf.len;
+                results[i].data.data_val = buf.ptr;
+                buf = (te_dbuf)TE_DBUF_INIT(0);
+                break;
+
+            default:
+                te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                                 "unknown event %d", reqs[i].event);
+                return -1;
+        }
+    }
+
+    return 0;
+}
+
+TARPC_FUNC_STATIC(zfts_sockets_bulk_invoke, {},
+{
+    unsigned int count = in->reqs.reqs_len;
+
+    out->results.results_len = count;
+    out->results.results_val =
+        TE_ALLOC(MAX(count, 1) * sizeof(*out->results.results_val));
+
+    MAKE_CALL(out->retval = func_ptr(in->reqs.reqs_val, count,
+                                     in->data.data_val, in->data.data_len,
+                                     out->results.results_val));
+})
+
+/**
+ * Establish a number of TCP connections on a stack, processing the stack
+ * in a single loop until all of them are established or @p timeout
+ * expires.
+ *
+ * If @p zftl is @c NULL, zockets are opened actively: all of them are
+ * allocated, bound to @p laddr (if its port is not zero, in which case
+ * it is incremented for every next zocket) and start connecting to
+ * @p raddr before the stack is processed. Otherwise @p count connections
+ * are accepted on @p zftl.
+ *
+ * Time to ESTABLISHED state is measured from zft_connect() call for
+ * actively opened zockets and from the start of this call for accepted
+ * ones.
+ *
+ * @param stack       ZF stack.
+ * @param attr        ZF attributes.
+ * @param zftl        TCP listening zocket (may be @c NULL).
+ * @param count       Number of connections.
+ * @param laddr       Local address (for active open).
+ * @param raddr       Remote address (for active open).
+ * @param timeout     How long to wait for connections, milliseconds.
+ * @param zockets     Where to save zockets.
+ * @param laddrs      Where to save local addresses of zockets.
+ * @param raddrs      Where to save remote addresses of zockets.
+ * @param times       Where to save times to ESTABLISHED state,
+ *                    nanoseconds.
+ *
+ * @return @c 0 on success, @c -1 on failure (in which case all the
+ *         created zockets are released).
+ */
+int
+zfts_zft_bulk_establish(struct zf_stack *stack, struct zf_attr *attr,
+                        struct zftl *zftl, int count,
+                        const struct sockaddr *laddr,
+                        const struct sockaddr *raddr, int timeout,
+                        struct zft **zockets,
+                        struct sockaddr_storage *laddrs,
+                        struct sockaddr_storage *raddrs,
+                        uint64_t *times)
+{
+    bulk_zocket_funcs       funcs;
+    struct sockaddr_storage addr;
+    struct zft_handle      *handle;
+    socklen_t               laddrlen;
+    socklen_t               raddrlen;
+    uint64_t                start;
+    uint64_t                deadline;
+    uint64_t                now;
+    int                    *pending = NULL;
+    int                     pending_num = 0;
+    int                     established = 0;
+    int                     created = 0;
+    int                     state;
+    int                     rc;
+    int                     i;
+    int                     j;
+
+    if (bulk_zocket_funcs_resolve(&funcs) != 0)
+        return -1;
+
+    if (zftl == NULL && (laddr == NULL || raddr == NULL))
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "addresses are required for active open");
+        return -1;
+    }
+
+    start = zfts_time_ns();
+
+    if (zftl == NULL)
+    {
+        pending = TE_ALLOC(count * sizeof(*pending));
+
+        for (created = 0; created < count; created++)
+        {
+            rc = funcs.zft_alloc(stack, attr, &handle);
+            if (rc < 0)
+            {
+                te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                                 "zft_alloc() failed for connection %d",
+                                 created);
+                goto fail;
+            }
+
+            if (te_sockaddr_get_port(laddr) != 0)
+            {
+                bulk_zocket_addr(laddr, created, &addr);
+                rc = funcs.zft_addr_bind(handle, SA(&addr),
+                                         te_sockaddr_get_size(SA(&addr)),
+                                         0);
+            }
+            if (rc == 0)
+            {
+                times[created] = zfts_time_ns();
+                rc = funcs.zft_connect(handle, raddr,
+                                       te_sockaddr_get_size(raddr),
+                                       &zockets[created]);
+            }
+            if (rc < 0)
+            {
+                funcs.zft_handle_free(handle);
+                te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                                 "failed to start connection %d",
+                                 created);
+                goto fail;
+            }
+
+            pending[pending_num++] = created;
+        }
+    }
+
+    deadline = start + (uint64_t)timeout * 1000000ULL;
+    while (TRUE)
+    {
+        if (zftl != NULL)
+        {
+            while (created < count)
+            {
+                rc = funcs.zftl_accept(zftl, &zockets[created]);
+                if (rc == -EAGAIN)
+                    break;
+                if (rc < 0)
+                {
+                    te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                                     "zftl_accept() failed");
+                    goto fail;
+                }
+
+                times[created++] = zfts_time_ns() - start;
+                established++;
+            }
+        }
+        else
+        {
+            now = zfts_time_ns();
+            for (i = 0, j = 0; i < pending_num; i++)
+            {
+                state = funcs.zft_state(zockets[pending[i]]);
+                if (state == TCP_ESTABLISHED)
+                {
+                    times[pending[i]] = now - times[pending[i]];
+                    established++;
+                }
+                else if (state == TCP_CLOSE)
+                {
+                    te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_ECONNREFUSED),
+                                     "connection %d failed", pending[i]);
+                    goto fail;
+                }
+                else
+                {
+                    pending[j++] = pending[i];
+                }
+            }
+            pending_num = j;
+        }
+
+        if (established == count)
+            break;
+
+        if (zfts_time_ns() >= deadline)
+        {
+            te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_ETIMEDOUT),
+                             "only %d of %d connections were established",
+                             established, count);
+            goto fail;
+        }
+
+        rc = funcs.process_events(stack);
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_process_events() failed");
+            goto fail;
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        laddrlen = sizeof(laddrs[i]);
+        raddrlen = sizeof(raddrs[i]);
+        funcs.zft_getname(zockets[i], SA(&laddrs[i]), &laddrlen,
+                          SA(&raddrs[i]), &raddrlen);
+    }
+
+    free(pending);
+    return 0;
+
+fail:
+    while (created-- > 0)
+        funcs.zft_free(zockets[created]);
+
+    free(pending);
+    return -1;
+}
+
+TARPC_FUNC_STATIC(zfts_zft_bulk_establish, {},
+{
+    static rpc_ptr_id_namespace ns_stack = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_attr = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zftl = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zft = RPC_PTR_ID_NS_INVALID;
+
+    struct zf_stack         *stack = NULL;
+    struct zf_attr          *attr = NULL;
+    struct zftl             *zftl = NULL;
+    struct zft             **zockets;
+    struct sockaddr_storage *laddrs;
+    struct sockaddr_storage *raddrs;
+    int                      i;
+
+    PREPARE_ADDR(laddr, in->laddr, 0);
+    PREPARE_ADDR(raddr, in->raddr, 0);
+
+    if (in->count <= 0)
+    {
+        out->common._errno = TE_RC(TE_TA_UNIX, TE_EINVAL);
+        out->retval = -1;
+        return;
+    }
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_stack,
+                                           RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_attr,
+                                           RPC_TYPE_NS_ZF_ATTR,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zftl, RPC_TYPE_NS_ZFTL,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zft, RPC_TYPE_NS_ZFT,);
+
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns_stack,);
+    if (in->zftl != RPC_NULL)
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(zftl, in->zftl, ns_zftl,);
+    else
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(attr, in->attr, ns_attr,);
+
+    zockets = TE_ALLOC(in->count * sizeof(*zockets));
+    laddrs = TE_ALLOC(in->count * sizeof(*laddrs));
+    raddrs = TE_ALLOC(in->count * sizeof(*raddrs));
+    out->times.times_val = TE_ALLOC(in->count *
+                                    sizeof(*out->times.times_val));
+
+    MAKE_CALL(out->retval = func_ptr(stack, attr, zftl, in->count,
+                                     laddr, raddr, in->timeout,
+                                     zockets, laddrs, raddrs,
+                                     out->times.times_val));
+
+    if (out->retval == 0)
+    {
+        out->times.times_len = in->count;
+        out->zockets.zockets_len = in->count;
+        out->zockets.zockets_val =
+            TE_ALLOC(in->count * sizeof(*out->zockets.zockets_val));
+        out->laddrs.laddrs_len = in->count;
+        out->laddrs.laddrs_val =
+            TE_ALLOC(in->count * sizeof(*out->laddrs.laddrs_val));
+        out->raddrs.raddrs_len = in->count;
+        out->raddrs.raddrs_val =
+            TE_ALLOC(in->count * sizeof(*out->raddrs.raddrs_val));
+
+        for (i = 0; i < in->count; i++)
+        {
+            out->zockets.zockets_val[i] =
+                RCF_PCH_MEM_INDEX_ALLOC(zockets[i], ns_zft);
+            zfts_stack_zocket_add(stack, zockets[i]);
+            sockaddr_output_h2rpc(SA(&laddrs[i]),
+                                  te_sockaddr_get_size(SA(&laddrs[i])),
+                                  te_sockaddr_get_size(SA(&laddrs[i])),
+                                  &out->laddrs.laddrs_val[i]);
+            sockaddr_output_h2rpc(SA(&raddrs[i]),
+                                  te_sockaddr_get_size(SA(&raddrs[i])),
+                                  te_sockaddr_get_size(SA(&raddrs[i])),
+                                  &out->raddrs.raddrs_val[i]);
+        }
+    }
+    else
+    {
+        free(out->times.times_val);
+        out->times.times_val = NULL;
+    }
+
+    free(zockets);
+    free(laddrs);
+    free(raddrs);
+})
+
+/**
+ * Connect a number of stream sockets concurrently: all of them start
+ * non-blocking connect to @p raddr, after which they are polled until
+ * all the connections are established or @p timeout expires. Sockets
+ * are switched back to blocking mode after that.
+ *
+ * @param domain    Communication domain.
+ * @param count     Number of sockets.
+ * @param laddr     Local address (may be @c NULL); if its port is not
+ *                  zero, it is incremented for every next socket.
+ * @param raddr     Remote address.
+ * @param sndbuf    @c SO_SNDBUF value to set before connecting
+ *                  (ignored if negative).
+ * @param rcvbuf    @c SO_RCVBUF value to set before connecting
+ *                  (ignored if negative).
+ * @param timeout   How long to wait for connections, milliseconds.
+ * @param fds       Where to save sockets.
+ * @param laddrs    Where to save local addresses of sockets.
+ * @param times     Where to save times from connect() call to
+ *                  connection establishment, nanoseconds.
+ *
+ * @return @c 0 on success, @c -1 on failure (in which case all the
+ *         created sockets are closed).
+ */
+int
+zfts_sockets_bulk_connect(int domain, int count,
+                          const struct sockaddr *laddr,
+                          const struct sockaddr *raddr,
+                          int sndbuf, int rcvbuf, int timeout, int *fds,
+                          struct sockaddr_storage *laddrs, uint64_t *times)
+{
+    struct sockaddr_storage addr;
+    struct pollfd          *pfds;
+    int                    *pending;
+    int                     pending_num = 0;
+    socklen_t               len;
+    uint64_t                deadline;
+    uint64_t                now;
+    int                     created;
+    int                     err;
+    int                     rc;
+    int                     i;
+    int                     j;
+    int                     k;
+
+    if (raddr == NULL)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "remote address is required");
+        return -1;
+    }
+
+    pfds = TE_ALLOC(count * sizeof(*pfds));
+    pending = TE_ALLOC(count * sizeof(*pending));
+
+    for (created = 0; created < count; created++)
+    {
+        fds[created] = socket(domain, SOCK_STREAM, 0);
+        if (fds[created] < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                             "failed to create socket %d", created);
+            goto fail;
+        }
+
+        rc = 0;
+        if (sndbuf >= 0)
+        {
+            rc = setsockopt(fds[created], SOL_SOCKET, SO_SNDBUF,
+                            &sndbuf, sizeof(sndbuf));
+        }
+        if (rc == 0 && rcvbuf >= 0)
+        {
+            rc = setsockopt(fds[created], SOL_SOCKET, SO_RCVBUF,
+                            &rcvbuf, sizeof(rcvbuf));
+        }
+        if (rc == 0 && laddr != NULL)
+        {
+            bulk_zocket_addr(laddr, created, &addr);
+            rc = bind(fds[created], SA(&addr),
+                      te_sockaddr_get_size(SA(&addr)));
+        }
+        if (rc == 0)
+        {
+            fcntl(fds[created], F_SETFL,
+                  fcntl(fds[created], F_GETFL) | O_NONBLOCK);
+            times[created] = zfts_time_ns();
+            rc = connect(fds[created], raddr, te_sockaddr_get_size(raddr));
+            if (rc < 0 && errno == EINPROGRESS)
+                rc = 0;
+        }
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                             "failed to start connecting socket %d",
+                             created);
+            close(fds[created]);
+            goto fail;
+        }
+
+        pending[pending_num++] = created;
+    }
+
+    deadline = zfts_time_ns() + (uint64_t)timeout * 1000000ULL;
+    while (pending_num > 0)
+    {
+        now = zfts_time_ns();
+        if (now >= deadline)
+        {
+            te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_ETIMEDOUT),
+                             "%d of %d connections were not established",
+                             pending_num, count);
+            goto fail;
+        }
+
+        for (i = 0; i < pending_num; i++)
+        {
+            pfds[i].fd = fds[pending[i]];
+            pfds[i].events = POLLOUT;
+            pfds[i].revents = 0;
+        }
+
+        rc = poll(pfds, pending_num, (deadline - now) / 1000000ULL + 1);
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                             "poll() failed");
+            goto fail;
+        }
+
+        now = zfts_time_ns();
+        for (i = 0, j = 0; i < pending_num; i++)
+        {
+            k = pending[i];
+            if (pfds[i].revents == 0)
+            {
+                pending[j++] = k;
+                continue;
+            }
+
+            err = 0;
+            len = sizeof(err);
+            getsockopt(fds[k], SOL_SOCKET, SO_ERROR, &err, &len);
+            if (err != 0)
+            {
+                te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, err),
+                                 "failed to connect socket %d", k);
+                goto fail;
+            }
+
+            times[k] = now - times[k];
+            fcntl(fds[k], F_SETFL, fcntl(fds[k], F_GETFL) & ~O_NONBLOCK);
+        }
+        pending_num = j;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        len = sizeof(laddrs[i]);
+        getsockname(fds[i], SA(&laddrs[i]), &len);
+    }
+
+    free(pfds);
+    free(pending);
+    return 0;
+
+fail:
+    while (created-- > 0)
+        close(fds[created]);
+
+    free(pfds);
+    free(pending);
+    return -1;
+}
+
+TARPC_FUNC_STATIC(zfts_sockets_bulk_connect, {},
+{
+    struct sockaddr_storage *laddrs;
+    int                      i;
+
+    PREPARE_ADDR(laddr, in->laddr, 0);
+    PREPARE_ADDR(raddr, in->raddr, 0);
+
+    if (in->count <= 0)
+    {
+        out->common._errno = TE_RC(TE_TA_UNIX, TE_EINVAL);
+        out->retval = -1;
+        return;
+    }
+
+    out->fds.fds_val = TE_ALLOC(in->count * sizeof(*out->fds.fds_val));
+    out->times.times_val = TE_ALLOC(in->count *
+                                    sizeof(*out->times.times_val));
+    laddrs = TE_ALLOC(in->count * sizeof(*laddrs));
+
+    MAKE_CALL(out->retval = func_ptr(domain_rpc2h(in->domain), in->count,
+                                     laddr, raddr, in->sndbuf,
+                                     in->rcvbuf, in->timeout,
+                                     out->fds.fds_val, laddrs,
+                                     out->times.times_val));
+
+    if (out->retval == 0)
+    {
+        out->fds.fds_len = in->count;
+        out->times.times_len = in->count;
+        out->laddrs.laddrs_len = in->count;
+        out->laddrs.laddrs_val =
+            TE_ALLOC(in->count * sizeof(*out->laddrs.laddrs_val));
+        for (i = 0; i < in->count; i++)
+        {
+            sockaddr_output_h2rpc(SA(&laddrs[i]),
+                                  te_sockaddr_get_size(SA(&laddrs[i])),
+                                  te_sockaddr_get_size(SA(&laddrs[i])),
+                                  &out->laddrs.laddrs_val[i]);
+        }
+    }
+    else
+    {
+        free(out->fds.fds_val);
+        out->fds.fds_val = NULL;
+        free(out->times.times_val);
+        out->times.times_val = NULL;
+    }
+
+    free(laddrs);
+})
+
+/**
+ * Set @c TCP_NODELAY option and/or @c O_NONBLOCK flag for a number of
+ * sockets.
+ *
+ * @param fds       Sockets.
+ * @param count     Number of sockets.
+ * @param nodelay   Whether to enable @c TCP_NODELAY.
+ * @param nonblock  Whether to set @c O_NONBLOCK.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+int
+zfts_sockets_bulk_set_flags(int *fds, int count, te_bool nodelay,
+                            te_bool nonblock)
+{
+    int one = 1;
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (nodelay &&
+            setsockopt(fds[i], IPPROTO_TCP, TCP_NODELAY,
+                       &one, sizeof(one)) < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                             "failed to set TCP_NODELAY for socket %d",
+                             fds[i]);
+            return -1;
+        }
+
+        if (nonblock &&
+            fcntl(fds[i], F_SETFL,
+                  fcntl(fds[i], F_GETFL) | O_NONBLOCK) < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                             "failed to set O_NONBLOCK for socket %d",
+                             fds[i]);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+TARPC_FUNC_STATIC(zfts_sockets_bulk_set_flags, {},
+{
+    MAKE_CALL(out->retval = func_ptr(in->fds.fds_val, in->fds.fds_len,
+                                     in->nodelay, in->nonblock));
+})
@@ -90,8 +90,11 @@ TARPC_FUNC(zf_muxer_alloc, {},
     TE_RPC_CONVERT_NEGATIVE_ERR(out->retval);
 
     if (out->retval == 0)
+    {
         out->muxer_set = RCF_PCH_MEM_INDEX_ALLOC(muxer_set_out,
                                                  ns_muxer_set);
+        zfts_stack_muxer_add(stack, muxer_set_out);
+    }
 })
 
 TARPC_FUNC(zf_muxer_free, {},
@@ -107,6 +110,7 @@ TARPC_FUNC(zf_muxer_free, {},
     RCF_PCH_MEM_INDEX_TO_PTR_RPC(muxer_set, in->muxer_set, ns_muxer_set,);
 
     MAKE_CALL(func_ptr(muxer_set));
+    zfts_stack_muxer_del(muxer_set);
     RCF_PCH_MEM_INDEX_FREE(in->muxer_set, ns_muxer_set);
 })
 
@@ -354,3 +358,230 @@ TARPC_FUNC(zf_muxer_mod_rearm, {},
 
     MAKE_CALL(out->retval = func_ptr(waitable));
 })
+
+/**
+ * Apply zf_muxer_add(), zf_muxer_mod() or zf_muxer_del() to a list of
+ * waitables measuring how long it takes. When events are added or
+ * modified, index of a waitable in the list is used as event data.
+ *
+ * @param muxer_set     Muxer set (used only for ZFTS_MUXER_BULK_ADD).
+ * @param op            Operation to apply.
+ * @param waitables     Array of waitables.
+ * @param count         Number of elements in @p waitables.
+ * @param events        Events to wait for.
+ * @param duration      Where to save total time spent in calls, ns.
+ * @param max_duration  Where to save maximum duration of a single
+ *                      call, ns.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+int
+zf_muxer_bulk(struct zf_muxer_set *muxer_set, zfts_muxer_bulk_op op,
+              struct zf_waitable **waitables, unsigned int count,
+              uint32_t events, uint64_t *duration, uint64_t *max_duration)
+{
+    api_func_ptr        op_func;
+    const char         *op_name;
+    struct epoll_event  event;
+    uint64_t            start;
+    uint64_t            elapsed;
+    unsigned int        i;
+    int                 rc;
+
+    switch (op)
+    {
+        case ZFTS_MUXER_BULK_ADD:
+            op_name = "zf_muxer_add";
+            break;
+
+        case ZFTS_MUXER_BULK_MOD:
+            op_name = "zf_muxer_mod";
+            break;
+
+        case ZFTS_MUXER_BULK_DEL:
+            op_name = "zf_muxer_del";
+            break;
+
+        default:
+            te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                             "unknown muxer operation %d", op);
+            return -1;
+    }
+
+    TARPC_FIND_FUNC_RETURN(FALSE, op_name, (api_func *)&op_func);
+
+    *duration = 0;
+    *max_duration = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        event.events = events;
+        event.data.u32 = i;
+
+        start = zfts_time_ns();
+        if (op == ZFTS_MUXER_BULK_ADD)
+            rc = op_func(muxer_set, waitables[i], &event);
+        else if (op == ZFTS_MUXER_BULK_MOD)
+            rc = op_func(waitables[i], &event);
+        else
+            rc = op_func(waitables[i]);
+        elapsed = zfts_time_ns() - start;
+
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "%s() failed for waitable %u", op_name, i);
+            return -1;
+        }
+
+        *duration += elapsed;
+        if (elapsed > *max_duration)
+            *max_duration = elapsed;
+    }
+
+    return 0;
+}
+
+TARPC_FUNC_STATIC(zf_muxer_bulk, {},
+{
+    static rpc_ptr_id_namespace ns_muxer_set = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_waitable = RPC_PTR_ID_NS_INVALID;
+
+    struct zf_muxer_set  *muxer_set = NULL;
+    struct zf_waitable   *waitable;
+    struct zf_waitable  **waitables;
+    unsigned int          i;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_muxer_set,
+                                           RPC_TYPE_NS_ZF_MUXER_SET,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_waitable,
+                                           RPC_TYPE_NS_ZF_WAITABLE,);
+
+    if (in->op == ZFTS_MUXER_BULK_ADD)
+    {
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(muxer_set, in->muxer_set,
+                                     ns_muxer_set,);
+    }
+
+    /*
+     * Check pointers before allocating memory, otherwise it is leaked
+     * if some pointer is invalid.
+     */
+    for (i = 0; i < in->waitables.waitables_len; i++)
+    {
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(waitable,
+                                     in->waitables.waitables_val[i],
+                                     ns_waitable,);
+    }
+
+    /* Thousands of waitables may be passed, so do not use the stack. */
+    waitables = TE_ALLOC(MAX(in->waitables.waitables_len, 1) *
+                         sizeof(*waitables));
+    for (i = 0; i < in->waitables.waitables_len; i++)
+    {
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(waitables[i],
+                                     in->waitables.waitables_val[i],
+                                     ns_waitable,);
+    }
+
+    MAKE_CALL(out->retval = func_ptr(muxer_set, in->op, waitables,
+                                     in->waitables.waitables_len,
+                                     zf_epoll_event_rpc2h(in->events),
+                                     &out->duration,
+                                     &out->max_duration));
+    free(waitables);
+})
+
+/** Maximum number of events retrieved by zf_muxer_wait_bench() at once */
+#define ZF_MUXER_WAIT_BENCH_MAXEVENTS 4096
+
+/**
+ * Call zf_muxer_wait() with zero timeout in a loop until the expected
+ * number of events is retrieved or time is out, gathering statistics
+ * about duration of the calls and number of events returned by them.
+ *
+ * @param muxer_set     Muxer set.
+ * @param maxevents     Value of @a maxevents passed to zf_muxer_wait().
+ * @param exp_events    Stop after retrieving this number of events.
+ * @param duration      How long to call zf_muxer_wait(), milliseconds.
+ * @param stats         Where to save statistics.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+int
+zf_muxer_wait_bench(struct zf_muxer_set *muxer_set, int maxevents,
+                    int exp_events, int duration,
+                    tarpc_zf_muxer_wait_stats *stats)
+{
+    api_func_ptr        muxer_wait_func;
+    struct epoll_event *events;
+    uint64_t            deadline;
+    uint64_t            start;
+    uint64_t            elapsed;
+    int                 rc;
+
+    if (maxevents <= 0 || maxevents > ZF_MUXER_WAIT_BENCH_MAXEVENTS)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "maxevents should be in range [1, %d]",
+                         ZF_MUXER_WAIT_BENCH_MAXEVENTS);
+        return -1;
+    }
+
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_muxer_wait",
+                           (api_func *)&muxer_wait_func);
+
+    events = TE_ALLOC(sizeof(*events) * maxevents);
+    memset(stats, 0, sizeof(*stats));
+
+    deadline = zfts_time_ns() + (uint64_t)duration * 1000000ULL;
+    do {
+        start = zfts_time_ns();
+        rc = muxer_wait_func(muxer_set, events, maxevents, 0);
+        elapsed = zfts_time_ns() - start;
+
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_muxer_wait() failed");
+            free(events);
+            return -1;
+        }
+
+        stats->calls++;
+        stats->duration += elapsed;
+        if (elapsed > stats->max_duration)
+            stats->max_duration = elapsed;
+
+        if (rc > 0)
+        {
+            stats->calls_with_events++;
+            stats->events += rc;
+            stats->events_duration += elapsed;
+            if ((uint64_t)rc > stats->max_events)
+                stats->max_events = rc;
+        }
+    } while (stats->events < (uint64_t)exp_events &&
+             start + elapsed < deadline);
+
+    free(events);
+    return 0;
+}
+
+TARPC_FUNC_STATIC(zf_muxer_wait_bench, {},
+{
+    static rpc_ptr_id_namespace ns_muxer_set = RPC_PTR_ID_NS_INVALID;
+
+    struct zf_muxer_set *muxer_set = NULL;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_muxer_set,
+                                           RPC_TYPE_NS_ZF_MUXER_SET,);
+
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(muxer_set, in->muxer_set, ns_muxer_set,);
+
+    MAKE_CALL(out->retval = func_ptr(muxer_set, in->maxevents,
+                                     in->exp_events, in->duration,
+                                     &out->stats));
+})
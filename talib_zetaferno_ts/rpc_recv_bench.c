@@ -0,0 +1,580 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/**
+ * @brief Receive benchmarks RPC routines implementation
+ *
+ * Agent-side loops draining zockets to measure cost of receive calls.
+ *
+ * $Id$
+ */
+
+#define TE_LGR_USER     "SFC Zetaferno RPC Recv Bench"
+#include "te_config.h"
+#include "config.h"
+
+#include "logger_ta_lock.h"
+#include "rpc_server.h"
+
+#include "zf_talib_namespace.h"
+#include "te_alloc.h"
+#include "zf_rpc.h"
+
+#include <zf/zf.h>
+#include <zf/zf_tcp.h>
+#include <zf/zf_udp.h>
+
+/** Size of every user buffer when data is copied, bytes */
+#define RECV_BENCH_BUF_SIZE 2048
+
+/** Maximum number of buffers passed to a receive call */
+#define RECV_BENCH_MAX_IOVCNT 64
+
+/** TCP message with vectors for zft_zc_recv() */
+typedef struct recv_bench_zft_msg {
+    struct zft_msg  msg;                            /**< Message */
+    struct iovec    iov[RECV_BENCH_MAX_IOVCNT];     /**< Vectors */
+} recv_bench_zft_msg;
+
+/** UDP message with vectors for zfur_zc_recv() */
+typedef struct recv_bench_zfur_msg {
+    struct zfur_msg msg;                            /**< Message */
+    struct iovec    iov[RECV_BENCH_MAX_IOVCNT];     /**< Vectors */
+} recv_bench_zfur_msg;
+
+/**
+ * Receive everything available on a zocket once.
+ *
+ * @param zocket      TCP or UDP RX zocket.
+ * @param udp         Whether @p zocket is zfur.
+ * @param copy        Whether data should be copied to @p bufs.
+ * @param iovcnt      Number of vectors to pass to a receive call.
+ * @param bufs        User buffers (if @p copy is @c TRUE).
+ * @param recv_f      zft_zc_recv(), zfur_zc_recv() or zft_recv().
+ * @param done_f      zft_zc_recv_done() or zfur_zc_recv_done().
+ * @param stats       Statistics to update; times are in TSC ticks here.
+ *
+ * @return @c 1 if the peer closed connection, @c 0 on success,
+ *         @c -1 on failure.
+ */
+static int
+recv_bench_drain(void *zocket, te_bool udp, te_bool copy, int iovcnt,
+                 struct iovec *bufs, api_func_ptr recv_f,
+                 api_func_ptr done_f, tarpc_zfts_recv_bench_stats *stats)
+{
+    recv_bench_zft_msg  tmsg;
+    recv_bench_zfur_msg umsg;
+    struct iovec       *iov;
+    int                 cnt;
+    uint64_t            tsc;
+    uint64_t            len;
+    int                 rc;
+    int                 i;
+
+    while (TRUE)
+    {
+        tsc = zfts_tsc();
+        if (!udp && copy)
+        {
+            rc = recv_f(zocket, bufs, iovcnt, 0);
+            stats->recv_calls++;
+            stats->recv_ns += zfts_tsc() - tsc;
+            if (rc == -EAGAIN)
+            {
+                stats->empty_calls++;
+                return 0;
+            }
+            else if (rc == 0)
+            {
+                return 1;
+            }
+            else if (rc < 0)
+            {
+                te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                                 "zft_recv() failed");
+                return -1;
+            }
+
+            stats->bytes += rc;
+            stats->bufs += (rc + RECV_BENCH_BUF_SIZE - 1) /
+                           RECV_BENCH_BUF_SIZE;
+            continue;
+        }
+
+        if (udp)
+        {
+            umsg.msg.iovcnt = iovcnt;
+            recv_f(zocket, &umsg.msg, 0);
+            cnt = umsg.msg.iovcnt;
+            iov = umsg.iov;
+        }
+        else
+        {
+            tmsg.msg.iovcnt = iovcnt;
+            recv_f(zocket, &tmsg.msg, 0);
+            cnt = tmsg.msg.iovcnt;
+            iov = tmsg.iov;
+        }
+
+        for (i = 0, len = 0; i < cnt; i++)
+        {
+            if (copy)
+            {
+                memcpy(bufs[i].iov_base, iov[i].iov_base,
+                       MIN(iov[i].iov_len, RECV_BENCH_BUF_SIZE));
+            }
+            len += iov[i].iov_len;
+        }
+        stats->recv_calls++;
+        stats->recv_ns += zfts_tsc() - tsc;
+
+        if (cnt == 0)
+        {
+            stats->empty_calls++;
+            return 0;
+        }
+        stats->bytes += len;
+        stats->bufs += cnt;
+
+        tsc = zfts_tsc();
+        if (udp)
+        {
+            done_f(zocket, &umsg.msg);
+            rc = 1;
+        }
+        else
+        {
+            rc = done_f(zocket, &tmsg.msg);
+        }
+        stats->done_calls++;
+        stats->done_ns += zfts_tsc() - tsc;
+
+        if (rc == 0)
+        {
+            return 1;
+        }
+        else if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zft_zc_recv_done() failed");
+            return -1;
+        }
+    }
+}
+
+/**
+ * Drain a zocket which is being flooded by peer for a given time,
+ * calling zf_reactor_perform() and then receiving all the available
+ * data with zero-copy or copying calls.
+ *
+ * @param stack       ZF stack.
+ * @param zocket      TCP or UDP RX zocket.
+ * @param udp         Whether @p zocket is zfur.
+ * @param copy        If @c TRUE, use zft_recv() for TCP zocket and copy
+ *                    data received with zfur_zc_recv() to user buffers
+ *                    for UDP zocket.
+ * @param iovcnt      Number of vectors to pass to a receive call.
+ * @param duration    How long to receive, milliseconds.
+ * @param stats       Where to save statistics.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_recv_bench(struct zf_stack *stack, void *zocket, te_bool udp,
+                te_bool copy, int iovcnt, int duration,
+                tarpc_zfts_recv_bench_stats *stats)
+{
+    zfts_reactor_ctx reactor_ctx = ZFTS_REACTOR_CTX_INIT;
+    api_func_ptr    recv_f;
+    api_func_ptr    done_f = NULL;
+    struct iovec    bufs[RECV_BENCH_MAX_IOVCNT];
+    char           *mem = NULL;
+    uint64_t        start;
+    uint64_t        start_tsc;
+    uint64_t        deadline;
+    uint64_t        tsc;
+    int             rc = 0;
+    int             i;
+
+    if (iovcnt <= 0 || iovcnt > RECV_BENCH_MAX_IOVCNT)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "iovcnt must be in range [1, %d]",
+                         RECV_BENCH_MAX_IOVCNT);
+        return -1;
+    }
+
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_reactor_perform",
+                           (api_func *)&reactor_ctx.reactor_func);
+    if (udp)
+    {
+        TARPC_FIND_FUNC_RETURN(FALSE, "zfur_zc_recv", (api_func *)&recv_f);
+        TARPC_FIND_FUNC_RETURN(FALSE, "zfur_zc_recv_done",
+                               (api_func *)&done_f);
+    }
+    else if (copy)
+    {
+        TARPC_FIND_FUNC_RETURN(FALSE, "zft_recv", (api_func *)&recv_f);
+    }
+    else
+    {
+        TARPC_FIND_FUNC_RETURN(FALSE, "zft_zc_recv", (api_func *)&recv_f);
+        TARPC_FIND_FUNC_RETURN(FALSE, "zft_zc_recv_done",
+                               (api_func *)&done_f);
+    }
+
+    if (copy)
+    {
+        mem = TE_ALLOC(iovcnt * RECV_BENCH_BUF_SIZE);
+        for (i = 0; i < iovcnt; i++)
+        {
+            bufs[i].iov_base = mem + i * RECV_BENCH_BUF_SIZE;
+            bufs[i].iov_len = RECV_BENCH_BUF_SIZE;
+        }
+    }
+
+    memset(stats, 0, sizeof(*stats));
+
+    start = zfts_time_ns();
+    start_tsc = zfts_tsc();
+    deadline = start + (uint64_t)duration * 1000000ULL;
+    while (zfts_time_ns() < deadline)
+    {
+        tsc = zfts_tsc();
+        rc = zfts_call_zf_reactor_perform(stack, &reactor_ctx);
+        stats->reactor_ns += zfts_tsc() - tsc;
+        stats->reactor_calls++;
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_reactor_perform() failed");
+            break;
+        }
+        else if (rc > 0)
+        {
+            stats->reactor_events++;
+        }
+
+        rc = recv_bench_drain(zocket, udp, copy, iovcnt, bufs, recv_f,
+                              done_f, stats);
+        if (rc != 0)
+            break;
+    }
+    stats->elapsed = zfts_time_ns() - start;
+
+    tsc = zfts_tsc() - start_tsc;
+    stats->reactor_ns = zfts_tsc2ns(stats->reactor_ns, stats->elapsed, tsc);
+    stats->recv_ns = zfts_tsc2ns(stats->recv_ns, stats->elapsed, tsc);
+    stats->done_ns = zfts_tsc2ns(stats->done_ns, stats->elapsed, tsc);
+
+    free(mem);
+    return rc < 0 ? -1 : 0;
+}
+
+TARPC_FUNC_STATIC(zfts_recv_bench, {},
+{
+    static rpc_ptr_id_namespace ns_stack = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zft = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zfur = RPC_PTR_ID_NS_INVALID;
+
+    struct zf_stack *stack = NULL;
+    struct zft      *zft = NULL;
+    struct zfur     *zfur = NULL;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_stack,
+                                           RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zft, RPC_TYPE_NS_ZFT,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zfur, RPC_TYPE_NS_ZFUR,);
+
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns_stack,);
+    if (in->udp)
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(zfur, in->zocket, ns_zfur,);
+    else
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(zft, in->zocket, ns_zft,);
+
+    MAKE_CALL(out->retval = func_ptr(stack,
+                                     in->udp ? (void *)zfur : (void *)zft,
+                                     in->udp, in->copy, in->iovcnt,
+                                     in->duration, &out->stats));
+})
+
+/**
+ * Receive data available on a TCP zocket with zft_zc_recv() and
+ * zft_zc_recv_done().
+ *
+ * @param zocket        TCP zocket.
+ * @param recv_f        zft_zc_recv().
+ * @param done_f        zft_zc_recv_done().
+ * @param max_bufs      Maximum number of buffers to receive
+ *                      (@c 0 - receive everything available).
+ * @param bytes         Where to add number of received bytes.
+ * @param bufs          Where to add number of received buffers.
+ * @param pkts_left     Where to save number of packets left in
+ *                      the receive queue.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+rx_exhaust_drain(struct zft *zocket, api_func_ptr recv_f,
+                 api_func_ptr done_f, int max_bufs, uint64_t *bytes,
+                 uint64_t *bufs, int *pkts_left)
+{
+    recv_bench_zft_msg  tmsg;
+    int                 left = max_bufs;
+    int                 rc;
+    int                 i;
+
+    *pkts_left = 0;
+    while (max_bufs == 0 || left > 0)
+    {
+        tmsg.msg.iovcnt = (max_bufs == 0 ?
+                              RECV_BENCH_MAX_IOVCNT :
+                              MIN(left, RECV_BENCH_MAX_IOVCNT));
+        recv_f(zocket, &tmsg.msg, 0);
+        if (tmsg.msg.iovcnt == 0)
+            return 0;
+
+        for (i = 0; i < tmsg.msg.iovcnt; i++)
+            *bytes += tmsg.iov[i].iov_len;
+        *bufs += tmsg.msg.iovcnt;
+        left -= tmsg.msg.iovcnt;
+        *pkts_left = tmsg.msg.pkts_left;
+
+        rc = done_f(zocket, &tmsg.msg);
+        if (rc <= 0)
+        {
+            te_rpc_error_set(rc == 0 ? TE_RC(TE_TA_UNIX, TE_ECONNRESET) :
+                                       TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zft_zc_recv_done() failed or peer closed "
+                             "connection");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Measure recovery of TCP zockets sharing a stack after receive
+ * buffers are exhausted on one of them.
+ *
+ * All zockets are drained in a loop with zft_zc_recv() and
+ * zft_zc_recv_done(). After @p baseline milliseconds the first zocket
+ * (victim) gets data with zft_zc_recv() which is not completed and is
+ * not read anymore, so that its receive queue holds stack buffers.
+ * After @p hold milliseconds the held buffers are released with
+ * zft_zc_recv_done() and the backlog of the victim is read either at
+ * once or by @p release_bufs buffers every @p release_interval
+ * microseconds, until its receive queue is empty. Then the loop
+ * continues for @p recovery milliseconds.
+ *
+ * Received bytes are accumulated per zocket in time buckets of
+ * @p bucket milliseconds: @p series[i * num + j] is the number of bytes
+ * received on zocket @c j in bucket @c i.
+ *
+ * @param stack             ZF stack.
+ * @param zockets           TCP zockets, the first one is the victim.
+ * @param num               Number of zockets.
+ * @param baseline          Time before exhaustion, milliseconds.
+ * @param hold              How long to hold buffers, milliseconds.
+ * @param release_bufs      How many buffers of the backlog to read at
+ *                          once (@c 0 - read everything at once).
+ * @param release_interval  Interval between backlog reads,
+ *                          microseconds.
+ * @param recovery          Time after releasing buffers, milliseconds.
+ * @param bucket            Bucket width, milliseconds.
+ * @param series            Where to save bytes received per bucket.
+ * @param buckets           Number of buckets in @p series.
+ * @param stats             Where to save statistics.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_rx_exhaust_bench(struct zf_stack *stack, struct zft **zockets,
+                      unsigned int num, int baseline, int hold,
+                      int release_bufs, int release_interval,
+                      int recovery, int bucket, uint64_t *series,
+                      unsigned int buckets,
+                      tarpc_zfts_rx_exhaust_stats *stats)
+{
+    enum {
+        PHASE_BASELINE,
+        PHASE_HOLD,
+        PHASE_RELEASE,
+        PHASE_RECOVERY,
+    } phase = PHASE_BASELINE;
+
+    zfts_reactor_ctx    reactor_ctx = ZFTS_REACTOR_CTX_INIT;
+    api_func_ptr        recv_f;
+    api_func_ptr        done_f;
+    recv_bench_zft_msg  held;
+    uint64_t            start;
+    uint64_t            now;
+    uint64_t            hold_start;
+    uint64_t            release_start;
+    uint64_t            end;
+    uint64_t            next_release = 0;
+    uint64_t            bytes;
+    uint64_t            bufs;
+    unsigned int        idx;
+    unsigned int        i;
+    int                 pkts_left;
+    int                 max_bufs;
+    int                 rc = 0;
+
+    if (num == 0 || bucket <= 0 || release_bufs < 0 ||
+        release_interval < 0)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "invalid arguments");
+        return -1;
+    }
+
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_reactor_perform",
+                           (api_func *)&reactor_ctx.reactor_func);
+    TARPC_FIND_FUNC_RETURN(FALSE, "zft_zc_recv", (api_func *)&recv_f);
+    TARPC_FIND_FUNC_RETURN(FALSE, "zft_zc_recv_done",
+                           (api_func *)&done_f);
+
+    memset(stats, 0, sizeof(*stats));
+    held.msg.iovcnt = 0;
+
+    start = zfts_time_ns();
+    hold_start = start + (uint64_t)baseline * 1000000ULL;
+    release_start = hold_start + (uint64_t)hold * 1000000ULL;
+    end = release_start + (uint64_t)recovery * 1000000ULL;
+    for (now = start; now < end; now = zfts_time_ns())
+    {
+        if (phase == PHASE_BASELINE && now >= hold_start)
+        {
+            held.msg.iovcnt = RECV_BENCH_MAX_IOVCNT;
+            recv_f(zockets[0], &held.msg, 0);
+            stats->held_bufs = held.msg.iovcnt;
+            phase = PHASE_HOLD;
+        }
+        else if (phase == PHASE_HOLD && now >= release_start)
+        {
+            if (held.msg.iovcnt > 0)
+            {
+                rc = done_f(zockets[0], &held.msg);
+                if (rc <= 0)
+                {
+                    te_rpc_error_set(rc == 0 ?
+                                        TE_RC(TE_TA_UNIX, TE_ECONNRESET) :
+                                        TE_OS_RC(TE_TA_UNIX, -rc),
+                                     "zft_zc_recv_done() failed on held "
+                                     "buffers");
+                    rc = -1;
+                    break;
+                }
+                rc = 0;
+            }
+            phase = PHASE_RELEASE;
+            next_release = now;
+        }
+
+        rc = zfts_call_zf_reactor_perform(stack, &reactor_ctx);
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_reactor_perform() failed");
+            break;
+        }
+        rc = 0;
+
+        idx = MIN((now - start) / (bucket * 1000000ULL), buckets - 1);
+        for (i = 0; i < num; i++)
+        {
+            max_bufs = 0;
+            if (i == 0 && phase == PHASE_HOLD)
+                continue;
+            if (i == 0 && phase == PHASE_RELEASE && release_bufs > 0)
+            {
+                if (now < next_release)
+                    continue;
+                next_release = now + release_interval * 1000ULL;
+                max_bufs = release_bufs;
+            }
+
+            bytes = 0;
+            bufs = 0;
+            rc = rx_exhaust_drain(zockets[i], recv_f, done_f, max_bufs,
+                                  &bytes, &bufs, &pkts_left);
+            if (rc < 0)
+                goto out;
+            series[idx * num + i] += bytes;
+
+            if (i == 0 && phase == PHASE_RELEASE)
+            {
+                stats->backlog_bufs += bufs;
+                if (pkts_left == 0 &&
+                    (max_bufs == 0 || bufs < (uint64_t)max_bufs))
+                {
+                    stats->released = TRUE;
+                    stats->release_ns = now - release_start;
+                    phase = PHASE_RECOVERY;
+                }
+            }
+        }
+    }
+
+out:
+    stats->elapsed = zfts_time_ns() - start;
+    if (phase == PHASE_HOLD && held.msg.iovcnt > 0)
+        done_f(zockets[0], &held.msg);
+    return rc < 0 ? -1 : 0;
+}
+
+TARPC_FUNC_STATIC(zfts_rx_exhaust_bench, {},
+{
+    static rpc_ptr_id_namespace ns_stack = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zft = RPC_PTR_ID_NS_INVALID;
+
+    struct zf_stack  *stack = NULL;
+    struct zft       *zocket;
+    struct zft      **zockets;
+    unsigned int      buckets;
+    unsigned int     i;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_stack,
+                                           RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zft, RPC_TYPE_NS_ZFT,);
+
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns_stack,);
+
+    /*
+     * Check pointers before allocating memory, otherwise it is leaked
+     * if some pointer is invalid.
+     */
+    for (i = 0; i < in->zockets.zockets_len; i++)
+    {
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(zocket, in->zockets.zockets_val[i],
+                                     ns_zft,);
+    }
+
+    /* Thousands of zockets may be passed, so do not use the stack. */
+    zockets = TE_ALLOC(MAX(in->zockets.zockets_len, 1) *
+                       sizeof(*zockets));
+    for (i = 0; i < in->zockets.zockets_len; i++)
+    {
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(zockets[i],
+                                     in->zockets.zockets_val[i],
+                                     ns_zft,);
+    }
+
+    buckets = (in->bucket <= 0 ? 1 :
+                  (in->baseline + in->hold + in->recovery) / in->bucket + 1);
+    out->series.series_len = buckets * in->zockets.zockets_len;
+    out->series.series_val = TE_ALLOC(MAX(out->series.series_len, 1) *
+                                      sizeof(*out->series.series_val));
+
+    MAKE_CALL(out->retval = func_ptr(stack, zockets,
+                                     in->zockets.zockets_len,
+                                     in->baseline, in->hold,
+                                     in->release_bufs,
+                                     in->release_interval, in->recovery,
+                                     in->bucket, out->series.series_val,
+                                     buckets, &out->stats));
+    free(zockets);
+})
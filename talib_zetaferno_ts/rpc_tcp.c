@@ -73,6 +73,8 @@ TARPC_FUNC(zftl_listen, {},
                                      attr, &tl_out));
     out->tl = RCF_PCH_MEM_INDEX_ALLOC(tl_out, ns_zftl);
     TE_RPC_CONVERT_NEGATIVE_ERR(out->retval);
+    if (out->retval == 0)
+        zfts_stack_zocket_add(stack, tl_out);
 })
 
 TARPC_FUNC(zftl_getname,
@@ -119,6 +121,8 @@ TARPC_FUNC(zftl_accept, {},
     MAKE_CALL(out->retval = func_ptr(tl, &ts_out));
     out->ts = RCF_PCH_MEM_INDEX_ALLOC(ts_out, ns_zft);
     TE_RPC_CONVERT_NEGATIVE_ERR(out->retval);
+    if (out->retval == 0)
+        zfts_stack_zocket_add_sibling(tl, ts_out);
 })
 
 TARPC_FUNC(zftl_to_waitable, {},
@@ -155,7 +159,10 @@ TARPC_FUNC(zftl_free, {},
     MAKE_CALL(out->retval = func_ptr(tl));
     TE_RPC_CONVERT_NEGATIVE_ERR(out->retval);
     if (out->retval == 0)
+    {
+        zfts_stack_zocket_del(tl);
         RCF_PCH_MEM_INDEX_FREE(in->tl, ns_zftl);
+    }
 })
 
 TARPC_FUNC(zft_to_waitable, {},
@@ -203,6 +210,8 @@ TARPC_FUNC(zft_alloc, {},
     MAKE_CALL(out->retval = func_ptr(stack, attr, &handle_out));
     TE_RPC_CONVERT_NEGATIVE_ERR(out->retval);
     out->handle = RCF_PCH_MEM_INDEX_ALLOC(handle_out, ns_zft_handle);
+    if (out->retval == 0)
+        zfts_stack_zocket_add(stack, handle_out);
 })
 
 TARPC_FUNC(zft_addr_bind, {},
@@ -248,6 +257,8 @@ TARPC_FUNC(zft_connect, {},
     {
         out->ts = RCF_PCH_MEM_INDEX_ALLOC(ts_out, ns_zft);
         RCF_PCH_MEM_INDEX_FREE(in->handle, ns_zft_handle);
+        zfts_stack_zocket_add_sibling(handle, ts_out);
+        zfts_stack_zocket_del(handle);
     }
 })
 
@@ -281,7 +292,10 @@ TARPC_FUNC(zft_handle_free, {},
     MAKE_CALL(out->retval = func_ptr(handle));
     TE_RPC_CONVERT_NEGATIVE_ERR(out->retval);
     if (out->retval == 0)
+    {
+        zfts_stack_zocket_del(handle);
         RCF_PCH_MEM_INDEX_FREE(in->handle, ns_zft_handle);
+    }
 })
 
 TARPC_FUNC(zft_free, {},
@@ -295,10 +309,14 @@ TARPC_FUNC(zft_free, {},
 
     RCF_PCH_MEM_INDEX_TO_PTR_RPC(ts, in->ts, ns_zft,);
 
+    zfts_tx_ts_collectors_forget(NULL, ts);
     MAKE_CALL(out->retval = func_ptr(ts));
     TE_RPC_CONVERT_NEGATIVE_ERR(out->retval);
     if (out->retval == 0)
+    {
+        zfts_stack_zocket_del(ts);
         RCF_PCH_MEM_INDEX_FREE(in->ts, ns_zft);
+    }
 })
 
 TARPC_FUNC(zft_state, {},
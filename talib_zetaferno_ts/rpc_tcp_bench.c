@@ -0,0 +1,1197 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/**
+ * @brief TCP benchmarks RPC routines implementation
+ *
+ * Agent-side loops used by TCP performance tests, so that measured
+ * operations are not interleaved with RPC calls.
+ *
+ * $Id$
+ */
+
+#define TE_LGR_USER     "SFC Zetaferno RPC TCP Bench"
+#include "te_config.h"
+#include "config.h"
+
+#include "logger_ta_lock.h"
+#include "rpc_server.h"
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include <fcntl.h>
+#include <poll.h>
+#include <netinet/tcp.h>
+
+#include "te_sockaddr.h"
+#include "zf_talib_namespace.h"
+#include "te_alloc.h"
+#include "zf_rpc.h"
+
+#include <zf/zf.h>
+#include <zf/zf_tcp.h>
+
+/**
+ * How long Tester keeps serving connections after the requested
+ * duration expires, so that IUT can finish its loop, milliseconds.
+ */
+#define TCP_CHURN_GRACE 500
+
+/** Size of buffer used to read data in benchmark loops */
+#define TCP_BENCH_BUF_SIZE 1024
+
+/** ZF functions used by TCP benchmarks. */
+typedef struct tcp_bench_funcs {
+    api_func_ptr    zftl_accept;        /**< zftl_accept() */
+    api_func_ptr    zft_alloc;          /**< zft_alloc() */
+    api_func_ptr    zft_connect;        /**< zft_connect() */
+    api_func_ptr    zft_handle_free;    /**< zft_handle_free() */
+    api_func_ptr    zft_shutdown_tx;    /**< zft_shutdown_tx() */
+    api_func_ptr    zft_free;           /**< zft_free() */
+    api_func_ptr    zft_state;          /**< zft_state() */
+    api_func_ptr    process_events;     /**< zf_process_events() */
+} tcp_bench_funcs;
+
+/**
+ * Resolve ZF functions used by TCP benchmarks.
+ *
+ * @param funcs     Where to save function pointers.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+tcp_bench_funcs_resolve(tcp_bench_funcs *funcs)
+{
+#define BENCH_FIND_FUNC(name_) \
+    TARPC_FIND_FUNC_RETURN(FALSE, #name_, (api_func *)&funcs->name_)
+
+    BENCH_FIND_FUNC(zftl_accept);
+    BENCH_FIND_FUNC(zft_alloc);
+    BENCH_FIND_FUNC(zft_connect);
+    BENCH_FIND_FUNC(zft_handle_free);
+    BENCH_FIND_FUNC(zft_shutdown_tx);
+    BENCH_FIND_FUNC(zft_free);
+    BENCH_FIND_FUNC(zft_state);
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_process_events",
+                           (api_func *)&funcs->process_events);
+
+#undef BENCH_FIND_FUNC
+    return 0;
+}
+
+/**
+ * Save a sample of connection setup time if there is space for it.
+ *
+ * @param times       Array of samples.
+ * @param max_num     Capacity of the array.
+ * @param num         Number of samples in the array (updated).
+ * @param value       Setup time, ns.
+ */
+static void
+tcp_bench_add_time(uint64_t *times, unsigned int max_num,
+                   unsigned int *num, uint64_t value)
+{
+    if (*num < max_num)
+        times[(*num)++] = value;
+}
+
+/**
+ * Close a zocket with zft_shutdown_tx() and zft_free() accounting time
+ * spent in these calls.
+ *
+ * @param funcs     ZF functions.
+ * @param zocket    TCP zocket.
+ * @param stats     Statistics to update.
+ */
+static void
+tcp_churn_close_zocket(tcp_bench_funcs *funcs, struct zft *zocket,
+                       tarpc_zfts_tcp_churn_stats *stats)
+{
+    uint64_t start = zfts_time_ns();
+
+    funcs->zft_shutdown_tx(zocket);
+    funcs->zft_free(zocket);
+
+    stats->teardown_ns += zfts_time_ns() - start;
+    stats->closed++;
+}
+
+/**
+ * Open and close TCP connections on IUT in a loop for a given time.
+ *
+ * If @p zftl is @c NULL, up to @p concurrency connections to @p raddr
+ * are opened actively at the same time; otherwise connections are
+ * accepted on @p zftl. Every connection is closed with zft_shutdown_tx()
+ * and zft_free() as soon as it is established (so IUT closes it first).
+ * Failure to allocate a zocket (for instance because all endpoints are
+ * occupied by connections which are still closing) is not an error,
+ * it is counted and the stack is processed before trying again.
+ *
+ * @param stack         ZF stack.
+ * @param attr          ZF attributes.
+ * @param zftl          TCP listening zocket (may be @c NULL).
+ * @param raddr         Address to connect to (for active open).
+ * @param duration      How long to run, milliseconds.
+ * @param concurrency   Maximum number of connections being opened
+ *                      at the same time (for active open).
+ * @param times         Where to save connection setup times, ns (for
+ *                      active open).
+ * @param max_times     Capacity of @p times.
+ * @param times_num     Where to save number of saved setup times.
+ * @param stats         Where to save statistics.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_tcp_churn(struct zf_stack *stack, struct zf_attr *attr,
+               struct zftl *zftl, const struct sockaddr *raddr,
+               int duration, int concurrency, uint64_t *times,
+               unsigned int max_times, unsigned int *times_num,
+               tarpc_zfts_tcp_churn_stats *stats)
+{
+    tcp_bench_funcs     funcs;
+    struct zft_handle  *handle;
+    struct zft        **zockets = NULL;
+    struct zft         *zocket;
+    uint64_t           *starts = NULL;
+    uint64_t            start;
+    uint64_t            deadline;
+    uint64_t            now;
+    int                 state;
+    int                 result = 0;
+    int                 rc;
+    int                 i;
+
+    if (tcp_bench_funcs_resolve(&funcs) != 0)
+        return -1;
+
+    if (zftl == NULL && (raddr == NULL || concurrency <= 0))
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "address and concurrency are required for "
+                         "active open");
+        return -1;
+    }
+
+    if (zftl == NULL)
+    {
+        zockets = TE_ALLOC(concurrency * sizeof(*zockets));
+        starts = TE_ALLOC(concurrency * sizeof(*starts));
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    *times_num = 0;
+
+    start = zfts_time_ns();
+    deadline = start + (uint64_t)duration * 1000000ULL;
+    for (now = start; now < deadline; now = zfts_time_ns())
+    {
+        if (zftl != NULL)
+        {
+            while (funcs.zftl_accept(zftl, &zocket) == 0)
+            {
+                stats->established++;
+                tcp_churn_close_zocket(&funcs, zocket, stats);
+            }
+        }
+        else
+        {
+            for (i = 0; i < concurrency; i++)
+            {
+                if (zockets[i] != NULL)
+                    continue;
+
+                rc = funcs.zft_alloc(stack, attr, &handle);
+                if (rc < 0)
+                {
+                    stats->alloc_fails++;
+                    break;
+                }
+
+                starts[i] = zfts_time_ns();
+                rc = funcs.zft_connect(handle, raddr,
+                                       te_sockaddr_get_size(raddr),
+                                       &zockets[i]);
+                if (rc < 0)
+                {
+                    funcs.zft_handle_free(handle);
+                    zockets[i] = NULL;
+                    stats->alloc_fails++;
+                    break;
+                }
+            }
+        }
+
+        rc = funcs.process_events(stack);
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_process_events() failed");
+            result = -1;
+            break;
+        }
+
+        for (i = 0; zftl == NULL && i < concurrency; i++)
+        {
+            if (zockets[i] == NULL)
+                continue;
+
+            state = funcs.zft_state(zockets[i]);
+            if (state == TCP_ESTABLISHED)
+            {
+                stats->established++;
+                tcp_bench_add_time(times, max_times, times_num,
+                                   zfts_time_ns() - starts[i]);
+                tcp_churn_close_zocket(&funcs, zockets[i], stats);
+                zockets[i] = NULL;
+            }
+            else if (state == TCP_CLOSE)
+            {
+                stats->failed++;
+                funcs.zft_free(zockets[i]);
+                zockets[i] = NULL;
+            }
+        }
+    }
+
+    for (i = 0; zftl == NULL && i < concurrency; i++)
+    {
+        if (zockets[i] != NULL)
+            funcs.zft_free(zockets[i]);
+    }
+
+    stats->elapsed = zfts_time_ns() - start;
+
+    free(zockets);
+    free(starts);
+    return result;
+}
+
+TARPC_FUNC_STATIC(zfts_tcp_churn, {},
+{
+    static rpc_ptr_id_namespace ns_stack = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_attr = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zftl = RPC_PTR_ID_NS_INVALID;
+
+    struct zf_stack *stack = NULL;
+    struct zf_attr  *attr = NULL;
+    struct zftl     *zftl = NULL;
+    unsigned int     times_num = 0;
+
+    PREPARE_ADDR(raddr, in->raddr, 0);
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_stack,
+                                           RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_attr,
+                                           RPC_TYPE_NS_ZF_ATTR,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zftl, RPC_TYPE_NS_ZFTL,);
+
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns_stack,);
+    if (in->zftl != RPC_NULL)
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(zftl, in->zftl, ns_zftl,);
+    else
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(attr, in->attr, ns_attr,);
+
+    out->times.times_val = TE_ALLOC(MAX(in->max_times, 1) *
+                                    sizeof(*out->times.times_val));
+
+    MAKE_CALL(out->retval = func_ptr(stack, attr, zftl, raddr,
+                                     in->duration, in->concurrency,
+                                     out->times.times_val, in->max_times,
+                                     &times_num, &out->stats));
+    out->times.times_len = times_num;
+})
+
+/** State of a Tester socket in churn loop */
+typedef enum tcp_churn_sock_state {
+    TCP_CHURN_SOCK_CONNECTING = 0,  /**< Connection is being opened */
+    TCP_CHURN_SOCK_WAIT_FIN,        /**< Waiting for peer to close
+                                         connection */
+} tcp_churn_sock_state;
+
+/** Tester socket in churn loop */
+typedef struct tcp_churn_sock {
+    int                     fd;     /**< Socket */
+    tcp_churn_sock_state    state;  /**< State */
+    uint64_t                start;  /**< When connect() was called */
+} tcp_churn_sock;
+
+/**
+ * Serve TCP connections opened and closed by IUT in a loop on Tester.
+ *
+ * If @p listener is not negative, connections are accepted on it;
+ * otherwise up to @p concurrency non-blocking connections to @p raddr
+ * are opened at the same time. In both cases a socket is closed after
+ * the peer closes connection. New connections are not opened after
+ * @p duration expires; the loop runs for a while after that to let IUT
+ * finish.
+ *
+ * @param listener      Listening socket (or negative value).
+ * @param laddr         Address to bind sockets to before connecting
+ *                      (may be @c NULL).
+ * @param raddr         Address to connect to.
+ * @param duration      How long to open connections, milliseconds.
+ * @param concurrency   Maximum number of sockets at the same time.
+ * @param times         Where to save connection setup times, ns (when
+ *                      connecting).
+ * @param max_times     Capacity of @p times.
+ * @param times_num     Where to save number of saved setup times.
+ * @param stats         Where to save statistics.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_sockets_churn(int listener, const struct sockaddr *laddr,
+                   const struct sockaddr *raddr, int duration,
+                   int concurrency, uint64_t *times,
+                   unsigned int max_times, unsigned int *times_num,
+                   tarpc_zfts_tcp_churn_stats *stats)
+{
+    tcp_churn_sock *socks;
+    struct pollfd  *pfds;
+    int             num = 0;
+    int             npfds;
+    char            buf[TCP_BENCH_BUF_SIZE];
+    socklen_t       len;
+    uint64_t        start;
+    uint64_t        deadline;
+    uint64_t        now;
+    ssize_t         rc;
+    int             err;
+    int             fd;
+    int             result = 0;
+    int             i;
+    int             j;
+
+    if (concurrency <= 0 || (listener < 0 && raddr == NULL))
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "invalid arguments");
+        return -1;
+    }
+
+    socks = TE_ALLOC(concurrency * sizeof(*socks));
+    pfds = TE_ALLOC((concurrency + 1) * sizeof(*pfds));
+
+    memset(stats, 0, sizeof(*stats));
+    *times_num = 0;
+
+    start = zfts_time_ns();
+    deadline = start + (uint64_t)duration * 1000000ULL;
+    for (now = start;
+         now < deadline + TCP_CHURN_GRACE * 1000000ULL;
+         now = zfts_time_ns())
+    {
+        while (listener < 0 && now < deadline && num < concurrency)
+        {
+            fd = socket(raddr->sa_family, SOCK_STREAM | SOCK_NONBLOCK, 0);
+            if (fd < 0 ||
+                (laddr != NULL &&
+                 bind(fd, laddr, te_sockaddr_get_size(laddr)) < 0))
+            {
+                if (fd >= 0)
+                    close(fd);
+                stats->alloc_fails++;
+                break;
+            }
+
+            socks[num].fd = fd;
+            socks[num].state = TCP_CHURN_SOCK_CONNECTING;
+            socks[num].start = zfts_time_ns();
+            if (connect(fd, raddr, te_sockaddr_get_size(raddr)) < 0 &&
+                errno != EINPROGRESS)
+            {
+                close(fd);
+                stats->failed++;
+                break;
+            }
+            num++;
+        }
+
+        npfds = 0;
+        if (listener >= 0 && num < concurrency)
+        {
+            pfds[npfds].fd = listener;
+            pfds[npfds].events = POLLIN;
+            pfds[npfds].revents = 0;
+            npfds++;
+        }
+        for (i = 0; i < num; i++)
+        {
+            pfds[npfds].fd = socks[i].fd;
+            pfds[npfds].events =
+                (socks[i].state == TCP_CHURN_SOCK_CONNECTING ?
+                                                    POLLOUT : POLLIN);
+            pfds[npfds].revents = 0;
+            npfds++;
+        }
+
+        if (npfds == 0)
+        {
+            if (now >= deadline)
+                break;
+            continue;
+        }
+
+        if (poll(pfds, npfds, 1) < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno), "poll() failed");
+            result = -1;
+            break;
+        }
+
+        now = zfts_time_ns();
+        i = 0;
+        if (listener >= 0 && num < concurrency)
+        {
+            if (pfds[0].revents != 0)
+            {
+                while (num < concurrency &&
+                       (fd = accept4(listener, NULL, NULL,
+                                     SOCK_NONBLOCK)) >= 0)
+                {
+                    socks[num].fd = fd;
+                    socks[num].state = TCP_CHURN_SOCK_WAIT_FIN;
+                    socks[num].start = now;
+                    stats->established++;
+                    num++;
+                }
+            }
+            i = 1;
+        }
+
+        for (j = 0; i < npfds; i++)
+        {
+            tcp_churn_sock *sock = &socks[j];
+
+            if (pfds[i].revents != 0 &&
+                sock->state == TCP_CHURN_SOCK_CONNECTING)
+            {
+                err = 0;
+                len = sizeof(err);
+                getsockopt(sock->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+                if (err != 0)
+                {
+                    close(sock->fd);
+                    stats->failed++;
+                    memmove(sock, sock + 1, (num - j - 1) * sizeof(*sock));
+                    num--;
+                    continue;
+                }
+
+                stats->established++;
+                tcp_bench_add_time(times, max_times, times_num,
+                                   now - sock->start);
+                sock->state = TCP_CHURN_SOCK_WAIT_FIN;
+            }
+            else if (pfds[i].revents != 0)
+            {
+                while ((rc = recv(sock->fd, buf, sizeof(buf), 0)) > 0);
+
+                if (rc == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+                {
+                    uint64_t close_start = zfts_time_ns();
+
+                    close(sock->fd);
+                    stats->teardown_ns += zfts_time_ns() - close_start;
+                    stats->closed++;
+                    memmove(sock, sock + 1, (num - j - 1) * sizeof(*sock));
+                    num--;
+                    continue;
+                }
+            }
+
+            j++;
+        }
+    }
+
+    for (i = 0; i < num; i++)
+        close(socks[i].fd);
+
+    stats->elapsed = zfts_time_ns() - start;
+
+    free(socks);
+    free(pfds);
+    return result;
+}
+
+TARPC_FUNC_STATIC(zfts_sockets_churn, {},
+{
+    unsigned int times_num = 0;
+
+    PREPARE_ADDR(laddr, in->laddr, 0);
+    PREPARE_ADDR(raddr, in->raddr, 0);
+
+    out->times.times_val = TE_ALLOC(MAX(in->max_times, 1) *
+                                    sizeof(*out->times.times_val));
+
+    MAKE_CALL(out->retval = func_ptr(in->listener, laddr, raddr,
+                                     in->duration, in->concurrency,
+                                     out->times.times_val, in->max_times,
+                                     &times_num, &out->stats));
+    out->times.times_len = times_num;
+})
+
+/**
+ * Send small writes over a TCP zocket in a loop for a given time,
+ * optionally coalescing them with @c MSG_MORE.
+ *
+ * With @p more, every write except each @p flush_every-th one is made
+ * with @c MSG_MORE. zf_reactor_perform() is called after every write.
+ *
+ * Time a write waits in the send queue is estimated assuming that
+ * data sent with @c MSG_MORE is held until a full segment is
+ * accumulated or until a write without @c MSG_MORE flushes it.
+ *
+ * @param stack         ZF stack.
+ * @param zocket        TCP zocket.
+ * @param size          Size of every write.
+ * @param use_single    Use zft_send_single() instead of zft_send().
+ * @param more          Whether to use @c MSG_MORE.
+ * @param flush_every   Write without @c MSG_MORE after this number of
+ *                      writes.
+ * @param mss           Maximum segment size.
+ * @param duration      How long to send, milliseconds.
+ * @param stats         Where to save statistics.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_tcp_send_bench(struct zf_stack *stack, struct zft *zocket,
+                    int size, te_bool use_single, te_bool more,
+                    int flush_every, int mss, int duration,
+                    tarpc_zfts_tcp_send_bench_stats *stats)
+{
+    api_func_ptr    send_f;
+    zfts_reactor_ctx reactor_ctx = ZFTS_REACTOR_CTX_INIT;
+    char           *buf;
+    struct iovec    iov;
+    uint64_t        start;
+    uint64_t        deadline;
+    uint64_t        now;
+    uint64_t        ts;
+    uint64_t        pending_num = 0;
+    uint64_t        pending_sum = 0;
+    uint64_t        pending_bytes = 0;
+    int             flags;
+    int             rc = 0;
+
+    if (size <= 0 || mss <= 0 || (more && flush_every <= 0))
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "invalid arguments");
+        return -1;
+    }
+
+    if (use_single)
+    {
+        TARPC_FIND_FUNC_RETURN(FALSE, "zft_send_single",
+                               (api_func *)&send_f);
+    }
+    else
+    {
+        TARPC_FIND_FUNC_RETURN(FALSE, "zft_send", (api_func *)&send_f);
+    }
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_reactor_perform",
+                           (api_func *)&reactor_ctx.reactor_func);
+
+    buf = TE_ALLOC(size);
+    iov.iov_base = buf;
+    iov.iov_len = size;
+
+    memset(stats, 0, sizeof(*stats));
+
+    start = zfts_time_ns();
+    deadline = start + (uint64_t)duration * 1000000ULL;
+    for (now = start; now < deadline; now = zfts_time_ns())
+    {
+        flags = 0;
+        if (more && (stats->writes + 1) % flush_every != 0)
+            flags = MSG_MORE;
+
+        ts = zfts_time_ns();
+        if (use_single)
+            rc = send_f(zocket, buf, size, flags);
+        else
+            rc = send_f(zocket, &iov, 1, flags);
+        now = zfts_time_ns();
+        stats->send_ns += now - ts;
+
+        if (rc == -EAGAIN || rc == -ENOMEM)
+        {
+            stats->again++;
+        }
+        else if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc), "%s() failed",
+                             use_single ? "zft_send_single" : "zft_send");
+            break;
+        }
+        else
+        {
+            stats->writes++;
+            stats->bytes += rc;
+
+            pending_num++;
+            pending_sum += now - start;
+            pending_bytes += rc;
+            if (flags == 0 || pending_bytes >= (uint64_t)mss)
+            {
+                if (flags == 0)
+                    stats->flushes++;
+
+                stats->hold_ns += pending_num * (now - start) -
+                                  pending_sum;
+                pending_bytes = (flags == 0 ? 0 : pending_bytes % mss);
+                pending_num = (pending_bytes > 0 ? 1 : 0);
+                pending_sum = (pending_bytes > 0 ? now - start : 0);
+            }
+        }
+
+        ts = zfts_time_ns();
+        rc = zfts_call_zf_reactor_perform(stack, &reactor_ctx);
+        stats->reactor_ns += zfts_time_ns() - ts;
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_reactor_perform() failed");
+            break;
+        }
+        rc = 0;
+    }
+    stats->elapsed = zfts_time_ns() - start;
+
+    free(buf);
+    return rc < 0 ? -1 : 0;
+}
+
+TARPC_FUNC_STATIC(zfts_tcp_send_bench, {},
+{
+    static rpc_ptr_id_namespace ns_stack = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zft = RPC_PTR_ID_NS_INVALID;
+
+    struct zf_stack *stack = NULL;
+    struct zft      *zft = NULL;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_stack,
+                                           RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zft, RPC_TYPE_NS_ZFT,);
+
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns_stack,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(zft, in->zocket, ns_zft,);
+
+    MAKE_CALL(out->retval = func_ptr(stack, zft, in->size, in->use_single,
+                                     in->more, in->flush_every, in->mss,
+                                     in->duration, &out->stats));
+})
+
+/**
+ * Add a sample of available send space, keeping memory constant: when
+ * the array is full, every second sample is dropped and the sampling
+ * period is doubled.
+ *
+ * @param samples       Array of samples.
+ * @param max_samples   Capacity of @p samples.
+ * @param samples_num   Number of saved samples.
+ * @param period        Sampling period (updated when samples are
+ *                      decimated).
+ * @param time          Time since the loop start, ns.
+ * @param space         Available send space.
+ */
+static void
+tcp_bench_add_space_sample(tarpc_zfts_send_space_sample *samples,
+                           unsigned int max_samples,
+                           unsigned int *samples_num, uint64_t *period,
+                           uint64_t time, uint64_t space)
+{
+    unsigned int i;
+
+    if (max_samples == 0)
+        return;
+
+    if (*samples_num == max_samples)
+    {
+        for (i = 0; i < max_samples / 2; i++)
+            samples[i] = samples[i * 2 + 1];
+        *samples_num = max_samples / 2;
+        *period *= 2;
+    }
+
+    samples[*samples_num].time = time;
+    samples[*samples_num].space = space;
+    (*samples_num)++;
+}
+
+/**
+ * Stream data over a TCP zocket as fast as possible for a given time,
+ * sampling available send space with zft_send_space() every
+ * @p sample_every send attempts. zf_reactor_perform() is called after
+ * every send attempt.
+ *
+ * A stall is a sequence of send attempts failed because the send queue
+ * is full; its duration is measured from the first failed attempt to
+ * the next successful one.
+ *
+ * @param stack         ZF stack.
+ * @param zocket        TCP zocket.
+ * @param size          Size of every write.
+ * @param sample_every  Sample send space after this number of send
+ *                      attempts.
+ * @param duration      How long to send, milliseconds.
+ * @param samples       Where to save send space samples.
+ * @param max_samples   Capacity of @p samples.
+ * @param samples_num   Where to save number of saved samples.
+ * @param stats         Where to save statistics.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_tcp_send_space_bench(struct zf_stack *stack, struct zft *zocket,
+                          int size, int sample_every, int duration,
+                          tarpc_zfts_send_space_sample *samples,
+                          unsigned int max_samples,
+                          unsigned int *samples_num,
+                          tarpc_zfts_tcp_send_space_stats *stats)
+{
+    api_func_ptr    send_f;
+    api_func_ptr    space_f;
+    zfts_reactor_ctx reactor_ctx = ZFTS_REACTOR_CTX_INIT;
+    char           *buf;
+    uint64_t        period;
+    uint64_t        attempts = 0;
+    uint64_t        start;
+    uint64_t        deadline;
+    uint64_t        now;
+    uint64_t        stall_start = 0;
+    size_t          space;
+    int             rc = 0;
+
+    if (size <= 0 || sample_every <= 0)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "invalid arguments");
+        return -1;
+    }
+
+    TARPC_FIND_FUNC_RETURN(FALSE, "zft_send_single", (api_func *)&send_f);
+    TARPC_FIND_FUNC_RETURN(FALSE, "zft_send_space", (api_func *)&space_f);
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_reactor_perform",
+                           (api_func *)&reactor_ctx.reactor_func);
+
+    buf = TE_ALLOC(size);
+
+    memset(stats, 0, sizeof(*stats));
+    stats->min_space = UINT64_MAX;
+    *samples_num = 0;
+    period = sample_every;
+
+    start = zfts_time_ns();
+    deadline = start + (uint64_t)duration * 1000000ULL;
+    for (now = start; now < deadline; now = zfts_time_ns())
+    {
+        if (attempts++ % period == 0)
+        {
+            rc = space_f(zocket, &space);
+            if (rc < 0)
+            {
+                te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                                 "zft_send_space() failed");
+                break;
+            }
+            stats->samples++;
+            stats->space_sum += space;
+            stats->min_space = MIN(stats->min_space, space);
+            tcp_bench_add_space_sample(samples, max_samples, samples_num,
+                                       &period, now - start, space);
+        }
+
+        rc = send_f(zocket, buf, size, 0);
+        if (rc == -EAGAIN || rc == -ENOMEM)
+        {
+            stats->again++;
+            if (stall_start == 0)
+            {
+                stall_start = zfts_time_ns();
+                stats->stalls++;
+            }
+        }
+        else if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zft_send_single() failed");
+            break;
+        }
+        else
+        {
+            stats->writes++;
+            stats->bytes += rc;
+            if (stall_start != 0)
+            {
+                stats->stall_ns += zfts_time_ns() - stall_start;
+                stall_start = 0;
+            }
+        }
+
+        rc = zfts_call_zf_reactor_perform(stack, &reactor_ctx);
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_reactor_perform() failed");
+            break;
+        }
+        rc = 0;
+    }
+    stats->elapsed = zfts_time_ns() - start;
+    if (stall_start != 0)
+        stats->stall_ns += stats->elapsed - (stall_start - start);
+    if (stats->samples == 0)
+        stats->min_space = 0;
+
+    free(buf);
+    return rc < 0 ? -1 : 0;
+}
+
+TARPC_FUNC_STATIC(zfts_tcp_send_space_bench, {},
+{
+    static rpc_ptr_id_namespace ns_stack = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zft = RPC_PTR_ID_NS_INVALID;
+
+    struct zf_stack *stack = NULL;
+    struct zft      *zft = NULL;
+    unsigned int     samples_num = 0;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_stack,
+                                           RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zft, RPC_TYPE_NS_ZFT,);
+
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns_stack,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(zft, in->zocket, ns_zft,);
+
+    out->samples.samples_val = TE_ALLOC(MAX(in->max_samples, 1) *
+                                        sizeof(*out->samples.samples_val));
+
+    MAKE_CALL(out->retval = func_ptr(stack, zft, in->size,
+                                     in->sample_every, in->duration,
+                                     out->samples.samples_val,
+                                     in->max_samples, &samples_num,
+                                     &out->stats));
+    out->samples.samples_len = samples_num;
+})
+
+/**
+ * How long request/response loops keep running after the requested
+ * duration expires to complete outstanding transactions, milliseconds.
+ */
+#define TCP_RR_GRACE 500
+
+/**
+ * Run request/response client on a TCP zocket: send requests keeping
+ * up to @p depth of them outstanding and receive responses, measuring
+ * time from sending a request to receiving its whole response. New
+ * requests are not sent after @p duration expires.
+ *
+ * @param stack         ZF stack.
+ * @param zocket        TCP zocket.
+ * @param req_size      Request size.
+ * @param resp_size     Response size.
+ * @param depth         Maximum number of outstanding requests.
+ * @param duration      How long to send requests, milliseconds.
+ * @param times         Where to save transaction latencies, ns.
+ * @param max_times     Capacity of @p times.
+ * @param times_num     Where to save number of saved latencies.
+ * @param stats         Where to save statistics.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_tcp_rr_client(struct zf_stack *stack, struct zft *zocket,
+                   int req_size, int resp_size, int depth, int duration,
+                   uint64_t *times, unsigned int max_times,
+                   unsigned int *times_num, tarpc_zfts_tcp_rr_stats *stats)
+{
+    api_func_ptr    send_f;
+    api_func_ptr    recv_f;
+    zfts_reactor_ctx reactor_ctx = ZFTS_REACTOR_CTX_INIT;
+    char           *req;
+    char            buf[TCP_BENCH_BUF_SIZE];
+    struct iovec    iov;
+    uint64_t       *starts;
+    unsigned int    head = 0;
+    unsigned int    tail = 0;
+    int             outstanding = 0;
+    int             req_left = 0;
+    int             resp_got = 0;
+    uint64_t        start;
+    uint64_t        deadline;
+    uint64_t        now;
+    int             rc = 0;
+    int             len;
+
+    if (req_size <= 0 || resp_size <= 0 || depth <= 0)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "invalid arguments");
+        return -1;
+    }
+
+    TARPC_FIND_FUNC_RETURN(FALSE, "zft_send_single", (api_func *)&send_f);
+    TARPC_FIND_FUNC_RETURN(FALSE, "zft_recv", (api_func *)&recv_f);
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_reactor_perform",
+                           (api_func *)&reactor_ctx.reactor_func);
+
+    req = TE_ALLOC(req_size);
+    starts = TE_ALLOC(depth * sizeof(*starts));
+
+    memset(stats, 0, sizeof(*stats));
+    *times_num = 0;
+
+    start = zfts_time_ns();
+    deadline = start + (uint64_t)duration * 1000000ULL;
+    for (now = start;
+         now < deadline ||
+         (outstanding > 0 &&
+          now < deadline + TCP_RR_GRACE * 1000000ULL);
+         now = zfts_time_ns())
+    {
+        while (req_left > 0 || (now < deadline && outstanding < depth))
+        {
+            if (req_left == 0)
+            {
+                req_left = req_size;
+                starts[head] = zfts_time_ns();
+                head = (head + 1) % depth;
+                outstanding++;
+            }
+
+            rc = send_f(zocket, req + req_size - req_left, req_left, 0);
+            if (rc == -EAGAIN || rc == -ENOMEM)
+            {
+                stats->again++;
+                rc = 0;
+                break;
+            }
+            else if (rc < 0)
+            {
+                te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                                 "zft_send_single() failed");
+                goto out;
+            }
+            req_left -= rc;
+            stats->sent += rc;
+        }
+
+        rc = zfts_call_zf_reactor_perform(stack, &reactor_ctx);
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_reactor_perform() failed");
+            goto out;
+        }
+
+        while (TRUE)
+        {
+            iov.iov_base = buf;
+            iov.iov_len = sizeof(buf);
+            rc = recv_f(zocket, &iov, 1, 0);
+            if (rc == -EAGAIN)
+            {
+                rc = 0;
+                break;
+            }
+            else if (rc <= 0)
+            {
+                te_rpc_error_set(rc == 0 ?
+                                    TE_RC(TE_TA_UNIX, TE_ECONNRESET) :
+                                    TE_OS_RC(TE_TA_UNIX, -rc),
+                                 "zft_recv() failed or peer closed "
+                                 "connection");
+                rc = -1;
+                goto out;
+            }
+
+            stats->received += rc;
+            now = zfts_time_ns();
+            for (len = rc; len > 0; )
+            {
+                if (resp_got + len < resp_size)
+                {
+                    resp_got += len;
+                    break;
+                }
+
+                len -= resp_size - resp_got;
+                resp_got = 0;
+                if (outstanding == 0)
+                {
+                    te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EPROTO),
+                                     "unexpected response data");
+                    rc = -1;
+                    goto out;
+                }
+                tcp_bench_add_time(times, max_times, times_num,
+                                   now - starts[tail]);
+                tail = (tail + 1) % depth;
+                outstanding--;
+                stats->transactions++;
+            }
+        }
+    }
+
+out:
+    stats->elapsed = zfts_time_ns() - start;
+    free(req);
+    free(starts);
+    return rc < 0 ? -1 : 0;
+}
+
+TARPC_FUNC_STATIC(zfts_tcp_rr_client, {},
+{
+    static rpc_ptr_id_namespace ns_stack = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zft = RPC_PTR_ID_NS_INVALID;
+
+    struct zf_stack *stack = NULL;
+    struct zft      *zft = NULL;
+    unsigned int     times_num = 0;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_stack,
+                                           RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zft, RPC_TYPE_NS_ZFT,);
+
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns_stack,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(zft, in->zocket, ns_zft,);
+
+    out->times.times_val = TE_ALLOC(MAX(in->max_times, 1) *
+                                    sizeof(*out->times.times_val));
+
+    MAKE_CALL(out->retval = func_ptr(stack, zft, in->req_size,
+                                     in->resp_size, in->depth,
+                                     in->duration, out->times.times_val,
+                                     in->max_times, &times_num,
+                                     &out->stats));
+    out->times.times_len = times_num;
+})
+
+/**
+ * Run request/response server on a socket: send a response of
+ * @p resp_size bytes for every @p req_size bytes received. The loop
+ * runs for @p duration and additional grace period to let the client
+ * complete outstanding transactions.
+ *
+ * @param fd            Connected TCP socket.
+ * @param req_size      Request size.
+ * @param resp_size     Response size.
+ * @param duration      How long the client sends requests,
+ *                      milliseconds.
+ * @param stats         Where to save statistics.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_sockets_rr_server(int fd, int req_size, int resp_size, int duration,
+                       tarpc_zfts_tcp_rr_stats *stats)
+{
+    char           *resp;
+    char            buf[TCP_BENCH_BUF_SIZE];
+    struct pollfd   pfd;
+    uint64_t        pending = 0;
+    int             resp_left = 0;
+    int             req_got = 0;
+    uint64_t        start;
+    uint64_t        deadline;
+    ssize_t         rc;
+    int             flags;
+    int             result = 0;
+
+    if (req_size <= 0 || resp_size <= 0)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "invalid arguments");
+        return -1;
+    }
+
+    flags = fcntl(fd, F_GETFL);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno), "fcntl() failed");
+        return -1;
+    }
+
+    resp = TE_ALLOC(resp_size);
+    memset(stats, 0, sizeof(*stats));
+
+    start = zfts_time_ns();
+    deadline = start + ((uint64_t)duration + TCP_RR_GRACE) * 1000000ULL;
+    while (zfts_time_ns() < deadline)
+    {
+        pfd.fd = fd;
+        pfd.events = POLLIN | (pending > 0 || resp_left > 0 ? POLLOUT : 0);
+        pfd.revents = 0;
+        if (poll(&pfd, 1, 1) < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno), "poll() failed");
+            result = -1;
+            break;
+        }
+
+        while ((rc = recv(fd, buf, sizeof(buf), 0)) > 0)
+        {
+            stats->received += rc;
+            req_got += rc;
+            pending += req_got / req_size;
+            req_got %= req_size;
+        }
+        if (rc == 0)
+            break;
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                             "recv() failed");
+            result = -1;
+            break;
+        }
+
+        while (resp_left > 0 || pending > 0)
+        {
+            if (resp_left == 0)
+            {
+                resp_left = resp_size;
+                pending--;
+            }
+
+            rc = send(fd, resp + resp_size - resp_left, resp_left, 0);
+            if (rc < 0)
+            {
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    stats->again++;
+                    break;
+                }
+                te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                                 "send() failed");
+                result = -1;
+                goto out;
+            }
+            stats->sent += rc;
+            resp_left -= rc;
+            if (resp_left == 0)
+                stats->transactions++;
+        }
+    }
+
+out:
+    stats->elapsed = zfts_time_ns() - start;
+    fcntl(fd, F_SETFL, flags);
+    free(resp);
+    return result;
+}
+
+TARPC_FUNC_STATIC(zfts_sockets_rr_server, {},
+{
+    MAKE_CALL(out->retval = func_ptr(in->fd, in->req_size, in->resp_size,
+                                     in->duration, &out->stats));
+})
@@ -0,0 +1,754 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/**
+ * @brief TX timestamps collector RPC routines implementation
+ *
+ * Agent-side collector of TX packet reports. Reports are retrieved
+ * from a zocket each time the agent calls zf_reactor_perform() on its
+ * stack, so that they do not have to be polled over RPC one by one.
+ * On-demand collectors retrieve reports only when asked explicitly,
+ * so that ZF keeps and drops them as if nobody collected them.
+ *
+ * $Id$
+ */
+
+#define TE_LGR_USER     "SFC Zetaferno RPC TX TS"
+#include "te_config.h"
+#include "config.h"
+
+#include "logger_ta_lock.h"
+#include "rpc_server.h"
+
+#include <pthread.h>
+
+#include "zf_talib_namespace.h"
+#include "te_alloc.h"
+#include "zf_rpc.h"
+
+#include <zf/zf.h>
+#include <zf/zf_udp.h>
+#include <zf/zf_tcp.h>
+
+/** Number of reports retrieved with a single get_tx_timestamps() call */
+#define TX_TS_COLLECTOR_BATCH 64
+
+/** TX packet reports collector attached to a zocket. */
+typedef struct tx_ts_collector {
+    struct tx_ts_collector *next;   /**< Next collector in the list */
+
+    struct zf_stack        *stack;  /**< Stack of the zocket
+                                         (@c NULL once detached) */
+    void                   *zocket; /**< zfut or zft zocket
+                                         (@c NULL once detached) */
+    te_bool                 udp;    /**< @c TRUE for zfut zocket */
+    te_bool                 on_demand; /**< @c TRUE if reports are
+                                            retrieved only by
+                                            zfts_tx_ts_collector_drain()
+                                            RPC */
+    api_func                get_tx_timestamps; /**< zfut or zft
+                                                    get_tx_timestamps() */
+
+    struct zf_pkt_report   *ring;   /**< Ring of the latest reports */
+    unsigned int            ring_size;  /**< Capacity of the ring */
+    unsigned int            ring_head;  /**< Index of the oldest report */
+    unsigned int            ring_len;   /**< Number of reports in
+                                             the ring */
+
+    tarpc_zfts_tx_ts_stats  stats;      /**< Statistics */
+    te_bool                 error;      /**< Set if retrieving reports
+                                             failed once */
+    te_bool                 have_prev;  /**< Set if @p prev_ts and
+                                             @p prev_start are valid */
+    struct timespec         prev_ts;    /**< Timestamp of the previous
+                                             timestamped report */
+    unsigned int            prev_start; /**< @c start field of the
+                                             previous report */
+} tx_ts_collector;
+
+/** List of active collectors */
+static tx_ts_collector *tx_ts_collectors = NULL;
+/** Number of active collectors, checked without taking the lock */
+static volatile int tx_ts_collectors_num = 0;
+/** Lock protecting the list of collectors */
+static pthread_mutex_t tx_ts_collectors_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Get difference between two timestamps in nanoseconds.
+ *
+ * @param a     The later timestamp.
+ * @param b     The earlier timestamp.
+ *
+ * @return @p a - @p b in nanoseconds.
+ */
+static int64_t
+tx_ts_diff_ns(const struct timespec *a, const struct timespec *b)
+{
+    return (int64_t)(a->tv_sec - b->tv_sec) * (int64_t)ZFTS_NSEC_PER_SEC +
+           (a->tv_nsec - b->tv_nsec);
+}
+
+/**
+ * Account a single packet report in collector statistics and save it
+ * in the ring, overwriting the oldest report if the ring is full.
+ *
+ * @param c         Collector.
+ * @param report    Packet report.
+ * @param now       Time when the report was retrieved (realtime clock).
+ */
+static void
+tx_ts_collector_add(tx_ts_collector *c, const struct zf_pkt_report *report,
+                    const struct timespec *now)
+{
+    tarpc_zfts_tx_ts_stats *st = &c->stats;
+    int64_t                 diff;
+
+    st->reports++;
+    st->bytes += report->bytes;
+
+    if (report->flags & ZF_PKT_REPORT_DROPPED)
+        st->dropped++;
+#ifdef ZF_PKT_REPORT_TCP_RETRANS
+    if (report->flags & ZF_PKT_REPORT_TCP_RETRANS)
+        st->retrans++;
+#endif
+
+    /*
+     * For UDP zockets 'start' is the packet index, so a gap in it
+     * tells how many reports were dropped by ZF.
+     */
+    if (c->udp && c->have_prev && report->start > c->prev_start + 1)
+        st->lost += report->start - c->prev_start - 1;
+
+    if (report->flags & ZF_PKT_REPORT_NO_TIMESTAMP)
+    {
+        st->no_timestamp++;
+    }
+    else
+    {
+        if (report->flags & ZF_PKT_REPORT_IN_SYNC)
+        {
+            diff = tx_ts_diff_ns(now, &report->timestamp);
+            if (diff < 0)
+                diff = 0;
+
+            if (st->delay_num == 0 || (uint64_t)diff < st->delay_min)
+                st->delay_min = diff;
+            if ((uint64_t)diff > st->delay_max)
+                st->delay_max = diff;
+
+            st->delay_num++;
+            st->delay_sum += diff;
+        }
+
+        if (c->have_prev && c->prev_ts.tv_sec != 0)
+        {
+            diff = tx_ts_diff_ns(&report->timestamp, &c->prev_ts);
+            if (diff >= 0)
+            {
+                if (st->gap_num == 0 || (uint64_t)diff < st->gap_min)
+                    st->gap_min = diff;
+                if ((uint64_t)diff > st->gap_max)
+                    st->gap_max = diff;
+                st->gap_num++;
+                st->gap_sum += diff;
+            }
+        }
+        c->prev_ts = report->timestamp;
+    }
+
+    c->prev_start = report->start;
+    c->have_prev = TRUE;
+
+    if (c->ring_len == c->ring_size)
+    {
+        c->ring_head = (c->ring_head + 1) % c->ring_size;
+        c->ring_len--;
+        st->overwritten++;
+    }
+    c->ring[(c->ring_head + c->ring_len) % c->ring_size] = *report;
+    c->ring_len++;
+}
+
+/**
+ * Retrieve all the available packet reports from the collector zocket.
+ *
+ * @param c     Collector.
+ */
+static void
+tx_ts_collector_drain(tx_ts_collector *c)
+{
+    struct zf_pkt_report reports[TX_TS_COLLECTOR_BATCH];
+    struct timespec      now;
+    int                  count;
+    int                  rc;
+    int                  i;
+
+    if (c->error)
+        return;
+
+    do {
+        count = TX_TS_COLLECTOR_BATCH;
+        rc = c->get_tx_timestamps(c->zocket, reports, &count);
+        if (rc < 0 || count < 0 || count > TX_TS_COLLECTOR_BATCH)
+        {
+            ERROR("%s(): %s_get_tx_timestamps() failed, rc=%d, count=%d",
+                  __FUNCTION__, c->udp ? "zfut" : "zft", rc, count);
+            c->error = TRUE;
+            return;
+        }
+
+        c->stats.polls++;
+        if (count == 0)
+            break;
+
+        clock_gettime(CLOCK_REALTIME, &now);
+        for (i = 0; i < count; i++)
+            tx_ts_collector_add(c, &reports[i], &now);
+    } while (count == TX_TS_COLLECTOR_BATCH);
+}
+
+/* See description in zf_rpc.h */
+void
+zfts_tx_ts_collectors_drain(struct zf_stack *stack)
+{
+    tx_ts_collector *c;
+
+    if (tx_ts_collectors_num == 0)
+        return;
+
+    pthread_mutex_lock(&tx_ts_collectors_lock);
+    for (c = tx_ts_collectors; c != NULL; c = c->next)
+    {
+        if (c->stack == stack && !c->on_demand)
+            tx_ts_collector_drain(c);
+    }
+    pthread_mutex_unlock(&tx_ts_collectors_lock);
+}
+
+/* See description in zf_rpc.h */
+void
+zfts_tx_ts_collectors_forget(struct zf_stack *stack, const void *zocket)
+{
+    tx_ts_collector **p;
+    tx_ts_collector  *c;
+
+    if (tx_ts_collectors_num == 0)
+        return;
+
+    pthread_mutex_lock(&tx_ts_collectors_lock);
+    for (p = &tx_ts_collectors; *p != NULL; )
+    {
+        c = *p;
+        if ((zocket != NULL && c->zocket == zocket) ||
+            (zocket == NULL && c->stack == stack))
+        {
+            /*
+             * The collector itself is released only by
+             * zfts_tx_ts_collector_stop() since its RPC pointer may
+             * still be used by the test.
+             */
+            *p = c->next;
+            c->next = NULL;
+            c->stack = NULL;
+            c->zocket = NULL;
+            tx_ts_collectors_num--;
+        }
+        else
+        {
+            p = &c->next;
+        }
+    }
+    pthread_mutex_unlock(&tx_ts_collectors_lock);
+}
+
+/**
+ * Start collecting TX packet reports of a zocket.
+ *
+ * @param stack         ZF stack.
+ * @param zocket        zfut or zft zocket.
+ * @param udp           @c TRUE if @p zocket is zfut.
+ * @param ring_size     Number of the latest reports to keep.
+ * @param on_demand     If @c TRUE, retrieve reports only when
+ *                      zfts_tx_ts_collector_drain() is called.
+ * @param coll          Where to save pointer to the collector.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_tx_ts_collector_start(struct zf_stack *stack, void *zocket,
+                           te_bool udp, unsigned int ring_size,
+                           te_bool on_demand, tx_ts_collector **coll)
+{
+    tx_ts_collector *c;
+    api_func         func = NULL;
+
+    if (ring_size == 0)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "ring size must be positive");
+        return -1;
+    }
+
+    TARPC_FIND_FUNC_RETURN(FALSE, udp ? "zfut_get_tx_timestamps" :
+                                        "zft_get_tx_timestamps",
+                           &func);
+
+    c = TE_ALLOC(sizeof(*c));
+    c->ring = TE_ALLOC(ring_size * sizeof(*c->ring));
+    c->ring_size = ring_size;
+    c->stack = stack;
+    c->zocket = zocket;
+    c->udp = udp;
+    c->on_demand = on_demand;
+    c->get_tx_timestamps = func;
+
+    pthread_mutex_lock(&tx_ts_collectors_lock);
+    c->next = tx_ts_collectors;
+    tx_ts_collectors = c;
+    tx_ts_collectors_num++;
+    pthread_mutex_unlock(&tx_ts_collectors_lock);
+
+    *coll = c;
+    return 0;
+}
+
+TARPC_FUNC_STATIC(zfts_tx_ts_collector_start, {},
+{
+    static rpc_ptr_id_namespace ns_stack = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zfut = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zft = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_coll = RPC_PTR_ID_NS_INVALID;
+
+    struct zf_stack *stack = NULL;
+    void            *zocket = NULL;
+    tx_ts_collector *coll = NULL;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_stack,
+                                           RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zfut, RPC_TYPE_NS_ZFUT,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zft, RPC_TYPE_NS_ZFT,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_coll,
+                                           RPC_TYPE_NS_ZFTS_TX_TS_COLL,);
+
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns_stack,);
+    if (in->udp)
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(zocket, in->zocket, ns_zfut,);
+    else
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(zocket, in->zocket, ns_zft,);
+
+    MAKE_CALL(out->retval = func_ptr(stack, zocket, in->udp,
+                                     in->ring_size, in->on_demand,
+                                     &coll));
+
+    if (out->retval == 0)
+        out->coll = RCF_PCH_MEM_INDEX_ALLOC(coll, ns_coll);
+})
+
+/**
+ * Get statistics of a collector.
+ *
+ * @param c         Collector.
+ * @param stats     Where to save statistics.
+ *
+ * @return @c 0 on success, @c -1 if retrieving reports failed.
+ */
+static int
+zfts_tx_ts_collector_stats(tx_ts_collector *c, tarpc_zfts_tx_ts_stats *stats)
+{
+    pthread_mutex_lock(&tx_ts_collectors_lock);
+
+    *stats = c->stats;
+    stats->ring_len = c->ring_len;
+
+    pthread_mutex_unlock(&tx_ts_collectors_lock);
+
+    if (c->error)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EFAIL),
+                         "failed to retrieve TX packet reports");
+        return -1;
+    }
+
+    return 0;
+}
+
+TARPC_FUNC_STATIC(zfts_tx_ts_collector_stats, {},
+{
+    static rpc_ptr_id_namespace ns_coll = RPC_PTR_ID_NS_INVALID;
+
+    tx_ts_collector *coll = NULL;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_coll,
+                                           RPC_TYPE_NS_ZFTS_TX_TS_COLL,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(coll, in->coll, ns_coll,);
+
+    MAKE_CALL(out->retval = func_ptr(coll, &out->stats));
+})
+
+/**
+ * Move the oldest reports from the collector ring to RPC output.
+ *
+ * @param c         Collector.
+ * @param reports   Where to save reports.
+ * @param max_num   Maximum number of reports to move.
+ *
+ * @return Number of moved reports.
+ */
+static int
+zfts_tx_ts_collector_read(tx_ts_collector *c, tarpc_zf_pkt_report *reports,
+                          unsigned int max_num)
+{
+    struct zf_pkt_report *report;
+    unsigned int          num;
+    unsigned int          i;
+
+    pthread_mutex_lock(&tx_ts_collectors_lock);
+
+    num = MIN(max_num, c->ring_len);
+    for (i = 0; i < num; i++)
+    {
+        report = &c->ring[(c->ring_head + i) % c->ring_size];
+        reports[i].timestamp.tv_sec = report->timestamp.tv_sec;
+        reports[i].timestamp.tv_nsec = report->timestamp.tv_nsec;
+        reports[i].start = report->start;
+        reports[i].bytes = report->bytes;
+        reports[i].flags = zf_pkt_report_flags_h2rpc(report->flags);
+    }
+    c->ring_head = (c->ring_head + num) % c->ring_size;
+    c->ring_len -= num;
+
+    pthread_mutex_unlock(&tx_ts_collectors_lock);
+
+    return num;
+}
+
+TARPC_FUNC_STATIC(zfts_tx_ts_collector_read, {},
+{
+    static rpc_ptr_id_namespace ns_coll = RPC_PTR_ID_NS_INVALID;
+
+    tx_ts_collector *coll = NULL;
+    unsigned int     max_num;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_coll,
+                                           RPC_TYPE_NS_ZFTS_TX_TS_COLL,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(coll, in->coll, ns_coll,);
+
+    max_num = in->max_num == 0 ? coll->ring_size :
+                                 MIN(in->max_num, coll->ring_size);
+    out->reports.reports_val =
+        TE_ALLOC(max_num * sizeof(*out->reports.reports_val));
+
+    MAKE_CALL(out->retval = func_ptr(coll, out->reports.reports_val,
+                                     max_num));
+    out->reports.reports_len = out->retval;
+})
+
+/**
+ * Retrieve packet reports from the collector zocket into its ring,
+ * calling get_tx_timestamps() until it returns no reports.
+ *
+ * @param c             Collector.
+ * @param min_num       Minimum number of reports requested by a single
+ *                      get_tx_timestamps() call.
+ * @param max_num       Maximum number of reports requested by a single
+ *                      get_tx_timestamps() call.
+ * @param single_call   If @c TRUE, call get_tx_timestamps() only once.
+ *
+ * @return Number of retrieved reports, @c -1 on failure.
+ */
+static int
+zfts_tx_ts_collector_drain(tx_ts_collector *c, unsigned int min_num,
+                           unsigned int max_num, te_bool single_call)
+{
+    struct zf_pkt_report *reports;
+    struct timespec       now;
+    int                   total = 0;
+    int                   req;
+    int                   count;
+    int                   rc;
+    int                   i;
+
+    if (c->zocket == NULL)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_ENOENT),
+                         "zocket of the collector was released");
+        return -1;
+    }
+
+    if (min_num == 0 || min_num > max_num || max_num > c->ring_size)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "number of reports must be positive and fit "
+                         "the ring");
+        return -1;
+    }
+
+    pthread_mutex_lock(&tx_ts_collectors_lock);
+
+    /*
+     * Returning zero must mean that ZF has no more reports, so do not
+     * start if the ring cannot take the largest batch.
+     */
+    if (c->ring_size - c->ring_len < max_num)
+    {
+        pthread_mutex_unlock(&tx_ts_collectors_lock);
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_ENOSPC),
+                         "collector ring should be read first");
+        return -1;
+    }
+
+    reports = TE_ALLOC(max_num * sizeof(*reports));
+
+    while (c->ring_size - c->ring_len >= max_num)
+    {
+        req = min_num + rand() % (max_num - min_num + 1);
+        count = req;
+        rc = c->get_tx_timestamps(c->zocket, reports, &count);
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "%s_get_tx_timestamps() failed",
+                             c->udp ? "zfut" : "zft");
+            total = -1;
+            break;
+        }
+        else if (count < 0 || count > req)
+        {
+            te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                             "%s_get_tx_timestamps() returned %d reports "
+                             "while %d were requested",
+                             c->udp ? "zfut" : "zft", count, req);
+            total = -1;
+            break;
+        }
+
+        c->stats.polls++;
+        if (count == 0)
+            break;
+
+        clock_gettime(CLOCK_REALTIME, &now);
+        for (i = 0; i < count; i++)
+            tx_ts_collector_add(c, &reports[i], &now);
+        total += count;
+
+        if (single_call)
+            break;
+    }
+
+    pthread_mutex_unlock(&tx_ts_collectors_lock);
+
+    free(reports);
+    return total;
+}
+
+TARPC_FUNC_STATIC(zfts_tx_ts_collector_drain, {},
+{
+    static rpc_ptr_id_namespace ns_coll = RPC_PTR_ID_NS_INVALID;
+
+    tx_ts_collector *coll = NULL;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_coll,
+                                           RPC_TYPE_NS_ZFTS_TX_TS_COLL,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(coll, in->coll, ns_coll,);
+
+    MAKE_CALL(out->retval = func_ptr(coll, in->min_num, in->max_num,
+                                     in->single_call));
+})
+
+/**
+ * Stop collecting TX packet reports and release the collector.
+ *
+ * @param c     Collector.
+ *
+ * @return @c 0.
+ */
+static int
+zfts_tx_ts_collector_stop(tx_ts_collector *c)
+{
+    tx_ts_collector **p;
+
+    pthread_mutex_lock(&tx_ts_collectors_lock);
+    for (p = &tx_ts_collectors; *p != NULL; p = &(*p)->next)
+    {
+        if (*p == c)
+        {
+            *p = c->next;
+            tx_ts_collectors_num--;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&tx_ts_collectors_lock);
+
+    free(c->ring);
+    free(c);
+    return 0;
+}
+
+TARPC_FUNC_STATIC(zfts_tx_ts_collector_stop, {},
+{
+    static rpc_ptr_id_namespace ns_coll = RPC_PTR_ID_NS_INVALID;
+
+    tx_ts_collector *coll = NULL;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_coll,
+                                           RPC_TYPE_NS_ZFTS_TX_TS_COLL,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(coll, in->coll, ns_coll,);
+
+    MAKE_CALL(out->retval = func_ptr(coll));
+    RCF_PCH_MEM_INDEX_FREE(in->coll, ns_coll);
+})
+
+/**
+ * Send UDP packets from the zocket of a collector in bursts paced to
+ * a given rate, retrieving packet reports with a given interval.
+ *
+ * @param c               Collector of a zfut zocket.
+ * @param rate            Packets per second.
+ * @param burst           Number of packets sent back-to-back.
+ * @param size            Payload size.
+ * @param duration        How long to send, milliseconds.
+ * @param drain_interval  Interval between retrieving reports,
+ *                        microseconds (@c 0 - after every
+ *                        zf_reactor_perform() call).
+ * @param sent            Where to save number of sent packets.
+ * @param again           Where to save number of sending attempts
+ *                        failed with @c EAGAIN.
+ * @param elapsed         Where to save sending time, nanoseconds.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_tx_ts_paced_send(tx_ts_collector *c, unsigned int rate,
+                      unsigned int burst, unsigned int size,
+                      unsigned int duration, unsigned int drain_interval,
+                      uint64_t *sent, uint64_t *again, uint64_t *elapsed)
+{
+    api_func_ptr  send_func = NULL;
+    api_func_ptr  reactor_func = NULL;
+    uint8_t      *buf;
+    uint64_t      period;
+    uint64_t      drain_ns = (uint64_t)drain_interval * 1000;
+    uint64_t      start;
+    uint64_t      end;
+    uint64_t      now;
+    uint64_t      next_burst;
+    uint64_t      last_drain;
+    unsigned int  i;
+    int           rc = 0;
+
+    if (c->zocket == NULL)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_ENOENT),
+                         "zocket of the collector was released");
+        return -1;
+    }
+
+    if (!c->udp || rate == 0 || burst == 0)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "paced sending requires zfut zocket and "
+                         "positive rate and burst");
+        return -1;
+    }
+
+    TARPC_FIND_FUNC_RETURN(FALSE, "zfut_send_single",
+                           (api_func *)&send_func);
+    /*
+     * zfts_call_zf_reactor_perform() is not used here since it would
+     * retrieve reports after every call regardless of drain_interval.
+     */
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_reactor_perform",
+                           (api_func *)&reactor_func);
+
+    buf = TE_ALLOC(MAX(size, 1));
+    period = (uint64_t)burst * ZFTS_NSEC_PER_SEC / rate;
+    *sent = 0;
+    *again = 0;
+
+    start = zfts_time_ns();
+    end = start + (uint64_t)duration * 1000000;
+    next_burst = start;
+    last_drain = start;
+
+    for (now = start; now < end; now = zfts_time_ns())
+    {
+        if (now >= next_burst)
+        {
+            for (i = 0; i < burst; i++)
+            {
+                rc = send_func(c->zocket, buf, size);
+                if (rc == -EAGAIN)
+                {
+                    (*again)++;
+                    break;
+                }
+                else if (rc < 0)
+                {
+                    te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                                     "zfut_send_single() failed");
+                    break;
+                }
+                (*sent)++;
+            }
+            if (rc < 0 && rc != -EAGAIN)
+                break;
+            next_burst += period;
+        }
+
+        rc = reactor_func(c->stack);
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_reactor_perform() failed");
+            break;
+        }
+
+        if (now - last_drain >= drain_ns)
+        {
+            pthread_mutex_lock(&tx_ts_collectors_lock);
+            tx_ts_collector_drain(c);
+            pthread_mutex_unlock(&tx_ts_collectors_lock);
+            last_drain = now;
+        }
+    }
+    *elapsed = zfts_time_ns() - start;
+
+    free(buf);
+    if (rc < 0 && rc != -EAGAIN)
+        return -1;
+
+    /* Let the stack complete sending and retrieve the rest of reports. */
+    end = zfts_time_ns() + ZFTS_NSEC_PER_SEC / 100;
+    while (zfts_time_ns() < end)
+    {
+        if (reactor_func(c->stack) < 0)
+            break;
+    }
+    pthread_mutex_lock(&tx_ts_collectors_lock);
+    tx_ts_collector_drain(c);
+    pthread_mutex_unlock(&tx_ts_collectors_lock);
+
+    return 0;
+}
+
+TARPC_FUNC_STATIC(zfts_tx_ts_paced_send, {},
+{
+    static rpc_ptr_id_namespace ns_coll = RPC_PTR_ID_NS_INVALID;
+
+    tx_ts_collector *coll = NULL;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_coll,
+                                           RPC_TYPE_NS_ZFTS_TX_TS_COLL,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(coll, in->coll, ns_coll,);
+
+    MAKE_CALL(out->retval = func_ptr(coll, in->rate, in->burst, in->size,
+                                     in->duration, in->drain_interval,
+                                     &out->sent, &out->again,
+                                     &out->elapsed));
+})
@@ -0,0 +1,936 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/**
+ * @brief UDP benchmarks RPC routines implementation
+ *
+ * Agent-side loops used by UDP performance tests, so that measured
+ * operations are not interleaved with RPC calls.
+ *
+ * $Id$
+ */
+
+#define TE_LGR_USER     "SFC Zetaferno RPC UDP Bench"
+#include "te_config.h"
+#include "config.h"
+
+#include "logger_ta_lock.h"
+#include "rpc_server.h"
+
+#include <sys/socket.h>
+
+#include "zf_talib_namespace.h"
+#include "te_alloc.h"
+#include "zf_rpc.h"
+
+#include <zf/zf.h>
+#include <zf/zf_udp.h>
+
+/** Maximum number of vectors in a datagram received by drain loop */
+#define DRAIN_BENCH_IOVCNT 5
+
+/** Size of buffer used to linearise datagrams for zfut_send_single() */
+#define FORWARD_BENCH_BUF_SIZE 65536
+
+/**
+ * How long the timestamped flooder keeps receiving after it stops
+ * sending, milliseconds.
+ */
+#define TS_FLOODER_GRACE 500
+
+/** Header of a datagram sent by the timestamped flooder */
+typedef struct ts_flooder_hdr {
+    uint64_t    seq;    /**< Sequence number */
+    uint64_t    ts;     /**< Send time, ns */
+} ts_flooder_hdr;
+
+/** UDP message with vectors for zfur_zc_recv() */
+typedef struct drain_bench_msg {
+    struct zfur_msg msg;                        /**< Message */
+    struct iovec    iov[DRAIN_BENCH_IOVCNT];    /**< Vectors */
+} drain_bench_msg;
+
+/**
+ * Send datagrams round-robin from a set of UDP TX zockets for a given
+ * time. After every round zf_reactor_perform() is called once on every
+ * distinct stack.
+ *
+ * @param stacks      Stack of every zocket (may repeat).
+ * @param zockets     UDP TX zockets.
+ * @param num         Number of zockets.
+ * @param send_func   Send function.
+ * @param dgram_size  Size of every datagram.
+ * @param duration    How long to send, milliseconds.
+ * @param sent        Where to save number of datagrams sent from every
+ *                    zocket.
+ * @param stats       Where to save statistics.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_zfut_fanout_bench(struct zf_stack **stacks, struct zfut **zockets,
+                       int num, zfts_send_function send_func,
+                       int dgram_size, int duration, uint64_t *sent,
+                       tarpc_zfts_zfut_fanout_stats *stats)
+{
+    api_func_ptr       send_f;
+    api_func_ptr       reactor_f;
+    struct zf_stack  **uniq;
+    zfts_reactor_ctx  *reactor_ctx;
+    int                uniq_num = 0;
+    struct iovec       iov;
+    char              *buf;
+    uint64_t           start;
+    uint64_t           start_tsc;
+    uint64_t           deadline;
+    uint64_t           tsc;
+    int                rc = 0;
+    int                i;
+    int                j;
+
+    if (num <= 0 || dgram_size <= 0)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "number of zockets and datagram size must be "
+                         "positive");
+        return -1;
+    }
+
+    if (zfut_get_send_function(send_func, &send_f) != 0)
+        return -1;
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_reactor_perform",
+                           (api_func *)&reactor_f);
+
+    /* Thousands of zockets may be passed, so do not use the stack. */
+    uniq = TE_ALLOC(num * sizeof(*uniq));
+    reactor_ctx = TE_ALLOC(num * sizeof(*reactor_ctx));
+
+    for (i = 0; i < num; i++)
+    {
+        for (j = 0; j < uniq_num; j++)
+        {
+            if (uniq[j] == stacks[i])
+                break;
+        }
+        if (j == uniq_num)
+        {
+            memset(&reactor_ctx[uniq_num], 0, sizeof(*reactor_ctx));
+            reactor_ctx[uniq_num].reactor_func = reactor_f;
+            uniq[uniq_num++] = stacks[i];
+        }
+    }
+
+    buf = TE_ALLOC(dgram_size);
+    iov.iov_base = buf;
+    iov.iov_len = dgram_size;
+
+    memset(stats, 0, sizeof(*stats));
+    memset(sent, 0, num * sizeof(*sent));
+
+    start = zfts_time_ns();
+    start_tsc = zfts_tsc();
+    deadline = start + (uint64_t)duration * 1000000ULL;
+    while (rc >= 0 && zfts_time_ns() < deadline)
+    {
+        for (i = 0; i < num; i++)
+        {
+            tsc = zfts_tsc();
+            if (send_func == ZFTS_ZFUT_SEND)
+                rc = send_f(zockets[i], &iov, 1, 0);
+            else
+                rc = send_f(zockets[i], buf, dgram_size);
+            stats->send_ns += zfts_tsc() - tsc;
+            stats->sends++;
+
+            if (rc == dgram_size)
+            {
+                sent[i]++;
+            }
+            else if (rc == -EAGAIN)
+            {
+                stats->again++;
+            }
+            else
+            {
+                te_rpc_error_set(rc < 0 ? TE_OS_RC(TE_TA_UNIX, -rc) :
+                                          TE_RC(TE_TA_UNIX, TE_EFAIL),
+                                 "send call on zocket %d returned "
+                                 "unexpected value %d", i, rc);
+                rc = -1;
+                break;
+            }
+        }
+
+        for (j = 0; j < uniq_num && rc >= 0; j++)
+        {
+            tsc = zfts_tsc();
+            rc = zfts_call_zf_reactor_perform(uniq[j], &reactor_ctx[j]);
+            stats->reactor_ns += zfts_tsc() - tsc;
+            if (rc < 0)
+            {
+                te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                                 "zf_reactor_perform() failed");
+            }
+        }
+    }
+    stats->elapsed = zfts_time_ns() - start;
+
+    tsc = zfts_tsc() - start_tsc;
+    stats->send_ns = zfts_tsc2ns(stats->send_ns, stats->elapsed, tsc);
+    stats->reactor_ns = zfts_tsc2ns(stats->reactor_ns, stats->elapsed, tsc);
+
+    free(buf);
+    free(uniq);
+    free(reactor_ctx);
+    return rc < 0 ? -1 : 0;
+}
+
+TARPC_FUNC_STATIC(zfts_zfut_fanout_bench, {},
+{
+    static rpc_ptr_id_namespace ns_stack = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zfut = RPC_PTR_ID_NS_INVALID;
+
+    struct zf_stack  *stack;
+    struct zfut      *zocket;
+    struct zf_stack **stacks;
+    struct zfut     **zockets;
+    unsigned int      i;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_stack,
+                                           RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zfut, RPC_TYPE_NS_ZFUT,);
+
+    if (in->stacks.stacks_len != in->zockets.zockets_len)
+    {
+        out->common._errno = TE_RC(TE_TA_UNIX, TE_EINVAL);
+        out->retval = -1;
+        return;
+    }
+
+    /*
+     * Check pointers before allocating memory, otherwise it is leaked
+     * if some pointer is invalid.
+     */
+    for (i = 0; i < in->zockets.zockets_len; i++)
+    {
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stacks.stacks_val[i],
+                                     ns_stack,);
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(zocket, in->zockets.zockets_val[i],
+                                     ns_zfut,);
+    }
+
+    /* Thousands of zockets may be passed, so do not use the stack. */
+    stacks = TE_ALLOC(MAX(in->zockets.zockets_len, 1) * sizeof(*stacks));
+    zockets = TE_ALLOC(MAX(in->zockets.zockets_len, 1) *
+                       sizeof(*zockets));
+    for (i = 0; i < in->zockets.zockets_len; i++)
+    {
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(stacks[i], in->stacks.stacks_val[i],
+                                     ns_stack,);
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(zockets[i],
+                                     in->zockets.zockets_val[i],
+                                     ns_zfut,);
+    }
+
+    out->sent.sent_len = in->zockets.zockets_len;
+    out->sent.sent_val = TE_ALLOC(MAX(out->sent.sent_len, 1) *
+                                  sizeof(*out->sent.sent_val));
+
+    MAKE_CALL(out->retval = func_ptr(stacks, zockets,
+                                     in->zockets.zockets_len,
+                                     in->send_func, in->dgram_size,
+                                     in->duration, out->sent.sent_val,
+                                     &out->stats));
+    free(stacks);
+    free(zockets);
+})
+
+/**
+ * Receive datagrams on a set of UDP RX zockets of the same stack for a
+ * given time. Every iteration calls zf_reactor_perform() once and then
+ * drains every zocket with zfur_zc_recv().
+ *
+ * @param stack       ZF stack.
+ * @param zockets     UDP RX zockets.
+ * @param num         Number of zockets.
+ * @param duration    How long to receive, milliseconds.
+ * @param dgrams      Where to save number of datagrams received on
+ *                    every zocket.
+ * @param stats       Where to save statistics.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_zfur_drain_bench(struct zf_stack *stack, struct zfur **zockets,
+                      int num, int duration, uint64_t *dgrams,
+                      tarpc_zfts_zfur_drain_stats *stats)
+{
+    api_func_ptr    recv_f;
+    api_func_ptr    done_f;
+    zfts_reactor_ctx reactor_ctx = ZFTS_REACTOR_CTX_INIT;
+    drain_bench_msg umsg;
+    uint64_t        start;
+    uint64_t        start_tsc;
+    uint64_t        deadline;
+    uint64_t        tsc;
+    te_bool         empty;
+    int             rc = 0;
+    int             i;
+    int             j;
+
+    if (num <= 0)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "number of zockets must be positive");
+        return -1;
+    }
+
+    TARPC_FIND_FUNC_RETURN(FALSE, "zfur_zc_recv", (api_func *)&recv_f);
+    TARPC_FIND_FUNC_RETURN(FALSE, "zfur_zc_recv_done",
+                           (api_func *)&done_f);
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_reactor_perform",
+                           (api_func *)&reactor_ctx.reactor_func);
+
+    memset(stats, 0, sizeof(*stats));
+    memset(dgrams, 0, num * sizeof(*dgrams));
+
+    start = zfts_time_ns();
+    start_tsc = zfts_tsc();
+    deadline = start + (uint64_t)duration * 1000000ULL;
+    while (zfts_time_ns() < deadline)
+    {
+        tsc = zfts_tsc();
+        rc = zfts_call_zf_reactor_perform(stack, &reactor_ctx);
+        stats->reactor_ns += zfts_tsc() - tsc;
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_reactor_perform() failed");
+            break;
+        }
+
+        for (i = 0; i < num; i++)
+        {
+            empty = TRUE;
+            while (TRUE)
+            {
+                umsg.msg.iovcnt = DRAIN_BENCH_IOVCNT;
+                recv_f(zockets[i], &umsg.msg, 0);
+                if (umsg.msg.iovcnt == 0)
+                    break;
+
+                for (j = 0; j < umsg.msg.iovcnt; j++)
+                    stats->bytes += umsg.iov[j].iov_len;
+                done_f(zockets[i], &umsg.msg);
+
+                dgrams[i]++;
+                stats->dgrams++;
+                empty = FALSE;
+            }
+
+            stats->polls++;
+            if (empty)
+                stats->empty_polls++;
+        }
+    }
+    stats->elapsed = zfts_time_ns() - start;
+
+    tsc = zfts_tsc() - start_tsc;
+    stats->reactor_ns = zfts_tsc2ns(stats->reactor_ns, stats->elapsed, tsc);
+
+    return rc < 0 ? -1 : 0;
+}
+
+TARPC_FUNC_STATIC(zfts_zfur_drain_bench, {},
+{
+    static rpc_ptr_id_namespace ns_stack = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zfur = RPC_PTR_ID_NS_INVALID;
+
+    struct zf_stack  *stack;
+    struct zfur      *zocket;
+    struct zfur     **zockets;
+    unsigned int      i;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_stack,
+                                           RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zfur, RPC_TYPE_NS_ZFUR,);
+
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns_stack,);
+
+    /*
+     * Check pointers before allocating memory, otherwise it is leaked
+     * if some pointer is invalid.
+     */
+    for (i = 0; i < in->zockets.zockets_len; i++)
+    {
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(zocket, in->zockets.zockets_val[i],
+                                     ns_zfur,);
+    }
+
+    /* Thousands of zockets may be passed, so do not use the stack. */
+    zockets = TE_ALLOC(MAX(in->zockets.zockets_len, 1) *
+                       sizeof(*zockets));
+    for (i = 0; i < in->zockets.zockets_len; i++)
+    {
+        RCF_PCH_MEM_INDEX_TO_PTR_RPC(zockets[i],
+                                     in->zockets.zockets_val[i],
+                                     ns_zfur,);
+    }
+
+    out->dgrams.dgrams_len = in->zockets.zockets_len;
+    out->dgrams.dgrams_val = TE_ALLOC(MAX(out->dgrams.dgrams_len, 1) *
+                                      sizeof(*out->dgrams.dgrams_val));
+
+    MAKE_CALL(out->retval = func_ptr(stack, zockets,
+                                     in->zockets.zockets_len,
+                                     in->duration, out->dgrams.dgrams_val,
+                                     &out->stats));
+    free(zockets);
+})
+
+/**
+ * Forward datagrams received on a UDP RX zocket with zfur_zc_recv() to
+ * a UDP TX zocket of the same stack without copying them (unless
+ * zfut_send_single() is used for a datagram in several vectors). When
+ * the send call reports @c EAGAIN, the received datagram is kept and
+ * the stack is processed until there is space to send it.
+ *
+ * @param stack       ZF stack.
+ * @param urx         UDP RX zocket.
+ * @param utx         UDP TX zocket.
+ * @param send_func   Send function.
+ * @param duration    How long to forward, milliseconds.
+ * @param stats       Where to save statistics.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_zfur_forward_bench(struct zf_stack *stack, struct zfur *urx,
+                        struct zfut *utx, zfts_send_function send_func,
+                        int duration, tarpc_zfts_zfur_forward_stats *stats)
+{
+    api_func_ptr    recv_f;
+    api_func_ptr    done_f;
+    api_func_ptr    send_f;
+    zfts_reactor_ctx reactor_ctx = ZFTS_REACTOR_CTX_INIT;
+    drain_bench_msg umsg;
+    char           *buf;
+    size_t          len;
+    uint64_t        start;
+    uint64_t        start_tsc;
+    uint64_t        stall_tsc;
+    uint64_t        deadline;
+    uint64_t        tsc;
+    int             rc = 0;
+    int             i;
+
+    if (zfut_get_send_function(send_func, &send_f) != 0)
+        return -1;
+    TARPC_FIND_FUNC_RETURN(FALSE, "zfur_zc_recv", (api_func *)&recv_f);
+    TARPC_FIND_FUNC_RETURN(FALSE, "zfur_zc_recv_done",
+                           (api_func *)&done_f);
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_reactor_perform",
+                           (api_func *)&reactor_ctx.reactor_func);
+
+    buf = TE_ALLOC(FORWARD_BENCH_BUF_SIZE);
+    memset(stats, 0, sizeof(*stats));
+
+    start = zfts_time_ns();
+    start_tsc = zfts_tsc();
+    deadline = start + (uint64_t)duration * 1000000ULL;
+    while (zfts_time_ns() < deadline)
+    {
+        rc = zfts_call_zf_reactor_perform(stack, &reactor_ctx);
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_reactor_perform() failed");
+            break;
+        }
+
+        umsg.msg.iovcnt = DRAIN_BENCH_IOVCNT;
+        recv_f(urx, &umsg.msg, 0);
+        if (umsg.msg.iovcnt == 0)
+            continue;
+
+        stats->received++;
+        for (i = 0, len = 0; i < umsg.msg.iovcnt; i++)
+            len += umsg.iov[i].iov_len;
+
+        if (send_func == ZFTS_ZFUT_SEND_SINGLE && umsg.msg.iovcnt > 1)
+        {
+            if (len > FORWARD_BENCH_BUF_SIZE)
+            {
+                done_f(urx, &umsg.msg);
+                te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EMSGSIZE),
+                                 "received datagram is too big");
+                rc = -1;
+                break;
+            }
+            for (i = 0, len = 0; i < umsg.msg.iovcnt; i++)
+            {
+                memcpy(buf + len, umsg.iov[i].iov_base,
+                       umsg.iov[i].iov_len);
+                len += umsg.iov[i].iov_len;
+            }
+        }
+
+        stall_tsc = 0;
+        while (TRUE)
+        {
+            if (send_func == ZFTS_ZFUT_SEND)
+                rc = send_f(utx, umsg.iov, umsg.msg.iovcnt, 0);
+            else if (umsg.msg.iovcnt == 1)
+                rc = send_f(utx, umsg.iov[0].iov_base, len);
+            else
+                rc = send_f(utx, buf, len);
+
+            if (rc != -EAGAIN)
+                break;
+
+            stats->again++;
+            if (stall_tsc == 0)
+                stall_tsc = zfts_tsc();
+            if (zfts_time_ns() >= deadline)
+                break;
+
+            /* Let the stack complete previous sends. */
+            if (zfts_call_zf_reactor_perform(stack, &reactor_ctx) < 0)
+                break;
+        }
+        if (stall_tsc != 0)
+            stats->stall_ns += zfts_tsc() - stall_tsc;
+
+        done_f(urx, &umsg.msg);
+
+        if (rc >= 0 && (size_t)rc == len)
+        {
+            stats->forwarded++;
+        }
+        else if (rc >= 0)
+        {
+            stats->partial++;
+            stats->dropped++;
+        }
+        else if (rc == -EAGAIN)
+        {
+            stats->dropped++;
+        }
+        else
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "send call failed");
+            break;
+        }
+        rc = 0;
+    }
+    stats->elapsed = zfts_time_ns() - start;
+
+    tsc = zfts_tsc() - start_tsc;
+    stats->stall_ns = zfts_tsc2ns(stats->stall_ns, stats->elapsed, tsc);
+
+    free(buf);
+    return rc < 0 ? -1 : 0;
+}
+
+TARPC_FUNC_STATIC(zfts_zfur_forward_bench, {},
+{
+    static rpc_ptr_id_namespace ns_stack = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zfur = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zfut = RPC_PTR_ID_NS_INVALID;
+
+    struct zf_stack *stack;
+    struct zfur     *urx;
+    struct zfut     *utx;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_stack,
+                                           RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zfur, RPC_TYPE_NS_ZFUR,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zfut, RPC_TYPE_NS_ZFUT,);
+
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns_stack,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(urx, in->urx, ns_zfur,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(utx, in->utx, ns_zfut,);
+
+    MAKE_CALL(out->retval = func_ptr(stack, urx, utx, in->send_func,
+                                     in->duration, &out->stats));
+})
+
+/**
+ * Send timestamped datagrams from one socket and receive them back on
+ * another one, measuring the time every datagram spent on the way.
+ * Latency samples are decimated when @p max_samples is reached, so
+ * that they cover the whole run evenly.
+ *
+ * @param snd_fd        Connected UDP socket to send from.
+ * @param rcv_fd        UDP socket to receive on (may be @p snd_fd).
+ * @param dgram_size    Size of every datagram.
+ * @param rate          Datagrams per second to send, @c 0 to send as
+ *                      fast as possible.
+ * @param duration      How long to send, milliseconds.
+ * @param max_samples   Maximum number of latency samples.
+ * @param stats         Where to save statistics.
+ * @param times         Where to save latency samples, ns.
+ * @param times_num     Where to save number of samples.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_sockets_udp_ts_flooder(int snd_fd, int rcv_fd, int dgram_size,
+                            int rate, int duration, int max_samples,
+                            tarpc_zfts_udp_ts_stats *stats,
+                            uint64_t *times, unsigned int *times_num)
+{
+    ts_flooder_hdr  hdr;
+    char           *buf;
+    uint64_t        start;
+    uint64_t        now;
+    uint64_t        send_end;
+    uint64_t        deadline;
+    uint64_t        next_seq = 0;
+    uint64_t        lat;
+    unsigned int    stride = 1;
+    unsigned int    i;
+    ssize_t         rc;
+
+    if (dgram_size < (int)sizeof(hdr) || max_samples <= 0 || rate < 0)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "invalid arguments");
+        return -1;
+    }
+
+    buf = TE_ALLOC(MAX(dgram_size, FORWARD_BENCH_BUF_SIZE));
+    memset(stats, 0, sizeof(*stats));
+    *times_num = 0;
+
+    start = zfts_time_ns();
+    send_end = start + (uint64_t)duration * 1000000ULL;
+    deadline = send_end + TS_FLOODER_GRACE * 1000000ULL;
+    while ((now = zfts_time_ns()) < deadline)
+    {
+        if (now < send_end &&
+            (rate == 0 ||
+             stats->sent * ZFTS_NSEC_PER_SEC / rate <= now - start))
+        {
+            hdr.seq = stats->sent;
+            hdr.ts = now;
+            memcpy(buf, &hdr, sizeof(hdr));
+            rc = send(snd_fd, buf, dgram_size, MSG_DONTWAIT);
+            if (rc == dgram_size)
+            {
+                stats->sent++;
+            }
+            else if (rc < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                stats->again++;
+            }
+            else
+            {
+                te_rpc_error_set(rc < 0 ? TE_OS_RC(TE_TA_UNIX, errno) :
+                                          TE_RC(TE_TA_UNIX, TE_EFAIL),
+                                 "send() failed");
+                free(buf);
+                return -1;
+            }
+        }
+
+        while ((rc = recv(rcv_fd, buf, FORWARD_BENCH_BUF_SIZE,
+                          MSG_DONTWAIT)) >= (ssize_t)sizeof(hdr))
+        {
+            memcpy(&hdr, buf, sizeof(hdr));
+            lat = zfts_time_ns() - hdr.ts;
+
+            stats->received++;
+            if (hdr.seq < next_seq)
+                stats->reordered++;
+            else
+                next_seq = hdr.seq + 1;
+            stats->lat_sum += lat;
+            stats->lat_max = MAX(stats->lat_max, lat);
+
+            if (stats->received % stride != 0)
+                continue;
+            if (*times_num == (unsigned int)max_samples)
+            {
+                for (i = 0; i < *times_num / 2; i++)
+                    times[i] = times[2 * i];
+                *times_num /= 2;
+                stride *= 2;
+                if (stats->received % stride != 0)
+                    continue;
+            }
+            times[(*times_num)++] = lat;
+        }
+        if (rc < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, errno),
+                             "recv() failed");
+            free(buf);
+            return -1;
+        }
+    }
+    stats->elapsed = MIN(now, send_end) - start;
+
+    free(buf);
+    return 0;
+}
+
+TARPC_FUNC_STATIC(zfts_sockets_udp_ts_flooder, {},
+{
+    unsigned int times_num = 0;
+
+    if (in->max_samples <= 0)
+    {
+        out->common._errno = TE_RC(TE_TA_UNIX, TE_EINVAL);
+        out->retval = -1;
+        return;
+    }
+
+    out->times.times_val = TE_ALLOC(in->max_samples *
+                                    sizeof(*out->times.times_val));
+
+    MAKE_CALL(out->retval = func_ptr(in->snd_fd, in->rcv_fd,
+                                     in->dgram_size, in->rate,
+                                     in->duration, in->max_samples,
+                                     &out->stats, out->times.times_val,
+                                     &times_num));
+    out->times.times_len = times_num;
+})
+
+/**
+ * Send datagrams of a fixed size split into a number of vectors for a
+ * given time, measuring send calls and, in @c ZFTS_SG_LINEARISE mode,
+ * copying of the vectors to a contiguous buffer. Every vector points
+ * to a separately allocated buffer, as when a message is assembled from
+ * several application buffers.
+ *
+ * @param stack       ZF stack.
+ * @param utx         UDP TX zocket.
+ * @param mode        How a datagram is passed to a send call.
+ * @param dgram_size  Size of every datagram.
+ * @param iovcnt      Number of vectors.
+ * @param duration    How long to send, milliseconds.
+ * @param stats       Where to save statistics.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_zfut_sg_bench(struct zf_stack *stack, struct zfut *utx,
+                   zfts_sg_mode mode, int dgram_size, int iovcnt,
+                   int duration, tarpc_zfts_zfut_sg_stats *stats)
+{
+    api_func_ptr    send_f;
+    zfts_reactor_ctx reactor_ctx = ZFTS_REACTOR_CTX_INIT;
+    struct iovec   *iov;
+    struct iovec    lin_iov;
+    char           *buf;
+    uint64_t        start;
+    uint64_t        start_tsc;
+    uint64_t        deadline;
+    uint64_t        tsc;
+    size_t          off;
+    int             rc = 0;
+    int             i;
+
+    if (iovcnt <= 0 || dgram_size < iovcnt)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "iovcnt must be positive and not greater than "
+                         "datagram size");
+        return -1;
+    }
+
+    if (zfut_get_send_function(mode == ZFTS_SG_SINGLE ?
+                                    ZFTS_ZFUT_SEND_SINGLE : ZFTS_ZFUT_SEND,
+                               &send_f) != 0)
+        return -1;
+    TARPC_FIND_FUNC_RETURN(FALSE, "zf_reactor_perform",
+                           (api_func *)&reactor_ctx.reactor_func);
+
+    iov = TE_ALLOC(iovcnt * sizeof(*iov));
+    for (i = 0; i < iovcnt; i++)
+    {
+        iov[i].iov_len = (i == iovcnt - 1) ?
+                            dgram_size - (size_t)dgram_size / iovcnt * i :
+                            (size_t)dgram_size / iovcnt;
+        iov[i].iov_base = TE_ALLOC(iov[i].iov_len);
+    }
+    buf = TE_ALLOC(dgram_size);
+    lin_iov.iov_base = buf;
+    lin_iov.iov_len = dgram_size;
+
+    memset(stats, 0, sizeof(*stats));
+
+    start = zfts_time_ns();
+    start_tsc = zfts_tsc();
+    deadline = start + (uint64_t)duration * 1000000ULL;
+    while (zfts_time_ns() < deadline)
+    {
+        rc = zfts_call_zf_reactor_perform(stack, &reactor_ctx);
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zf_reactor_perform() failed");
+            break;
+        }
+
+        if (mode == ZFTS_SG_LINEARISE)
+        {
+            tsc = zfts_tsc();
+            for (i = 0, off = 0; i < iovcnt; i++)
+            {
+                memcpy(buf + off, iov[i].iov_base, iov[i].iov_len);
+                off += iov[i].iov_len;
+            }
+            stats->copy_ns += zfts_tsc() - tsc;
+        }
+
+        tsc = zfts_tsc();
+        switch (mode)
+        {
+            case ZFTS_SG_IOV:
+                rc = send_f(utx, iov, iovcnt, 0);
+                break;
+
+            case ZFTS_SG_LINEARISE:
+                rc = send_f(utx, &lin_iov, 1, 0);
+                break;
+
+            default:
+                rc = send_f(utx, buf, dgram_size);
+        }
+        stats->send_ns += zfts_tsc() - tsc;
+        stats->sends++;
+
+        if (rc == dgram_size)
+        {
+            stats->sent++;
+        }
+        else if (rc == -EAGAIN)
+        {
+            stats->again++;
+        }
+        else
+        {
+            te_rpc_error_set(rc < 0 ? TE_OS_RC(TE_TA_UNIX, -rc) :
+                                      TE_RC(TE_TA_UNIX, TE_EFAIL),
+                             "send call returned unexpected value %d",
+                             rc);
+            rc = -1;
+            break;
+        }
+        rc = 0;
+    }
+    stats->elapsed = zfts_time_ns() - start;
+
+    tsc = zfts_tsc() - start_tsc;
+    stats->send_ns = zfts_tsc2ns(stats->send_ns, stats->elapsed, tsc);
+    stats->copy_ns = zfts_tsc2ns(stats->copy_ns, stats->elapsed, tsc);
+
+    for (i = 0; i < iovcnt; i++)
+        free(iov[i].iov_base);
+    free(iov);
+    free(buf);
+    return rc < 0 ? -1 : 0;
+}
+
+TARPC_FUNC_STATIC(zfts_zfut_sg_bench, {},
+{
+    static rpc_ptr_id_namespace ns_stack = RPC_PTR_ID_NS_INVALID;
+    static rpc_ptr_id_namespace ns_zfut = RPC_PTR_ID_NS_INVALID;
+
+    struct zf_stack *stack;
+    struct zfut     *utx;
+
+    out->common._errno = TE_RC(TE_RCF_PCH, TE_EFAIL);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_stack,
+                                           RPC_TYPE_NS_ZF_STACK,);
+    RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns_zfut, RPC_TYPE_NS_ZFUT,);
+
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(stack, in->stack, ns_stack,);
+    RCF_PCH_MEM_INDEX_TO_PTR_RPC(utx, in->utx, ns_zfut,);
+
+    MAKE_CALL(out->retval = func_ptr(stack, utx, in->mode,
+                                     in->dgram_size, in->iovcnt,
+                                     in->duration, &out->stats));
+})
+
+/**
+ * Send datagrams from a connected socket at a given rate until either
+ * a given number of datagrams is sent or a given time passes. Send
+ * calls failing with @c EAGAIN or @c ENOBUFS are retried.
+ *
+ * @param fd            Connected UDP socket.
+ * @param dgram_size    Size of every datagram.
+ * @param rate          Datagrams per second, @c 0 to send as fast as
+ *                      possible.
+ * @param count         Number of datagrams to send, @c 0 for no limit.
+ * @param duration      Maximum time of sending, milliseconds.
+ * @param stats         Where to save statistics.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+static int
+zfts_sockets_udp_paced_send(int fd, int dgram_size, int rate,
+                            uint64_t count, int duration,
+                            tarpc_zfts_udp_paced_stats *stats)
+{
+    char       *buf;
+    uint64_t    start;
+    uint64_t    now;
+    uint64_t    deadline;
+    ssize_t     rc;
+
+    if (dgram_size <= 0 || rate < 0)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "invalid arguments");
+        return -1;
+    }
+
+    buf = TE_ALLOC(dgram_size);
+    memset(stats, 0, sizeof(*stats));
+
+    start = zfts_time_ns();
+    deadline = start + (uint64_t)duration * 1000000ULL;
+    while ((count == 0 || stats->sent < count) &&
+           (now = zfts_time_ns()) < deadline)
+    {
+        if (rate != 0 &&
+            stats->sent * ZFTS_NSEC_PER_SEC / rate > now - start)
+            continue;
+
+        rc = send(fd, buf, dgram_size, MSG_DONTWAIT);
+        if (rc == dgram_size)
+        {
+            stats->sent++;
+        }
+        else if (rc < 0 && (errno == EAGAIN || errno == EWOULDBLOCK ||
+                            errno == ENOBUFS))
+        {
+            stats->again++;
+        }
+        else
+        {
+            te_rpc_error_set(rc < 0 ? TE_OS_RC(TE_TA_UNIX, errno) :
+                                      TE_RC(TE_TA_UNIX, TE_EFAIL),
+                             "send() failed");
+            free(buf);
+            return -1;
+        }
+    }
+    stats->elapsed = zfts_time_ns() - start;
+
+    free(buf);
+    return 0;
+}
+
+TARPC_FUNC_STATIC(zfts_sockets_udp_paced_send, {},
+{
+    MAKE_CALL(out->retval = func_ptr(in->fd, in->dgram_size, in->rate,
+                                     in->count, in->duration,
+                                     &out->stats));
+})
@@ -82,7 +82,10 @@ TARPC_FUNC(zfur_alloc, {},
     TE_RPC_CONVERT_NEGATIVE_ERR(out->retval);
 
     if (out->retval == 0)
+    {
         out->urx = RCF_PCH_MEM_INDEX_ALLOC(us_out, ns_zfur);
+        zfts_stack_zocket_add(stack, us_out);
+    }
 })
 
 TARPC_FUNC(zfur_free, {},
@@ -98,7 +101,10 @@ TARPC_FUNC(zfur_free, {},
     MAKE_CALL(out->retval = func_ptr(us));
     TE_RPC_CONVERT_NEGATIVE_ERR(out->retval);
     if (out->retval == 0)
+    {
+        zfts_stack_zocket_del(us);
         RCF_PCH_MEM_INDEX_FREE(in->urx, ns);
+    }
 })
 
 TARPC_FUNC(zfur_addr_bind,
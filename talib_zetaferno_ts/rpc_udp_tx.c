@@ -76,7 +76,10 @@ TARPC_FUNC(zfut_alloc, {},
     TE_RPC_CONVERT_NEGATIVE_ERR(out->retval);
 
     if (out->retval == 0)
+    {
         out->utx = RCF_PCH_MEM_INDEX_ALLOC(us_out, ns_zfut);
+        zfts_stack_zocket_add(stack, us_out);
+    }
 })
 
 TARPC_FUNC(zfut_free, {},
@@ -88,10 +91,14 @@ TARPC_FUNC(zfut_free, {},
     RCF_PCH_MEM_NS_CREATE_IF_NEEDED_RETURN(&ns, RPC_TYPE_NS_ZFUT,);
     RCF_PCH_MEM_INDEX_TO_PTR_RPC(us, in->utx, ns,);
 
+    zfts_tx_ts_collectors_forget(NULL, us);
     MAKE_CALL(out->retval = func_ptr(us));
     TE_RPC_CONVERT_NEGATIVE_ERR(out->retval);
     if (out->retval == 0)
+    {
+        zfts_stack_zocket_del(us);
         RCF_PCH_MEM_INDEX_FREE(in->utx, ns);
+    }
 })
 
 TARPC_FUNC(zfut_send, {},
@@ -216,21 +223,31 @@ zfut_get_send_function(zfts_send_function send_func, api_func_ptr *func)
  * @param stack         Zetaferno stack.
  * @param utx           UDP TX zocket.
  * @param send_func     Transmitting function.
- * @param dgram_size    Datagrams size, bytes.
+ * @param dgram_size    Datagrams size, bytes. If @p fill_frame is
+ *                      @c TRUE, it is added to the value returned by
+ *                      @b zfut_get_mss() to get datagrams size.
  * @param iovcnt        Iov vectors number.
  * @param duration      How long transmit datagrams, milliseconds.
+ * @param fill_frame    Size datagrams relative to the maximum payload
+ *                      fitting in one frame.
  * @param stats         Sent data amount, bytes.
  * @param errors        @c EAGAIN errors counter.
+ * @param size_used     Where to save datagrams size which was used.
+ * @param header_size   Where to save protocol headers size of a frame
+ *                      if @p fill_frame is @c TRUE (@c 0 otherwise).
  *
  * @return @c Zero on success or a negative value in case of fail.
  */
 int
 zfut_flooder(struct zf_stack *stack, struct zfut *utx,
              zfts_send_function send_func, int dgram_size, int iovcnt,
-             int duration, uint64_t *stats, uint64_t *errors)
+             int duration, te_bool fill_frame, uint64_t *stats,
+             uint64_t *errors, int *size_used, int *header_size)
 {
     api_func_ptr func_send;
     api_func_ptr process_events_func;
+    api_func_ptr get_mss_func;
+    api_func_ptr get_header_size_func;
     struct timeval tv_start;
     struct timeval tv_now;
     struct iovec  *iov;
@@ -254,6 +271,33 @@ zfut_flooder(struct zf_stack *stack, struct zfut *utx,
 
     *stats = 0;
     *errors = 0;
+    *header_size = 0;
+
+    if (fill_frame)
+    {
+        TARPC_FIND_FUNC_RETURN(FALSE, "zfut_get_mss",
+                               (api_func *)&get_mss_func);
+        TARPC_FIND_FUNC_RETURN(FALSE, "zfut_get_header_size",
+                               (api_func *)&get_header_size_func);
+
+        rc = get_mss_func(utx);
+        if (rc < 0)
+        {
+            te_rpc_error_set(TE_OS_RC(TE_TA_UNIX, -rc),
+                             "zfut_get_mss() failed");
+            return -1;
+        }
+        dgram_size += rc;
+        *header_size = get_header_size_func(utx);
+    }
+    *size_used = dgram_size;
+
+    if (dgram_size <= 0)
+    {
+        te_rpc_error_set(TE_RC(TE_TA_UNIX, TE_EINVAL),
+                         "dgram_size should be positive");
+        return -1;
+    }
 
     if ((rc = gettimeofday(&tv_start, NULL)) != 0)
     {
@@ -362,8 +406,10 @@ TARPC_FUNC_STATIC(zfut_flooder, {},
 
     MAKE_CALL(out->retval = func_ptr(stack, utx, in->send_func,
                                      in->dgram_size, in->iovcnt,
-                                     in->duration, &out->stats,
-                                     &out->errors));
+                                     in->duration, in->fill_frame,
+                                     &out->stats, &out->errors,
+                                     &out->dgram_size,
+                                     &out->header_size));
 })
 
 TARPC_FUNC(zfut_get_header_size, {},
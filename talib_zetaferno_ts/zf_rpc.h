@@ -14,9 +14,70 @@
 #ifndef __ZF_RPC_H__
 #define __ZF_RPC_H__
 
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
 #include <zf/zf.h>
 #include <etherfabric/ef_vi.h>
 
+/** Number of nanoseconds in a second */
+#define ZFTS_NSEC_PER_SEC 1000000000ULL
+
+/**
+ * Get current value of the monotonic clock. It is used to measure
+ * duration of ZF calls in agent-side benchmark loops.
+ *
+ * @return Time in nanoseconds.
+ */
+static inline uint64_t
+zfts_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * ZFTS_NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * Read CPU time stamp counter. On architectures where it is not
+ * available, monotonic clock in nanoseconds is returned instead.
+ *
+ * @return Counter value.
+ */
+static inline uint64_t
+zfts_tsc(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return zfts_time_ns();
+#endif
+}
+
+/**
+ * Convert a number of zfts_tsc() ticks to nanoseconds, given that
+ * @p ref_ticks ticks were counted during @p ref_ns nanoseconds (usually
+ * the whole duration of a benchmark loop). Multiplication is done in
+ * long double since ticks multiplied by nanoseconds overflow 64 bits
+ * after a couple of seconds.
+ *
+ * @param ticks       Ticks to convert.
+ * @param ref_ns      Reference duration in nanoseconds.
+ * @param ref_ticks   Ticks counted during @p ref_ns.
+ *
+ * @return Nanoseconds (@p ticks if @p ref_ticks is zero).
+ */
+static inline uint64_t
+zfts_tsc2ns(uint64_t ticks, uint64_t ref_ns, uint64_t ref_ticks)
+{
+    if (ref_ticks == 0)
+        return ticks;
+
+    return (uint64_t)((long double)ticks * ref_ns / ref_ticks);
+}
+
 static inline int
 zf_zc_flags_rpc2h(int rpc_flags)
 {
@@ -181,4 +242,120 @@ extern int process_pkt_reports(struct zf_pkt_report *reports,
                                tarpc_zf_pkt_report *tarpc_reports,
                                size_t reports_num, int count);
 
+/**
+ * State kept by a caller repeatedly calling zf_reactor_perform() with
+ * zfts_call_zf_reactor_perform(), so that ZF functions are resolved
+ * and reactor profile of the stack is looked up only once.
+ */
+typedef struct zfts_reactor_ctx {
+    api_func_ptr         reactor_func;      /**< zf_reactor_perform() */
+    api_func_ptr         has_pending_func;  /**< zf_stack_has_pending_work()
+                                                 */
+    struct zf_stack     *stack;             /**< Stack for which @p prof
+                                                 was looked up */
+    struct reactor_prof *prof;              /**< Reactor profile of
+                                                 @p stack or @c NULL */
+} zfts_reactor_ctx;
+
+/** Initializer for zfts_reactor_ctx */
+#define ZFTS_REACTOR_CTX_INIT { NULL, NULL, NULL, NULL }
+
+/**
+ * Call zf_reactor_perform(); call zf_stack_has_pending_work() before
+ * that if required. The call is accounted in reactor profile of the
+ * stack if profiling is enabled, and TX packet reports are retrieved
+ * for collectors of the stack zockets after it. All the agent loops
+ * calling zf_reactor_perform() should use this function.
+ *
+ * @param stack     Pointer to ZF stack.
+ * @param ctx       Caller context initialized with
+ *                  @c ZFTS_REACTOR_CTX_INIT and reused for all the
+ *                  calls made by the caller (may be @c NULL for
+ *                  a single call). Passing another stack with the
+ *                  same context makes it look up the profile again.
+ *
+ * @return Return value of zf_reactor_perform() on success,
+ *         negative value in case of failure.
+ */
+extern int zfts_call_zf_reactor_perform(struct zf_stack *stack,
+                                        zfts_reactor_ctx *ctx);
+
+/**
+ * Retrieve TX packet reports of all the zockets of a stack having
+ * a TX timestamps collector started. It is called after each
+ * zf_reactor_perform() call made by the agent.
+ *
+ * @param stack     ZF stack.
+ */
+extern void zfts_tx_ts_collectors_drain(struct zf_stack *stack);
+
+/**
+ * Detach TX timestamps collectors from a zocket or from all the zockets
+ * of a stack before it is released, so that they are not drained any
+ * more. Detached collectors keep their statistics and reports until
+ * they are stopped.
+ *
+ * @param stack     ZF stack (used if @p zocket is @c NULL).
+ * @param zocket    zfut or zft zocket or @c NULL.
+ */
+extern void zfts_tx_ts_collectors_forget(struct zf_stack *stack,
+                                         const void *zocket);
+
+/**
+ * Register a zocket allocated via RPC on a stack, so that the stack
+ * is not parked in the stack pool while the zocket is alive. Zockets
+ * of unknown stacks are ignored.
+ *
+ * @param stack     ZF stack.
+ * @param zocket    zfur, zfut, zftl, zft or zft_handle.
+ */
+extern void zfts_stack_zocket_add(struct zf_stack *stack,
+                                  const void *zocket);
+
+/**
+ * Register a zocket allocated on the same stack as another registered
+ * zocket (e.g. a zft accepted from a zftl, or a zft connected from a
+ * zft_handle). Nothing is done if @p peer is not registered.
+ *
+ * @param peer      Registered zocket.
+ * @param zocket    Zocket to register.
+ */
+extern void zfts_stack_zocket_add_sibling(const void *peer,
+                                          const void *zocket);
+
+/**
+ * Unregister a zocket when it is released. Nothing is done if
+ * the zocket is not registered.
+ *
+ * @param zocket    Zocket pointer.
+ */
+extern void zfts_stack_zocket_del(const void *zocket);
+
+/**
+ * Register a muxer set allocated via RPC on a stack, so that the stack
+ * is not parked in the stack pool while the muxer set is alive.
+ *
+ * @param stack       ZF stack.
+ * @param muxer_set   Muxer set.
+ */
+extern void zfts_stack_muxer_add(struct zf_stack *stack,
+                                 const void *muxer_set);
+
+/**
+ * Unregister a muxer set when it is released. Nothing is done if
+ * the muxer set is not registered.
+ *
+ * @param muxer_set   Muxer set.
+ */
+extern void zfts_stack_muxer_del(const void *muxer_set);
+
+/**
+ * Update number of alternatives allocated via RPC on a stack.
+ *
+ * @param stack     ZF stack.
+ * @param delta     @c 1 when an alternative is allocated, @c -1 when
+ *                  it is released.
+ */
+extern void zfts_stack_alts_add(struct zf_stack *stack, int delta);
+
 #endif /* !__ZF_RPC_H__ */
@@ -297,12 +297,15 @@ struct tarpc_zfut_flooder_in {
     tarpc_int               dgram_size;
     tarpc_int               iovcnt;
     tarpc_int               duration;
+    tarpc_bool              fill_frame;
 };
 
 struct tarpc_zfut_flooder_out {
     struct tarpc_out_arg    common;
     uint64_t                stats;
     uint64_t                errors;
+    tarpc_int               dgram_size;
+    tarpc_int               header_size;
     tarpc_int               retval;
 };
 
@@ -752,6 +755,60 @@ struct tarpc_zf_muxer_mod_rearm_in {
 
 typedef struct tarpc_int_retval_out tarpc_zf_muxer_mod_rearm_out;
 
+/**
+ * Operations which can be applied by zf_muxer_bulk() to a list
+ * of waitables.
+ */
+enum zfts_muxer_bulk_op {
+    ZFTS_MUXER_BULK_ADD = 0,    /**< zf_muxer_add() */
+    ZFTS_MUXER_BULK_MOD,        /**< zf_muxer_mod() */
+    ZFTS_MUXER_BULK_DEL         /**< zf_muxer_del() */
+};
+
+struct tarpc_zf_muxer_bulk_in {
+    struct tarpc_in_arg       common;
+    tarpc_ptr                 muxer_set;
+    zfts_muxer_bulk_op        op;
+    tarpc_ptr                 waitables<>;
+    tarpc_uint                events;
+};
+
+struct tarpc_zf_muxer_bulk_out {
+    struct tarpc_out_arg    common;
+    uint64_t                duration;
+    uint64_t                max_duration;
+    tarpc_int               retval;
+};
+
+/** Statistics gathered by zf_muxer_wait_bench() */
+struct tarpc_zf_muxer_wait_stats {
+    uint64_t    calls;              /**< Number of zf_muxer_wait() calls */
+    uint64_t    calls_with_events;  /**< Number of calls which returned
+                                         events */
+    uint64_t    events;             /**< Total number of events */
+    uint64_t    max_events;         /**< Maximum number of events
+                                         returned by a single call */
+    uint64_t    duration;           /**< Time spent in all calls, ns */
+    uint64_t    events_duration;    /**< Time spent in calls which
+                                         returned events, ns */
+    uint64_t    max_duration;       /**< Maximum duration of a single
+                                         call, ns */
+};
+
+struct tarpc_zf_muxer_wait_bench_in {
+    struct tarpc_in_arg       common;
+    tarpc_ptr                 muxer_set;
+    tarpc_int                 maxevents;
+    tarpc_int                 exp_events;
+    tarpc_int                 duration;
+};
+
+struct tarpc_zf_muxer_wait_bench_out {
+    struct tarpc_out_arg              common;
+    struct tarpc_zf_muxer_wait_stats  stats;
+    tarpc_int                         retval;
+};
+
 struct tarpc_zf_alternatives_alloc_in {
     struct tarpc_in_arg common;
 
@@ -816,6 +873,34 @@ struct tarpc_zf_alternatives_free_space_out {
     tarpc_uint              retval;
 };
 
+/* Histogram of durations of calls made by the agent reactor loops */
+struct tarpc_zfts_reactor_hist {
+    uint64_t    calls;          /**< Number of calls */
+    uint64_t    ticks;          /**< Total duration, TSC ticks */
+    uint64_t    max;            /**< Maximum duration, TSC ticks */
+    uint64_t    buckets[64];    /**< Bucket i counts calls which took
+                                     [2^i, 2^(i+1)) ticks */
+};
+
+struct tarpc_zfts_reactor_profile {
+    struct tarpc_zfts_reactor_hist  events;
+    struct tarpc_zfts_reactor_hist  idle;
+    struct tarpc_zfts_reactor_hist  has_pending;
+    uint64_t                        tsc_hz;
+};
+
+struct tarpc_zfts_reactor_profile_get_in {
+    struct tarpc_in_arg common;
+    tarpc_ptr           stack;
+    tarpc_bool          reset;
+};
+
+struct tarpc_zfts_reactor_profile_get_out {
+    struct tarpc_out_arg                common;
+    struct tarpc_zfts_reactor_profile   prof;
+    tarpc_int                           retval;
+};
+
 struct tarpc_zf_many_threads_alloc_free_stack_in {
     struct tarpc_in_arg common;
     tarpc_ptr           attr;
@@ -828,6 +913,81 @@ struct tarpc_zf_many_threads_alloc_free_stack_out {
     tarpc_int               retval;
 };
 
+/* Latency of zf_stack_alloc() and zf_stack_free() calls of a thread */
+struct tarpc_zfts_stack_alloc_stats {
+    struct tarpc_zfts_reactor_hist  alloc;  /**< Successful
+                                                 zf_stack_alloc() */
+    struct tarpc_zfts_reactor_hist  free;   /**< zf_stack_free() */
+    uint64_t                        failed; /**< Failed zf_stack_alloc()
+                                                 calls */
+};
+
+struct tarpc_zfts_stack_alloc_free_bench_in {
+    struct tarpc_in_arg common;
+    tarpc_ptr           attr;
+    tarpc_int           threads_num;
+    tarpc_int           iterations;
+    tarpc_int           live_stacks;
+};
+
+struct tarpc_zfts_stack_alloc_free_bench_out {
+    struct tarpc_out_arg                    common;
+    struct tarpc_zfts_stack_alloc_stats     stats<>;
+    tarpc_int                               live_allocated;
+    uint64_t                                tsc_hz;
+    tarpc_int                               retval;
+};
+
+/* Statistics of the pool of ZF stacks reused by tests */
+struct tarpc_zfts_stack_pool_stats {
+    uint64_t    allocs;     /**< Stacks allocated through the pool */
+    uint64_t    alloc_ns;   /**< Total duration of the allocations */
+    uint64_t    reuses;     /**< Parked stacks given to tests */
+    uint64_t    parks;      /**< Stacks parked by tests */
+    uint64_t    rejects;    /**< Stacks not parked since they were not
+                                 quiescent or the pool was full */
+    uint64_t    frees;      /**< Parked stacks released when draining */
+    uint64_t    free_ns;    /**< Total duration of the releases */
+};
+
+typedef struct tarpc_void_in tarpc_zfts_stack_pool_get_in;
+
+struct tarpc_zfts_stack_pool_get_out {
+    struct tarpc_out_arg    common;
+    tarpc_ptr               stack;
+    tarpc_int               retval;
+};
+
+struct tarpc_zfts_stack_pool_alloc_in {
+    struct tarpc_in_arg common;
+    tarpc_ptr           attr;
+};
+
+struct tarpc_zfts_stack_pool_alloc_out {
+    struct tarpc_out_arg    common;
+    tarpc_ptr               stack;
+    tarpc_int               retval;
+};
+
+struct tarpc_zfts_stack_pool_park_in {
+    struct tarpc_in_arg common;
+    tarpc_ptr           stack;
+};
+
+struct tarpc_zfts_stack_pool_park_out {
+    struct tarpc_out_arg    common;
+    tarpc_bool              parked;
+    tarpc_int               retval;
+};
+
+typedef struct tarpc_void_in tarpc_zfts_stack_pool_drain_in;
+
+struct tarpc_zfts_stack_pool_drain_out {
+    struct tarpc_out_arg                common;
+    struct tarpc_zfts_stack_pool_stats  stats;
+    tarpc_int                           retval;
+};
+
 enum tarpc_zf_sync_flags {
     TARPC_ZF_SYNC_FLAG_CLOCK_SET = 0x1,
     TARPC_ZF_SYNC_FLAG_CLOCK_IN_SYNC = 0x2
@@ -1013,6 +1173,735 @@ struct tarpc_zf_delegated_send_cancel_in {
 typedef struct tarpc_int_retval_out
     tarpc_zf_delegated_send_cancel_out;
 
+/**
+ * Types of zockets which can be created in bulk.
+ */
+enum zfts_bulk_zocket_type {
+    ZFTS_BULK_ZOCKET_URX = 0,   /**< UDP RX zocket */
+    ZFTS_BULK_ZOCKET_UTX,       /**< UDP TX zocket */
+    ZFTS_BULK_ZOCKET_ZFTL,      /**< TCP listening zocket */
+    ZFTS_BULK_ZOCKET_ZFT_ACT,   /**< Actively opened TCP zocket */
+    ZFTS_BULK_ZOCKET_ZFT_PAS    /**< Passively opened TCP zocket (can be
+                                     obtained only with
+                                     zfts_zftl_bulk_accept()) */
+};
+
+struct tarpc_zfts_zockets_bulk_alloc_in {
+    struct tarpc_in_arg     common;
+    tarpc_ptr               stack;
+    tarpc_ptr               attr;
+    zfts_bulk_zocket_type   type;
+    tarpc_int               count;
+    struct tarpc_sa         laddr;
+    struct tarpc_sa         raddr;
+    tarpc_int               timeout;
+};
+
+struct tarpc_zfts_zockets_bulk_alloc_out {
+    struct tarpc_out_arg    common;
+    tarpc_ptr               zockets<>;
+    tarpc_ptr               waitables<>;
+    tarpc_int               retval;
+};
+
+struct tarpc_zfts_zockets_bulk_free_in {
+    struct tarpc_in_arg     common;
+    zfts_bulk_zocket_type   type;
+    tarpc_ptr               zockets<>;
+    tarpc_ptr               waitables<>;
+};
+
+typedef struct tarpc_int_retval_out tarpc_zfts_zockets_bulk_free_out;
+
+struct tarpc_zfts_zftl_bulk_accept_in {
+    struct tarpc_in_arg     common;
+    tarpc_ptr               stack;
+    tarpc_ptr               zftl;
+    tarpc_int               count;
+    tarpc_int               timeout;
+};
+
+struct tarpc_zfts_zftl_bulk_accept_out {
+    struct tarpc_out_arg    common;
+    tarpc_ptr               zockets<>;
+    tarpc_ptr               waitables<>;
+    struct tarpc_sa         raddrs<>;
+    tarpc_int               retval;
+};
+
+struct tarpc_zfts_sockets_bulk_create_in {
+    struct tarpc_in_arg     common;
+    tarpc_int               domain;
+    tarpc_int               type;
+    tarpc_int               count;
+    struct tarpc_sa         laddr;
+    struct tarpc_sa         raddr;
+};
+
+struct tarpc_zfts_sockets_bulk_create_out {
+    struct tarpc_out_arg    common;
+    tarpc_int               fds<>;
+    tarpc_int               retval;
+};
+
+struct tarpc_zfts_sockets_bulk_accept_in {
+    struct tarpc_in_arg     common;
+    tarpc_int               fd;
+    tarpc_int               count;
+    tarpc_int               timeout;
+};
+
+struct tarpc_zfts_sockets_bulk_accept_out {
+    struct tarpc_out_arg    common;
+    tarpc_int               fds<>;
+    struct tarpc_sa         raddrs<>;
+    tarpc_int               retval;
+};
+
+/** Peer socket and address to which it should send data */
+struct tarpc_zfts_peer {
+    tarpc_int       fd;
+    struct tarpc_sa dst;
+};
+
+struct tarpc_zfts_sockets_bulk_send_in {
+    struct tarpc_in_arg     common;
+    struct tarpc_zfts_peer  peers<>;
+    tarpc_size_t            len;
+};
+
+typedef struct tarpc_int_retval_out tarpc_zfts_sockets_bulk_send_out;
+
+struct tarpc_zfts_sockets_bulk_close_in {
+    struct tarpc_in_arg     common;
+    tarpc_int               fds<>;
+};
+
+typedef struct tarpc_int_retval_out tarpc_zfts_sockets_bulk_close_out;
+
+/**
+ * Actions performed on a peer socket to invoke an event on a zocket.
+ */
+enum zfts_sock_event {
+    ZFTS_SOCK_EVENT_SEND = 0,   /**< Send data */
+    ZFTS_SOCK_EVENT_CONNECT,    /**< Start non-blocking connect */
+    ZFTS_SOCK_EVENT_DRAIN       /**< Read all the available data */
+};
+
+/** Action to be performed on a peer socket */
+struct tarpc_zfts_sock_event_req {
+    tarpc_int       fd;
+    zfts_sock_event event;
+    struct tarpc_sa addr;
+};
+
+/** Result of an action performed on a peer socket */
+struct tarpc_zfts_sock_event_res {
+    struct tarpc_sa addr;
+    uint8_t         data<>;
+};
+
+struct tarpc_zfts_sockets_bulk_invoke_in {
+    struct tarpc_in_arg                 common;
+    struct tarpc_zfts_sock_event_req    reqs<>;
+    uint8_t                             data<>;
+};
+
+struct tarpc_zfts_sockets_bulk_invoke_out {
+    struct tarpc_out_arg                common;
+    struct tarpc_zfts_sock_event_res    results<>;
+    tarpc_int                           retval;
+};
+
+struct tarpc_zfts_zft_bulk_establish_in {
+    struct tarpc_in_arg     common;
+    tarpc_ptr               stack;
+    tarpc_ptr               attr;
+    tarpc_ptr               zftl;
+    tarpc_int               count;
+    struct tarpc_sa         laddr;
+    struct tarpc_sa         raddr;
+    tarpc_int               timeout;
+};
+
+struct tarpc_zfts_zft_bulk_establish_out {
+    struct tarpc_out_arg    common;
+    tarpc_ptr               zockets<>;
+    struct tarpc_sa         laddrs<>;
+    struct tarpc_sa         raddrs<>;
+    uint64_t                times<>;
+    tarpc_int               retval;
+};
+
+struct tarpc_zfts_sockets_bulk_connect_in {
+    struct tarpc_in_arg     common;
+    tarpc_int               domain;
+    tarpc_int               count;
+    struct tarpc_sa         laddr;
+    struct tarpc_sa         raddr;
+    tarpc_int               sndbuf;
+    tarpc_int               rcvbuf;
+    tarpc_int               timeout;
+};
+
+struct tarpc_zfts_sockets_bulk_connect_out {
+    struct tarpc_out_arg    common;
+    tarpc_int               fds<>;
+    struct tarpc_sa         laddrs<>;
+    uint64_t                times<>;
+    tarpc_int               retval;
+};
+
+struct tarpc_zfts_sockets_bulk_set_flags_in {
+    struct tarpc_in_arg     common;
+    tarpc_int               fds<>;
+    tarpc_bool              nodelay;
+    tarpc_bool              nonblock;
+};
+
+typedef struct tarpc_int_retval_out tarpc_zfts_sockets_bulk_set_flags_out;
+
+/* TX timestamps collector statistics */
+struct tarpc_zfts_tx_ts_stats {
+    uint64_t    reports;        /**< Number of retrieved reports */
+    uint64_t    bytes;          /**< Total bytes in the reports */
+    uint64_t    dropped;        /**< Reports with DROPPED flag */
+    uint64_t    lost;           /**< Missing reports (UDP only) */
+    uint64_t    no_timestamp;   /**< Reports with NO_TIMESTAMP flag */
+    uint64_t    retrans;        /**< Reports with TCP_RETRANS flag */
+    uint64_t    overwritten;    /**< Reports overwritten in the ring */
+    uint64_t    polls;          /**< get_tx_timestamps() calls */
+    uint64_t    delay_num;      /**< Number of delay samples */
+    uint64_t    delay_sum;      /**< Sum of delays, ns */
+    uint64_t    delay_min;      /**< Minimum delay, ns */
+    uint64_t    delay_max;      /**< Maximum delay, ns */
+    uint64_t    gap_num;        /**< Number of gap samples */
+    uint64_t    gap_sum;        /**< Sum of gaps, ns */
+    uint64_t    gap_min;        /**< Minimum gap, ns */
+    uint64_t    gap_max;        /**< Maximum gap, ns */
+    uint64_t    ring_len;       /**< Reports currently in the ring */
+};
+
+struct tarpc_zfts_tx_ts_collector_start_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           stack;
+    tarpc_ptr           zocket;
+    tarpc_bool          udp;
+    tarpc_uint          ring_size;
+    tarpc_bool          on_demand;
+};
+
+struct tarpc_zfts_tx_ts_collector_start_out {
+    struct tarpc_out_arg    common;
+
+    tarpc_ptr               coll;
+    tarpc_int               retval;
+};
+
+struct tarpc_zfts_tx_ts_collector_stats_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           coll;
+};
+
+struct tarpc_zfts_tx_ts_collector_stats_out {
+    struct tarpc_out_arg            common;
+
+    struct tarpc_zfts_tx_ts_stats   stats;
+    tarpc_int                       retval;
+};
+
+struct tarpc_zfts_tx_ts_collector_read_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           coll;
+    tarpc_uint          max_num;
+};
+
+struct tarpc_zfts_tx_ts_collector_read_out {
+    struct tarpc_out_arg    common;
+
+    tarpc_zf_pkt_report     reports<>;
+    tarpc_int               retval;
+};
+
+struct tarpc_zfts_tx_ts_collector_drain_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           coll;
+    tarpc_uint          min_num;
+    tarpc_uint          max_num;
+    tarpc_bool          single_call;
+};
+
+typedef struct tarpc_int_retval_out tarpc_zfts_tx_ts_collector_drain_out;
+
+struct tarpc_zfts_tx_ts_collector_stop_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           coll;
+};
+
+typedef struct tarpc_int_retval_out tarpc_zfts_tx_ts_collector_stop_out;
+
+struct tarpc_zfts_tx_ts_paced_send_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           coll;
+    tarpc_uint          rate;
+    tarpc_uint          burst;
+    tarpc_uint          size;
+    tarpc_uint          duration;
+    tarpc_uint          drain_interval;
+};
+
+struct tarpc_zfts_tx_ts_paced_send_out {
+    struct tarpc_out_arg    common;
+
+    uint64_t                sent;
+    uint64_t                again;
+    uint64_t                elapsed;
+    tarpc_int               retval;
+};
+
+/* TCP connections churn statistics */
+struct tarpc_zfts_tcp_churn_stats {
+    uint64_t    established;    /**< Established connections */
+    uint64_t    closed;         /**< Closed connections */
+    uint64_t    failed;         /**< Connections failed to establish */
+    uint64_t    alloc_fails;    /**< Failures to allocate zocket or
+                                     socket */
+    uint64_t    teardown_ns;    /**< Time spent closing connections, ns */
+    uint64_t    elapsed;        /**< Time of the loop, ns */
+};
+
+struct tarpc_zfts_tcp_churn_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           stack;
+    tarpc_ptr           attr;
+    tarpc_ptr           zftl;
+    struct tarpc_sa     raddr;
+    tarpc_int           duration;
+    tarpc_int           concurrency;
+    tarpc_uint          max_times;
+};
+
+struct tarpc_zfts_tcp_churn_out {
+    struct tarpc_out_arg                common;
+
+    struct tarpc_zfts_tcp_churn_stats   stats;
+    uint64_t                            times<>;
+    tarpc_int                           retval;
+};
+
+struct tarpc_zfts_sockets_churn_in {
+    struct tarpc_in_arg common;
+
+    tarpc_int           listener;
+    struct tarpc_sa     laddr;
+    struct tarpc_sa     raddr;
+    tarpc_int           duration;
+    tarpc_int           concurrency;
+    tarpc_uint          max_times;
+};
+
+typedef struct tarpc_zfts_tcp_churn_out tarpc_zfts_sockets_churn_out;
+
+/* Receive benchmark statistics */
+struct tarpc_zfts_recv_bench_stats {
+    uint64_t    bytes;          /**< Received bytes */
+    uint64_t    bufs;           /**< Received buffers */
+    uint64_t    reactor_calls;  /**< zf_reactor_perform() calls */
+    uint64_t    reactor_events; /**< zf_reactor_perform() calls which
+                                     reported events */
+    uint64_t    reactor_ns;     /**< Time spent in zf_reactor_perform(),
+                                     ns */
+    uint64_t    recv_calls;     /**< Receive calls */
+    uint64_t    empty_calls;    /**< Receive calls which returned
+                                     nothing */
+    uint64_t    recv_ns;        /**< Time spent in receive calls
+                                     (including copying), ns */
+    uint64_t    done_calls;     /**< zc_recv_done() calls */
+    uint64_t    done_ns;        /**< Time spent in zc_recv_done()
+                                     calls, ns */
+    uint64_t    elapsed;        /**< Time of the loop, ns */
+};
+
+struct tarpc_zfts_recv_bench_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           stack;
+    tarpc_ptr           zocket;
+    tarpc_bool          udp;
+    tarpc_bool          copy;
+    tarpc_int           iovcnt;
+    tarpc_int           duration;
+};
+
+struct tarpc_zfts_recv_bench_out {
+    struct tarpc_out_arg                common;
+
+    struct tarpc_zfts_recv_bench_stats  stats;
+    tarpc_int                           retval;
+};
+
+/* TCP send benchmark statistics */
+struct tarpc_zfts_tcp_send_bench_stats {
+    uint64_t    writes;         /**< Successful writes */
+    uint64_t    bytes;          /**< Sent bytes */
+    uint64_t    again;          /**< Writes failed because send queue
+                                     was full */
+    uint64_t    flushes;        /**< Writes without MSG_MORE */
+    uint64_t    send_ns;        /**< Time spent in send calls, ns */
+    uint64_t    reactor_ns;     /**< Time spent in zf_reactor_perform(),
+                                     ns */
+    uint64_t    hold_ns;        /**< Estimated total time writes waited
+                                     for a segment to be sent, ns */
+    uint64_t    elapsed;        /**< Time of the loop, ns */
+};
+
+struct tarpc_zfts_tcp_send_bench_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           stack;
+    tarpc_ptr           zocket;
+    tarpc_int           size;
+    tarpc_bool          use_single;
+    tarpc_bool          more;
+    tarpc_int           flush_every;
+    tarpc_int           mss;
+    tarpc_int           duration;
+};
+
+struct tarpc_zfts_tcp_send_bench_out {
+    struct tarpc_out_arg                    common;
+
+    struct tarpc_zfts_tcp_send_bench_stats  stats;
+    tarpc_int                               retval;
+};
+
+/* TCP request/response statistics */
+struct tarpc_zfts_tcp_rr_stats {
+    uint64_t    transactions;   /**< Completed transactions */
+    uint64_t    sent;           /**< Sent bytes */
+    uint64_t    received;       /**< Received bytes */
+    uint64_t    again;          /**< Sending attempts failed because
+                                     send queue was full */
+    uint64_t    elapsed;        /**< Time of the loop, ns */
+};
+
+struct tarpc_zfts_tcp_rr_client_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           stack;
+    tarpc_ptr           zocket;
+    tarpc_int           req_size;
+    tarpc_int           resp_size;
+    tarpc_int           depth;
+    tarpc_int           duration;
+    tarpc_uint          max_times;
+};
+
+struct tarpc_zfts_tcp_rr_client_out {
+    struct tarpc_out_arg            common;
+
+    struct tarpc_zfts_tcp_rr_stats  stats;
+    uint64_t                        times<>;
+    tarpc_int                       retval;
+};
+
+struct tarpc_zfts_sockets_rr_server_in {
+    struct tarpc_in_arg common;
+
+    tarpc_int           fd;
+    tarpc_int           req_size;
+    tarpc_int           resp_size;
+    tarpc_int           duration;
+};
+
+struct tarpc_zfts_sockets_rr_server_out {
+    struct tarpc_out_arg            common;
+
+    struct tarpc_zfts_tcp_rr_stats  stats;
+    tarpc_int                       retval;
+};
+
+/* Sample of available TCP send space */
+struct tarpc_zfts_send_space_sample {
+    uint64_t    time;           /**< Time since the loop start, ns */
+    uint64_t    space;          /**< Value returned by zft_send_space() */
+};
+
+/* TCP send space benchmark statistics */
+struct tarpc_zfts_tcp_send_space_stats {
+    uint64_t    writes;         /**< Successful writes */
+    uint64_t    bytes;          /**< Sent bytes */
+    uint64_t    again;          /**< Writes failed because send queue
+                                     was full */
+    uint64_t    stalls;         /**< Sequences of failed writes */
+    uint64_t    stall_ns;       /**< Total duration of stalls, ns */
+    uint64_t    samples;        /**< Number of zft_send_space() calls */
+    uint64_t    space_sum;      /**< Sum of sampled send space */
+    uint64_t    min_space;      /**< Minimum sampled send space */
+    uint64_t    elapsed;        /**< Time of the loop, ns */
+};
+
+struct tarpc_zfts_tcp_send_space_bench_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           stack;
+    tarpc_ptr           zocket;
+    tarpc_int           size;
+    tarpc_int           sample_every;
+    tarpc_int           duration;
+    tarpc_uint          max_samples;
+};
+
+struct tarpc_zfts_tcp_send_space_bench_out {
+    struct tarpc_out_arg                    common;
+
+    struct tarpc_zfts_tcp_send_space_stats  stats;
+    struct tarpc_zfts_send_space_sample     samples<>;
+    tarpc_int                               retval;
+};
+
+/* Receive buffers exhaustion benchmark statistics */
+struct tarpc_zfts_rx_exhaust_stats {
+    uint64_t    held_bufs;      /**< Buffers held by not completed
+                                     zft_zc_recv() */
+    uint64_t    backlog_bufs;   /**< Buffers read from the victim after
+                                     releasing held ones until its queue
+                                     became empty */
+    tarpc_bool  released;       /**< Whether the victim queue became
+                                     empty after releasing held
+                                     buffers */
+    uint64_t    release_ns;     /**< Time from releasing held buffers
+                                     to emptying the victim queue, ns,
+                                     valid only if @b released */
+    uint64_t    elapsed;        /**< Time of the loop, ns */
+};
+
+struct tarpc_zfts_rx_exhaust_bench_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           stack;
+    tarpc_ptr           zockets<>;
+    tarpc_int           baseline;
+    tarpc_int           hold;
+    tarpc_int           release_bufs;
+    tarpc_int           release_interval;
+    tarpc_int           recovery;
+    tarpc_int           bucket;
+};
+
+struct tarpc_zfts_rx_exhaust_bench_out {
+    struct tarpc_out_arg                common;
+
+    struct tarpc_zfts_rx_exhaust_stats  stats;
+    uint64_t                            series<>;
+    tarpc_int                           retval;
+};
+
+/* UDP multicast fan-out benchmark statistics */
+struct tarpc_zfts_zfut_fanout_stats {
+    uint64_t    sends;          /**< Send calls */
+    uint64_t    again;          /**< Send calls failed with EAGAIN */
+    uint64_t    send_ns;        /**< Time spent in send calls, ns */
+    uint64_t    reactor_ns;     /**< Time spent in zf_reactor_perform(),
+                                     ns */
+    uint64_t    elapsed;        /**< Time of the loop, ns */
+};
+
+struct tarpc_zfts_zfut_fanout_bench_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           stacks<>;
+    tarpc_ptr           zockets<>;
+    zfts_send_function  send_func;
+    tarpc_int           dgram_size;
+    tarpc_int           duration;
+};
+
+struct tarpc_zfts_zfut_fanout_bench_out {
+    struct tarpc_out_arg                common;
+
+    struct tarpc_zfts_zfut_fanout_stats stats;
+    uint64_t                            sent<>;
+    tarpc_int                           retval;
+};
+
+/* zfts_zfur_bulk_bind() */
+struct tarpc_zfts_zfur_bulk_bind_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           urx;
+    struct tarpc_sa     laddrs<>;
+    struct tarpc_sa     raddrs<>;
+    tarpc_bool          unbind;
+    tarpc_int           flags;
+};
+
+struct tarpc_zfts_zfur_bulk_bind_out {
+    struct tarpc_out_arg    common;
+
+    uint64_t                times<>;
+    tarpc_int               retval;
+};
+
+/* UDP RX drain benchmark statistics */
+struct tarpc_zfts_zfur_drain_stats {
+    uint64_t    dgrams;         /**< Received datagrams */
+    uint64_t    bytes;          /**< Received bytes */
+    uint64_t    polls;          /**< Polls of all the zockets */
+    uint64_t    empty_polls;    /**< Polls which found nothing */
+    uint64_t    reactor_ns;     /**< Time spent in zf_reactor_perform(),
+                                     ns */
+    uint64_t    elapsed;        /**< Time of the loop, ns */
+};
+
+struct tarpc_zfts_zfur_drain_bench_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           stack;
+    tarpc_ptr           zockets<>;
+    tarpc_int           duration;
+};
+
+struct tarpc_zfts_zfur_drain_bench_out {
+    struct tarpc_out_arg                common;
+
+    struct tarpc_zfts_zfur_drain_stats  stats;
+    uint64_t                            dgrams<>;
+    tarpc_int                           retval;
+};
+
+/* UDP forwarder benchmark statistics */
+struct tarpc_zfts_zfur_forward_stats {
+    uint64_t    received;       /**< Datagrams received on UDP RX
+                                     zocket */
+    uint64_t    forwarded;      /**< Datagrams sent from UDP TX zocket */
+    uint64_t    again;          /**< Send calls failed with EAGAIN */
+    uint64_t    partial;        /**< Datagrams sent incompletely */
+    uint64_t    dropped;        /**< Received datagrams which were not
+                                     forwarded */
+    uint64_t    stall_ns;       /**< Time spent waiting for TX space,
+                                     ns */
+    uint64_t    elapsed;        /**< Time of the loop, ns */
+};
+
+struct tarpc_zfts_zfur_forward_bench_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           stack;
+    tarpc_ptr           urx;
+    tarpc_ptr           utx;
+    zfts_send_function  send_func;
+    tarpc_int           duration;
+};
+
+struct tarpc_zfts_zfur_forward_bench_out {
+    struct tarpc_out_arg                    common;
+
+    struct tarpc_zfts_zfur_forward_stats    stats;
+    tarpc_int                               retval;
+};
+
+/* Timestamped UDP flooder statistics */
+struct tarpc_zfts_udp_ts_stats {
+    uint64_t    sent;           /**< Sent datagrams */
+    uint64_t    again;          /**< Send calls failed with EAGAIN */
+    uint64_t    received;       /**< Received datagrams */
+    uint64_t    reordered;      /**< Datagrams received out of order */
+    uint64_t    lat_sum;        /**< Sum of latencies, ns */
+    uint64_t    lat_max;        /**< Maximum latency, ns */
+    uint64_t    elapsed;        /**< Time of sending, ns */
+};
+
+struct tarpc_zfts_sockets_udp_ts_flooder_in {
+    struct tarpc_in_arg common;
+
+    tarpc_int           snd_fd;
+    tarpc_int           rcv_fd;
+    tarpc_int           dgram_size;
+    tarpc_int           rate;
+    tarpc_int           duration;
+    tarpc_int           max_samples;
+};
+
+struct tarpc_zfts_sockets_udp_ts_flooder_out {
+    struct tarpc_out_arg            common;
+
+    struct tarpc_zfts_udp_ts_stats  stats;
+    uint64_t                        times<>;
+    tarpc_int                       retval;
+};
+
+/* How a datagram is passed to a send call in scatter-gather benchmark */
+enum zfts_sg_mode {
+    ZFTS_SG_IOV = 0,        /**< zfut_send() with vectors pointing to
+                                 separate buffers */
+    ZFTS_SG_LINEARISE,      /**< Copy the buffers to a contiguous one,
+                                 then zfut_send() with a single vector */
+    ZFTS_SG_SINGLE          /**< zfut_send_single() with a contiguous
+                                 buffer */
+};
+
+/* UDP scatter-gather send benchmark statistics */
+struct tarpc_zfts_zfut_sg_stats {
+    uint64_t    sends;          /**< Send calls */
+    uint64_t    sent;           /**< Datagrams sent */
+    uint64_t    again;          /**< Send calls failed with EAGAIN */
+    uint64_t    send_ns;        /**< Time spent in send calls, ns */
+    uint64_t    copy_ns;        /**< Time spent linearising datagrams,
+                                     ns */
+    uint64_t    elapsed;        /**< Time of the loop, ns */
+};
+
+struct tarpc_zfts_zfut_sg_bench_in {
+    struct tarpc_in_arg common;
+
+    tarpc_ptr           stack;
+    tarpc_ptr           utx;
+    zfts_sg_mode        mode;
+    tarpc_int           dgram_size;
+    tarpc_int           iovcnt;
+    tarpc_int           duration;
+};
+
+struct tarpc_zfts_zfut_sg_bench_out {
+    struct tarpc_out_arg            common;
+
+    struct tarpc_zfts_zfut_sg_stats stats;
+    tarpc_int                       retval;
+};
+
+/* Statistics of paced sending from a socket */
+struct tarpc_zfts_udp_paced_stats {
+    uint64_t    sent;           /**< Sent datagrams */
+    uint64_t    again;          /**< Send calls failed with EAGAIN or
+                                     ENOBUFS */
+    uint64_t    elapsed;        /**< Time of sending, ns */
+};
+
+struct tarpc_zfts_sockets_udp_paced_send_in {
+    struct tarpc_in_arg common;
+
+    tarpc_int           fd;
+    tarpc_int           dgram_size;
+    tarpc_int           rate;
+    uint64_t            count;
+    tarpc_int           duration;
+};
+
+struct tarpc_zfts_sockets_udp_paced_send_out {
+    struct tarpc_out_arg                common;
+
+    struct tarpc_zfts_udp_paced_stats   stats;
+    tarpc_int                           retval;
+};
+
 program zfrpc
 {
     version ver0
@@ -1087,6 +1976,8 @@ program zfrpc
         RPC_DEF(zf_waitable_fd_get)
         RPC_DEF(zf_waitable_fd_prime)
         RPC_DEF(zf_muxer_mod_rearm)
+        RPC_DEF(zf_muxer_bulk)
+        RPC_DEF(zf_muxer_wait_bench)
         RPC_DEF(zf_alternatives_alloc)
         RPC_DEF(zf_alternatives_release)
         RPC_DEF(zf_alternatives_send)
@@ -1094,6 +1985,7 @@ program zfrpc
         RPC_DEF(zft_alternatives_queue)
         RPC_DEF(zf_alternatives_free_space)
         RPC_DEF(zf_many_threads_alloc_free_stack)
+        RPC_DEF(zfts_reactor_profile_get)
         RPC_DEF(zfur_pkt_get_timestamp)
         RPC_DEF(zft_pkt_get_timestamp)
         RPC_DEF(zfut_get_tx_timestamps)
@@ -1106,5 +1998,42 @@ program zfrpc
         RPC_DEF(zf_delegated_send_tcp_advance)
         RPC_DEF(zf_delegated_send_complete)
         RPC_DEF(zf_delegated_send_cancel)
+        RPC_DEF(zfts_zockets_bulk_alloc)
+        RPC_DEF(zfts_zockets_bulk_free)
+        RPC_DEF(zfts_zftl_bulk_accept)
+        RPC_DEF(zfts_sockets_bulk_create)
+        RPC_DEF(zfts_sockets_bulk_accept)
+        RPC_DEF(zfts_sockets_bulk_send)
+        RPC_DEF(zfts_sockets_bulk_close)
+        RPC_DEF(zfts_sockets_bulk_invoke)
+        RPC_DEF(zfts_tx_ts_collector_start)
+        RPC_DEF(zfts_tx_ts_collector_stats)
+        RPC_DEF(zfts_tx_ts_collector_read)
+        RPC_DEF(zfts_tx_ts_collector_drain)
+        RPC_DEF(zfts_tx_ts_collector_stop)
+        RPC_DEF(zfts_tx_ts_paced_send)
+        RPC_DEF(zfts_zft_bulk_establish)
+        RPC_DEF(zfts_sockets_bulk_connect)
+        RPC_DEF(zfts_sockets_bulk_set_flags)
+        RPC_DEF(zfts_tcp_churn)
+        RPC_DEF(zfts_sockets_churn)
+        RPC_DEF(zfts_recv_bench)
+        RPC_DEF(zfts_tcp_send_bench)
+        RPC_DEF(zfts_tcp_rr_client)
+        RPC_DEF(zfts_sockets_rr_server)
+        RPC_DEF(zfts_tcp_send_space_bench)
+        RPC_DEF(zfts_rx_exhaust_bench)
+        RPC_DEF(zfts_zfut_fanout_bench)
+        RPC_DEF(zfts_zfur_bulk_bind)
+        RPC_DEF(zfts_zfur_drain_bench)
+        RPC_DEF(zfts_zfur_forward_bench)
+        RPC_DEF(zfts_sockets_udp_ts_flooder)
+        RPC_DEF(zfts_zfut_sg_bench)
+        RPC_DEF(zfts_sockets_udp_paced_send)
+        RPC_DEF(zfts_stack_alloc_free_bench)
+        RPC_DEF(zfts_stack_pool_get)
+        RPC_DEF(zfts_stack_pool_alloc)
+        RPC_DEF(zfts_stack_pool_park)
+        RPC_DEF(zfts_stack_pool_drain)
     } = 1;
 } = 2;
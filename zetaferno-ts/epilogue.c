@@ -48,6 +48,7 @@ main(int argc, char **argv)
     TEST_START;
     TEST_GET_PCO(pco_iut);
 
+    zfts_stack_pool_drain(pco_iut);
     epilogue_check_sockstat(pco_iut);
 
     TEST_SUCCESS;
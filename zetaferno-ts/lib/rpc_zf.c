@@ -257,6 +257,39 @@ rpc_zf_stack_has_pending_work(rcf_rpc_server *rpcs, rpc_zf_stack_p stack)
     RETVAL_INT(zf_stack_has_pending_work, out.retval);
 }
 
+/* See description in rpc_zf.h */
+int
+rpc_zfts_reactor_profile_get(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                             te_bool reset,
+                             tarpc_zfts_reactor_profile *prof)
+{
+    tarpc_zfts_reactor_profile_get_in  in;
+    tarpc_zfts_reactor_profile_get_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stack, RPC_TYPE_NS_ZF_STACK);
+    in.stack = stack;
+    in.reset = reset;
+
+    rcf_rpc_call(rpcs, "zfts_reactor_profile_get", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT && prof != NULL)
+        *prof = out.prof;
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_reactor_profile_get,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_reactor_profile_get, RPC_PTR_FMT ", %s",
+                 "%d events=%llu idle=%llu has_pending=%llu",
+                 RPC_PTR_VAL(stack), reset ? "reset" : "keep", out.retval,
+                 (unsigned long long)out.prof.events.calls,
+                 (unsigned long long)out.prof.idle.calls,
+                 (unsigned long long)out.prof.has_pending.calls);
+
+    RETVAL_ZERO_INT(zfts_reactor_profile_get, out.retval);
+}
+
 /* See description in rpc_zf.h */
 int
 rpc_zf_reactor_perform(rcf_rpc_server *rpcs, rpc_zf_stack_p stack)
@@ -378,3 +411,176 @@ rpc_zf_many_threads_alloc_free_stack(rcf_rpc_server *rpcs, rpc_zf_attr_p attr,
 
     RETVAL_ZERO_INT(zf_many_threads_alloc_free_stack, out.retval);
 }
+
+/** Upper bound on duration of a single stack alloc/free, milliseconds */
+#define ZFTS_STACK_ALLOC_FREE_MAX_MS 1000
+
+/* See description in rpc_zf.h */
+int
+rpc_zfts_stack_alloc_free_bench(rcf_rpc_server *rpcs, rpc_zf_attr_p attr,
+                                int threads_num, int iterations,
+                                int live_stacks,
+                                tarpc_zfts_stack_alloc_stats *stats,
+                                int *live_allocated, uint64_t *tsc_hz)
+{
+    tarpc_zfts_stack_alloc_free_bench_in  in;
+    tarpc_zfts_stack_alloc_free_bench_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, attr, RPC_TYPE_NS_ZF_ATTR);
+    in.attr = attr;
+    in.threads_num = threads_num;
+    in.iterations = iterations;
+    in.live_stacks = live_stacks;
+
+    /* Threads share the kernel resources, so assume they serialise. */
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+    {
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) +
+                        ZFTS_STACK_ALLOC_FREE_MAX_MS *
+                        (MAX(threads_num, 0) * MAX(iterations, 0) +
+                         MAX(live_stacks, 0));
+    }
+
+    rcf_rpc_call(rpcs, "zfts_stack_alloc_free_bench", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+    {
+        if (out.stats.stats_len != (unsigned int)threads_num)
+        {
+            ERROR("%s(): unexpected number of threads statistics",
+                  __FUNCTION__);
+            out.retval = -1;
+            rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+        }
+        else
+        {
+            if (stats != NULL)
+            {
+                memcpy(stats, out.stats.stats_val,
+                       threads_num * sizeof(*stats));
+            }
+            if (live_allocated != NULL)
+                *live_allocated = out.live_allocated;
+            if (tsc_hz != NULL)
+                *tsc_hz = out.tsc_hz;
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_stack_alloc_free_bench,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_stack_alloc_free_bench,
+                 RPC_PTR_FMT ", %d, %d, %d", "%d live_allocated=%d",
+                 RPC_PTR_VAL(attr), threads_num, iterations, live_stacks,
+                 out.retval, out.live_allocated);
+
+    RETVAL_ZERO_INT(zfts_stack_alloc_free_bench, out.retval);
+}
+
+/* See description in rpc_zf.h */
+int
+rpc_zfts_stack_pool_get(rcf_rpc_server *rpcs, rpc_zf_stack_p *stack)
+{
+    tarpc_zfts_stack_pool_get_in  in;
+    tarpc_zfts_stack_pool_get_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    rcf_rpc_call(rpcs, "zfts_stack_pool_get", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
+        *stack = out.stack;
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_stack_pool_get, out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_stack_pool_get, "", RPC_PTR_FMT " %d",
+                 RPC_PTR_VAL(out.stack), out.retval);
+
+    RETVAL_ZERO_INT(zfts_stack_pool_get, out.retval);
+}
+
+/* See description in rpc_zf.h */
+int
+rpc_zfts_stack_pool_alloc(rcf_rpc_server *rpcs, rpc_zf_attr_p attr,
+                          rpc_zf_stack_p *stack)
+{
+    tarpc_zfts_stack_pool_alloc_in  in;
+    tarpc_zfts_stack_pool_alloc_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, attr, RPC_TYPE_NS_ZF_ATTR);
+    in.attr = attr;
+
+    rcf_rpc_call(rpcs, "zfts_stack_pool_alloc", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
+        *stack = out.stack;
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_stack_pool_alloc,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_stack_pool_alloc, RPC_PTR_FMT,
+                 RPC_PTR_FMT " %d", RPC_PTR_VAL(attr),
+                 RPC_PTR_VAL(out.stack), out.retval);
+
+    RETVAL_ZERO_INT(zfts_stack_pool_alloc, out.retval);
+}
+
+/* See description in rpc_zf.h */
+int
+rpc_zfts_stack_pool_park(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                         te_bool *parked)
+{
+    tarpc_zfts_stack_pool_park_in  in;
+    tarpc_zfts_stack_pool_park_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stack, RPC_TYPE_NS_ZF_STACK);
+    in.stack = stack;
+
+    rcf_rpc_call(rpcs, "zfts_stack_pool_park", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
+        *parked = out.parked;
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_stack_pool_park,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_stack_pool_park, RPC_PTR_FMT, "%d %s",
+                 RPC_PTR_VAL(stack), out.retval,
+                 out.parked ? "parked" : "not parked");
+
+    RETVAL_ZERO_INT(zfts_stack_pool_park, out.retval);
+}
+
+/* See description in rpc_zf.h */
+int
+rpc_zfts_stack_pool_drain(rcf_rpc_server *rpcs,
+                          tarpc_zfts_stack_pool_stats *stats)
+{
+    tarpc_zfts_stack_pool_drain_in  in;
+    tarpc_zfts_stack_pool_drain_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    rcf_rpc_call(rpcs, "zfts_stack_pool_drain", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT && stats != NULL)
+        *stats = out.stats;
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_stack_pool_drain,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_stack_pool_drain, "",
+                 "%d allocs=%llu reuses=%llu frees=%llu", out.retval,
+                 (unsigned long long)out.stats.allocs,
+                 (unsigned long long)out.stats.reuses,
+                 (unsigned long long)out.stats.frees);
+
+    RETVAL_ZERO_INT(zfts_stack_pool_drain, out.retval);
+}
@@ -26,11 +26,16 @@
 #include "zf_talib_namespace.h"
 
 #include "rpc_zf_tcp.h"
+#include "rpc_zf_tcp_bench.h"
+#include "rpc_zf_recv_bench.h"
 #include "rpc_zf_udp_rx.h"
 #include "rpc_zf_udp_tx.h"
 #include "rpc_zf_muxer.h"
 #include "rpc_zf_alts.h"
 #include "rpc_zf_ds.h"
+#include "rpc_zf_bulk.h"
+#include "rpc_zf_tx_ts.h"
+#include "rpc_zf_udp_bench.h"
 
 /** Event indicating stack quiescence. */
 #define RPC_EPOLLSTACKHUP RPC_EPOLLRDHUP
@@ -195,6 +200,23 @@ extern int rpc_zf_wait_for_event(rcf_rpc_server *rpcs,
 extern int rpc_zf_process_events(rcf_rpc_server *rpcs,
                                  rpc_zf_stack_p stack);
 
+/**
+ * Get profile of zf_reactor_perform() calls made by the agent on a stack
+ * (profiling is enabled with TE_RPC_ZF_REACTOR_PROFILE_ENABLED
+ * environment variable on the agent side).
+ *
+ * @param rpcs    RPC server handle.
+ * @param stack   RPC pointer identifier of ZF stack object.
+ * @param reset   If @c TRUE, reset the profile after getting it.
+ * @param prof    Where to save the profile (may be @c NULL).
+ *
+ * @return @c 0 on success, or @c -1 in case of failure.
+ */
+extern int rpc_zfts_reactor_profile_get(rcf_rpc_server *rpcs,
+                                        rpc_zf_stack_p stack,
+                                        te_bool reset,
+                                        tarpc_zfts_reactor_profile *prof);
+
 /**
  * Call @a zf_reactor_perform repeatedly until timeout is expired.
  *
@@ -229,4 +251,91 @@ extern int rpc_zf_many_threads_alloc_free_stack(rcf_rpc_server *rpcs,
                                                 rpc_zf_attr_p attr,
                                                 int threads_num,
                                                 int wait_after_alloc);
+
+/**
+ * Measure latency of @b zf_stack_alloc() and @b zf_stack_free():
+ * allocate @p live_stacks stacks and keep them while @p threads_num
+ * threads allocate and release a stack @p iterations times each
+ * concurrently, timing every call with TSC.
+ *
+ * @param rpcs              RPC server.
+ * @param attr              RPC pointer to the ZF attributes object.
+ * @param threads_num       Number of threads.
+ * @param iterations        Number of alloc/free iterations of every
+ *                          thread.
+ * @param live_stacks       Number of stacks to keep allocated.
+ * @param stats             Where to save latencies, an array of
+ *                          @p threads_num elements (may be @c NULL).
+ * @param live_allocated    Where to save number of live stacks which
+ *                          were actually allocated (may be @c NULL).
+ * @param tsc_hz            Where to save TSC frequency (may be
+ *                          @c NULL).
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+extern int rpc_zfts_stack_alloc_free_bench(
+                                    rcf_rpc_server *rpcs,
+                                    rpc_zf_attr_p attr,
+                                    int threads_num, int iterations,
+                                    int live_stacks,
+                                    tarpc_zfts_stack_alloc_stats *stats,
+                                    int *live_allocated,
+                                    uint64_t *tsc_hz);
+
+/**
+ * Take a parked stack from the agent stack pool. Only a stack allocated
+ * while @b ZF_ATTR environment variable of the RPC server had the same
+ * value as now is taken, so that it has the same attributes as a stack
+ * allocated with a new default attributes object.
+ *
+ * @param rpcs      RPC server.
+ * @param stack     Where to save RPC pointer of the stack (@c RPC_NULL
+ *                  if there is no suitable parked stack).
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+extern int rpc_zfts_stack_pool_get(rcf_rpc_server *rpcs,
+                                   rpc_zf_stack_p *stack);
+
+/**
+ * Allocate ZF stack which can be parked in the agent stack pool
+ * with rpc_zfts_stack_pool_park() afterwards.
+ *
+ * @param rpcs      RPC server.
+ * @param attr      RPC pointer to the ZF attributes object.
+ * @param stack     Where to save RPC pointer of the stack.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+extern int rpc_zfts_stack_pool_alloc(rcf_rpc_server *rpcs,
+                                     rpc_zf_attr_p attr,
+                                     rpc_zf_stack_p *stack);
+
+/**
+ * Park a stack allocated with rpc_zfts_stack_pool_alloc() in the agent
+ * stack pool if @b zf_stack_is_quiescent() reports it is quiescent and
+ * the pool is not full. A stack which is not parked should be released
+ * with rpc_zf_stack_free().
+ *
+ * @param rpcs      RPC server.
+ * @param stack     RPC pointer of the stack.
+ * @param parked    Where to save @c TRUE if the stack is parked.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+extern int rpc_zfts_stack_pool_park(rcf_rpc_server *rpcs,
+                                    rpc_zf_stack_p stack,
+                                    te_bool *parked);
+
+/**
+ * Release all the stacks parked in the agent stack pool and get
+ * statistics of the pool.
+ *
+ * @param rpcs      RPC server.
+ * @param stats     Where to save statistics (may be @c NULL).
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+extern int rpc_zfts_stack_pool_drain(rcf_rpc_server *rpcs,
+                                     tarpc_zfts_stack_pool_stats *stats);
 #endif /* !___RPC_ZF_H__ */
@@ -175,11 +175,9 @@ rpc_zft_alternatives_queue(rcf_rpc_server *rpcs, rpc_zft_p ts,
     rcf_rpc_call(rpcs, "zft_alternatives_queue", &in, &out);
     free(in.iovec.iovec_val);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    rpc_iovec2str(iov, iov_cnt, &log_strbuf);
-
     CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zf_alternatives_queue,
                                           out.retval);
+    ZFTS_LOG_STRBUF_FILL(rpcs, rpc_iovec2str(iov, iov_cnt, &log_strbuf));
     /* FIXME: print flags as a string. */
     TAPI_RPC_LOG(rpcs, zft_alternatives_queue,
                  RPC_PTR_FMT ", alt = %"TE_PRINTF_64"u, iov = %s, "
@@ -0,0 +1,798 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/** @file
+ * @brief Test API - bulk RPC functions implementation
+ *
+ * Implementation of TAPI for remote calls which create, release or
+ * exercise many zockets or peer sockets in a single call.
+ *
+ * $Id$
+ */
+
+#include "te_config.h"
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "tapi_rpc_internal.h"
+#include "tapi_rpc_unistd.h"
+#include "te_rpc_sys_socket.h"
+#include "zf_test.h"
+
+#include "rpc_zf_internal.h"
+#include "rpc_zf_bulk.h"
+
+#undef TE_LGR_USER
+#define TE_LGR_USER "ZF TAPI BULK RPC"
+
+/**
+ * Convert bulk zocket type to string.
+ *
+ * @param type      Zocket type.
+ *
+ * @return String representation.
+ */
+static const char *
+zfts_bulk_zocket_type2str(zfts_bulk_zocket_type type)
+{
+    switch (type)
+    {
+        case ZFTS_BULK_ZOCKET_URX:
+            return "urx";
+
+        case ZFTS_BULK_ZOCKET_UTX:
+            return "utx";
+
+        case ZFTS_BULK_ZOCKET_ZFTL:
+            return "zftl";
+
+        case ZFTS_BULK_ZOCKET_ZFT_ACT:
+            return "zft_act";
+
+        case ZFTS_BULK_ZOCKET_ZFT_PAS:
+            return "zft_pas";
+
+        default:
+            return "<unknown>";
+    }
+}
+
+/**
+ * Get namespace of RPC pointers of zockets of a given type.
+ *
+ * @param type      Zocket type.
+ *
+ * @return Namespace name.
+ */
+static const char *
+zfts_bulk_zocket_type2ns(zfts_bulk_zocket_type type)
+{
+    switch (type)
+    {
+        case ZFTS_BULK_ZOCKET_URX:
+            return RPC_TYPE_NS_ZFUR;
+
+        case ZFTS_BULK_ZOCKET_UTX:
+            return RPC_TYPE_NS_ZFUT;
+
+        case ZFTS_BULK_ZOCKET_ZFTL:
+            return RPC_TYPE_NS_ZFTL;
+
+        default:
+            return RPC_TYPE_NS_ZFT;
+    }
+}
+
+/**
+ * Convert socket event action to string.
+ *
+ * @param event     Action.
+ *
+ * @return String representation.
+ */
+static const char *
+zfts_sock_event2str(zfts_sock_event event)
+{
+    switch (event)
+    {
+        case ZFTS_SOCK_EVENT_SEND:
+            return "send";
+
+        case ZFTS_SOCK_EVENT_CONNECT:
+            return "connect";
+
+        case ZFTS_SOCK_EVENT_DRAIN:
+            return "drain";
+
+        default:
+            return "<unknown>";
+    }
+}
+
+/* See description in rpc_zf_bulk.h */
+int
+rpc_zfts_zockets_bulk_alloc(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                            rpc_zf_attr_p attr, zfts_bulk_zocket_type type,
+                            int count, const struct sockaddr *laddr,
+                            const struct sockaddr *raddr, int timeout,
+                            rpc_ptr *zockets, rpc_zf_waitable_p *waitables)
+{
+    tarpc_zfts_zockets_bulk_alloc_in  in;
+    tarpc_zfts_zockets_bulk_alloc_out out;
+
+    int i;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stack, RPC_TYPE_NS_ZF_STACK);
+    in.stack = stack;
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, attr, RPC_TYPE_NS_ZF_ATTR);
+    in.attr = attr;
+    in.type = type;
+    in.count = count;
+    sockaddr_input_h2rpc(laddr, &in.laddr);
+    sockaddr_input_h2rpc(raddr, &in.raddr);
+    in.timeout = timeout;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) + timeout;
+
+    rcf_rpc_call(rpcs, "zfts_zockets_bulk_alloc", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+    {
+        if (out.zockets.zockets_len != (unsigned int)count ||
+            out.waitables.waitables_len != (unsigned int)count)
+        {
+            ERROR("%s(): unexpected number of zockets was returned",
+                  __FUNCTION__);
+            out.retval = -1;
+            rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+        }
+        else
+        {
+            for (i = 0; i < count; i++)
+            {
+                zockets[i] = out.zockets.zockets_val[i];
+                if (waitables != NULL)
+                    waitables[i] = out.waitables.waitables_val[i];
+            }
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_zockets_bulk_alloc,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_zockets_bulk_alloc,
+                 RPC_PTR_FMT ", " RPC_PTR_FMT ", %s, %d, laddr = %s, "
+                 "raddr = %s, timeout = %d", "%d",
+                 RPC_PTR_VAL(stack), RPC_PTR_VAL(attr),
+                 zfts_bulk_zocket_type2str(type), count,
+                 te_sockaddr2str(laddr), te_sockaddr2str(raddr), timeout,
+                 out.retval);
+
+    if (rpcs->op != RCF_RPC_WAIT && out.retval == 0 && count > 0)
+    {
+        TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, zockets[0],
+                                      zfts_bulk_zocket_type2ns(type));
+    }
+
+    RETVAL_ZERO_INT(zfts_zockets_bulk_alloc, out.retval);
+}
+
+/* See description in rpc_zf_bulk.h */
+int
+rpc_zfts_zockets_bulk_free(rcf_rpc_server *rpcs,
+                           zfts_bulk_zocket_type type,
+                           const rpc_ptr *zockets,
+                           const rpc_zf_waitable_p *waitables, int count)
+{
+    tarpc_zfts_zockets_bulk_free_in  in;
+    tarpc_zfts_zockets_bulk_free_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    in.type = type;
+    in.zockets.zockets_len = count;
+    in.zockets.zockets_val = (tarpc_ptr *)zockets;
+    if (waitables != NULL)
+    {
+        in.waitables.waitables_len = count;
+        in.waitables.waitables_val = (tarpc_ptr *)waitables;
+    }
+
+    rcf_rpc_call(rpcs, "zfts_zockets_bulk_free", &in, &out);
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_zockets_bulk_free,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_zockets_bulk_free, "%s, %d zockets", "%d",
+                 zfts_bulk_zocket_type2str(type), count, out.retval);
+
+    RETVAL_ZERO_INT(zfts_zockets_bulk_free, out.retval);
+}
+
+/* See description in rpc_zf_bulk.h */
+int
+rpc_zfts_zfur_bulk_bind(rcf_rpc_server *rpcs, rpc_zfur_p urx,
+                        const struct sockaddr **laddrs,
+                        const struct sockaddr **raddrs, int count,
+                        te_bool unbind, int flags, uint64_t *times,
+                        int *done)
+{
+    tarpc_zfts_zfur_bulk_bind_in  in;
+    tarpc_zfts_zfur_bulk_bind_out out;
+
+    int i;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, urx, RPC_TYPE_NS_ZFUR);
+    in.urx = urx;
+    in.laddrs.laddrs_len = count;
+    in.laddrs.laddrs_val = tapi_calloc(MAX(count, 1),
+                                       sizeof(*in.laddrs.laddrs_val));
+    if (raddrs != NULL)
+    {
+        in.raddrs.raddrs_len = count;
+        in.raddrs.raddrs_val = tapi_calloc(MAX(count, 1),
+                                           sizeof(*in.raddrs.raddrs_val));
+    }
+    for (i = 0; i < count; i++)
+    {
+        sockaddr_input_h2rpc(laddrs[i], &in.laddrs.laddrs_val[i]);
+        if (raddrs != NULL)
+            sockaddr_input_h2rpc(raddrs[i], &in.raddrs.raddrs_val[i]);
+    }
+    in.unbind = unbind;
+    in.flags = flags;
+
+    rcf_rpc_call(rpcs, "zfts_zfur_bulk_bind", &in, &out);
+    free(in.laddrs.laddrs_val);
+    free(in.raddrs.raddrs_val);
+
+    /*
+     * Results of successful calls are returned even if some call
+     * failed, so that the caller can see where binding stopped.
+     */
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
+    {
+        if (out.times.times_len > (unsigned int)count)
+        {
+            ERROR("%s(): unexpected number of measurements",
+                  __FUNCTION__);
+            out.retval = -1;
+            rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+        }
+        else
+        {
+            if (times != NULL)
+            {
+                memcpy(times, out.times.times_val,
+                       out.times.times_len * sizeof(*times));
+            }
+            if (done != NULL)
+                *done = out.times.times_len;
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_zfur_bulk_bind,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_zfur_bulk_bind,
+                 RPC_PTR_FMT ", %d tuples, laddr[0] = %s, %s, %s, "
+                 "flags = %d", "%d done = %u",
+                 RPC_PTR_VAL(urx), count,
+                 count > 0 ? te_sockaddr2str(laddrs[0]) : "none",
+                 raddrs == NULL ? "no raddrs" : "with raddrs",
+                 unbind ? "unbind" : "bind", flags, out.retval,
+                 out.times.times_len);
+
+    RETVAL_ZERO_INT(zfts_zfur_bulk_bind, out.retval);
+}
+
+/* See description in rpc_zf_bulk.h */
+int
+rpc_zfts_zftl_bulk_accept(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                          rpc_zftl_p zftl, int count, int timeout,
+                          rpc_zft_p *zockets, rpc_zf_waitable_p *waitables,
+                          struct sockaddr_storage *raddrs)
+{
+    tarpc_zfts_zftl_bulk_accept_in  in;
+    tarpc_zfts_zftl_bulk_accept_out out;
+
+    int i;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stack, RPC_TYPE_NS_ZF_STACK);
+    in.stack = stack;
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, zftl, RPC_TYPE_NS_ZFTL);
+    in.zftl = zftl;
+    in.count = count;
+    in.timeout = timeout;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) + timeout;
+
+    rcf_rpc_call(rpcs, "zfts_zftl_bulk_accept", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+    {
+        if (out.zockets.zockets_len != (unsigned int)count ||
+            out.waitables.waitables_len != (unsigned int)count ||
+            out.raddrs.raddrs_len != (unsigned int)count)
+        {
+            ERROR("%s(): unexpected number of zockets was returned",
+                  __FUNCTION__);
+            out.retval = -1;
+            rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+        }
+        else
+        {
+            for (i = 0; i < count; i++)
+            {
+                zockets[i] = out.zockets.zockets_val[i];
+                if (waitables != NULL)
+                    waitables[i] = out.waitables.waitables_val[i];
+                if (raddrs != NULL &&
+                    sockaddr_rpc2h(&out.raddrs.raddrs_val[i],
+                                   SA(&raddrs[i]), sizeof(raddrs[i]),
+                                   NULL, NULL) != 0)
+                {
+                    rpcs->_errno = TE_RC(TE_RCF, TE_EINVAL);
+                }
+            }
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_zftl_bulk_accept,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_zftl_bulk_accept,
+                 RPC_PTR_FMT ", " RPC_PTR_FMT ", %d, timeout = %d", "%d",
+                 RPC_PTR_VAL(stack), RPC_PTR_VAL(zftl), count, timeout,
+                 out.retval);
+
+    if (out.retval == 0 && count > 0)
+        TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, zockets[0], RPC_TYPE_NS_ZFT);
+
+    RETVAL_ZERO_INT(zfts_zftl_bulk_accept, out.retval);
+}
+
+/* See description in rpc_zf_bulk.h */
+int
+rpc_zfts_sockets_bulk_create(rcf_rpc_server *rpcs,
+                             rpc_socket_domain domain,
+                             rpc_socket_type type, int count,
+                             const struct sockaddr *laddr,
+                             const struct sockaddr *raddr, int *fds)
+{
+    tarpc_zfts_sockets_bulk_create_in  in;
+    tarpc_zfts_sockets_bulk_create_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    in.domain = domain;
+    in.type = type;
+    in.count = count;
+    sockaddr_input_h2rpc(laddr, &in.laddr);
+    sockaddr_input_h2rpc(raddr, &in.raddr);
+
+    rcf_rpc_call(rpcs, "zfts_sockets_bulk_create", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+    {
+        if (out.fds.fds_len != (unsigned int)count)
+        {
+            ERROR("%s(): unexpected number of sockets was returned",
+                  __FUNCTION__);
+            out.retval = -1;
+            rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+        }
+        else
+        {
+            memcpy(fds, out.fds.fds_val, count * sizeof(*fds));
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_sockets_bulk_create,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_sockets_bulk_create,
+                 "%s, %s, %d, laddr = %s, raddr = %s", "%d",
+                 domain_rpc2str(domain), socktype_rpc2str(type), count,
+                 te_sockaddr2str(laddr), te_sockaddr2str(raddr),
+                 out.retval);
+
+    RETVAL_ZERO_INT(zfts_sockets_bulk_create, out.retval);
+}
+
+/* See description in rpc_zf_bulk.h */
+int
+rpc_zfts_sockets_bulk_accept(rcf_rpc_server *rpcs, int fd, int count,
+                             int timeout, int *fds,
+                             struct sockaddr_storage *raddrs)
+{
+    tarpc_zfts_sockets_bulk_accept_in  in;
+    tarpc_zfts_sockets_bulk_accept_out out;
+
+    int i;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    in.fd = fd;
+    in.count = count;
+    in.timeout = timeout;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) + timeout;
+
+    rcf_rpc_call(rpcs, "zfts_sockets_bulk_accept", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+    {
+        if (out.fds.fds_len != (unsigned int)count ||
+            out.raddrs.raddrs_len != (unsigned int)count)
+        {
+            ERROR("%s(): unexpected number of sockets was returned",
+                  __FUNCTION__);
+            out.retval = -1;
+            rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+        }
+        else
+        {
+            memcpy(fds, out.fds.fds_val, count * sizeof(*fds));
+            for (i = 0; raddrs != NULL && i < count; i++)
+            {
+                if (sockaddr_rpc2h(&out.raddrs.raddrs_val[i],
+                                   SA(&raddrs[i]), sizeof(raddrs[i]),
+                                   NULL, NULL) != 0)
+                    rpcs->_errno = TE_RC(TE_RCF, TE_EINVAL);
+            }
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_sockets_bulk_accept,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_sockets_bulk_accept,
+                 "%d, %d, timeout = %d", "%d",
+                 fd, count, timeout, out.retval);
+
+    RETVAL_ZERO_INT(zfts_sockets_bulk_accept, out.retval);
+}
+
+/* See description in rpc_zf_bulk.h */
+int
+rpc_zfts_sockets_bulk_send(rcf_rpc_server *rpcs, const int *fds,
+                           const struct sockaddr **dsts, int count,
+                           size_t len)
+{
+    tarpc_zfts_sockets_bulk_send_in  in;
+    tarpc_zfts_sockets_bulk_send_out out;
+
+    int i;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    in.peers.peers_len = count;
+    in.peers.peers_val = tapi_calloc(MAX(count, 1),
+                                     sizeof(*in.peers.peers_val));
+    for (i = 0; i < count; i++)
+    {
+        in.peers.peers_val[i].fd = fds[i];
+        sockaddr_input_h2rpc(dsts == NULL ? NULL : dsts[i],
+                             &in.peers.peers_val[i].dst);
+    }
+    in.len = len;
+
+    rcf_rpc_call(rpcs, "zfts_sockets_bulk_send", &in, &out);
+    free(in.peers.peers_val);
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_sockets_bulk_send,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_sockets_bulk_send, "%d sockets, len = %u",
+                 "%d", count, (unsigned int)len, out.retval);
+
+    RETVAL_ZERO_INT(zfts_sockets_bulk_send, out.retval);
+}
+
+/* See description in rpc_zf_bulk.h */
+int
+rpc_zfts_sockets_bulk_close(rcf_rpc_server *rpcs, const int *fds,
+                            int count)
+{
+    tarpc_zfts_sockets_bulk_close_in  in;
+    tarpc_zfts_sockets_bulk_close_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    in.fds.fds_len = count;
+    in.fds.fds_val = (tarpc_int *)fds;
+
+    rcf_rpc_call(rpcs, "zfts_sockets_bulk_close", &in, &out);
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_sockets_bulk_close,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_sockets_bulk_close, "%d sockets", "%d",
+                 count, out.retval);
+
+    RETVAL_ZERO_INT(zfts_sockets_bulk_close, out.retval);
+}
+
+/* See description in rpc_zf_bulk.h */
+int
+rpc_zfts_sockets_bulk_invoke(rcf_rpc_server *rpcs,
+                             rpc_zfts_sock_event *events, int count,
+                             const void *data, size_t len)
+{
+    tarpc_zfts_sockets_bulk_invoke_in  in;
+    tarpc_zfts_sockets_bulk_invoke_out out;
+
+    tarpc_zfts_sock_event_res *res;
+    int i;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    in.reqs.reqs_len = count;
+    in.reqs.reqs_val = tapi_calloc(MAX(count, 1),
+                                   sizeof(*in.reqs.reqs_val));
+    for (i = 0; i < count; i++)
+    {
+        in.reqs.reqs_val[i].fd = events[i].fd;
+        in.reqs.reqs_val[i].event = events[i].event;
+        sockaddr_input_h2rpc(events[i].addr, &in.reqs.reqs_val[i].addr);
+    }
+    in.data.data_len = len;
+    in.data.data_val = (uint8_t *)data;
+
+    rcf_rpc_call(rpcs, "zfts_sockets_bulk_invoke", &in, &out);
+    free(in.reqs.reqs_val);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+    {
+        if (out.results.results_len != (unsigned int)count)
+        {
+            ERROR("%s(): unexpected number of results was returned",
+                  __FUNCTION__);
+            out.retval = -1;
+            rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+        }
+        else
+        {
+            for (i = 0; i < count; i++)
+            {
+                res = &out.results.results_val[i];
+                if (events[i].event == ZFTS_SOCK_EVENT_CONNECT &&
+                    sockaddr_rpc2h(&res->addr, SA(&events[i].local_addr),
+                                   sizeof(events[i].local_addr),
+                                   NULL, NULL) != 0)
+                {
+                    rpcs->_errno = TE_RC(TE_RCF, TE_EINVAL);
+                }
+                if (events[i].event == ZFTS_SOCK_EVENT_DRAIN &&
+                    events[i].data != NULL)
+                {
+                    te_dbuf_append(events[i].data, res->data.data_val,
+                                   res->data.data_len);
+                }
+            }
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_sockets_bulk_invoke,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_sockets_bulk_invoke,
+                 "%d actions (first: %s), len = %u", "%d",
+                 count, count > 0 ? zfts_sock_event2str(events[0].event) :
+                                    "none",
+                 (unsigned int)len, out.retval);
+
+    RETVAL_ZERO_INT(zfts_sockets_bulk_invoke, out.retval);
+}
+
+/* See description in rpc_zf_bulk.h */
+int
+rpc_zfts_zft_bulk_establish(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                            rpc_zf_attr_p attr, rpc_zftl_p zftl, int count,
+                            const struct sockaddr *laddr,
+                            const struct sockaddr *raddr, int timeout,
+                            rpc_zft_p *zockets,
+                            struct sockaddr_storage *laddrs,
+                            struct sockaddr_storage *raddrs,
+                            uint64_t *times)
+{
+    tarpc_zfts_zft_bulk_establish_in  in;
+    tarpc_zfts_zft_bulk_establish_out out;
+
+    int i;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stack, RPC_TYPE_NS_ZF_STACK);
+    in.stack = stack;
+    if (zftl != RPC_NULL)
+    {
+        TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, zftl, RPC_TYPE_NS_ZFTL);
+    }
+    else
+    {
+        TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, attr, RPC_TYPE_NS_ZF_ATTR);
+        sockaddr_input_h2rpc(laddr, &in.laddr);
+        sockaddr_input_h2rpc(raddr, &in.raddr);
+    }
+    in.attr = attr;
+    in.zftl = zftl;
+    in.count = count;
+    in.timeout = timeout;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) + timeout;
+
+    rcf_rpc_call(rpcs, "zfts_zft_bulk_establish", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+    {
+        if (out.zockets.zockets_len != (unsigned int)count ||
+            out.laddrs.laddrs_len != (unsigned int)count ||
+            out.raddrs.raddrs_len != (unsigned int)count ||
+            out.times.times_len != (unsigned int)count)
+        {
+            ERROR("%s(): unexpected number of zockets was returned",
+                  __FUNCTION__);
+            out.retval = -1;
+            rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+        }
+        else
+        {
+            for (i = 0; i < count; i++)
+            {
+                zockets[i] = out.zockets.zockets_val[i];
+                if (times != NULL)
+                    times[i] = out.times.times_val[i];
+                if (laddrs != NULL &&
+                    sockaddr_rpc2h(&out.laddrs.laddrs_val[i],
+                                   SA(&laddrs[i]), sizeof(laddrs[i]),
+                                   NULL, NULL) != 0)
+                {
+                    rpcs->_errno = TE_RC(TE_RCF, TE_EINVAL);
+                }
+                if (raddrs != NULL &&
+                    sockaddr_rpc2h(&out.raddrs.raddrs_val[i],
+                                   SA(&raddrs[i]), sizeof(raddrs[i]),
+                                   NULL, NULL) != 0)
+                {
+                    rpcs->_errno = TE_RC(TE_RCF, TE_EINVAL);
+                }
+            }
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_zft_bulk_establish,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_zft_bulk_establish,
+                 RPC_PTR_FMT ", " RPC_PTR_FMT ", " RPC_PTR_FMT ", %d, "
+                 "laddr = %s, raddr = %s, timeout = %d", "%d",
+                 RPC_PTR_VAL(stack), RPC_PTR_VAL(attr), RPC_PTR_VAL(zftl),
+                 count, te_sockaddr2str(laddr), te_sockaddr2str(raddr),
+                 timeout, out.retval);
+
+    if (rpcs->op != RCF_RPC_WAIT && out.retval == 0 && count > 0)
+        TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, zockets[0], RPC_TYPE_NS_ZFT);
+
+    RETVAL_ZERO_INT(zfts_zft_bulk_establish, out.retval);
+}
+
+/* See description in rpc_zf_bulk.h */
+int
+rpc_zfts_sockets_bulk_connect(rcf_rpc_server *rpcs,
+                              rpc_socket_domain domain, int count,
+                              const struct sockaddr *laddr,
+                              const struct sockaddr *raddr,
+                              int sndbuf, int rcvbuf, int timeout,
+                              int *fds, struct sockaddr_storage *laddrs,
+                              uint64_t *times)
+{
+    tarpc_zfts_sockets_bulk_connect_in  in;
+    tarpc_zfts_sockets_bulk_connect_out out;
+
+    int i;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    in.domain = domain;
+    in.count = count;
+    sockaddr_input_h2rpc(laddr, &in.laddr);
+    sockaddr_input_h2rpc(raddr, &in.raddr);
+    in.sndbuf = sndbuf;
+    in.rcvbuf = rcvbuf;
+    in.timeout = timeout;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) + timeout;
+
+    rcf_rpc_call(rpcs, "zfts_sockets_bulk_connect", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+    {
+        if (out.fds.fds_len != (unsigned int)count ||
+            out.laddrs.laddrs_len != (unsigned int)count ||
+            out.times.times_len != (unsigned int)count)
+        {
+            ERROR("%s(): unexpected number of sockets was returned",
+                  __FUNCTION__);
+            out.retval = -1;
+            rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+        }
+        else
+        {
+            memcpy(fds, out.fds.fds_val, count * sizeof(*fds));
+            for (i = 0; i < count; i++)
+            {
+                if (times != NULL)
+                    times[i] = out.times.times_val[i];
+                if (laddrs != NULL &&
+                    sockaddr_rpc2h(&out.laddrs.laddrs_val[i],
+                                   SA(&laddrs[i]), sizeof(laddrs[i]),
+                                   NULL, NULL) != 0)
+                {
+                    rpcs->_errno = TE_RC(TE_RCF, TE_EINVAL);
+                }
+            }
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_sockets_bulk_connect,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_sockets_bulk_connect,
+                 "%s, %d, laddr = %s, raddr = %s, sndbuf = %d, "
+                 "rcvbuf = %d, timeout = %d", "%d",
+                 domain_rpc2str(domain), count, te_sockaddr2str(laddr),
+                 te_sockaddr2str(raddr), sndbuf, rcvbuf, timeout,
+                 out.retval);
+
+    RETVAL_ZERO_INT(zfts_sockets_bulk_connect, out.retval);
+}
+
+/* See description in rpc_zf_bulk.h */
+int
+rpc_zfts_sockets_bulk_set_flags(rcf_rpc_server *rpcs, const int *fds,
+                                int count, te_bool nodelay,
+                                te_bool nonblock)
+{
+    tarpc_zfts_sockets_bulk_set_flags_in  in;
+    tarpc_zfts_sockets_bulk_set_flags_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    in.fds.fds_len = count;
+    in.fds.fds_val = (tarpc_int *)fds;
+    in.nodelay = nodelay;
+    in.nonblock = nonblock;
+
+    rcf_rpc_call(rpcs, "zfts_sockets_bulk_set_flags", &in, &out);
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_sockets_bulk_set_flags,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_sockets_bulk_set_flags,
+                 "%d sockets, nodelay = %s, nonblock = %s", "%d",
+                 count, nodelay ? "TRUE" : "FALSE",
+                 nonblock ? "TRUE" : "FALSE", out.retval);
+
+    RETVAL_ZERO_INT(zfts_sockets_bulk_set_flags, out.retval);
+}
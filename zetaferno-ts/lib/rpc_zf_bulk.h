@@ -0,0 +1,351 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/** @file
+ * @brief Test API - bulk RPC functions definition
+ *
+ * Definition of TAPI for remote calls which create, release or
+ * exercise many zockets or peer sockets in a single call.
+ *
+ * $Id$
+ */
+
+#ifndef ___RPC_ZF_BULK_H__
+#define ___RPC_ZF_BULK_H__
+
+#include "rcf_rpc.h"
+#include "tapi_rpc_unistd.h"
+#include "te_rpc_sys_socket.h"
+#include "te_dbuf.h"
+#include "zf_talib_namespace.h"
+#include "zf_talib_common.h"
+
+/**
+ * Create a number of zockets of the same type on a stack in a single RPC
+ * call.
+ *
+ * If port of @p laddr is not zero, it is incremented for every next
+ * zocket. UDP zockets are bound to @p laddr and @p raddr (required for
+ * UDP TX zockets, optional for UDP RX ones); nonzero port of @p raddr
+ * is incremented for every next zocket too. TCP listening zockets
+ * listen on @p laddr. Active TCP zockets are bound to @p laddr if its
+ * port is not zero and connect to the same @p raddr; the call returns
+ * after all the connections are established. Passively opened TCP
+ * zockets cannot be created with this call, see
+ * rpc_zfts_zftl_bulk_accept().
+ *
+ * @param rpcs        RPC server handle.
+ * @param stack       RPC pointer to ZF stack.
+ * @param attr        RPC pointer to ZF attributes.
+ * @param type        Type of zockets.
+ * @param count       Number of zockets to create.
+ * @param laddr       Local address.
+ * @param raddr       Remote address (may be @c NULL for UDP RX and TCP
+ *                    listening zockets).
+ * @param timeout     How long to wait for TCP connections establishment,
+ *                    milliseconds.
+ * @param zockets     Where to save RPC pointers of created zockets
+ *                    (array of @p count elements).
+ * @param waitables   Where to save RPC pointers to zf_waitable objects
+ *                    of created zockets (array of @p count elements,
+ *                    may be @c NULL).
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_zockets_bulk_alloc(rcf_rpc_server *rpcs,
+                                       rpc_zf_stack_p stack,
+                                       rpc_zf_attr_p attr,
+                                       zfts_bulk_zocket_type type,
+                                       int count,
+                                       const struct sockaddr *laddr,
+                                       const struct sockaddr *raddr,
+                                       int timeout, rpc_ptr *zockets,
+                                       rpc_zf_waitable_p *waitables);
+
+/**
+ * Release zockets created with rpc_zfts_zockets_bulk_alloc() together
+ * with RPC pointers of their waitables.
+ *
+ * @param rpcs        RPC server handle.
+ * @param type        Type of zockets.
+ * @param zockets     RPC pointers of zockets.
+ * @param waitables   RPC pointers of waitables (may be @c NULL).
+ * @param count       Number of zockets.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_zockets_bulk_free(rcf_rpc_server *rpcs,
+                                      zfts_bulk_zocket_type type,
+                                      const rpc_ptr *zockets,
+                                      const rpc_zf_waitable_p *waitables,
+                                      int count);
+
+/**
+ * Bind a UDP RX zocket to a number of (laddr, raddr) tuples, or unbind
+ * it from them, in a single RPC call, measuring every zfur_addr_bind()
+ * or zfur_addr_unbind() call on the agent. The agent stops at the first
+ * failed call; measurements of the calls made before it are returned
+ * anyway, so that the caller can find out e.g. when hardware filters
+ * run out.
+ *
+ * @param rpcs        RPC server handle.
+ * @param urx         RPC pointer to UDP RX zocket.
+ * @param laddrs      Local addresses.
+ * @param raddrs      Remote addresses (the array or its elements may be
+ *                    @c NULL).
+ * @param count       Number of tuples.
+ * @param unbind      Call zfur_addr_unbind() instead of zfur_addr_bind().
+ * @param flags       Flags passed to every call.
+ * @param times       Where to save duration of every successful call,
+ *                    nanoseconds (may be @c NULL).
+ * @param done        Where to save number of successful calls (may be
+ *                    @c NULL).
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_zfur_bulk_bind(rcf_rpc_server *rpcs, rpc_zfur_p urx,
+                                   const struct sockaddr **laddrs,
+                                   const struct sockaddr **raddrs,
+                                   int count, te_bool unbind, int flags,
+                                   uint64_t *times, int *done);
+
+/**
+ * Accept a number of connections on a TCP listening zocket in a single
+ * RPC call. Accepted zockets should be released with
+ * rpc_zfts_zockets_bulk_free() using @c ZFTS_BULK_ZOCKET_ZFT_PAS type.
+ *
+ * @param rpcs        RPC server handle.
+ * @param stack       RPC pointer to ZF stack.
+ * @param zftl        RPC pointer to TCP listening zocket.
+ * @param count       Number of connections to accept.
+ * @param timeout     How long to wait for connections, milliseconds.
+ * @param zockets     Where to save RPC pointers of accepted zockets
+ *                    (array of @p count elements).
+ * @param waitables   Where to save RPC pointers to zf_waitable objects
+ *                    of accepted zockets (may be @c NULL).
+ * @param raddrs      Where to save remote addresses of accepted zockets
+ *                    (may be @c NULL).
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_zftl_bulk_accept(rcf_rpc_server *rpcs,
+                                     rpc_zf_stack_p stack,
+                                     rpc_zftl_p zftl, int count,
+                                     int timeout, rpc_zft_p *zockets,
+                                     rpc_zf_waitable_p *waitables,
+                                     struct sockaddr_storage *raddrs);
+
+/**
+ * Create a number of sockets of the same type in a single RPC call.
+ *
+ * If @p laddr is not @c NULL, sockets are bound to it, its nonzero port
+ * being incremented for every next socket. If @p raddr is not @c NULL,
+ * datagram sockets are connected to it (its nonzero port being
+ * incremented for every next socket), while stream sockets start
+ * connecting to the same @p raddr without waiting for connections
+ * establishment.
+ *
+ * @param rpcs        RPC server handle.
+ * @param domain      Communication domain.
+ * @param type        Socket type.
+ * @param count       Number of sockets to create.
+ * @param laddr       Local address (may be @c NULL).
+ * @param raddr       Remote address (may be @c NULL).
+ * @param fds         Where to save created sockets (array of @p count
+ *                    elements).
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_sockets_bulk_create(rcf_rpc_server *rpcs,
+                                        rpc_socket_domain domain,
+                                        rpc_socket_type type, int count,
+                                        const struct sockaddr *laddr,
+                                        const struct sockaddr *raddr,
+                                        int *fds);
+
+/**
+ * Accept a number of connections on a listening socket in a single RPC
+ * call.
+ *
+ * @param rpcs        RPC server handle.
+ * @param fd          Listening socket.
+ * @param count       Number of connections to accept.
+ * @param timeout     How long to wait for connections, milliseconds.
+ * @param fds         Where to save accepted sockets (array of @p count
+ *                    elements).
+ * @param raddrs      Where to save addresses of peers (may be @c NULL).
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_sockets_bulk_accept(rcf_rpc_server *rpcs, int fd,
+                                        int count, int timeout,
+                                        int *fds,
+                                        struct sockaddr_storage *raddrs);
+
+/**
+ * Send a data chunk from every socket in a list in a single RPC call.
+ *
+ * @param rpcs        RPC server handle.
+ * @param fds         Sockets.
+ * @param dsts        Destination addresses (the whole array or its
+ *                    elements may be @c NULL for connected sockets).
+ * @param count       Number of sockets.
+ * @param len         Number of bytes to send from every socket.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_sockets_bulk_send(rcf_rpc_server *rpcs,
+                                      const int *fds,
+                                      const struct sockaddr **dsts,
+                                      int count, size_t len);
+
+/**
+ * Close a number of sockets in a single RPC call.
+ *
+ * @param rpcs        RPC server handle.
+ * @param fds         Sockets.
+ * @param count       Number of sockets.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_sockets_bulk_close(rcf_rpc_server *rpcs,
+                                       const int *fds, int count);
+
+/**
+ * Action performed on a peer socket to invoke an event on a zocket.
+ */
+typedef struct rpc_zfts_sock_event {
+    int                     fd;         /**< Peer socket. */
+    zfts_sock_event         event;      /**< Action. */
+    const struct sockaddr  *addr;       /**< Address to connect to
+                                             (for
+                                             @c ZFTS_SOCK_EVENT_CONNECT). */
+    struct sockaddr_storage local_addr; /**< Local address of the socket
+                                             after starting connection
+                                             (for
+                                             @c ZFTS_SOCK_EVENT_CONNECT). */
+    te_dbuf                *data;       /**< Where to append read data
+                                             (for
+                                             @c ZFTS_SOCK_EVENT_DRAIN,
+                                             may be @c NULL). */
+} rpc_zfts_sock_event;
+
+/**
+ * Perform actions on a number of peer sockets in a single RPC call:
+ * send data (@c ZFTS_SOCK_EVENT_SEND), start non-blocking connect
+ * (@c ZFTS_SOCK_EVENT_CONNECT, the socket is left in non-blocking mode)
+ * or read all the available data (@c ZFTS_SOCK_EVENT_DRAIN).
+ *
+ * @param rpcs        RPC server handle.
+ * @param events      Actions (results are saved here too).
+ * @param count       Number of actions.
+ * @param data        Data to send from every socket.
+ * @param len         Length of @p data.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_sockets_bulk_invoke(rcf_rpc_server *rpcs,
+                                        rpc_zfts_sock_event *events,
+                                        int count, const void *data,
+                                        size_t len);
+
+/**
+ * Establish a number of TCP connections on IUT in a single RPC call.
+ * The agent processes the stack in a single loop until all the
+ * connections are established.
+ *
+ * If @p zftl is @c RPC_NULL, zockets are opened actively: all of them
+ * are allocated, bound to @p laddr (if its port is not zero, in which
+ * case it is incremented for every next zocket) and start connecting to
+ * @p raddr before the stack is processed. Otherwise @p count
+ * connections are accepted on @p zftl (@p attr, @p laddr and @p raddr
+ * are ignored then).
+ *
+ * Time to ESTABLISHED state is measured from zft_connect() call for
+ * actively opened zockets and from the start of the RPC call for
+ * accepted ones.
+ *
+ * @param rpcs        RPC server handle.
+ * @param stack       RPC pointer to ZF stack.
+ * @param attr        RPC pointer to ZF attributes.
+ * @param zftl        RPC pointer to TCP listening zocket
+ *                    (may be @c RPC_NULL).
+ * @param count       Number of connections.
+ * @param laddr       Local address.
+ * @param raddr       Remote address.
+ * @param timeout     How long to wait for connections, milliseconds.
+ * @param zockets     Where to save RPC pointers of zockets (array of
+ *                    @p count elements).
+ * @param laddrs      Where to save local addresses of zockets
+ *                    (may be @c NULL).
+ * @param raddrs      Where to save remote addresses of zockets
+ *                    (may be @c NULL).
+ * @param times       Where to save times to ESTABLISHED state,
+ *                    nanoseconds (may be @c NULL).
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_zft_bulk_establish(rcf_rpc_server *rpcs,
+                                       rpc_zf_stack_p stack,
+                                       rpc_zf_attr_p attr,
+                                       rpc_zftl_p zftl, int count,
+                                       const struct sockaddr *laddr,
+                                       const struct sockaddr *raddr,
+                                       int timeout, rpc_zft_p *zockets,
+                                       struct sockaddr_storage *laddrs,
+                                       struct sockaddr_storage *raddrs,
+                                       uint64_t *times);
+
+/**
+ * Connect a number of stream sockets concurrently in a single RPC
+ * call. All the sockets start non-blocking connect to @p raddr and are
+ * polled until all the connections are established; then they are
+ * switched back to blocking mode.
+ *
+ * @param rpcs        RPC server handle.
+ * @param domain      Communication domain.
+ * @param count       Number of sockets.
+ * @param laddr       Local address (may be @c NULL); its nonzero port
+ *                    is incremented for every next socket.
+ * @param raddr       Remote address.
+ * @param sndbuf      @c SO_SNDBUF value to set before connecting
+ *                    (ignored if negative).
+ * @param rcvbuf      @c SO_RCVBUF value to set before connecting
+ *                    (ignored if negative).
+ * @param timeout     How long to wait for connections, milliseconds.
+ * @param fds         Where to save sockets (array of @p count elements).
+ * @param laddrs      Where to save local addresses of sockets
+ *                    (may be @c NULL).
+ * @param times       Where to save times from connect() call to
+ *                    connection establishment, nanoseconds
+ *                    (may be @c NULL).
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_sockets_bulk_connect(rcf_rpc_server *rpcs,
+                                         rpc_socket_domain domain,
+                                         int count,
+                                         const struct sockaddr *laddr,
+                                         const struct sockaddr *raddr,
+                                         int sndbuf, int rcvbuf,
+                                         int timeout, int *fds,
+                                         struct sockaddr_storage *laddrs,
+                                         uint64_t *times);
+
+/**
+ * Set @c TCP_NODELAY option and/or @c O_NONBLOCK flag for a number of
+ * sockets in a single RPC call.
+ *
+ * @param rpcs        RPC server handle.
+ * @param fds         Sockets.
+ * @param count       Number of sockets.
+ * @param nodelay     Whether to enable @c TCP_NODELAY.
+ * @param nonblock    Whether to set @c O_NONBLOCK.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_sockets_bulk_set_flags(rcf_rpc_server *rpcs,
+                                           const int *fds, int count,
+                                           te_bool nodelay,
+                                           te_bool nonblock);
+
+#endif /* !___RPC_ZF_BULK_H__ */
@@ -35,13 +35,22 @@ void
 rpc_iovec2str(rpc_iovec *iov, size_t iovcnt, te_string *str)
 {
     size_t i;
+    size_t len = 0;
 
     te_string_append(str, "{");
-    for (i = 0; i < iovcnt; i++)
+    for (i = 0; i < MIN(iovcnt, ZFTS_LOG_IOV_MAX); i++)
         te_string_append(str,"%s{%"TE_PRINTF_SIZE_T"u, "
                          "%p[%"TE_PRINTF_SIZE_T"u]}", (i == 0) ? "" : ", ",
                          iov[i].iov_len, iov[i].iov_base,
                          iov[i].iov_rlen);
+    if (iovcnt > ZFTS_LOG_IOV_MAX)
+    {
+        for (i = ZFTS_LOG_IOV_MAX; i < iovcnt; i++)
+            len += iov[i].iov_len;
+        te_string_append(str, ", ...%"TE_PRINTF_SIZE_T"u more of "
+                         "%"TE_PRINTF_SIZE_T"u bytes",
+                         iovcnt - ZFTS_LOG_IOV_MAX, len);
+    }
     te_string_append(str, "}");
 }
 
@@ -30,6 +30,40 @@
  * string representation. */
 extern te_string log_strbuf;
 
+/**
+ * Check whether TAPI_RPC_LOG() may print a message for the last RPC call,
+ * so that arguments are converted to strings only when they are going to
+ * be logged. A message is not printed for a successful call made with
+ * @b silent or @b silent_pass set, or if @c TE_LL_RING level is disabled
+ * at compile time; failed calls are always considered to be logged.
+ *
+ * @param rpcs_       RPC server handle.
+ */
+#define ZFTS_RPC_LOG_NEEDED(rpcs_) \
+    (!RPC_IS_CALL_OK(rpcs_) || (rpcs_)->err_log ||              \
+     ((TE_LOG_LEVEL & TE_LL_RING) != 0 &&                       \
+      !(rpcs_)->silent && !(rpcs_)->silent_pass))
+
+/**
+ * Clear @ref log_strbuf and fill it with string representation of
+ * RPC call arguments only if the call is going to be logged.
+ *
+ * @param rpcs_       RPC server handle.
+ * @param conv_       Expression appending arguments to @ref log_strbuf.
+ */
+#define ZFTS_LOG_STRBUF_FILL(rpcs_, conv_) \
+    do {                                                \
+        te_string_cut(&log_strbuf, log_strbuf.len);     \
+        if (ZFTS_RPC_LOG_NEEDED(rpcs_))                 \
+            conv_;                                      \
+    } while (0)
+
+/**
+ * Maximum number of vectors printed by rpc_iovec2str(), the rest are
+ * summarized.
+ */
+#define ZFTS_LOG_IOV_MAX 8
+
 /**
  * Network address format string for logging.
  */
@@ -54,7 +88,9 @@ extern te_string log_strbuf;
     (fwd_ ## addr ## len ? "passed" : "not passed")
 
 /**
- * Convert @p iov vectors array to TE string representation.
+ * Convert @p iov vectors array to TE string representation. Only the first
+ * @c ZFTS_LOG_IOV_MAX vectors are printed, the rest are summarized by
+ * their number and total length.
  *
  * @param iov       Iov vectors array.
  * @param iovcnt    The array length.
@@ -228,8 +228,8 @@ rpc_zf_muxer_add(rcf_rpc_server *rpcs, rpc_zf_muxer_set_p ms,
 
     CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zf_muxer_add, out.retval);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    epoll_events_rpc2str(rpcs, event, 1, &log_strbuf);
+    ZFTS_LOG_STRBUF_FILL(rpcs, epoll_events_rpc2str(rpcs, event, 1,
+                                                    &log_strbuf));
     TAPI_RPC_LOG(rpcs, zf_muxer_add,
                  RPC_PTR_FMT ", " RPC_PTR_FMT ", %p%s", "%d",
                  RPC_PTR_VAL(ms), RPC_PTR_VAL(waitable),
@@ -262,8 +262,8 @@ rpc_zf_muxer_mod(rcf_rpc_server *rpcs,
 
     CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zf_muxer_mod, out.retval);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    epoll_events_rpc2str(rpcs, event, 1, &log_strbuf);
+    ZFTS_LOG_STRBUF_FILL(rpcs, epoll_events_rpc2str(rpcs, event, 1,
+                                                    &log_strbuf));
     TAPI_RPC_LOG(rpcs, zf_muxer_mod,
                  RPC_PTR_FMT ", %p%s", "%d",
                  RPC_PTR_VAL(waitable),
@@ -330,7 +330,6 @@ rpc_zf_muxer_wait_gen(rcf_rpc_server *rpcs, rpc_zf_muxer_set_p ms,
 
     rcf_rpc_call(rpcs, "zf_muxer_wait", &in, &out);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
     if (RPC_IS_CALL_OK(rpcs))
     {
         if (events != NULL && out.events.events_val != NULL)
@@ -342,12 +341,17 @@ rpc_zf_muxer_wait_gen(rcf_rpc_server *rpcs, rpc_zf_muxer_set_p ms,
                     out.events.events_val[i].data.tarpc_epoll_data_u.u32;
             }
         }
-        epoll_events_rpc2str(rpcs, events, MIN(rmaxev, MAX(out.retval, 0)),
-                             &log_strbuf);
     }
 
     CHECK_RETVAL_VAR_IS_GTE_MINUS_ONE(zf_muxer_wait, out.retval);
 
+    te_string_cut(&log_strbuf, log_strbuf.len);
+    if (RPC_IS_CALL_OK(rpcs) && ZFTS_RPC_LOG_NEEDED(rpcs))
+    {
+        epoll_events_rpc2str(rpcs, events, MIN(rmaxev, MAX(out.retval, 0)),
+                             &log_strbuf);
+    }
+
     free(evts);
     TAPI_RPC_LOG(rpcs, zf_muxer_wait,
                  RPC_PTR_FMT ", %p, %d, %"TE_PRINTF_64"d", "%d %s",
@@ -378,7 +382,8 @@ rpc_zf_waitable_event(rcf_rpc_server *rpcs,
     {
         event->events = out.event.events;
         event->data.u32 = out.event.data.tarpc_epoll_data_u.u32;
-        epoll_events_rpc2str(rpcs, event, 1, &log_strbuf);
+        if (ZFTS_RPC_LOG_NEEDED(rpcs))
+            epoll_events_rpc2str(rpcs, event, 1, &log_strbuf);
     }
 
     TAPI_RPC_LOG(rpcs, zf_waitable_event, RPC_PTR_FMT, "%s",
@@ -461,3 +466,110 @@ rpc_zf_muxer_mod_rearm(rcf_rpc_server *rpcs,
 
     RETVAL_INT(zf_muxer_mod_rearm, out.retval);
 }
+
+/**
+ * Convert bulk muxer operation to string.
+ *
+ * @param op      Operation.
+ *
+ * @return String representation.
+ */
+static const char *
+zfts_muxer_bulk_op2str(zfts_muxer_bulk_op op)
+{
+    switch (op)
+    {
+        case ZFTS_MUXER_BULK_ADD:
+            return "add";
+
+        case ZFTS_MUXER_BULK_MOD:
+            return "mod";
+
+        case ZFTS_MUXER_BULK_DEL:
+            return "del";
+
+        default:
+            return "<unknown>";
+    }
+}
+
+/* See description in rpc_zf_muxer.h */
+int
+rpc_zf_muxer_bulk(rcf_rpc_server *rpcs, rpc_zf_muxer_set_p ms,
+                  zfts_muxer_bulk_op op, const rpc_zf_waitable_p *waitables,
+                  int count, uint32_t events, uint64_t *duration,
+                  uint64_t *max_duration)
+{
+    tarpc_zf_muxer_bulk_in  in;
+    tarpc_zf_muxer_bulk_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    if (op == ZFTS_MUXER_BULK_ADD)
+        TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, ms, RPC_TYPE_NS_ZF_MUXER_SET);
+    in.muxer_set = ms;
+    in.op = op;
+    in.waitables.waitables_len = count;
+    in.waitables.waitables_val = (tarpc_ptr *)waitables;
+    in.events = events;
+
+    rcf_rpc_call(rpcs, "zf_muxer_bulk", &in, &out);
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zf_muxer_bulk, out.retval);
+    TAPI_RPC_LOG(rpcs, zf_muxer_bulk,
+                 RPC_PTR_FMT ", %s, %d waitables, %s", "%d "
+                 "duration = %llu ns, max_duration = %llu ns",
+                 RPC_PTR_VAL(ms), zfts_muxer_bulk_op2str(op), count,
+                 epoll_event_rpc2str(events), out.retval,
+                 out.duration, out.max_duration);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
+    {
+        if (duration != NULL)
+            *duration = out.duration;
+        if (max_duration != NULL)
+            *max_duration = out.max_duration;
+    }
+
+    RETVAL_ZERO_INT(zf_muxer_bulk, out.retval);
+}
+
+/* See description in rpc_zf_muxer.h */
+int
+rpc_zf_muxer_wait_bench(rcf_rpc_server *rpcs, rpc_zf_muxer_set_p ms,
+                        int maxevents, int exp_events, int duration,
+                        tarpc_zf_muxer_wait_stats *stats)
+{
+    tarpc_zf_muxer_wait_bench_in  in;
+    tarpc_zf_muxer_wait_bench_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, ms, RPC_TYPE_NS_ZF_MUXER_SET);
+    in.muxer_set = ms;
+    in.maxevents = maxevents;
+    in.exp_events = exp_events;
+    in.duration = duration;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) + duration;
+
+    rcf_rpc_call(rpcs, "zf_muxer_wait_bench", &in, &out);
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zf_muxer_wait_bench, out.retval);
+    TAPI_RPC_LOG(rpcs, zf_muxer_wait_bench,
+                 RPC_PTR_FMT ", maxevents = %d, exp_events = %d, "
+                 "duration = %d", "%d calls = %llu, "
+                 "calls_with_events = %llu, events = %llu, "
+                 "duration = %llu ns",
+                 RPC_PTR_VAL(ms), maxevents, exp_events, duration,
+                 out.retval, out.stats.calls, out.stats.calls_with_events,
+                 out.stats.events, out.stats.duration);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT && stats != NULL)
+        *stats = out.stats;
+
+    RETVAL_ZERO_INT(zf_muxer_wait_bench, out.retval);
+}
@@ -257,4 +257,50 @@ extern int rpc_zf_waitable_fd_prime(rcf_rpc_server *rpcs,
 extern int rpc_zf_muxer_mod_rearm(rcf_rpc_server *rpcs,
                                   rpc_zf_waitable_p waitable);
 
+/**
+ * Apply @b zf_muxer_add(), @b zf_muxer_mod() or @b zf_muxer_del() to
+ * a list of waitables in a single RPC call, measuring how long it takes.
+ * Index of a waitable in @p waitables is used as event data.
+ *
+ * @param rpcs          RPC server handle.
+ * @param ms            RPC pointer to ZF muxer set (used only with
+ *                      @c ZFTS_MUXER_BULK_ADD).
+ * @param op            Operation to apply.
+ * @param waitables     Array of RPC pointers to zf_waitable objects.
+ * @param count         Number of elements in @p waitables.
+ * @param events        Events to wait for.
+ * @param duration      Where to save total time spent in ZF calls,
+ *                      nanoseconds (may be @c NULL).
+ * @param max_duration  Where to save maximum duration of a single ZF
+ *                      call, nanoseconds (may be @c NULL).
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zf_muxer_bulk(rcf_rpc_server *rpcs, rpc_zf_muxer_set_p ms,
+                             zfts_muxer_bulk_op op,
+                             const rpc_zf_waitable_p *waitables,
+                             int count, uint32_t events,
+                             uint64_t *duration, uint64_t *max_duration);
+
+/**
+ * Call @b zf_muxer_wait() with zero timeout in a loop until
+ * @p exp_events events are retrieved or @p duration expires, gathering
+ * statistics about duration of the calls and number of returned events.
+ *
+ * @param rpcs          RPC server handle.
+ * @param ms            RPC pointer to ZF muxer set.
+ * @param maxevents     Number of events to be passed to
+ *                      @a zf_muxer_wait.
+ * @param exp_events    Expected number of events.
+ * @param duration      How long to call @a zf_muxer_wait (milliseconds).
+ * @param stats         Where to save statistics.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zf_muxer_wait_bench(rcf_rpc_server *rpcs,
+                                   rpc_zf_muxer_set_p ms,
+                                   int maxevents, int exp_events,
+                                   int duration,
+                                   tarpc_zf_muxer_wait_stats *stats);
+
 #endif /* !___RPC_ZF_MUXER_H__ */
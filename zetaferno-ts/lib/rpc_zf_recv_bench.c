@@ -0,0 +1,149 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/** @file
+ * @brief Test API - receive benchmarks RPC functions implementation
+ *
+ * Implementation of TAPI for agent-side loops measuring cost of receive
+ * calls on zockets.
+ *
+ * $Id$
+ */
+
+#include "te_config.h"
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "tapi_rpc_internal.h"
+#include "zf_test.h"
+
+#include "rpc_zf_internal.h"
+#include "rpc_zf_recv_bench.h"
+
+#undef TE_LGR_USER
+#define TE_LGR_USER "ZF TAPI RECV BENCH RPC"
+
+/* See description in rpc_zf_recv_bench.h */
+int
+rpc_zfts_recv_bench(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                    rpc_ptr zocket, te_bool copy, int iovcnt, int duration,
+                    tarpc_zfts_recv_bench_stats *stats)
+{
+    tarpc_zfts_recv_bench_in  in;
+    tarpc_zfts_recv_bench_out out;
+
+    const char *ns_string = NULL;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stack, RPC_TYPE_NS_ZF_STACK);
+    in.stack = stack;
+    in.zocket = zocket;
+    in.copy = copy;
+    in.iovcnt = iovcnt;
+    in.duration = duration;
+
+    ns_string = tapi_rpc_namespace_get(rpcs, zocket);
+    if (ns_string == NULL)
+    {
+        ERROR("%s(): failed to get namespace of the zocket", __FUNCTION__);
+        RETVAL_INT(zfts_recv_bench, -1);
+    }
+    in.udp = (strcmp(ns_string, RPC_TYPE_NS_ZFUR) == 0);
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) + duration;
+
+    rcf_rpc_call(rpcs, "zfts_recv_bench", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
+        *stats = out.stats;
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_recv_bench, out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_recv_bench,
+                 RPC_PTR_FMT ", " RPC_PTR_FMT ", %s, iovcnt=%d, "
+                 "duration=%d", "%d bytes=%llu reactor_calls=%llu "
+                 "recv_calls=%llu done_calls=%llu",
+                 RPC_PTR_VAL(stack), RPC_PTR_VAL(zocket),
+                 copy ? "copy" : "zero-copy", iovcnt, duration,
+                 out.retval, (unsigned long long)out.stats.bytes,
+                 (unsigned long long)out.stats.reactor_calls,
+                 (unsigned long long)out.stats.recv_calls,
+                 (unsigned long long)out.stats.done_calls);
+
+    RETVAL_ZERO_INT(zfts_recv_bench, out.retval);
+}
+
+/* See description in rpc_zf_recv_bench.h */
+int
+rpc_zfts_rx_exhaust_bench(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                          const rpc_zft_p *zockets, int num, int baseline,
+                          int hold, int release_bufs,
+                          int release_interval, int recovery, int bucket,
+                          tarpc_zfts_rx_exhaust_stats *stats,
+                          uint64_t **series, unsigned int *buckets)
+{
+    tarpc_zfts_rx_exhaust_bench_in  in;
+    tarpc_zfts_rx_exhaust_bench_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stack, RPC_TYPE_NS_ZF_STACK);
+    in.stack = stack;
+    in.zockets.zockets_len = num;
+    in.zockets.zockets_val = (tarpc_ptr *)zockets;
+    in.baseline = baseline;
+    in.hold = hold;
+    in.release_bufs = release_bufs;
+    in.release_interval = release_interval;
+    in.recovery = recovery;
+    in.bucket = bucket;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+    {
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) + baseline +
+                        hold + recovery;
+    }
+
+    rcf_rpc_call(rpcs, "zfts_rx_exhaust_bench", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+    {
+        *stats = out.stats;
+        if (num <= 0 || out.series.series_len % num != 0)
+        {
+            ERROR("%s(): unexpected length of time series",
+                  __FUNCTION__);
+            out.retval = -1;
+            rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+        }
+        else
+        {
+            *series = tapi_calloc(MAX(out.series.series_len, 1),
+                                  sizeof(**series));
+            memcpy(*series, out.series.series_val,
+                   out.series.series_len * sizeof(**series));
+            *buckets = out.series.series_len / num;
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_rx_exhaust_bench,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_rx_exhaust_bench,
+                 RPC_PTR_FMT ", %d zockets, baseline=%d, hold=%d, "
+                 "release_bufs=%d, release_interval=%d, recovery=%d, "
+                 "bucket=%d", "%d held_bufs=%llu backlog_bufs=%llu "
+                 "release_ns=%s%llu",
+                 RPC_PTR_VAL(stack), num, baseline, hold, release_bufs,
+                 release_interval, recovery, bucket, out.retval,
+                 (unsigned long long)out.stats.held_bufs,
+                 (unsigned long long)out.stats.backlog_bufs,
+                 out.stats.released ? "" : "(not released) ",
+                 (unsigned long long)out.stats.release_ns);
+
+    RETVAL_ZERO_INT(zfts_rx_exhaust_bench, out.retval);
+}
@@ -0,0 +1,93 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/** @file
+ * @brief Test API - receive benchmarks RPC functions definition
+ *
+ * Definition of TAPI for agent-side loops measuring cost of receive
+ * calls on zockets.
+ *
+ * $Id$
+ */
+
+#ifndef ___RPC_ZF_RECV_BENCH_H__
+#define ___RPC_ZF_RECV_BENCH_H__
+
+#include "rcf_rpc.h"
+#include "zf_talib_namespace.h"
+#include "zf_talib_common.h"
+
+/**
+ * Drain a zocket flooded by peer for a given time. On every iteration
+ * the agent calls zf_reactor_perform() once and then receives all the
+ * available data passing @p iovcnt vectors to every receive call.
+ *
+ * Zero-copy mode uses zft_zc_recv() or zfur_zc_recv() followed by
+ * zft_zc_recv_done() or zfur_zc_recv_done(). Copy mode uses zft_recv()
+ * for TCP zocket; for UDP zocket (which has no copying receive call)
+ * data received with zfur_zc_recv() is copied to user buffers before
+ * zfur_zc_recv_done().
+ *
+ * @param rpcs        RPC server handle.
+ * @param stack       RPC pointer to ZF stack.
+ * @param zocket      RPC pointer to zft or zfur zocket.
+ * @param copy        Whether to copy data to user buffers.
+ * @param iovcnt      Number of vectors passed to a receive call
+ *                    (up to @c 64).
+ * @param duration    How long to receive, milliseconds.
+ * @param stats       Where to save statistics.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_recv_bench(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                               rpc_ptr zocket, te_bool copy, int iovcnt,
+                               int duration,
+                               tarpc_zfts_recv_bench_stats *stats);
+
+/**
+ * Measure recovery of TCP zockets sharing a stack after receive buffers
+ * are exhausted on one of them, while all the zockets are flooded by
+ * peers.
+ *
+ * All zockets are drained with zft_zc_recv() and zft_zc_recv_done() for
+ * @p baseline milliseconds. Then the first zocket (victim) gets data
+ * with zft_zc_recv() which is not completed, and its receive queue is
+ * not read for @p hold milliseconds. After that the held buffers are
+ * released and the backlog of the victim is read either at once
+ * (@p release_bufs is @c 0) or by @p release_bufs buffers every
+ * @p release_interval microseconds until its queue is empty. Then all
+ * the zockets are drained for @p recovery milliseconds.
+ *
+ * @param rpcs              RPC server handle.
+ * @param stack             RPC pointer to ZF stack.
+ * @param zockets           TCP zockets, the first one is the victim.
+ * @param num               Number of zockets.
+ * @param baseline          Time before exhaustion, milliseconds.
+ * @param hold              How long to hold buffers, milliseconds.
+ * @param release_bufs      How many buffers of the backlog to read at
+ *                          once.
+ * @param release_interval  Interval between backlog reads,
+ *                          microseconds.
+ * @param recovery          Time after releasing buffers, milliseconds.
+ * @param bucket            Width of a time bucket, milliseconds.
+ * @param stats             Where to save statistics.
+ * @param series            Where to save pointer to allocated array of
+ *                          bytes received per bucket: element
+ *                          @c i * @p num + @c j is for zocket @c j in
+ *                          bucket @c i (should be released by the
+ *                          caller).
+ * @param buckets           Where to save number of buckets.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_rx_exhaust_bench(rcf_rpc_server *rpcs,
+                                     rpc_zf_stack_p stack,
+                                     const rpc_zft_p *zockets, int num,
+                                     int baseline, int hold,
+                                     int release_bufs,
+                                     int release_interval, int recovery,
+                                     int bucket,
+                                     tarpc_zfts_rx_exhaust_stats *stats,
+                                     uint64_t **series,
+                                     unsigned int *buckets);
+
+#endif /* !___RPC_ZF_RECV_BENCH_H__ */
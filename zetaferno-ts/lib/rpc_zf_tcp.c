@@ -612,8 +612,7 @@ rpc_zft_zc_recv(rcf_rpc_server *rpcs, rpc_zft_p ts,
     if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
         rpc_zft_msg_tarpc2rpc(&out.msg, msg, TRUE);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    rpc_zft_msg2str(rpcs, msg, &log_strbuf);
+    ZFTS_LOG_STRBUF_FILL(rpcs, rpc_zft_msg2str(rpcs, msg, &log_strbuf));
 
     TAPI_RPC_LOG(rpcs, zft_zc_recv, RPC_PTR_FMT ", %s, %s", "",
                  RPC_PTR_VAL(ts), log_strbuf.ptr,
@@ -647,8 +646,7 @@ rpc_zft_zc_recv_done(rcf_rpc_server *rpcs, rpc_zft_p ts,
     if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
         rpc_zft_msg_tarpc2rpc(&out.msg, msg, FALSE);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    rpc_zft_msg2str(rpcs, msg, &log_strbuf);
+    ZFTS_LOG_STRBUF_FILL(rpcs, rpc_zft_msg2str(rpcs, msg, &log_strbuf));
     TAPI_RPC_LOG(rpcs, zft_zc_recv_done, RPC_PTR_FMT ", %s", "%d",
                  RPC_PTR_VAL(ts), log_strbuf.ptr, out.retval);
 
@@ -680,8 +678,7 @@ rpc_zft_zc_recv_done_some(rcf_rpc_server *rpcs, rpc_zft_p ts,
     if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
         rpc_zft_msg_tarpc2rpc(&out.msg, msg, FALSE);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    rpc_zft_msg2str(rpcs, msg, &log_strbuf);
+    ZFTS_LOG_STRBUF_FILL(rpcs, rpc_zft_msg2str(rpcs, msg, &log_strbuf));
     TAPI_RPC_LOG(rpcs, zft_zc_recv_done_some,
                  RPC_PTR_FMT ", %s, %"TE_PRINTF_SIZE_T"u", "%d",
                  RPC_PTR_VAL(ts), log_strbuf.ptr, len, out.retval);
@@ -719,10 +716,8 @@ rpc_zft_recv(rcf_rpc_server *rpcs, rpc_zft_p ts, rpc_iovec *iov,
 
     tarpc_iovec2rpc_iovec(out.iovec.iovec_val, iov, iovcnt);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    rpc_iovec2str(iov, iovcnt, &log_strbuf);
-
     CHECK_RETVAL_VAR_IS_GTE_MINUS_ONE(zft_recv, out.retval);
+    ZFTS_LOG_STRBUF_FILL(rpcs, rpc_iovec2str(iov, iovcnt, &log_strbuf));
     TAPI_RPC_LOG(rpcs, zft_recv, RPC_PTR_FMT ", iov = %s, iovcnt = %d, "
                  "flags %d", "%d", RPC_PTR_VAL(ts), log_strbuf.ptr,
                  iovcnt, flags, out.retval);
@@ -749,8 +744,7 @@ rpc_zft_read_zft_msg(rcf_rpc_server *rpcs, rpc_zft_msg_p msg_ptr,
     if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
         rpc_zft_msg_tarpc2rpc(&out.msg, msg, TRUE);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    rpc_zft_msg2str(rpcs, msg, &log_strbuf);
+    ZFTS_LOG_STRBUF_FILL(rpcs, rpc_zft_msg2str(rpcs, msg, &log_strbuf));
 
     TAPI_RPC_LOG(rpcs, zft_read_zft_msg, RPC_PTR_FMT ", %s", "",
                  RPC_PTR_VAL(msg_ptr), log_strbuf.ptr);
@@ -781,10 +775,8 @@ rpc_zft_send(rcf_rpc_server *rpcs, rpc_zft_p ts, rpc_iovec *iov,
     rcf_rpc_call(rpcs, "zft_send", &in, &out);
     free(in.iovec.iovec_val);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    rpc_iovec2str(iov, iovcnt, &log_strbuf);
-
     CHECK_RETVAL_VAR_IS_GTE_MINUS_ONE(zft_send, out.retval);
+    ZFTS_LOG_STRBUF_FILL(rpcs, rpc_iovec2str(iov, iovcnt, &log_strbuf));
     TAPI_RPC_LOG(rpcs, zft_send, RPC_PTR_FMT ", iov = %s, iovcnt = %d, "
                  "flags = %s", "%"TE_PRINTF_SIZE_T"d",
                  RPC_PTR_VAL(ts), log_strbuf.ptr,
@@ -963,11 +955,10 @@ rpc_zft_get_tx_timestamps(rcf_rpc_server *rpcs, rpc_zft_p tz,
         *count = out.count;
     }
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    zf_pkt_reports_rpc2str(reports, *count, &log_strbuf);
-
     CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zft_get_tx_timestamps,
                                           out.retval);
+    ZFTS_LOG_STRBUF_FILL(rpcs, zf_pkt_reports_rpc2str(reports, *count,
+                                                      &log_strbuf));
     TAPI_RPC_LOG(rpcs, zft_get_tx_timestamps, RPC_PTR_FMT ", %s, %d", "%d",
                  RPC_PTR_VAL(tz), log_strbuf.ptr, *count,
                  out.retval);
@@ -0,0 +1,386 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/** @file
+ * @brief Test API - TCP benchmarks RPC functions implementation
+ *
+ * Implementation of TAPI for agent-side loops used by TCP performance
+ * tests.
+ *
+ * $Id$
+ */
+
+#include "te_config.h"
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "tapi_rpc_internal.h"
+#include "zf_test.h"
+
+#include "rpc_zf_internal.h"
+#include "rpc_zf_tcp_bench.h"
+
+#undef TE_LGR_USER
+#define TE_LGR_USER "ZF TAPI TCP BENCH RPC"
+
+/** Grace period of agent-side loops, milliseconds */
+#define TCP_BENCH_GRACE 500
+
+/**
+ * Copy statistics and setup times returned by a churn RPC.
+ *
+ * @param rpcs        RPC server handle.
+ * @param out         RPC output.
+ * @param stats       Where to save statistics.
+ * @param times       Where to save setup times (may be @c NULL).
+ * @param times_num   On input - capacity of @p times, on output -
+ *                    number of saved times.
+ */
+static void
+churn_copy_out(rcf_rpc_server *rpcs, tarpc_zfts_tcp_churn_out *out,
+               tarpc_zfts_tcp_churn_stats *stats, uint64_t *times,
+               unsigned int *times_num)
+{
+    *stats = out->stats;
+    if (times == NULL)
+        return;
+
+    if (out->times.times_len > *times_num)
+    {
+        ERROR("%s(): too many setup times were returned", __FUNCTION__);
+        out->retval = -1;
+        rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+        return;
+    }
+
+    memcpy(times, out->times.times_val,
+           out->times.times_len * sizeof(*times));
+    *times_num = out->times.times_len;
+}
+
+/* See description in rpc_zf_tcp_bench.h */
+int
+rpc_zfts_tcp_churn(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                   rpc_zf_attr_p attr, rpc_zftl_p zftl,
+                   const struct sockaddr *raddr, int duration,
+                   int concurrency, tarpc_zfts_tcp_churn_stats *stats,
+                   uint64_t *times, unsigned int *times_num)
+{
+    tarpc_zfts_tcp_churn_in  in;
+    tarpc_zfts_tcp_churn_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stack, RPC_TYPE_NS_ZF_STACK);
+    in.stack = stack;
+    if (zftl != RPC_NULL)
+    {
+        TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, zftl, RPC_TYPE_NS_ZFTL);
+    }
+    else
+    {
+        TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, attr, RPC_TYPE_NS_ZF_ATTR);
+    }
+    in.attr = attr;
+    in.zftl = zftl;
+    sockaddr_input_h2rpc(raddr, &in.raddr);
+    in.duration = duration;
+    in.concurrency = concurrency;
+    in.max_times = (times == NULL ? 0 : *times_num);
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) + duration;
+
+    rcf_rpc_call(rpcs, "zfts_tcp_churn", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+        churn_copy_out(rpcs, &out, stats, times, times_num);
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_tcp_churn, out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_tcp_churn,
+                 RPC_PTR_FMT ", " RPC_PTR_FMT ", " RPC_PTR_FMT ", %s, "
+                 "duration = %d, concurrency = %d",
+                 "%d established=%llu closed=%llu failed=%llu "
+                 "alloc_fails=%llu",
+                 RPC_PTR_VAL(stack), RPC_PTR_VAL(attr), RPC_PTR_VAL(zftl),
+                 te_sockaddr2str(raddr), duration, concurrency, out.retval,
+                 (unsigned long long)out.stats.established,
+                 (unsigned long long)out.stats.closed,
+                 (unsigned long long)out.stats.failed,
+                 (unsigned long long)out.stats.alloc_fails);
+
+    RETVAL_ZERO_INT(zfts_tcp_churn, out.retval);
+}
+
+/* See description in rpc_zf_tcp_bench.h */
+int
+rpc_zfts_sockets_churn(rcf_rpc_server *rpcs, int listener,
+                       const struct sockaddr *laddr,
+                       const struct sockaddr *raddr, int duration,
+                       int concurrency, tarpc_zfts_tcp_churn_stats *stats,
+                       uint64_t *times, unsigned int *times_num)
+{
+    tarpc_zfts_sockets_churn_in  in;
+    tarpc_zfts_sockets_churn_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    in.listener = listener;
+    sockaddr_input_h2rpc(laddr, &in.laddr);
+    sockaddr_input_h2rpc(raddr, &in.raddr);
+    in.duration = duration;
+    in.concurrency = concurrency;
+    in.max_times = (times == NULL ? 0 : *times_num);
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+    {
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) + duration +
+                        TCP_BENCH_GRACE;
+    }
+
+    rcf_rpc_call(rpcs, "zfts_sockets_churn", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+        churn_copy_out(rpcs, &out, stats, times, times_num);
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_sockets_churn, out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_sockets_churn,
+                 "%d, laddr = %s, raddr = %s, duration = %d, "
+                 "concurrency = %d",
+                 "%d established=%llu closed=%llu failed=%llu "
+                 "alloc_fails=%llu",
+                 listener, te_sockaddr2str(laddr), te_sockaddr2str(raddr),
+                 duration, concurrency, out.retval,
+                 (unsigned long long)out.stats.established,
+                 (unsigned long long)out.stats.closed,
+                 (unsigned long long)out.stats.failed,
+                 (unsigned long long)out.stats.alloc_fails);
+
+    RETVAL_ZERO_INT(zfts_sockets_churn, out.retval);
+}
+
+/* See description in rpc_zf_tcp_bench.h */
+int
+rpc_zfts_tcp_send_bench(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                        rpc_zft_p zocket, int size, te_bool use_single,
+                        te_bool more, int flush_every, int mss,
+                        int duration,
+                        tarpc_zfts_tcp_send_bench_stats *stats)
+{
+    tarpc_zfts_tcp_send_bench_in  in;
+    tarpc_zfts_tcp_send_bench_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stack, RPC_TYPE_NS_ZF_STACK);
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, zocket, RPC_TYPE_NS_ZFT);
+    in.stack = stack;
+    in.zocket = zocket;
+    in.size = size;
+    in.use_single = use_single;
+    in.more = more;
+    in.flush_every = flush_every;
+    in.mss = mss;
+    in.duration = duration;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) + duration;
+
+    rcf_rpc_call(rpcs, "zfts_tcp_send_bench", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
+        *stats = out.stats;
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_tcp_send_bench, out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_tcp_send_bench,
+                 RPC_PTR_FMT ", " RPC_PTR_FMT ", size = %d, %s, "
+                 "more = %s, flush_every = %d, mss = %d, duration = %d",
+                 "%d writes=%llu bytes=%llu again=%llu",
+                 RPC_PTR_VAL(stack), RPC_PTR_VAL(zocket), size,
+                 use_single ? "zft_send_single" : "zft_send",
+                 more ? "TRUE" : "FALSE", flush_every, mss, duration,
+                 out.retval, (unsigned long long)out.stats.writes,
+                 (unsigned long long)out.stats.bytes,
+                 (unsigned long long)out.stats.again);
+
+    RETVAL_ZERO_INT(zfts_tcp_send_bench, out.retval);
+}
+
+/* See description in rpc_zf_tcp_bench.h */
+int
+rpc_zfts_tcp_rr_client(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                       rpc_zft_p zocket, int req_size, int resp_size,
+                       int depth, int duration,
+                       tarpc_zfts_tcp_rr_stats *stats, uint64_t *times,
+                       unsigned int *times_num)
+{
+    tarpc_zfts_tcp_rr_client_in  in;
+    tarpc_zfts_tcp_rr_client_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stack, RPC_TYPE_NS_ZF_STACK);
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, zocket, RPC_TYPE_NS_ZFT);
+    in.stack = stack;
+    in.zocket = zocket;
+    in.req_size = req_size;
+    in.resp_size = resp_size;
+    in.depth = depth;
+    in.duration = duration;
+    in.max_times = (times == NULL ? 0 : *times_num);
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+    {
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) + duration +
+                        TCP_BENCH_GRACE;
+    }
+
+    rcf_rpc_call(rpcs, "zfts_tcp_rr_client", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+    {
+        *stats = out.stats;
+        if (times != NULL)
+        {
+            if (out.times.times_len > *times_num)
+            {
+                ERROR("%s(): too many latencies were returned",
+                      __FUNCTION__);
+                out.retval = -1;
+                rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+            }
+            else
+            {
+                memcpy(times, out.times.times_val,
+                       out.times.times_len * sizeof(*times));
+                *times_num = out.times.times_len;
+            }
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_tcp_rr_client, out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_tcp_rr_client,
+                 RPC_PTR_FMT ", " RPC_PTR_FMT ", req_size = %d, "
+                 "resp_size = %d, depth = %d, duration = %d",
+                 "%d transactions=%llu again=%llu",
+                 RPC_PTR_VAL(stack), RPC_PTR_VAL(zocket), req_size,
+                 resp_size, depth, duration, out.retval,
+                 (unsigned long long)out.stats.transactions,
+                 (unsigned long long)out.stats.again);
+
+    RETVAL_ZERO_INT(zfts_tcp_rr_client, out.retval);
+}
+
+/* See description in rpc_zf_tcp_bench.h */
+int
+rpc_zfts_sockets_rr_server(rcf_rpc_server *rpcs, int fd, int req_size,
+                           int resp_size, int duration,
+                           tarpc_zfts_tcp_rr_stats *stats)
+{
+    tarpc_zfts_sockets_rr_server_in  in;
+    tarpc_zfts_sockets_rr_server_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    in.fd = fd;
+    in.req_size = req_size;
+    in.resp_size = resp_size;
+    in.duration = duration;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+    {
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) + duration +
+                        TCP_BENCH_GRACE;
+    }
+
+    rcf_rpc_call(rpcs, "zfts_sockets_rr_server", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
+        *stats = out.stats;
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_sockets_rr_server,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_sockets_rr_server,
+                 "%d, req_size = %d, resp_size = %d, duration = %d",
+                 "%d transactions=%llu",
+                 fd, req_size, resp_size, duration, out.retval,
+                 (unsigned long long)out.stats.transactions);
+
+    RETVAL_ZERO_INT(zfts_sockets_rr_server, out.retval);
+}
+
+/* See description in rpc_zf_tcp_bench.h */
+int
+rpc_zfts_tcp_send_space_bench(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                              rpc_zft_p zocket, int size, int sample_every,
+                              int duration,
+                              tarpc_zfts_tcp_send_space_stats *stats,
+                              tarpc_zfts_send_space_sample *samples,
+                              unsigned int *samples_num)
+{
+    tarpc_zfts_tcp_send_space_bench_in  in;
+    tarpc_zfts_tcp_send_space_bench_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stack, RPC_TYPE_NS_ZF_STACK);
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, zocket, RPC_TYPE_NS_ZFT);
+    in.stack = stack;
+    in.zocket = zocket;
+    in.size = size;
+    in.sample_every = sample_every;
+    in.duration = duration;
+    in.max_samples = (samples == NULL ? 0 : *samples_num);
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) + duration;
+
+    rcf_rpc_call(rpcs, "zfts_tcp_send_space_bench", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+    {
+        *stats = out.stats;
+        if (samples != NULL)
+        {
+            if (out.samples.samples_len > *samples_num)
+            {
+                ERROR("%s(): too many samples were returned",
+                      __FUNCTION__);
+                out.retval = -1;
+                rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+            }
+            else
+            {
+                memcpy(samples, out.samples.samples_val,
+                       out.samples.samples_len * sizeof(*samples));
+                *samples_num = out.samples.samples_len;
+            }
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_tcp_send_space_bench,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_tcp_send_space_bench,
+                 RPC_PTR_FMT ", " RPC_PTR_FMT ", size = %d, "
+                 "sample_every = %d, duration = %d",
+                 "%d writes=%llu bytes=%llu again=%llu stalls=%llu",
+                 RPC_PTR_VAL(stack), RPC_PTR_VAL(zocket), size,
+                 sample_every, duration, out.retval,
+                 (unsigned long long)out.stats.writes,
+                 (unsigned long long)out.stats.bytes,
+                 (unsigned long long)out.stats.again,
+                 (unsigned long long)out.stats.stalls);
+
+    RETVAL_ZERO_INT(zfts_tcp_send_space_bench, out.retval);
+}
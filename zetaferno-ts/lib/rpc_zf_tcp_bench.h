@@ -0,0 +1,203 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/** @file
+ * @brief Test API - TCP benchmarks RPC functions definition
+ *
+ * Definition of TAPI for agent-side loops used by TCP performance tests.
+ *
+ * $Id$
+ */
+
+#ifndef ___RPC_ZF_TCP_BENCH_H__
+#define ___RPC_ZF_TCP_BENCH_H__
+
+#include "rcf_rpc.h"
+#include "zf_talib_namespace.h"
+#include "zf_talib_common.h"
+
+/**
+ * Open and close TCP connections on IUT in a loop for a given time.
+ *
+ * If @p zftl is @c RPC_NULL, up to @p concurrency connections to
+ * @p raddr are opened actively at the same time; otherwise connections
+ * are accepted on @p zftl. Every connection is closed with
+ * zft_shutdown_tx() and zft_free() as soon as it is established.
+ * Failures to allocate a zocket are counted in @b alloc_fails and are
+ * not treated as errors.
+ *
+ * @param rpcs          RPC server handle.
+ * @param stack         RPC pointer to ZF stack.
+ * @param attr          RPC pointer to ZF attributes (for active open).
+ * @param zftl          RPC pointer to TCP listening zocket or
+ *                      @c RPC_NULL.
+ * @param raddr         Address to connect to (for active open).
+ * @param duration      How long to run, milliseconds.
+ * @param concurrency   Maximum number of connections being opened at
+ *                      the same time (for active open).
+ * @param stats         Where to save statistics.
+ * @param times         Where to save connection setup times,
+ *                      nanoseconds (for active open, may be @c NULL).
+ * @param times_num     On input - capacity of @p times, on output -
+ *                      number of saved setup times (may be @c NULL
+ *                      if @p times is @c NULL).
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_tcp_churn(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                              rpc_zf_attr_p attr, rpc_zftl_p zftl,
+                              const struct sockaddr *raddr, int duration,
+                              int concurrency,
+                              tarpc_zfts_tcp_churn_stats *stats,
+                              uint64_t *times, unsigned int *times_num);
+
+/**
+ * Serve TCP connections opened and closed by IUT in a loop on a peer
+ * using system sockets.
+ *
+ * If @p listener is not negative, connections are accepted on it;
+ * otherwise up to @p concurrency non-blocking connections to @p raddr
+ * are opened at the same time. A socket is closed after the peer
+ * closes connection. New connections are not opened after @p duration
+ * expires, but the loop runs for additional half a second to let
+ * IUT finish.
+ *
+ * @param rpcs          RPC server handle.
+ * @param listener      Listening socket or @c -1.
+ * @param laddr         Address to bind connecting sockets to
+ *                      (may be @c NULL).
+ * @param raddr         Address to connect to (when @p listener is
+ *                      negative).
+ * @param duration      How long to open connections, milliseconds.
+ * @param concurrency   Maximum number of sockets at the same time.
+ * @param stats         Where to save statistics.
+ * @param times         Where to save connection setup times,
+ *                      nanoseconds (when connecting, may be @c NULL).
+ * @param times_num     On input - capacity of @p times, on output -
+ *                      number of saved setup times (may be @c NULL
+ *                      if @p times is @c NULL).
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_sockets_churn(rcf_rpc_server *rpcs, int listener,
+                                  const struct sockaddr *laddr,
+                                  const struct sockaddr *raddr,
+                                  int duration, int concurrency,
+                                  tarpc_zfts_tcp_churn_stats *stats,
+                                  uint64_t *times,
+                                  unsigned int *times_num);
+
+/**
+ * Send small writes over a TCP zocket in a loop for a given time.
+ * zf_reactor_perform() is called after every write. Writes failed
+ * because send queue is full are counted and retried.
+ *
+ * If @p more is @c TRUE, every write except each @p flush_every-th one
+ * is made with @c MSG_MORE flag. Time a write waits in the send queue
+ * is estimated assuming that data sent with @c MSG_MORE is held until
+ * @p mss bytes are accumulated or a write without @c MSG_MORE is made.
+ *
+ * @param rpcs          RPC server handle.
+ * @param stack         RPC pointer to ZF stack.
+ * @param zocket        RPC pointer to TCP zocket.
+ * @param size          Size of every write.
+ * @param use_single    Use zft_send_single() instead of zft_send().
+ * @param more          Whether to use @c MSG_MORE.
+ * @param flush_every   How often to write without @c MSG_MORE.
+ * @param mss           Maximum segment size of the connection.
+ * @param duration      How long to send, milliseconds.
+ * @param stats         Where to save statistics.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_tcp_send_bench(rcf_rpc_server *rpcs,
+                                   rpc_zf_stack_p stack, rpc_zft_p zocket,
+                                   int size, te_bool use_single,
+                                   te_bool more, int flush_every, int mss,
+                                   int duration,
+                                   tarpc_zfts_tcp_send_bench_stats *stats);
+
+/**
+ * Run request/response client on a TCP zocket: send requests keeping
+ * up to @p depth of them outstanding and receive responses. New
+ * requests are not sent after @p duration expires; outstanding ones
+ * are waited for additional half a second.
+ *
+ * @param rpcs          RPC server handle.
+ * @param stack         RPC pointer to ZF stack.
+ * @param zocket        RPC pointer to TCP zocket.
+ * @param req_size      Request size.
+ * @param resp_size     Response size.
+ * @param depth         Maximum number of outstanding requests.
+ * @param duration      How long to send requests, milliseconds.
+ * @param stats         Where to save statistics.
+ * @param times         Where to save transaction latencies (from
+ *                      sending a request to receiving the whole
+ *                      response), nanoseconds (may be @c NULL).
+ * @param times_num     On input - capacity of @p times, on output -
+ *                      number of saved latencies (may be @c NULL if
+ *                      @p times is @c NULL).
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_tcp_rr_client(rcf_rpc_server *rpcs,
+                                  rpc_zf_stack_p stack, rpc_zft_p zocket,
+                                  int req_size, int resp_size, int depth,
+                                  int duration,
+                                  tarpc_zfts_tcp_rr_stats *stats,
+                                  uint64_t *times,
+                                  unsigned int *times_num);
+
+/**
+ * Run request/response server on a connected TCP socket: send
+ * @p resp_size bytes for every @p req_size bytes received. The server
+ * runs for @p duration and additional half a second.
+ *
+ * @param rpcs          RPC server handle.
+ * @param fd            Socket.
+ * @param req_size      Request size.
+ * @param resp_size     Response size.
+ * @param duration      How long the client sends requests,
+ *                      milliseconds.
+ * @param stats         Where to save statistics.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_sockets_rr_server(rcf_rpc_server *rpcs, int fd,
+                                      int req_size, int resp_size,
+                                      int duration,
+                                      tarpc_zfts_tcp_rr_stats *stats);
+
+/**
+ * Stream data over a TCP zocket as fast as possible for a given time,
+ * sampling available send space with zft_send_space() every
+ * @p sample_every send attempts. Writes failed because send queue is
+ * full are counted and retried; a sequence of such writes is a stall.
+ *
+ * Samples are kept in constant memory: when @p samples is full, every
+ * second sample is dropped and the sampling period is doubled, so the
+ * saved samples always cover the whole run.
+ *
+ * @param rpcs          RPC server handle.
+ * @param stack         RPC pointer to ZF stack.
+ * @param zocket        RPC pointer to TCP zocket.
+ * @param size          Size of every write.
+ * @param sample_every  Initial sampling period, in send attempts.
+ * @param duration      How long to send, milliseconds.
+ * @param stats         Where to save statistics.
+ * @param samples       Where to save send space samples (may be
+ *                      @c NULL).
+ * @param samples_num   On input - capacity of @p samples, on output -
+ *                      number of saved samples (may be @c NULL if
+ *                      @p samples is @c NULL).
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_tcp_send_space_bench(
+                                rcf_rpc_server *rpcs,
+                                rpc_zf_stack_p stack, rpc_zft_p zocket,
+                                int size, int sample_every, int duration,
+                                tarpc_zfts_tcp_send_space_stats *stats,
+                                tarpc_zfts_send_space_sample *samples,
+                                unsigned int *samples_num);
+
+#endif /* !___RPC_ZF_TCP_BENCH_H__ */
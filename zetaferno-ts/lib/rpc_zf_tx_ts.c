@@ -0,0 +1,261 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/** @file
+ * @brief Test API - TX timestamps collector RPC functions implementation
+ *
+ * Implementation of TAPI for the agent-side collector of TX packet
+ * reports.
+ *
+ * $Id$
+ */
+
+#include "te_config.h"
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "tapi_rpc_internal.h"
+#include "zf_test.h"
+
+#include "rpc_zf_internal.h"
+#include "rpc_zf_tx_ts.h"
+
+#undef TE_LGR_USER
+#define TE_LGR_USER "ZF TAPI TX TS RPC"
+
+/* See description in rpc_zf_tx_ts.h */
+int
+rpc_zfts_tx_ts_collector_start(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                               rpc_ptr zocket, unsigned int ring_size,
+                               te_bool on_demand,
+                               rpc_zfts_tx_ts_coll_p *coll)
+{
+    tarpc_zfts_tx_ts_collector_start_in  in;
+    tarpc_zfts_tx_ts_collector_start_out out;
+
+    const char *ns_string = NULL;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stack, RPC_TYPE_NS_ZF_STACK);
+    in.stack = stack;
+    in.zocket = zocket;
+    in.ring_size = ring_size;
+    in.on_demand = on_demand;
+
+    ns_string = tapi_rpc_namespace_get(rpcs, zocket);
+    if (ns_string == NULL)
+    {
+        ERROR("%s(): failed to get namespace of the zocket", __FUNCTION__);
+        RETVAL_INT(zfts_tx_ts_collector_start, -1);
+    }
+    in.udp = (strcmp(ns_string, RPC_TYPE_NS_ZFUT) == 0);
+
+    rcf_rpc_call(rpcs, "zfts_tx_ts_collector_start", &in, &out);
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_tx_ts_collector_start,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_tx_ts_collector_start,
+                 RPC_PTR_FMT ", " RPC_PTR_FMT ", %u, %s",
+                 RPC_PTR_FMT ", %d",
+                 RPC_PTR_VAL(stack), RPC_PTR_VAL(zocket), ring_size,
+                 on_demand ? "TRUE" : "FALSE",
+                 RPC_PTR_VAL(out.coll), out.retval);
+
+    if (RPC_IS_CALL_OK(rpcs) && out.retval >= 0)
+    {
+        if (TAPI_RPC_NAMESPACE_CHECK(rpcs, out.coll,
+                                     RPC_TYPE_NS_ZFTS_TX_TS_COLL))
+            RETVAL_INT(zfts_tx_ts_collector_start, -1);
+    }
+
+    *coll = out.coll;
+    RETVAL_ZERO_INT(zfts_tx_ts_collector_start, out.retval);
+}
+
+/* See description in rpc_zf_tx_ts.h */
+int
+rpc_zfts_tx_ts_collector_stats(rcf_rpc_server *rpcs,
+                               rpc_zfts_tx_ts_coll_p coll,
+                               tarpc_zfts_tx_ts_stats *stats)
+{
+    tarpc_zfts_tx_ts_collector_stats_in  in;
+    tarpc_zfts_tx_ts_collector_stats_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, coll, RPC_TYPE_NS_ZFTS_TX_TS_COLL);
+    in.coll = coll;
+
+    rcf_rpc_call(rpcs, "zfts_tx_ts_collector_stats", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
+        *stats = out.stats;
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_tx_ts_collector_stats,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_tx_ts_collector_stats, RPC_PTR_FMT,
+                 "%d reports=%llu dropped=%llu lost=%llu overwritten=%llu "
+                 "polls=%llu",
+                 RPC_PTR_VAL(coll), out.retval,
+                 (unsigned long long)out.stats.reports,
+                 (unsigned long long)out.stats.dropped,
+                 (unsigned long long)out.stats.lost,
+                 (unsigned long long)out.stats.overwritten,
+                 (unsigned long long)out.stats.polls);
+
+    RETVAL_ZERO_INT(zfts_tx_ts_collector_stats, out.retval);
+}
+
+/* See description in rpc_zf_tx_ts.h */
+int
+rpc_zfts_tx_ts_collector_read(rcf_rpc_server *rpcs,
+                              rpc_zfts_tx_ts_coll_p coll,
+                              tarpc_zf_pkt_report *reports,
+                              unsigned int max_num)
+{
+    tarpc_zfts_tx_ts_collector_read_in  in;
+    tarpc_zfts_tx_ts_collector_read_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, coll, RPC_TYPE_NS_ZFTS_TX_TS_COLL);
+    in.coll = coll;
+    in.max_num = max_num;
+
+    rcf_rpc_call(rpcs, "zfts_tx_ts_collector_read", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval >= 0)
+    {
+        if (out.reports.reports_len != (unsigned int)out.retval ||
+            out.reports.reports_len > max_num)
+        {
+            ERROR("%s(): unexpected number of reports was returned",
+                  __FUNCTION__);
+            out.retval = -1;
+            rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+        }
+        else
+        {
+            memcpy(reports, out.reports.reports_val,
+                   sizeof(*reports) * out.reports.reports_len);
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_GTE_MINUS_ONE(zfts_tx_ts_collector_read,
+                                      out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_tx_ts_collector_read, RPC_PTR_FMT ", %u", "%d",
+                 RPC_PTR_VAL(coll), max_num, out.retval);
+
+    RETVAL_INT(zfts_tx_ts_collector_read, out.retval);
+}
+
+/* See description in rpc_zf_tx_ts.h */
+int
+rpc_zfts_tx_ts_collector_drain(rcf_rpc_server *rpcs,
+                               rpc_zfts_tx_ts_coll_p coll,
+                               unsigned int min_num, unsigned int max_num,
+                               te_bool single_call)
+{
+    tarpc_zfts_tx_ts_collector_drain_in  in;
+    tarpc_zfts_tx_ts_collector_drain_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, coll, RPC_TYPE_NS_ZFTS_TX_TS_COLL);
+    in.coll = coll;
+    in.min_num = min_num;
+    in.max_num = max_num;
+    in.single_call = single_call;
+
+    rcf_rpc_call(rpcs, "zfts_tx_ts_collector_drain", &in, &out);
+
+    CHECK_RETVAL_VAR_IS_GTE_MINUS_ONE(zfts_tx_ts_collector_drain,
+                                      out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_tx_ts_collector_drain,
+                 RPC_PTR_FMT ", %u, %u, %s", "%d",
+                 RPC_PTR_VAL(coll), min_num, max_num,
+                 single_call ? "TRUE" : "FALSE", out.retval);
+
+    RETVAL_INT(zfts_tx_ts_collector_drain, out.retval);
+}
+
+/* See description in rpc_zf_tx_ts.h */
+int
+rpc_zfts_tx_ts_collector_stop(rcf_rpc_server *rpcs,
+                              rpc_zfts_tx_ts_coll_p coll)
+{
+    tarpc_zfts_tx_ts_collector_stop_in  in;
+    tarpc_zfts_tx_ts_collector_stop_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, coll, RPC_TYPE_NS_ZFTS_TX_TS_COLL);
+    in.coll = coll;
+
+    rcf_rpc_call(rpcs, "zfts_tx_ts_collector_stop", &in, &out);
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_tx_ts_collector_stop,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_tx_ts_collector_stop, RPC_PTR_FMT, "%d",
+                 RPC_PTR_VAL(coll), out.retval);
+
+    RETVAL_ZERO_INT(zfts_tx_ts_collector_stop, out.retval);
+}
+
+/* See description in rpc_zf_tx_ts.h */
+int
+rpc_zfts_tx_ts_paced_send(rcf_rpc_server *rpcs, rpc_zfts_tx_ts_coll_p coll,
+                          unsigned int rate, unsigned int burst,
+                          unsigned int size, unsigned int duration,
+                          unsigned int drain_interval, uint64_t *sent,
+                          uint64_t *again, uint64_t *elapsed)
+{
+    tarpc_zfts_tx_ts_paced_send_in  in;
+    tarpc_zfts_tx_ts_paced_send_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, coll, RPC_TYPE_NS_ZFTS_TX_TS_COLL);
+    in.coll = coll;
+    in.rate = rate;
+    in.burst = burst;
+    in.size = size;
+    in.duration = duration;
+    in.drain_interval = drain_interval;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) + duration;
+
+    rcf_rpc_call(rpcs, "zfts_tx_ts_paced_send", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
+    {
+        *sent = out.sent;
+        if (again != NULL)
+            *again = out.again;
+        *elapsed = out.elapsed;
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_tx_ts_paced_send,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_tx_ts_paced_send,
+                 RPC_PTR_FMT ", rate=%u, burst=%u, size=%u, duration=%u, "
+                 "drain_interval=%u", "%d sent=%llu again=%llu "
+                 "elapsed=%lluns",
+                 RPC_PTR_VAL(coll), rate, burst, size, duration,
+                 drain_interval, out.retval,
+                 (unsigned long long)out.sent,
+                 (unsigned long long)out.again,
+                 (unsigned long long)out.elapsed);
+
+    RETVAL_ZERO_INT(zfts_tx_ts_paced_send, out.retval);
+}
@@ -0,0 +1,158 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/** @file
+ * @brief Test API - TX timestamps collector RPC functions definition
+ *
+ * Definition of TAPI for the agent-side collector of TX packet reports.
+ * Once a collector is started for a zocket, the agent retrieves packet
+ * reports of that zocket after each zf_reactor_perform() call it makes
+ * on the zocket stack through the RPC server (including calls made by
+ * zf_process_events(), zf_process_events_long() and zf_wait_for_event()
+ * RPCs and by agent-side benchmark loops), keeps statistics and stores
+ * the latest reports in a ring.
+ * Agent-side flooders calling zf_process_events() of ZF library directly
+ * do not retrieve reports.
+ *
+ * An on-demand collector does not retrieve reports on
+ * zf_reactor_perform() calls; it does so only when
+ * rpc_zfts_tx_ts_collector_drain() is called, so ZF keeps and drops
+ * reports the same way as when get_tx_timestamps() is called over RPC.
+ *
+ * Releasing the zocket or its stack detaches the collector: it is not
+ * drained any more but keeps its statistics and reports until it is
+ * stopped. While the collector is active, zfut_get_tx_timestamps() or
+ * zft_get_tx_timestamps() should not be called on the zocket
+ * directly.
+ *
+ * $Id$
+ */
+
+#ifndef ___RPC_ZF_TX_TS_H__
+#define ___RPC_ZF_TX_TS_H__
+
+#include "rcf_rpc.h"
+#include "zf_talib_namespace.h"
+#include "zf_talib_common.h"
+
+/**
+ * Start collecting TX packet reports of a zocket.
+ *
+ * @param rpcs        RPC server handle.
+ * @param stack       RPC pointer to ZF stack of the zocket.
+ * @param zocket      RPC pointer to zfut or zft zocket.
+ * @param ring_size   How many of the latest reports to keep.
+ * @param on_demand   If @c TRUE, retrieve reports only in
+ *                    rpc_zfts_tx_ts_collector_drain().
+ * @param coll        Where to save RPC pointer to the collector.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_tx_ts_collector_start(rcf_rpc_server *rpcs,
+                                          rpc_zf_stack_p stack,
+                                          rpc_ptr zocket,
+                                          unsigned int ring_size,
+                                          te_bool on_demand,
+                                          rpc_zfts_tx_ts_coll_p *coll);
+
+/**
+ * Get statistics of a collector.
+ *
+ * Delay is time from the TX timestamp of a packet to the moment its
+ * report was retrieved by the agent; it is computed only for reports
+ * with @c ZF_PKT_REPORT_IN_SYNC flag. Gap is difference between
+ * TX timestamps of consecutive timestamped reports.
+ *
+ * @param rpcs        RPC server handle.
+ * @param coll        RPC pointer to the collector.
+ * @param stats       Where to save statistics.
+ *
+ * @return @c 0 on success, or negative value in case of failure
+ *         (including failure to retrieve reports during collection).
+ */
+extern int rpc_zfts_tx_ts_collector_stats(rcf_rpc_server *rpcs,
+                                          rpc_zfts_tx_ts_coll_p coll,
+                                          tarpc_zfts_tx_ts_stats *stats);
+
+/**
+ * Move the oldest reports stored by a collector to the caller.
+ *
+ * @param rpcs        RPC server handle.
+ * @param coll        RPC pointer to the collector.
+ * @param reports     Where to save reports.
+ * @param max_num     Maximum number of reports to retrieve.
+ *
+ * @return Number of retrieved reports, or @c -1 in case of failure.
+ */
+extern int rpc_zfts_tx_ts_collector_read(rcf_rpc_server *rpcs,
+                                         rpc_zfts_tx_ts_coll_p coll,
+                                         tarpc_zf_pkt_report *reports,
+                                         unsigned int max_num);
+
+/**
+ * Retrieve packet reports of the collector zocket into the collector
+ * ring by calling get_tx_timestamps() on the agent until it returns no
+ * reports. The ring should have space for at least @p max_num reports.
+ *
+ * @param rpcs          RPC server handle.
+ * @param coll          RPC pointer to the collector.
+ * @param min_num       Minimum number of reports requested by a single
+ *                      get_tx_timestamps() call.
+ * @param max_num       Maximum number of reports requested by a single
+ *                      get_tx_timestamps() call (the number is chosen
+ *                      randomly each time).
+ * @param single_call   If @c TRUE, call get_tx_timestamps() only once.
+ *
+ * @return Number of retrieved reports (@c 0 if there were no reports),
+ *         or @c -1 in case of failure.
+ */
+extern int rpc_zfts_tx_ts_collector_drain(rcf_rpc_server *rpcs,
+                                          rpc_zfts_tx_ts_coll_p coll,
+                                          unsigned int min_num,
+                                          unsigned int max_num,
+                                          te_bool single_call);
+
+/**
+ * Stop collecting TX packet reports and release the collector.
+ * Reports left in its ring are discarded.
+ *
+ * @param rpcs        RPC server handle.
+ * @param coll        RPC pointer to the collector.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_tx_ts_collector_stop(rcf_rpc_server *rpcs,
+                                         rpc_zfts_tx_ts_coll_p coll);
+
+/**
+ * Send UDP packets from the zfut zocket of a collector in bursts
+ * paced to a given rate. The agent calls zf_reactor_perform() between
+ * bursts and retrieves packet reports into the collector every
+ * @p drain_interval microseconds; after sending it processes the stack
+ * for a while and retrieves the remaining reports.
+ *
+ * @param rpcs            RPC server handle.
+ * @param coll            RPC pointer to the collector.
+ * @param rate            Packets per second.
+ * @param burst           Number of packets sent back-to-back.
+ * @param size            Payload size.
+ * @param duration        How long to send, milliseconds.
+ * @param drain_interval  Interval between retrieving reports,
+ *                        microseconds (@c 0 - after every
+ *                        zf_reactor_perform() call).
+ * @param sent            Where to save number of sent packets.
+ * @param again           Where to save number of sending attempts
+ *                        failed with @c EAGAIN (may be @c NULL).
+ * @param elapsed         Where to save sending time, nanoseconds.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_tx_ts_paced_send(rcf_rpc_server *rpcs,
+                                     rpc_zfts_tx_ts_coll_p coll,
+                                     unsigned int rate, unsigned int burst,
+                                     unsigned int size,
+                                     unsigned int duration,
+                                     unsigned int drain_interval,
+                                     uint64_t *sent, uint64_t *again,
+                                     uint64_t *elapsed);
+
+#endif /* !___RPC_ZF_TX_TS_H__ */
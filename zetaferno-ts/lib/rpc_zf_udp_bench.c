@@ -0,0 +1,382 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/** @file
+ * @brief Test API - UDP benchmarks RPC functions implementation
+ *
+ * Implementation of TAPI for agent-side loops used by UDP performance
+ * tests.
+ *
+ * $Id$
+ */
+
+#include "te_config.h"
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "tapi_rpc_internal.h"
+#include "zf_test.h"
+
+#include "rpc_zf_internal.h"
+#include "rpc_zf_udp_bench.h"
+
+#undef TE_LGR_USER
+#define TE_LGR_USER "ZF TAPI UDP BENCH RPC"
+
+/* See description in rpc_zf_udp_bench.h */
+int
+rpc_zfts_zfut_fanout_bench(rcf_rpc_server *rpcs,
+                           const rpc_zf_stack_p *stacks,
+                           const rpc_zfut_p *zockets, int num,
+                           zfts_send_function send_func, int dgram_size,
+                           int duration,
+                           tarpc_zfts_zfut_fanout_stats *stats,
+                           uint64_t *sent)
+{
+    tarpc_zfts_zfut_fanout_bench_in  in;
+    tarpc_zfts_zfut_fanout_bench_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    if (num > 0)
+    {
+        TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stacks[0],
+                                      RPC_TYPE_NS_ZF_STACK);
+        TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, zockets[0], RPC_TYPE_NS_ZFUT);
+    }
+    in.stacks.stacks_len = num;
+    in.stacks.stacks_val = (tarpc_ptr *)stacks;
+    in.zockets.zockets_len = num;
+    in.zockets.zockets_val = (tarpc_ptr *)zockets;
+    in.send_func = send_func;
+    in.dgram_size = dgram_size;
+    in.duration = duration;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+    {
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) +
+                        duration;
+    }
+
+    rcf_rpc_call(rpcs, "zfts_zfut_fanout_bench", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+    {
+        *stats = out.stats;
+        if (out.sent.sent_len != (unsigned int)num)
+        {
+            ERROR("%s(): unexpected number of per-zocket counters",
+                  __FUNCTION__);
+            out.retval = -1;
+            rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+        }
+        else
+        {
+            memcpy(sent, out.sent.sent_val, num * sizeof(*sent));
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_zfut_fanout_bench,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_zfut_fanout_bench,
+                 "%d zockets, %s, dgram_size=%d, duration=%d",
+                 "%d sends=%llu again=%llu send_ns=%llu",
+                 num, send_func == ZFTS_ZFUT_SEND ?
+                            "zfut_send" : "zfut_send_single",
+                 dgram_size, duration, out.retval,
+                 (unsigned long long)out.stats.sends,
+                 (unsigned long long)out.stats.again,
+                 (unsigned long long)out.stats.send_ns);
+
+    RETVAL_ZERO_INT(zfts_zfut_fanout_bench, out.retval);
+}
+
+/* See description in rpc_zf_udp_bench.h */
+int
+rpc_zfts_zfur_drain_bench(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                          const rpc_zfur_p *zockets, int num,
+                          int duration,
+                          tarpc_zfts_zfur_drain_stats *stats,
+                          uint64_t *dgrams)
+{
+    tarpc_zfts_zfur_drain_bench_in  in;
+    tarpc_zfts_zfur_drain_bench_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stack, RPC_TYPE_NS_ZF_STACK);
+    in.stack = stack;
+    if (num > 0)
+        TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, zockets[0], RPC_TYPE_NS_ZFUR);
+    in.zockets.zockets_len = num;
+    in.zockets.zockets_val = (tarpc_ptr *)zockets;
+    in.duration = duration;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+    {
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) +
+                        duration;
+    }
+
+    rcf_rpc_call(rpcs, "zfts_zfur_drain_bench", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+    {
+        *stats = out.stats;
+        if (out.dgrams.dgrams_len != (unsigned int)num)
+        {
+            ERROR("%s(): unexpected number of per-zocket counters",
+                  __FUNCTION__);
+            out.retval = -1;
+            rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+        }
+        else
+        {
+            memcpy(dgrams, out.dgrams.dgrams_val, num * sizeof(*dgrams));
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_zfur_drain_bench,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_zfur_drain_bench,
+                 RPC_PTR_FMT ", %d zockets, duration=%d",
+                 "%d dgrams=%llu polls=%llu empty_polls=%llu",
+                 RPC_PTR_VAL(stack), num, duration, out.retval,
+                 (unsigned long long)out.stats.dgrams,
+                 (unsigned long long)out.stats.polls,
+                 (unsigned long long)out.stats.empty_polls);
+
+    RETVAL_ZERO_INT(zfts_zfur_drain_bench, out.retval);
+}
+
+/* See description in rpc_zf_udp_bench.h */
+int
+rpc_zfts_zfur_forward_bench(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                            rpc_zfur_p urx, rpc_zfut_p utx,
+                            zfts_send_function send_func, int duration,
+                            tarpc_zfts_zfur_forward_stats *stats)
+{
+    tarpc_zfts_zfur_forward_bench_in  in;
+    tarpc_zfts_zfur_forward_bench_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stack, RPC_TYPE_NS_ZF_STACK);
+    in.stack = stack;
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, urx, RPC_TYPE_NS_ZFUR);
+    in.urx = urx;
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, utx, RPC_TYPE_NS_ZFUT);
+    in.utx = utx;
+    in.send_func = send_func;
+    in.duration = duration;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+    {
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) +
+                        duration;
+    }
+
+    rcf_rpc_call(rpcs, "zfts_zfur_forward_bench", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+        *stats = out.stats;
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_zfur_forward_bench,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_zfur_forward_bench,
+                 RPC_PTR_FMT ", " RPC_PTR_FMT ", " RPC_PTR_FMT ", %s, "
+                 "duration=%d",
+                 "%d received=%llu forwarded=%llu dropped=%llu "
+                 "again=%llu",
+                 RPC_PTR_VAL(stack), RPC_PTR_VAL(urx), RPC_PTR_VAL(utx),
+                 send_func == ZFTS_ZFUT_SEND ?
+                            "zfut_send" : "zfut_send_single",
+                 duration, out.retval,
+                 (unsigned long long)out.stats.received,
+                 (unsigned long long)out.stats.forwarded,
+                 (unsigned long long)out.stats.dropped,
+                 (unsigned long long)out.stats.again);
+
+    RETVAL_ZERO_INT(zfts_zfur_forward_bench, out.retval);
+}
+
+/* See description in rpc_zf_udp_bench.h */
+int
+rpc_zfts_sockets_udp_ts_flooder(rcf_rpc_server *rpcs, int snd_fd,
+                                int rcv_fd, int dgram_size, int rate,
+                                int duration,
+                                tarpc_zfts_udp_ts_stats *stats,
+                                uint64_t *times, unsigned int *times_num)
+{
+    tarpc_zfts_sockets_udp_ts_flooder_in  in;
+    tarpc_zfts_sockets_udp_ts_flooder_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    in.snd_fd = snd_fd;
+    in.rcv_fd = rcv_fd;
+    in.dgram_size = dgram_size;
+    in.rate = rate;
+    in.duration = duration;
+    in.max_samples = *times_num;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+    {
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) +
+                        duration;
+    }
+
+    rcf_rpc_call(rpcs, "zfts_sockets_udp_ts_flooder", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+    {
+        *stats = out.stats;
+        if (out.times.times_len > *times_num)
+        {
+            ERROR("%s(): too many latency samples were returned",
+                  __FUNCTION__);
+            out.retval = -1;
+            rpcs->_errno = TE_RC(TE_TAPI, TE_ECORRUPTED);
+        }
+        else
+        {
+            memcpy(times, out.times.times_val,
+                   out.times.times_len * sizeof(*times));
+            *times_num = out.times.times_len;
+        }
+    }
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_sockets_udp_ts_flooder,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_sockets_udp_ts_flooder,
+                 "%d, %d, dgram_size=%d, rate=%d, duration=%d",
+                 "%d sent=%llu received=%llu samples=%u",
+                 snd_fd, rcv_fd, dgram_size, rate, duration, out.retval,
+                 (unsigned long long)out.stats.sent,
+                 (unsigned long long)out.stats.received,
+                 out.times.times_len);
+
+    RETVAL_ZERO_INT(zfts_sockets_udp_ts_flooder, out.retval);
+}
+
+/* See description in rpc_zf_udp_bench.h */
+const char *
+zfts_sg_mode2str(zfts_sg_mode mode)
+{
+    switch (mode)
+    {
+        case ZFTS_SG_IOV:
+            return "iov";
+
+        case ZFTS_SG_LINEARISE:
+            return "linearise";
+
+        case ZFTS_SG_SINGLE:
+            return "single";
+
+        default:
+            return "<unknown>";
+    }
+}
+
+/* See description in rpc_zf_udp_bench.h */
+int
+rpc_zfts_zfut_sg_bench(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                       rpc_zfut_p utx, zfts_sg_mode mode, int dgram_size,
+                       int iovcnt, int duration,
+                       tarpc_zfts_zfut_sg_stats *stats)
+{
+    tarpc_zfts_zfut_sg_bench_in  in;
+    tarpc_zfts_zfut_sg_bench_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, stack, RPC_TYPE_NS_ZF_STACK);
+    in.stack = stack;
+    TAPI_RPC_NAMESPACE_CHECK_JUMP(rpcs, utx, RPC_TYPE_NS_ZFUT);
+    in.utx = utx;
+    in.mode = mode;
+    in.dgram_size = dgram_size;
+    in.iovcnt = iovcnt;
+    in.duration = duration;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+    {
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) +
+                        duration;
+    }
+
+    rcf_rpc_call(rpcs, "zfts_zfut_sg_bench", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+        *stats = out.stats;
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_zfut_sg_bench, out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_zfut_sg_bench,
+                 RPC_PTR_FMT ", " RPC_PTR_FMT ", %s, dgram_size=%d, "
+                 "iovcnt=%d, duration=%d",
+                 "%d sent=%llu again=%llu send_ns=%llu copy_ns=%llu",
+                 RPC_PTR_VAL(stack), RPC_PTR_VAL(utx),
+                 zfts_sg_mode2str(mode), dgram_size, iovcnt, duration,
+                 out.retval, (unsigned long long)out.stats.sent,
+                 (unsigned long long)out.stats.again,
+                 (unsigned long long)out.stats.send_ns,
+                 (unsigned long long)out.stats.copy_ns);
+
+    RETVAL_ZERO_INT(zfts_zfut_sg_bench, out.retval);
+}
+
+/* See description in rpc_zf_udp_bench.h */
+int
+rpc_zfts_sockets_udp_paced_send(rcf_rpc_server *rpcs, int fd,
+                                int dgram_size, int rate, uint64_t count,
+                                int duration,
+                                tarpc_zfts_udp_paced_stats *stats)
+{
+    tarpc_zfts_sockets_udp_paced_send_in  in;
+    tarpc_zfts_sockets_udp_paced_send_out out;
+
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+
+    in.fd = fd;
+    in.dgram_size = dgram_size;
+    in.rate = rate;
+    in.count = count;
+    in.duration = duration;
+
+    if (rpcs->timeout == RCF_RPC_UNSPEC_TIMEOUT)
+    {
+        rpcs->timeout = TE_SEC2MS(TAPI_RPC_TIMEOUT_EXTRA_SEC) +
+                        duration;
+    }
+
+    rcf_rpc_call(rpcs, "zfts_sockets_udp_paced_send", &in, &out);
+
+    if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT &&
+        out.retval == 0)
+        *stats = out.stats;
+
+    CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfts_sockets_udp_paced_send,
+                                          out.retval);
+    TAPI_RPC_LOG(rpcs, zfts_sockets_udp_paced_send,
+                 "%d, dgram_size=%d, rate=%d, count=%llu, duration=%d",
+                 "%d sent=%llu again=%llu",
+                 fd, dgram_size, rate, (unsigned long long)count,
+                 duration, out.retval,
+                 (unsigned long long)out.stats.sent,
+                 (unsigned long long)out.stats.again);
+
+    RETVAL_ZERO_INT(zfts_sockets_udp_paced_send, out.retval);
+}
@@ -0,0 +1,177 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/** @file
+ * @brief Test API - UDP benchmarks RPC functions definition
+ *
+ * Definition of TAPI for agent-side loops used by UDP performance
+ * tests.
+ *
+ * $Id$
+ */
+
+#ifndef ___RPC_ZF_UDP_BENCH_H__
+#define ___RPC_ZF_UDP_BENCH_H__
+
+#include "rcf_rpc.h"
+#include "zf_talib_namespace.h"
+#include "zf_talib_common.h"
+
+/**
+ * Send datagrams round-robin from a set of UDP TX zockets (e.g. bound
+ * to different multicast groups) for a given time. After every round
+ * the agent calls zf_reactor_perform() once on every distinct stack.
+ *
+ * @param rpcs        RPC server handle.
+ * @param stacks      RPC pointers to stack of every zocket; the same
+ *                    stack may be used by several zockets.
+ * @param zockets     RPC pointers to UDP TX zockets.
+ * @param num         Number of zockets.
+ * @param send_func   Send function.
+ * @param dgram_size  Size of every datagram.
+ * @param duration    How long to send, milliseconds.
+ * @param stats       Where to save statistics.
+ * @param sent        Where to save number of datagrams sent from every
+ *                    zocket (@p num elements).
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_zfut_fanout_bench(rcf_rpc_server *rpcs,
+                                      const rpc_zf_stack_p *stacks,
+                                      const rpc_zfut_p *zockets, int num,
+                                      zfts_send_function send_func,
+                                      int dgram_size, int duration,
+                                      tarpc_zfts_zfut_fanout_stats *stats,
+                                      uint64_t *sent);
+
+/**
+ * Receive datagrams on a set of UDP RX zockets of the same stack for a
+ * given time. Every iteration of the agent loop calls
+ * zf_reactor_perform() once and then drains every zocket with
+ * zfur_zc_recv().
+ *
+ * @param rpcs        RPC server handle.
+ * @param stack       RPC pointer to ZF stack.
+ * @param zockets     RPC pointers to UDP RX zockets.
+ * @param num         Number of zockets.
+ * @param duration    How long to receive, milliseconds.
+ * @param stats       Where to save statistics.
+ * @param dgrams      Where to save number of datagrams received on every
+ *                    zocket (@p num elements).
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_zfur_drain_bench(rcf_rpc_server *rpcs,
+                                     rpc_zf_stack_p stack,
+                                     const rpc_zfur_p *zockets, int num,
+                                     int duration,
+                                     tarpc_zfts_zfur_drain_stats *stats,
+                                     uint64_t *dgrams);
+
+/**
+ * Forward datagrams received on a UDP RX zocket with zfur_zc_recv() to
+ * a UDP TX zocket of the same stack for a given time. If the send call
+ * fails with @c EAGAIN, the agent keeps the datagram and processes the
+ * stack until it can be sent; datagrams which cannot be sent before
+ * the loop ends or are sent incompletely are counted as dropped.
+ *
+ * @param rpcs        RPC server handle.
+ * @param stack       RPC pointer to ZF stack.
+ * @param urx         RPC pointer to UDP RX zocket.
+ * @param utx         RPC pointer to UDP TX zocket.
+ * @param send_func   Send function.
+ * @param duration    How long to forward, milliseconds.
+ * @param stats       Where to save statistics.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_zfur_forward_bench(rcf_rpc_server *rpcs,
+                                       rpc_zf_stack_p stack,
+                                       rpc_zfur_p urx, rpc_zfut_p utx,
+                                       zfts_send_function send_func,
+                                       int duration,
+                                       tarpc_zfts_zfur_forward_stats *stats);
+
+/**
+ * Send datagrams carrying sequence number and send time from a socket
+ * and receive them back on another (or the same) socket, measuring the
+ * time every datagram spent on the way. After sending stops the agent
+ * keeps receiving for a short grace period.
+ *
+ * @param rpcs          RPC server handle.
+ * @param snd_fd        Connected UDP socket to send from.
+ * @param rcv_fd        UDP socket to receive on.
+ * @param dgram_size    Size of every datagram (at least 16 bytes).
+ * @param rate          Datagrams per second, @c 0 to send as fast as
+ *                      possible.
+ * @param duration      How long to send, milliseconds.
+ * @param stats         Where to save statistics.
+ * @param times         Where to save latency samples, nanoseconds.
+ * @param times_num     On input, maximum number of samples; on output,
+ *                      number of saved samples. Samples are decimated
+ *                      evenly if more datagrams are received.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_sockets_udp_ts_flooder(rcf_rpc_server *rpcs,
+                                           int snd_fd, int rcv_fd,
+                                           int dgram_size, int rate,
+                                           int duration,
+                                           tarpc_zfts_udp_ts_stats *stats,
+                                           uint64_t *times,
+                                           unsigned int *times_num);
+
+/**
+ * Get string representation of @ref zfts_sg_mode.
+ *
+ * @param mode  Value.
+ *
+ * @return String representation.
+ */
+extern const char *zfts_sg_mode2str(zfts_sg_mode mode);
+
+/**
+ * Send datagrams of a fixed size split into @p iovcnt vectors (every
+ * one pointing to a separate buffer) for a given time, measuring send
+ * calls and, in @c ZFTS_SG_LINEARISE mode, copying of the vectors to a
+ * contiguous buffer.
+ *
+ * @param rpcs        RPC server handle.
+ * @param stack       RPC pointer to ZF stack.
+ * @param utx         RPC pointer to UDP TX zocket.
+ * @param mode        How a datagram is passed to a send call.
+ * @param dgram_size  Size of every datagram.
+ * @param iovcnt      Number of vectors (ignored by
+ *                    @c ZFTS_SG_SINGLE mode apart from checks).
+ * @param duration    How long to send, milliseconds.
+ * @param stats       Where to save statistics.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_zfut_sg_bench(rcf_rpc_server *rpcs,
+                                  rpc_zf_stack_p stack, rpc_zfut_p utx,
+                                  zfts_sg_mode mode, int dgram_size,
+                                  int iovcnt, int duration,
+                                  tarpc_zfts_zfut_sg_stats *stats);
+
+/**
+ * Send datagrams from a connected socket at a given rate until either
+ * @p count datagrams are sent or @p duration passes. Send calls failing
+ * with @c EAGAIN or @c ENOBUFS are retried.
+ *
+ * @param rpcs          RPC server handle.
+ * @param fd            Connected UDP socket.
+ * @param dgram_size    Size of every datagram.
+ * @param rate          Datagrams per second, @c 0 to send as fast as
+ *                      possible.
+ * @param count         Number of datagrams to send, @c 0 for no limit.
+ * @param duration      Maximum time of sending, milliseconds.
+ * @param stats         Where to save statistics.
+ *
+ * @return @c 0 on success, or negative value in case of failure.
+ */
+extern int rpc_zfts_sockets_udp_paced_send(rcf_rpc_server *rpcs, int fd,
+                                           int dgram_size, int rate,
+                                           uint64_t count, int duration,
+                                           tarpc_zfts_udp_paced_stats *stats);
+
+#endif /* !___RPC_ZF_UDP_BENCH_H__ */
@@ -293,8 +293,7 @@ rpc_zfur_zc_recv(rcf_rpc_server *rpcs, rpc_zfur_p urx,
     if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
         rpc_zfur_msg_tarpc2rpc(&out.msg, msg, TRUE);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    rpc_zfur_msg2str(rpcs, msg, &log_strbuf);
+    ZFTS_LOG_STRBUF_FILL(rpcs, rpc_zfur_msg2str(rpcs, msg, &log_strbuf));
 
     TAPI_RPC_LOG(rpcs, zfur_zc_recv, RPC_PTR_FMT ", %s, %s", "",
                  RPC_PTR_VAL(urx), log_strbuf.ptr,
@@ -328,8 +327,7 @@ rpc_zfur_zc_recv_done(rcf_rpc_server *rpcs, rpc_zfur_p urx,
     if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
         rpc_zfur_msg_tarpc2rpc(&out.msg, msg, FALSE);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    rpc_zfur_msg2str(rpcs, msg, &log_strbuf);
+    ZFTS_LOG_STRBUF_FILL(rpcs, rpc_zfur_msg2str(rpcs, msg, &log_strbuf));
     TAPI_RPC_LOG(rpcs, zfur_zc_recv_done, RPC_PTR_FMT ", %s", "%d",
                  RPC_PTR_VAL(urx), log_strbuf.ptr, out.retval);
 
@@ -355,8 +353,7 @@ rpc_zfur_read_zfur_msg(rcf_rpc_server *rpcs, rpc_zfur_msg_p msg_ptr,
     if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
         rpc_zfur_msg_tarpc2rpc(&out.msg, msg, TRUE);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    rpc_zfur_msg2str(rpcs, msg, &log_strbuf);
+    ZFTS_LOG_STRBUF_FILL(rpcs, rpc_zfur_msg2str(rpcs, msg, &log_strbuf));
 
     TAPI_RPC_LOG(rpcs, zfur_read_zfur_msg, RPC_PTR_FMT ", %s", "",
                  RPC_PTR_VAL(msg_ptr), log_strbuf.ptr);
@@ -427,8 +424,7 @@ rpc_zfur_pkt_get_header(rcf_rpc_server *rpcs, rpc_zfur_p urx,
 
     CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfur_pkt_get_header, out.retval);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    rpc_zfur_msg2str(rpcs, msg, &log_strbuf);
+    ZFTS_LOG_STRBUF_FILL(rpcs, rpc_zfur_msg2str(rpcs, msg, &log_strbuf));
 
     if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
     {
@@ -442,10 +438,15 @@ rpc_zfur_pkt_get_header(rcf_rpc_server *rpcs, rpc_zfur_p urx,
         if (udph != NULL)
             memcpy(udph, out.udphdr.udphdr_val, out.udphdr.udphdr_len);
 
-        te_string_append(&log_strbuf, ", ");
-        tarpc_iphdr2str((struct iphdr *)out.iphdr.iphdr_val, &log_strbuf);
-        te_string_append(&log_strbuf, ", ");
-        tarpc_udphdr2str((struct udphdr *)out.udphdr.udphdr_val, &log_strbuf);
+        if (ZFTS_RPC_LOG_NEEDED(rpcs))
+        {
+            te_string_append(&log_strbuf, ", ");
+            tarpc_iphdr2str((struct iphdr *)out.iphdr.iphdr_val,
+                            &log_strbuf);
+            te_string_append(&log_strbuf, ", ");
+            tarpc_udphdr2str((struct udphdr *)out.udphdr.udphdr_val,
+                             &log_strbuf);
+        }
     }
 
     TAPI_RPC_LOG(rpcs, zfur_pkt_get_header, RPC_PTR_FMT ", %s", "%d",
@@ -481,8 +482,7 @@ rpc_zfur_zc_recv_send(rcf_rpc_server *rpcs,rpc_zfur_p urx,
     if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
         rpc_zfur_msg_tarpc2rpc(&out.msg, msg, TRUE);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    rpc_zfur_msg2str(rpcs, msg, &log_strbuf);
+    ZFTS_LOG_STRBUF_FILL(rpcs, rpc_zfur_msg2str(rpcs, msg, &log_strbuf));
     TAPI_RPC_LOG(rpcs, zfur_zc_recv_send, RPC_PTR_FMT ", %s, "
                  RPC_PTR_FMT, "%d", RPC_PTR_VAL(urx), log_strbuf.ptr,
                  RPC_PTR_VAL(utx), out.retval);
@@ -121,10 +121,8 @@ rpc_zfut_send(rcf_rpc_server *rpcs, rpc_zfut_p utx, rpc_iovec *iov,
     rcf_rpc_call(rpcs, "zfut_send", &in, &out);
     free(in.iovec.iovec_val);
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    rpc_iovec2str(iov, iovcnt, &log_strbuf);
-
     CHECK_RETVAL_VAR_IS_GTE_MINUS_ONE(zfut_send, out.retval);
+    ZFTS_LOG_STRBUF_FILL(rpcs, rpc_iovec2str(iov, iovcnt, &log_strbuf));
     TAPI_RPC_LOG(rpcs, zfut_send, RPC_PTR_FMT ", iov = %s, iovcnt = %d, "
                  "flags %s", "%d", RPC_PTR_VAL(utx), log_strbuf.ptr,
                  iovcnt, zfut_flags_rpc2str(flags), out.retval);
@@ -180,12 +178,30 @@ rpc_zfut_send_single(rcf_rpc_server *rpcs, rpc_zfut_p utx, const void *buf,
     RETVAL_INT(zfut_send_single, out.retval);
 }
 
-/* See description in rpc_zf_udp_tx.h */
-int
-rpc_zfut_flooder(rcf_rpc_server *rpcs, rpc_zf_stack_p stack, rpc_zfut_p utx,
-                 zfts_send_function send_func, int dgram_size,
-                 int iovcnt, int duration, uint64_t *stats,
-                 uint64_t *errors)
+/**
+ * Call @b zfut_flooder RPC.
+ *
+ * @param rpcs          RPC server handle.
+ * @param stack         Pointer to the stack object.
+ * @param utx           Pointer to UDP TX zocket.
+ * @param send_func     Transmitting function.
+ * @param dgram_size    Datagrams size or its offset from MSS, bytes.
+ * @param iovcnt        Iov vectors number.
+ * @param duration      How long transmit datagrams, milliseconds.
+ * @param fill_frame    Whether @p dgram_size is offset from MSS.
+ * @param stats         Sent data amount, bytes.
+ * @param errors        @c EAGAIN errors counter.
+ * @param size_used     Datagrams size which was used.
+ * @param header_size   Protocol headers size of a frame.
+ *
+ * @return @c Zero on success or a negative value in case of fail.
+ */
+static int
+zfut_flooder_call(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                  rpc_zfut_p utx, zfts_send_function send_func,
+                  int dgram_size, int iovcnt, int duration,
+                  te_bool fill_frame, uint64_t *stats, uint64_t *errors,
+                  int *size_used, int *header_size)
 {
     tarpc_zfut_flooder_in  in;
     tarpc_zfut_flooder_out out;
@@ -201,16 +217,18 @@ rpc_zfut_flooder(rcf_rpc_server *rpcs, rpc_zf_stack_p stack, rpc_zfut_p utx,
     in.dgram_size = dgram_size;
     in.iovcnt = iovcnt;
     in.duration = duration;
+    in.fill_frame = fill_frame;
 
     rcf_rpc_call(rpcs, "zfut_flooder", &in, &out);
 
     CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfut_flooder, out.retval);
 
     TAPI_RPC_LOG(rpcs, zfut_flooder, RPC_PTR_FMT", "RPC_PTR_FMT
-                 ", dgram_size = %d, duration = %d, stats = %llu, "
-                 "errors = %llu", "%d", RPC_PTR_VAL(stack),
-                 RPC_PTR_VAL(utx), dgram_size, duration, out.stats,
-                 out.errors, out.retval);
+                 ", dgram_size = %d%s, duration = %d, stats = %llu, "
+                 "errors = %llu, size_used = %d, header_size = %d", "%d",
+                 RPC_PTR_VAL(stack), RPC_PTR_VAL(utx), dgram_size,
+                 fill_frame ? " (from MSS)" : "", duration, out.stats,
+                 out.errors, out.dgram_size, out.header_size, out.retval);
 
     if (RPC_IS_CALL_OK(rpcs) && rpcs->op != RCF_RPC_WAIT)
     {
@@ -218,11 +236,40 @@ rpc_zfut_flooder(rcf_rpc_server *rpcs, rpc_zf_stack_p stack, rpc_zfut_p utx,
             *stats = out.stats;
         if (errors != NULL)
             *errors = out.errors;
+        if (size_used != NULL)
+            *size_used = out.dgram_size;
+        if (header_size != NULL)
+            *header_size = out.header_size;
     }
 
     RETVAL_ZERO_INT(zfut_flooder, out.retval);
 }
 
+/* See description in rpc_zf_udp_tx.h */
+int
+rpc_zfut_flooder(rcf_rpc_server *rpcs, rpc_zf_stack_p stack, rpc_zfut_p utx,
+                 zfts_send_function send_func, int dgram_size,
+                 int iovcnt, int duration, uint64_t *stats,
+                 uint64_t *errors)
+{
+    return zfut_flooder_call(rpcs, stack, utx, send_func, dgram_size,
+                             iovcnt, duration, FALSE, stats, errors,
+                             NULL, NULL);
+}
+
+/* See description in rpc_zf_udp_tx.h */
+int
+rpc_zfut_flooder_fill_frame(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
+                            rpc_zfut_p utx, zfts_send_function send_func,
+                            int mss_offset, int iovcnt, int duration,
+                            uint64_t *stats, uint64_t *errors,
+                            int *dgram_size, int *header_size)
+{
+    return zfut_flooder_call(rpcs, stack, utx, send_func, mss_offset,
+                             iovcnt, duration, TRUE, stats, errors,
+                             dgram_size, header_size);
+}
+
 /* See description in rpc_zf_udp_tx.h */
 rpc_zf_waitable_p
 rpc_zfut_to_waitable(rcf_rpc_server *rpcs, rpc_zfut_p utx)
@@ -297,11 +344,10 @@ rpc_zfut_get_tx_timestamps(rcf_rpc_server *rpcs, rpc_zfut_p utx,
         *count = out.count;
     }
 
-    te_string_cut(&log_strbuf, log_strbuf.len);
-    zf_pkt_reports_rpc2str(reports, *count, &log_strbuf);
-
     CHECK_RETVAL_VAR_IS_ZERO_OR_MINUS_ONE(zfut_get_tx_timestamps,
                                           out.retval);
+    ZFTS_LOG_STRBUF_FILL(rpcs, zf_pkt_reports_rpc2str(reports, *count,
+                                                      &log_strbuf));
 
     TAPI_RPC_LOG(rpcs, zfut_get_tx_timestamps, RPC_PTR_FMT ", %s, %d", "%d",
                  RPC_PTR_VAL(utx), log_strbuf.ptr, *count,
@@ -147,6 +147,37 @@ extern int rpc_zfut_flooder(rcf_rpc_server *rpcs, rpc_zf_stack_p stack,
                             int dgram_size, int iovcnt, int duration,
                             uint64_t *stats, uint64_t *errors);
 
+/**
+ * Send datagrams sized relative to the maximum payload which fits in
+ * one frame (as reported by @b zfut_get_mss()) during a period of time.
+ *
+ * @param rpcs          RPC server handle.
+ * @param stack         Pointer to the stack object.
+ * @param utx           Pointer to UDP TX zocket.
+ * @param send_func     Transmitting function.
+ * @param mss_offset    Offset added to MSS to get datagrams size, bytes
+ *                      (@c 0 to fill exactly one frame).
+ * @param iovcnt        Iov vectors number.
+ * @param duration      How long transmit datagrams, milliseconds.
+ * @param stats         Sent data amount, bytes.
+ * @param errors        @c EAGAIN errors counter.
+ * @param dgram_size    Where to save datagrams size which was used
+ *                      (may be @c NULL).
+ * @param header_size   Where to save protocol headers size of a frame
+ *                      as reported by @b zfut_get_header_size()
+ *                      (may be @c NULL).
+ *
+ * @return @c Zero on success or a negative value in case of fail.
+ */
+extern int rpc_zfut_flooder_fill_frame(rcf_rpc_server *rpcs,
+                                       rpc_zf_stack_p stack,
+                                       rpc_zfut_p utx,
+                                       zfts_send_function send_func,
+                                       int mss_offset, int iovcnt,
+                                       int duration, uint64_t *stats,
+                                       uint64_t *errors, int *dgram_size,
+                                       int *header_size);
+
 /**
  * Get pointer to @b zf_waitatable structure of ZF UDP TX zocket.
  *
@@ -17,6 +17,7 @@
 #include "zfts_tcp.h"
 #include "te_dbuf.h"
 #include "te_param.h"
+#include "te_mi_log.h"
 
 /** Shell command to get sockstat data. */
 #define  ZFTS_SOCKSTAT_CMD  "cat /proc/net/sockstat"
@@ -42,14 +43,191 @@ typedef struct zfts_sockstat_stats {
     int udp_inuse;
 } zfts_sockstat_stats;
 
+/**
+ * Check whether reusing ZF stacks across tests is enabled.
+ *
+ * @return @c TRUE if @c TE_RPC_ZF_STACK_POOL_ENABLED environment variable
+ *         is set.
+ */
+static te_bool
+zfts_stack_pool_enabled(void)
+{
+    return tapi_getenv_bool("TE_RPC_ZF_STACK_POOL_ENABLED");
+}
+
 /* See description in zetaferno_ts.h */
 void
 zfts_create_stack(rcf_rpc_server *rpcs, rpc_zf_attr_p *attr,
                   rpc_zf_stack_p *stack)
 {
-    rpc_zf_init(rpcs);
+    if (!zfts_stack_pool_enabled())
+    {
+        rpc_zf_init(rpcs);
+        rpc_zf_attr_alloc(rpcs, attr);
+        rpc_zf_stack_alloc(rpcs, *attr, stack);
+        return;
+    }
+
+    /*
+     * ZF library is not deinitialized when a stack is parked, so it is
+     * initialized only if a new stack is allocated.
+     */
+    rpc_zfts_stack_pool_get(rpcs, stack);
+    if (*stack == RPC_NULL)
+        rpc_zf_init(rpcs);
+
     rpc_zf_attr_alloc(rpcs, attr);
-    rpc_zf_stack_alloc(rpcs, *attr, stack);
+
+    if (*stack == RPC_NULL)
+        rpc_zfts_stack_pool_alloc(rpcs, *attr, stack);
+    else
+        RING("Reusing ZF stack " RPC_PTR_FMT " parked by a previous test",
+             RPC_PTR_VAL(*stack));
+}
+
+/* See description in zetaferno_ts.h */
+te_bool
+zfts_park_stack(rcf_rpc_server *rpcs, rpc_zf_stack_p *stack,
+                te_bool passed)
+{
+    te_bool parked = FALSE;
+
+    if (*stack == RPC_NULL || !zfts_stack_pool_enabled())
+        return FALSE;
+
+    if (!passed)
+    {
+        RING("ZF stack " RPC_PTR_FMT " is not parked since the test "
+             "failed", RPC_PTR_VAL(*stack));
+        return FALSE;
+    }
+
+    RPC_AWAIT_ERROR(rpcs);
+    if (rpc_zfts_stack_pool_park(rpcs, *stack, &parked) != 0)
+    {
+        ERROR("Failed to park ZF stack: %r", RPC_ERRNO(rpcs));
+        return FALSE;
+    }
+
+    if (parked)
+        *stack = RPC_NULL;
+
+    return parked;
+}
+
+/* See description in zetaferno_ts.h */
+void
+zfts_stack_pool_drain(rcf_rpc_server *rpcs)
+{
+    tarpc_zfts_stack_pool_stats  stats;
+    te_mi_logger                *logger;
+    double                       alloc_ms;
+    double                       free_ms;
+    double                       saved_s;
+
+    if (!zfts_stack_pool_enabled())
+        return;
+
+    RPC_AWAIT_ERROR(rpcs);
+    if (rpc_zfts_stack_pool_drain(rpcs, &stats) != 0)
+    {
+        ERROR_VERDICT("Failed to release ZF stacks parked in the pool");
+        return;
+    }
+
+    alloc_ms = stats.allocs == 0 ? 0 :
+               (double)stats.alloc_ns / stats.allocs / 1000000;
+    free_ms = stats.frees == 0 ? 0 :
+              (double)stats.free_ns / stats.frees / 1000000;
+    saved_s = stats.reuses * (alloc_ms + free_ms) / 1000;
+
+    RING("ZF stack pool: %llu stacks allocated (%.2f ms on average), "
+         "%llu reused, %llu parked, %llu not parked, %llu released "
+         "(%.2f ms on average); about %.1f s saved",
+         (unsigned long long)stats.allocs, alloc_ms,
+         (unsigned long long)stats.reuses,
+         (unsigned long long)stats.parks,
+         (unsigned long long)stats.rejects,
+         (unsigned long long)stats.frees, free_ms, saved_s);
+
+    CHECK_RC(te_mi_logger_meas_create("zf_stack_pool", &logger));
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "stack alloc",
+                          TE_MI_MEAS_AGGR_MEAN, alloc_ms,
+                          TE_MI_MEAS_MULTIPLIER_MILLI);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "stack free",
+                          TE_MI_MEAS_AGGR_MEAN, free_ms,
+                          TE_MI_MEAS_MULTIPLIER_MILLI);
+    te_mi_logger_add_comment(logger, NULL, "allocs", "%llu",
+                             (unsigned long long)stats.allocs);
+    te_mi_logger_add_comment(logger, NULL, "reuses", "%llu",
+                             (unsigned long long)stats.reuses);
+    te_mi_logger_add_comment(logger, NULL, "not_parked", "%llu",
+                             (unsigned long long)stats.rejects);
+    te_mi_logger_add_comment(logger, NULL, "saved_seconds", "%.1f",
+                             saved_s);
+    te_mi_logger_destroy(logger);
+}
+
+/* See description in zetaferno_ts.h */
+int
+zfts_time_cmp(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* See description in zetaferno_ts.h */
+uint64_t
+zfts_time_pml(const uint64_t *times, unsigned int num, unsigned int pml)
+{
+    return times[MIN((uint64_t)num * pml / 1000, num - 1)];
+}
+
+/* See description in zetaferno_ts.h */
+void
+zfts_reactor_hist2str(te_string *str, const char *name,
+                      const tarpc_zfts_reactor_hist *hist, uint64_t tsc_hz)
+{
+    double   ns_per_tick = tsc_hz == 0 ? 0 : 1e9 / tsc_hz;
+    unsigned int i;
+
+    te_string_append(str, "%s: calls=%llu mean=%.0fns max=%.0fns\n", name,
+                     (unsigned long long)hist->calls,
+                     hist->calls == 0 ? 0 :
+                        (double)hist->ticks / hist->calls * ns_per_tick,
+                     hist->max * ns_per_tick);
+
+    for (i = 0; i < TE_ARRAY_LEN(hist->buckets); i++)
+    {
+        if (hist->buckets[i] == 0)
+            continue;
+
+        te_string_append(str, "  [%.0f, %.0f) ns: %llu\n",
+                         (double)(1ULL << i) * ns_per_tick,
+                         (double)(1ULL << i) * 2 * ns_per_tick,
+                         (unsigned long long)hist->buckets[i]);
+    }
+}
+
+/* See description in zetaferno_ts.h */
+void
+zfts_log_reactor_profile(rpc_zf_stack_p stack,
+                         const tarpc_zfts_reactor_profile *prof)
+{
+    te_string str = TE_STRING_INIT;
+
+    zfts_reactor_hist2str(&str, "zf_reactor_perform() with events",
+                          &prof->events, prof->tsc_hz);
+    zfts_reactor_hist2str(&str, "zf_reactor_perform() without events",
+                          &prof->idle, prof->tsc_hz);
+    zfts_reactor_hist2str(&str, "zf_stack_has_pending_work()",
+                          &prof->has_pending, prof->tsc_hz);
+
+    RING("Reactor profile of stack " RPC_PTR_FMT ":\n%s",
+         RPC_PTR_VAL(stack), str.ptr);
+    te_string_free(&str);
 }
 
 /* See description in zetaferno_ts.h */
@@ -57,6 +235,23 @@ void
 zfts_destroy_stack(rcf_rpc_server *rpcs, rpc_zf_attr_p attr,
                    rpc_zf_stack_p stack)
 {
+    tarpc_zfts_reactor_profile prof;
+
+    if (stack != RPC_NULL &&
+        tapi_getenv_bool("TE_RPC_ZF_REACTOR_PROFILE_ENABLED"))
+    {
+        RPC_AWAIT_ERROR(rpcs);
+        if (rpc_zfts_reactor_profile_get(rpcs, stack, FALSE, &prof) == 0)
+            zfts_log_reactor_profile(stack, &prof);
+    }
+
+    if (zfts_park_stack(rpcs, &stack, TRUE))
+    {
+        if (attr != RPC_NULL)
+            rpc_zf_attr_free(rpcs, attr);
+        return;
+    }
+
     if (stack != RPC_NULL)
         rpc_zf_stack_free(rpcs, stack);
 
@@ -20,6 +20,7 @@
 #include "te_errno.h"
 #include "te_bufs.h"
 #include "te_dbuf.h"
+#include "te_string.h"
 #include "logger_api.h"
 #include "te_sleep.h"
 #include "tapi_jmp.h"
@@ -146,7 +147,11 @@ extern void zfts_sendto_iov(rcf_rpc_server *rpcs, int sock,
                             const struct sockaddr *dst_addr);
 
 /**
- * Initialize ZF library, allocate attributes and stack.
+ * Initialize ZF library, allocate attributes and stack. If
+ * @c TE_RPC_ZF_STACK_POOL_ENABLED environment variable is set, a stack
+ * parked by a previous test in the agent stack pool is reused if it
+ * was allocated with the same @b ZF_ATTR value (ZF library is not
+ * initialized again then).
  *
  * @param rpcs      RPC server handle.
  * @param stack     Pointer to the stack object.
@@ -156,9 +161,88 @@ extern void zfts_create_stack(rcf_rpc_server *rpcs, rpc_zf_attr_p *attr,
                               rpc_zf_stack_p *stack);
 
 /**
- * Free ZF attributes and stack and deinitialize ZF library. The function
- * can be safely used in cleanup code, it checks attribute and stack RPC
- * pointers against @c RPC_NULL.
+ * Park a stack created with zfts_create_stack() in the agent stack pool
+ * instead of releasing it, so that the next test can reuse it. It is
+ * done only if @c TE_RPC_ZF_STACK_POOL_ENABLED environment variable is
+ * set, the test has passed so far, the stack is quiescent and the agent
+ * does not know about any zockets or alternatives still allocated on it;
+ * ZF library should not be deinitialized if the stack is parked.
+ *
+ * @param rpcs      RPC server handle.
+ * @param stack     Pointer to the stack object, set to @c RPC_NULL if
+ *                  the stack is parked.
+ * @param passed    @c FALSE if the test has failed, then the stack is
+ *                  never parked.
+ *
+ * @return @c TRUE if the stack is parked.
+ */
+extern te_bool zfts_park_stack(rcf_rpc_server *rpcs, rpc_zf_stack_p *stack,
+                               te_bool passed);
+
+/**
+ * Release stacks parked in the agent stack pool (so that resource leak
+ * checks see the state without them) and report how much time reusing
+ * stacks saved. Nothing is done if @c TE_RPC_ZF_STACK_POOL_ENABLED
+ * environment variable is not set.
+ *
+ * @param rpcs      RPC server handle.
+ */
+extern void zfts_stack_pool_drain(rcf_rpc_server *rpcs);
+
+/**
+ * Compare two durations for qsort().
+ *
+ * @param a     Pointer to the first uint64_t value.
+ * @param b     Pointer to the second uint64_t value.
+ *
+ * @return Negative, zero or positive value.
+ */
+extern int zfts_time_cmp(const void *a, const void *b);
+
+/**
+ * Get percentile of durations sorted with zfts_time_cmp().
+ *
+ * @param times     Sorted array.
+ * @param num       Number of elements (must be positive).
+ * @param pml       Percentile multiplied by 10 (e.g. @c 999 for
+ *                  p99.9).
+ *
+ * @return Value of the percentile.
+ */
+extern uint64_t zfts_time_pml(const uint64_t *times, unsigned int num,
+                              unsigned int pml);
+
+/**
+ * Append a histogram of call durations (as reported by agent benchmarks
+ * and reactor profiling) to a string.
+ *
+ * @param str       String.
+ * @param name      Name of the histogram.
+ * @param hist      Histogram.
+ * @param tsc_hz    Frequency of TSC.
+ */
+extern void zfts_reactor_hist2str(te_string *str, const char *name,
+                                  const tarpc_zfts_reactor_hist *hist,
+                                  uint64_t tsc_hz);
+
+/**
+ * Log profile of zf_reactor_perform() calls made by the agent on a stack
+ * as histograms of call durations.
+ *
+ * @param stack     RPC pointer of the stack (used in the log only).
+ * @param prof      Reactor profile.
+ */
+extern void zfts_log_reactor_profile(rpc_zf_stack_p stack,
+                                     const tarpc_zfts_reactor_profile *prof);
+
+/**
+ * Free ZF attributes and stack and deinitialize ZF library. If
+ * @c TE_RPC_ZF_REACTOR_PROFILE_ENABLED environment variable is set,
+ * reactor profile of the stack is logged before releasing it. The stack
+ * is parked rather than released if zfts_park_stack() allows, so it
+ * should be called only while the test passes; cleanup code should use
+ * CLEANUP_RPC_ZFTS_DESTROY_STACK() instead. The function checks
+ * attribute and stack RPC pointers against @c RPC_NULL.
  *
  * @param rpcs      RPC server handle.
  * @param stack     Pointer to the stack object.
@@ -239,17 +323,23 @@ extern void zfts_destroy_stack(rcf_rpc_server *rpcs, rpc_zf_attr_p attr,
 
 /**
  * Release resources allocated for Zetaferno objects and its RPC pointer,
- * deinitialize Zetaferno library.
+ * deinitialize Zetaferno library. The stack is parked instead if
+ * the test has passed so far and zfts_park_stack() allows, then
+ * the library is not deinitialized.
  *
  * @param rpcs_       RPC server.
  * @param attr_       Pointer to the attribute object.
  * @param stack_      Pointer to the stack object.
  */
-#define CLEANUP_RPC_ZFTS_DESTROY_STACK(rpcs_, attr_, stack_)\
-    do {                                                    \
-        CLEANUP_RPC_ZFTS_FREE(rpcs_, zf_stack, stack_);     \
-        CLEANUP_RPC_ZF_ATTR_FREE(rpcs_, attr_);             \
-        CLEANUP_RPC_ZF_DEINIT(rpcs_);                       \
+#define CLEANUP_RPC_ZFTS_DESTROY_STACK(rpcs_, attr_, stack_)      \
+    do {                                                          \
+        te_bool parked_ = zfts_park_stack(rpcs_, &(stack_),       \
+                                          result == EXIT_SUCCESS); \
+                                                                  \
+        CLEANUP_RPC_ZFTS_FREE(rpcs_, zf_stack, stack_);           \
+        CLEANUP_RPC_ZF_ATTR_FREE(rpcs_, attr_);                   \
+        if (!parked_)                                             \
+            CLEANUP_RPC_ZF_DEINIT(rpcs_);                         \
     } while (0)
 
 /**
@@ -47,5 +47,6 @@
 #include "zfts_tcp.h"
 #include "zfts_muxer.h"
 #include "zfts_alt.h"
+#include "zfts_attr_sweep.h"
 
 #endif /* !__TS_ZF_TEST_H__ */
@@ -0,0 +1,380 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/** @file
+ * @brief Sweeping benchmarks over ZF attributes
+ *
+ * Implementation of test API to run a benchmark for every point of
+ * a grid of ZF attribute values.
+ *
+ * $Id$
+ */
+
+/* User name of the library which is used in logging. */
+#define TE_LGR_USER     "ZF attributes sweep"
+
+#include <limits.h>
+
+#include "zetaferno_ts.h"
+#include "zfts_attr_sweep.h"
+
+/**
+ * Parse a single dimension "name=v1,v2,...".
+ *
+ * @param str       String to parse (not including ';').
+ * @param len       Length of the string.
+ * @param dim       Where to save the dimension.
+ *
+ * @return Status code.
+ */
+static te_errno
+parse_dim(const char *str, size_t len, zfts_attr_sweep_dim *dim)
+{
+    const char *eq = memchr(str, '=', len);
+    const char *end = str + len;
+    const char *p;
+    char       *endptr;
+    long        val;
+
+    if (eq == NULL || eq == str || eq + 1 == end)
+    {
+        ERROR("%s(): dimension '%.*s' is malformed", __FUNCTION__,
+              (int)len, str);
+        return TE_EINVAL;
+    }
+
+    dim->name = tapi_strndup(str, eq - str);
+    dim->vals = NULL;
+    dim->num = 0;
+
+    for (p = eq + 1; p < end; p = endptr + 1)
+    {
+        errno = 0;
+        val = strtol(p, &endptr, 10);
+        if (endptr == p || endptr > end || errno != 0 ||
+            val < INT_MIN || val > INT_MAX ||
+            (endptr < end && *endptr != ','))
+        {
+            ERROR("%s(): values of attribute '%s' are malformed",
+                  __FUNCTION__, dim->name);
+            return TE_EINVAL;
+        }
+
+        dim->vals = tapi_realloc(dim->vals,
+                                 (dim->num + 1) * sizeof(*dim->vals));
+        dim->vals[dim->num++] = val;
+    }
+
+    return 0;
+}
+
+/* See description in zfts_attr_sweep.h */
+te_errno
+zfts_attr_sweep_parse(const char *str, zfts_attr_sweep_dim **dims,
+                      unsigned int *num)
+{
+    zfts_attr_sweep_dim *arr = NULL;
+    unsigned int         n = 0;
+    const char          *p = str;
+    const char          *sep;
+    size_t               len;
+    te_errno             rc;
+
+    while (*p != '\0')
+    {
+        sep = strchr(p, ';');
+        len = sep == NULL ? strlen(p) : (size_t)(sep - p);
+
+        arr = tapi_realloc(arr, (n + 1) * sizeof(*arr));
+        memset(&arr[n], 0, sizeof(arr[n]));
+        rc = parse_dim(p, len, &arr[n]);
+        n++;
+        if (rc != 0)
+        {
+            zfts_attr_sweep_dims_free(arr, n);
+            return rc;
+        }
+
+        p = sep == NULL ? p + len : sep + 1;
+    }
+
+    if (n == 0)
+    {
+        ERROR("%s(): grid of attribute values is empty", __FUNCTION__);
+        return TE_EINVAL;
+    }
+
+    *dims = arr;
+    *num = n;
+    return 0;
+}
+
+/* See description in zfts_attr_sweep.h */
+void
+zfts_attr_sweep_dims_free(zfts_attr_sweep_dim *dims, unsigned int num)
+{
+    unsigned int i;
+
+    if (dims == NULL)
+        return;
+
+    for (i = 0; i < num; i++)
+    {
+        free(dims[i].name);
+        free(dims[i].vals);
+    }
+    free(dims);
+}
+
+/**
+ * Log values reported for a point as a MI measurement.
+ *
+ * @param sweep     Sweep description.
+ * @param point     Point of the sweep.
+ * @param values    Reported values.
+ * @param num       Number of values.
+ */
+static void
+report_point(const zfts_attr_sweep *sweep,
+             const zfts_attr_sweep_point *point,
+             const zfts_attr_sweep_value *values, unsigned int num)
+{
+    te_mi_logger *logger;
+    unsigned int  i;
+
+    CHECK_RC(te_mi_logger_meas_create(sweep->meas_name, &logger));
+
+    for (i = 0; i < sweep->dims_num; i++)
+    {
+        te_mi_logger_add_meas_key(logger, NULL, sweep->dims[i].name, "%d",
+                                  point->vals[i]);
+    }
+
+    for (i = 0; i < sweep->keys_num; i++)
+    {
+        te_mi_logger_add_meas_key(logger, NULL, sweep->keys[i].name, "%d",
+                                  sweep->keys[i].val);
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        if (values[i].str != NULL)
+        {
+            te_mi_logger_add_comment(logger, NULL, values[i].name, "%s",
+                                     values[i].str);
+        }
+        else if (values[i].comment)
+        {
+            te_mi_logger_add_comment(logger, NULL, values[i].name, "%g",
+                                     values[i].val);
+        }
+        else
+        {
+            te_mi_logger_add_meas(logger, NULL, values[i].type,
+                                  values[i].name, values[i].aggr,
+                                  values[i].val, values[i].multiplier);
+        }
+    }
+
+    te_mi_logger_destroy(logger);
+}
+
+/* See description in zfts_attr_sweep.h */
+te_errno
+zfts_attr_sweep_run(rcf_rpc_server *rpcs, zfts_attr_sweep *sweep)
+{
+    zfts_attr_sweep_value   values[ZFTS_ATTR_SWEEP_MAX_VALUES];
+    zfts_attr_sweep_point   point;
+    unsigned int           *idx;
+    int                    *vals;
+    unsigned int            num;
+    unsigned int            i;
+    te_errno                result = 0;
+    te_errno                rc;
+
+    te_string zf_attr = TE_STRING_INIT;
+    te_string keys = TE_STRING_INIT;
+    te_string env = TE_STRING_INIT;
+    te_string header = TE_STRING_INIT;
+    te_string table = TE_STRING_INIT;
+
+    if (sweep->dims_num == 0)
+    {
+        ERROR("%s(): no dimensions to sweep", __FUNCTION__);
+        return TE_EINVAL;
+    }
+
+    idx = tapi_calloc(sweep->dims_num, sizeof(*idx));
+    vals = tapi_calloc(sweep->dims_num, sizeof(*vals));
+
+    if (sweep->mode == ZFTS_ATTR_SWEEP_ENV)
+    {
+        sweep->env_orig = rpc_getenv(rpcs, "ZF_ATTR");
+        sweep->env_set = TRUE;
+    }
+
+    for (point.index = 0; ; point.index++)
+    {
+        te_string_reset(&zf_attr);
+        for (i = 0; i < sweep->dims_num; i++)
+        {
+            vals[i] = sweep->dims[i].vals[idx[i]];
+            CHECK_RC(te_string_append(&zf_attr, "%s%s=%d",
+                                      i == 0 ? "" : ";",
+                                      sweep->dims[i].name, vals[i]));
+        }
+        point.vals = vals;
+        point.zf_attr = zf_attr.ptr;
+
+        RING("Attributes sweep point #%u: %s", point.index, zf_attr.ptr);
+
+        if (sweep->mode == ZFTS_ATTR_SWEEP_SET_INT)
+        {
+            rpc_zf_init(rpcs);
+            sweep->zf_inited = TRUE;
+            rpc_zf_attr_alloc(rpcs, &sweep->attr);
+            for (i = 0; i < sweep->dims_num; i++)
+                rpc_zf_attr_set_int(rpcs, sweep->attr,
+                                    sweep->dims[i].name, vals[i]);
+        }
+        else
+        {
+            te_string_reset(&env);
+            if (sweep->env_orig != NULL && *sweep->env_orig != '\0')
+                CHECK_RC(te_string_append(&env, "%s;", sweep->env_orig));
+            CHECK_RC(te_string_append(&env, "%s", zf_attr.ptr));
+            rpc_setenv(rpcs, "ZF_ATTR", env.ptr, 1);
+        }
+
+        num = TE_ARRAY_LEN(values);
+        memset(values, 0, sizeof(values));
+        rc = sweep->cb(rpcs, sweep->attr, &point, values, &num,
+                       sweep->opaque);
+        num = MIN(num, TE_ARRAY_LEN(values));
+
+        if (sweep->attr != RPC_NULL)
+        {
+            rpc_zf_attr_free(rpcs, sweep->attr);
+            sweep->attr = RPC_NULL;
+        }
+        if (sweep->zf_inited)
+        {
+            rpc_zf_deinit(rpcs);
+            sweep->zf_inited = FALSE;
+        }
+
+        if (rc == 0 && header.len == 0)
+        {
+            CHECK_RC(te_string_append(&header, "%-40s", "attributes"));
+            for (i = 0; i < num; i++)
+            {
+                if (values[i].str == NULL)
+                    CHECK_RC(te_string_append(&header, " %14s",
+                                              values[i].name));
+            }
+        }
+
+        CHECK_RC(te_string_append(&table, "%-40s", zf_attr.ptr));
+        if (rc != 0)
+        {
+            WARN("Benchmark failed with %s: %r", zf_attr.ptr, rc);
+            CHECK_RC(te_string_append(&table, " failed: %r\n", rc));
+            if (result == 0)
+                result = rc;
+        }
+        else
+        {
+            for (i = 0; i < num; i++)
+            {
+                if (values[i].str == NULL)
+                    CHECK_RC(te_string_append(&table, " %14.2f",
+                                              values[i].val));
+            }
+            CHECK_RC(te_string_append(&table, "\n"));
+            report_point(sweep, &point, values, num);
+        }
+
+        /* Move to the next point, the last dimension changes first. */
+        for (i = sweep->dims_num; i > 0; i--)
+        {
+            if (++idx[i - 1] < sweep->dims[i - 1].num)
+                break;
+            idx[i - 1] = 0;
+        }
+        if (i == 0)
+            break;
+    }
+
+    if (sweep->env_set)
+    {
+        if (sweep->env_orig != NULL)
+            rpc_setenv(rpcs, "ZF_ATTR", sweep->env_orig, 1);
+        else
+            rpc_unsetenv(rpcs, "ZF_ATTR");
+        sweep->env_set = FALSE;
+    }
+
+    for (i = 0; i < sweep->keys_num; i++)
+    {
+        CHECK_RC(te_string_append(&keys, "%s%s=%d",
+                                  i == 0 ? " with " : ", ",
+                                  sweep->keys[i].name,
+                                  sweep->keys[i].val));
+    }
+
+    RING("%s over ZF attributes%s:\n%s\n%s", sweep->meas_name,
+         keys.len == 0 ? "" : keys.ptr,
+         header.len == 0 ? "attributes" : header.ptr, table.ptr);
+
+    free(sweep->env_orig);
+    sweep->env_orig = NULL;
+    free(idx);
+    free(vals);
+    te_string_free(&zf_attr);
+    te_string_free(&keys);
+    te_string_free(&env);
+    te_string_free(&header);
+    te_string_free(&table);
+
+    return result;
+}
+
+/* See description in zfts_attr_sweep.h */
+te_errno
+zfts_attr_sweep_cleanup(rcf_rpc_server *rpcs, zfts_attr_sweep *sweep)
+{
+    te_errno result = 0;
+
+    if (sweep->attr != RPC_NULL)
+    {
+        RPC_AWAIT_ERROR(rpcs);
+        rpc_zf_attr_free(rpcs, sweep->attr);
+        if (!RPC_IS_CALL_OK(rpcs))
+            result = RPC_ERRNO(rpcs);
+        sweep->attr = RPC_NULL;
+    }
+
+    if (sweep->zf_inited)
+    {
+        RPC_AWAIT_ERROR(rpcs);
+        if (rpc_zf_deinit(rpcs) != 0 && result == 0)
+            result = RPC_ERRNO(rpcs);
+        sweep->zf_inited = FALSE;
+    }
+
+    if (sweep->env_set)
+    {
+        RPC_AWAIT_ERROR(rpcs);
+        if (sweep->env_orig != NULL)
+            rpc_setenv(rpcs, "ZF_ATTR", sweep->env_orig, 1);
+        else
+            rpc_unsetenv(rpcs, "ZF_ATTR");
+        if (!RPC_IS_CALL_OK(rpcs) && result == 0)
+            result = RPC_ERRNO(rpcs);
+        sweep->env_set = FALSE;
+    }
+
+    free(sweep->env_orig);
+    sweep->env_orig = NULL;
+
+    return result;
+}
@@ -0,0 +1,198 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/** @file
+ * @brief Sweeping benchmarks over ZF attributes
+ *
+ * Definition of test API to run a benchmark for every point of a grid
+ * of ZF attribute values and report results of all the points together.
+ *
+ * $Id$
+ */
+
+#ifndef ___ZFTS_ATTR_SWEEP_H__
+#define ___ZFTS_ATTR_SWEEP_H__
+
+#include "te_mi_log.h"
+#include "rpc_zf.h"
+
+/** Maximum number of values a benchmark can report for a point */
+#define ZFTS_ATTR_SWEEP_MAX_VALUES 8
+
+/**
+ * How attribute values of a point are applied.
+ */
+typedef enum zfts_attr_sweep_mode {
+    ZFTS_ATTR_SWEEP_SET_INT = 0,    /**< Allocate attributes object and
+                                         set the values with
+                                         @b zf_attr_set_int() */
+    ZFTS_ATTR_SWEEP_ENV,            /**< Append the values to @b ZF_ATTR
+                                         environment variable of the RPC
+                                         server, e.g. for applications
+                                         started from it */
+} zfts_attr_sweep_mode;
+
+/**
+ * Sweep dimension: ZF attribute and its values.
+ */
+typedef struct zfts_attr_sweep_dim {
+    char           *name;   /**< Attribute name */
+    int            *vals;   /**< Values */
+    unsigned int    num;    /**< Number of values */
+} zfts_attr_sweep_dim;
+
+/**
+ * Point of a sweep passed to the benchmark.
+ */
+typedef struct zfts_attr_sweep_point {
+    unsigned int    index;      /**< Index of the point */
+    const int      *vals;       /**< Attribute values, one per
+                                     dimension */
+    const char     *zf_attr;    /**< The values in @b ZF_ATTR format */
+} zfts_attr_sweep_point;
+
+/**
+ * Value reported by the benchmark for a point.
+ */
+typedef struct zfts_attr_sweep_value {
+    const char             *name;       /**< Name */
+    te_bool                 comment;    /**< If @c TRUE, the value is
+                                             logged as MI comment rather
+                                             than measurement */
+    te_mi_meas_type         type;       /**< Measurement type */
+    te_mi_meas_aggr         aggr;       /**< Measurement aggregation */
+    te_mi_meas_multiplier   multiplier; /**< Measurement multiplier */
+    double                  val;        /**< The value */
+    const char             *str;        /**< If not @c NULL, the value
+                                             is this string logged as
+                                             MI comment and not shown
+                                             in the summary table; it
+                                             should be valid until the
+                                             next point is run */
+} zfts_attr_sweep_value;
+
+/**
+ * Extra MI measurement key which is the same for all points of a sweep,
+ * e.g. a parameter of the benchmark set outside of ZF attributes.
+ */
+typedef struct zfts_attr_sweep_key {
+    const char     *name;   /**< Key name */
+    int             val;    /**< Key value */
+} zfts_attr_sweep_key;
+
+/**
+ * Benchmark run for every point of a sweep.
+ *
+ * In @c ZFTS_ATTR_SWEEP_SET_INT mode the benchmark gets attributes
+ * object with the point values applied and should not release it; in
+ * @c ZFTS_ATTR_SWEEP_ENV mode @p attr is @c RPC_NULL. Everything else
+ * the benchmark allocates should be released before it returns.
+ *
+ * The benchmark may jump to cleanup like any other test code (e.g. on
+ * a failed RPC call or a verdict); then the test should release what
+ * the benchmark allocated and call zfts_attr_sweep_cleanup().
+ *
+ * @param rpcs      RPC server.
+ * @param attr      Attributes object.
+ * @param point     Point of the sweep.
+ * @param values    Where to save reported values.
+ * @param num       On input, maximum number of values; on output,
+ *                  number of reported values.
+ * @param opaque    Benchmark data.
+ *
+ * @return Status code; if it is not zero, nothing is reported for the
+ *         point and the sweep goes on.
+ */
+typedef te_errno (*zfts_attr_sweep_cb)(rcf_rpc_server *rpcs,
+                                       rpc_zf_attr_p attr,
+                                       const zfts_attr_sweep_point *point,
+                                       zfts_attr_sweep_value *values,
+                                       unsigned int *num, void *opaque);
+
+/**
+ * Attributes sweep description. It should be initialized with
+ * @c ZFTS_ATTR_SWEEP_INIT before filling.
+ */
+typedef struct zfts_attr_sweep {
+    const char                 *meas_name;  /**< Name of MI measurement */
+    zfts_attr_sweep_mode        mode;       /**< How values are applied */
+    const zfts_attr_sweep_dim  *dims;       /**< Dimensions */
+    unsigned int                dims_num;   /**< Number of dimensions */
+    zfts_attr_sweep_cb          cb;         /**< Benchmark */
+    void                       *opaque;     /**< Benchmark data */
+    const zfts_attr_sweep_key  *keys;       /**< Extra keys (may be
+                                                 @c NULL) */
+    unsigned int                keys_num;   /**< Number of extra keys */
+
+    /* State of a running sweep, released by zfts_attr_sweep_cleanup() */
+    te_bool                     zf_inited;  /**< @b zf_init() was called
+                                                 for the current point */
+    rpc_zf_attr_p               attr;       /**< Attributes object of the
+                                                 current point */
+    te_bool                     env_set;    /**< @b ZF_ATTR was changed */
+    char                       *env_orig;   /**< Original value of
+                                                 @b ZF_ATTR */
+} zfts_attr_sweep;
+
+/** Initializer of attributes sweep description */
+#define ZFTS_ATTR_SWEEP_INIT { .attr = RPC_NULL, .env_orig = NULL }
+
+/**
+ * Parse a grid of attribute values. The grid is a semicolon-separated
+ * list of dimensions, every one is an attribute name followed by @c '='
+ * and comma-separated list of integer values, e.g.
+ * @c "rx_ring_max=512,1024;n_bufs=4096,16384".
+ *
+ * @param str       String to parse.
+ * @param dims      Where to save pointer to allocated array of
+ *                  dimensions (should be released with
+ *                  zfts_attr_sweep_dims_free()).
+ * @param num       Where to save number of dimensions.
+ *
+ * @return Status code.
+ */
+extern te_errno zfts_attr_sweep_parse(const char *str,
+                                      zfts_attr_sweep_dim **dims,
+                                      unsigned int *num);
+
+/**
+ * Release dimensions allocated by zfts_attr_sweep_parse().
+ *
+ * @param dims      Array of dimensions (may be @c NULL).
+ * @param num       Number of dimensions.
+ */
+extern void zfts_attr_sweep_dims_free(zfts_attr_sweep_dim *dims,
+                                      unsigned int num);
+
+/**
+ * Run a benchmark for every combination of attribute values (the last
+ * dimension changes the fastest). Values reported for every point are
+ * logged as a MI measurement with the attribute values and extra keys
+ * as keys, so that all the points (and sweeps run with different extra
+ * keys) make a single table, and a summary table with one row per point
+ * is logged at the end.
+ *
+ * @param rpcs      RPC server to apply attribute values on.
+ * @param sweep     Sweep description.
+ *
+ * @return @c 0 if the benchmark succeeded for every point, otherwise
+ *         status code of the first failure.
+ */
+extern te_errno zfts_attr_sweep_run(rcf_rpc_server *rpcs,
+                                    zfts_attr_sweep *sweep);
+
+/**
+ * Release what is left by a sweep interrupted by a jump to cleanup:
+ * free attributes object of the current point, call @b zf_deinit()
+ * and restore @b ZF_ATTR. It should be called from test cleanup after
+ * releasing stacks and zockets allocated by the benchmark; it does
+ * nothing if no sweep was interrupted.
+ *
+ * @param rpcs      RPC server passed to zfts_attr_sweep_run().
+ * @param sweep     Sweep description.
+ *
+ * @return Status code.
+ */
+extern te_errno zfts_attr_sweep_cleanup(rcf_rpc_server *rpcs,
+                                        zfts_attr_sweep *sweep);
+
+#endif /* !___ZFTS_ATTR_SWEEP_H__ */
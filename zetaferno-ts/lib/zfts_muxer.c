@@ -23,6 +23,12 @@
 /** Maximum length of string containing muxer events. */
 #define MAX_EVT_STR_LEN 1000
 
+/**
+ * How long to wait for TCP connections establishment when creating
+ * zockets in bulk, in milliseconds.
+ */
+#define ZFTS_MZOCKETS_CONN_TIMEOUT 10000
+
 /* See description in zfts_muxer.h */
 void
 zfts_check_muxer_events(rcf_rpc_server *rpcs,
@@ -516,6 +522,243 @@ zfts_mzocket_check_events(rcf_rpc_server *pco_iut,
                                &mzockets, err_msg);
 }
 
+/**
+ * Convert zocket type to type used by bulk RPC calls.
+ *
+ * @param zock_type     Zocket type.
+ *
+ * @return Bulk zocket type.
+ */
+static zfts_bulk_zocket_type
+zfts_zocket_type2bulk(zfts_zocket_type zock_type)
+{
+    switch (zock_type)
+    {
+        case ZFTS_ZOCKET_URX:
+            return ZFTS_BULK_ZOCKET_URX;
+
+        case ZFTS_ZOCKET_UTX:
+            return ZFTS_BULK_ZOCKET_UTX;
+
+        case ZFTS_ZOCKET_ZFTL:
+            return ZFTS_BULK_ZOCKET_ZFTL;
+
+        case ZFTS_ZOCKET_ZFT_ACT:
+            return ZFTS_BULK_ZOCKET_ZFT_ACT;
+
+        case ZFTS_ZOCKET_ZFT_PAS:
+            return ZFTS_BULK_ZOCKET_ZFT_PAS;
+
+        default:
+            TEST_FAIL("Incorrect zocket type");
+    }
+
+    return ZFTS_BULK_ZOCKET_URX;
+}
+
+/**
+ * Get index of a zocket or a socket from its address and the first
+ * port of the range allocated for zockets of the same type.
+ *
+ * @param addr        Address.
+ * @param base_port   The first port of the range (host byte order).
+ * @param count       Number of ports in the range.
+ *
+ * @return Index.
+ */
+static int
+zfts_mzockets_addr2idx(const struct sockaddr *addr, uint16_t base_port,
+                       int count)
+{
+    int idx = (int)ntohs(te_sockaddr_get_port(addr)) - base_port;
+
+    if (idx < 0 || idx >= count)
+    {
+        TEST_FAIL("Failed to find peer corresponding to connected "
+                  "zocket %s", te_sockaddr2str(addr));
+    }
+
+    return idx;
+}
+
+/**
+ * Create zockets of the same type and their peers for some elements of
+ * an array of zfts_mzocket structures using bulk RPC calls.
+ *
+ * Every zocket and peer socket gets its own port from ranges allocated
+ * on IUT and Tester, except for passively opened TCP zockets (accepted
+ * from a single listening zocket) and peers of actively opened TCP
+ * zockets (accepted from a single listening socket).
+ *
+ * @param zock_type     Zocket type.
+ * @param idx           Indexes of elements in @p mzockets.
+ * @param count         Number of elements in @p idx.
+ * @param pco_iut       RPC server on IUT.
+ * @param attr          RPC pointer to ZF attributes object.
+ * @param stack         RPC pointer to ZF stack object.
+ * @param iut_addr      Network address on IUT.
+ * @param pco_tst       RPC server on Tester.
+ * @param tst_addr      Network address on Tester.
+ * @param mzockets      Zockets array.
+ */
+static void
+zfts_create_mzockets_bulk(zfts_zocket_type zock_type,
+                          const int *idx, int count,
+                          rcf_rpc_server *pco_iut,
+                          rpc_zf_attr_p attr,
+                          rpc_zf_stack_p stack,
+                          const struct sockaddr *iut_addr,
+                          rcf_rpc_server *pco_tst,
+                          const struct sockaddr *tst_addr,
+                          zfts_mzockets *mzockets)
+{
+    rpc_ptr                 *zockets;
+    rpc_zf_waitable_p       *waitables;
+    int                     *peers;
+    rpc_ptr                 *acc_zockets;
+    rpc_zf_waitable_p       *acc_waitables;
+    int                     *acc_peers;
+    struct sockaddr_storage *raddrs;
+
+    struct sockaddr_storage iut_base;
+    struct sockaddr_storage tst_base;
+    uint16_t                iut_port;
+    uint16_t                tst_port;
+    rpc_socket_domain       domain = rpc_socket_domain_by_addr(tst_addr);
+    rpc_zftl_p              zftl = RPC_NULL;
+    int                     tst_listener;
+    zfts_mzocket           *mzocket;
+    int                     i;
+    int                     k;
+
+    if (count <= 0)
+        return;
+
+    zockets = tapi_calloc(count, sizeof(*zockets));
+    waitables = tapi_calloc(count, sizeof(*waitables));
+    peers = tapi_calloc(count, sizeof(*peers));
+    acc_zockets = tapi_calloc(count, sizeof(*acc_zockets));
+    acc_waitables = tapi_calloc(count, sizeof(*acc_waitables));
+    acc_peers = tapi_calloc(count, sizeof(*acc_peers));
+    raddrs = tapi_calloc(count, sizeof(*raddrs));
+
+    CHECK_RC(tapi_allocate_port_range(pco_iut, &iut_port, count));
+    CHECK_RC(tapi_allocate_port_range(pco_tst, &tst_port, count));
+    tapi_sockaddr_clone_exact(iut_addr, &iut_base);
+    te_sockaddr_set_port(SA(&iut_base), htons(iut_port));
+    tapi_sockaddr_clone_exact(tst_addr, &tst_base);
+    te_sockaddr_set_port(SA(&tst_base), htons(tst_port));
+
+    for (i = 0; i < count; i++)
+        peers[i] = -1;
+
+    switch (zock_type)
+    {
+        case ZFTS_ZOCKET_URX:
+        case ZFTS_ZOCKET_UTX:
+            rpc_zfts_zockets_bulk_alloc(pco_iut, stack, attr,
+                                        zfts_zocket_type2bulk(zock_type),
+                                        count, SA(&iut_base),
+                                        SA(&tst_base), 0,
+                                        zockets, waitables);
+            rpc_zfts_sockets_bulk_create(pco_tst, domain, RPC_SOCK_DGRAM,
+                                         count, SA(&tst_base),
+                                         SA(&iut_base), peers);
+            break;
+
+        case ZFTS_ZOCKET_ZFTL:
+            rpc_zfts_zockets_bulk_alloc(pco_iut, stack, attr,
+                                        ZFTS_BULK_ZOCKET_ZFTL, count,
+                                        SA(&iut_base), NULL, 0,
+                                        zockets, waitables);
+            break;
+
+        case ZFTS_ZOCKET_ZFT_ACT:
+            tst_listener = rpc_create_and_bind_socket(pco_tst,
+                                                      RPC_SOCK_STREAM,
+                                                      RPC_PROTO_DEF,
+                                                      FALSE, FALSE,
+                                                      SA(&tst_base));
+            rpc_listen(pco_tst, tst_listener, count);
+
+            rpc_zfts_zockets_bulk_alloc(pco_iut, stack, attr,
+                                        ZFTS_BULK_ZOCKET_ZFT_ACT, count,
+                                        SA(&iut_base), SA(&tst_base),
+                                        ZFTS_MZOCKETS_CONN_TIMEOUT,
+                                        zockets, waitables);
+            rpc_zfts_sockets_bulk_accept(pco_tst, tst_listener, count,
+                                         ZFTS_MZOCKETS_CONN_TIMEOUT,
+                                         acc_peers, raddrs);
+            rpc_close(pco_tst, tst_listener);
+
+            for (i = 0; i < count; i++)
+            {
+                k = zfts_mzockets_addr2idx(SA(&raddrs[i]), iut_port,
+                                           count);
+                peers[k] = acc_peers[i];
+            }
+            break;
+
+        case ZFTS_ZOCKET_ZFT_PAS:
+            rpc_zftl_listen(pco_iut, stack, SA(&iut_base), attr, &zftl);
+            rpc_zfts_sockets_bulk_create(pco_tst, domain, RPC_SOCK_STREAM,
+                                         count, SA(&tst_base),
+                                         SA(&iut_base), peers);
+            rpc_zfts_zftl_bulk_accept(pco_iut, stack, zftl, count,
+                                      ZFTS_MZOCKETS_CONN_TIMEOUT,
+                                      acc_zockets, acc_waitables, raddrs);
+            rpc_zftl_free(pco_iut, zftl);
+
+            for (i = 0; i < count; i++)
+            {
+                k = zfts_mzockets_addr2idx(SA(&raddrs[i]), tst_port,
+                                           count);
+                zockets[k] = acc_zockets[i];
+                waitables[k] = acc_waitables[i];
+            }
+            break;
+
+        default:
+            TEST_FAIL("Incorrect zocket type");
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        mzocket = &mzockets->mzocks[idx[i]];
+
+        memset(mzocket, 0, sizeof(*mzocket));
+        mzocket->zock_type = zock_type;
+        mzocket->pco_tst = pco_tst;
+        mzocket->pco_iut = pco_iut;
+        mzocket->attr = attr;
+        mzocket->stack = stack;
+        mzocket->zocket = zockets[i];
+        mzocket->waitable = waitables[i];
+        mzocket->peer_sock = peers[i];
+        mzocket->in_mset = FALSE;
+
+        snprintf(mzocket->descr, ZFTS_MZOCK_DESCR_LEN, "zocket %i",
+                 idx[i] + 1);
+
+        tapi_sockaddr_clone_exact(SA(&iut_base), &mzocket->iut_addr);
+        if (zock_type != ZFTS_ZOCKET_ZFT_PAS)
+            te_sockaddr_set_port(SA(&mzocket->iut_addr),
+                                 htons(iut_port + i));
+        tapi_sockaddr_clone_exact(SA(&tst_base), &mzocket->tst_addr);
+        if (zock_type != ZFTS_ZOCKET_ZFT_ACT)
+            te_sockaddr_set_port(SA(&mzocket->tst_addr),
+                                 htons(tst_port + i));
+    }
+
+    free(zockets);
+    free(waitables);
+    free(peers);
+    free(acc_zockets);
+    free(acc_waitables);
+    free(acc_peers);
+    free(raddrs);
+}
+
 /* See description in zfts_muxer.h */
 void
 zfts_create_mzockets(const char *spec,
@@ -534,10 +777,9 @@ zfts_create_mzockets(const char *spec,
     int k = 0;
 
     char              type_str[MAX_SUBSTR_LEN];
+    zfts_zocket_type *types;
     zfts_zocket_type  zock_type;
-
-    struct sockaddr_storage iut_addr2;
-    struct sockaddr_storage tst_addr2;
+    int              *idx;
 
     if (spec[0] != '\0')
         count++;
@@ -557,21 +799,18 @@ zfts_create_mzockets(const char *spec,
     mzockets->mzocks = tapi_calloc(count, sizeof(zfts_mzocket));
     mzockets->count = count;
 
+    types = tapi_calloc(count, sizeof(*types));
+    idx = tapi_calloc(count, sizeof(*idx));
+
     for (k = 0, j = 0, i = 0; ; i++, j++)
     {
         if (spec[i] == ',' || spec[i] == '\0')
         {
             type_str[j] = '\0';
-            zock_type = zfts_str2zocket_type(type_str);
+            types[k] = zfts_str2zocket_type(type_str);
+            if (types[k] == ZFTS_ZOCKET_UNKNOWN)
+                TEST_FAIL("Incorrect zocket type '%s'", type_str);
             j = -1;
-
-            CHECK_RC(tapi_sockaddr_clone(pco_iut, iut_addr, &iut_addr2));
-            CHECK_RC(tapi_sockaddr_clone(pco_tst, tst_addr, &tst_addr2));
-            zfts_create_mzocket(zock_type, pco_iut, attr, stack,
-                                SA(&iut_addr2), pco_tst, SA(&tst_addr2),
-                                "", &mzockets->mzocks[k]);
-            snprintf(mzockets->mzocks[k].descr, ZFTS_MZOCK_DESCR_LEN,
-                     "zocket %i", k + 1);
             k++;
         }
         else
@@ -585,6 +824,26 @@ zfts_create_mzockets(const char *spec,
         if (spec[i] == '\0')
             break;
     }
+
+    /*
+     * Create all the zockets of the same type (and their peers)
+     * with a few RPC calls instead of a few calls per zocket.
+     */
+    for (zock_type = ZFTS_ZOCKET_URX; zock_type < ZFTS_ZOCKET_UNKNOWN;
+         zock_type++)
+    {
+        for (j = 0, i = 0; i < count; i++)
+        {
+            if (types[i] == zock_type)
+                idx[j++] = i;
+        }
+
+        zfts_create_mzockets_bulk(zock_type, idx, j, pco_iut, attr, stack,
+                                  iut_addr, pco_tst, tst_addr, mzockets);
+    }
+
+    free(types);
+    free(idx);
 }
 
 /* See description in zfts_muxer.h */
@@ -651,7 +910,12 @@ zfts_mzockets_prepare_events(zfts_mzockets *mzockets,
 void
 zfts_mzockets_invoke_events(zfts_mzockets *mzockets)
 {
-    int i;
+    char                  data[ZFTS_TCP_DATA_MAX];
+    rpc_zfts_sock_event  *events;
+    zfts_mzocket        **owners;
+    zfts_mzocket         *mzocket;
+    int                   num = 0;
+    int                   i;
 
     /*
      * This function may be called to invoke events
@@ -659,11 +923,91 @@ zfts_mzockets_invoke_events(zfts_mzockets *mzockets)
      * so it should not use RPC calls on IUT.
      */
 
+    events = tapi_calloc(MAX(mzockets->count, 1) * 2, sizeof(*events));
+    owners = tapi_calloc(MAX(mzockets->count, 1) * 2, sizeof(*owners));
+
+    te_fill_buf(data, ZFTS_TCP_DATA_MAX);
+
+    /*
+     * Collect actions for all the peers to perform them
+     * with a single RPC call on Tester.
+     */
     for (i = 0; i < mzockets->count; i++)
     {
-        zfts_mzocket_invoke_events(&mzockets->mzocks[i]);
+        mzocket = &mzockets->mzocks[i];
+
+        if (mzocket->exp_events & RPC_EPOLLIN)
+        {
+            owners[num] = mzocket;
+            if (mzocket->zock_type == ZFTS_ZOCKET_URX ||
+                zfts_zocket_type_zft(mzocket->zock_type))
+            {
+                events[num].fd = mzocket->peer_sock;
+                events[num].event = ZFTS_SOCK_EVENT_SEND;
+            }
+            else if (mzocket->zock_type == ZFTS_ZOCKET_ZFTL)
+            {
+                if (mzocket->lpeers_count <= 0)
+                    TEST_FAIL("No peer socket present for "
+                              "initiating connection");
+
+                events[num].fd =
+                    mzocket->lpeers[mzocket->lpeers_count - 1].lpeer_sock;
+                events[num].event = ZFTS_SOCK_EVENT_CONNECT;
+                events[num].addr = SA(&mzocket->iut_addr);
+            }
+            else
+            {
+                TEST_FAIL("Cannot invoke EPOLLIN event for zocket "
+                          "type '%s'",
+                          zfts_zocket_type2str(mzocket->zock_type));
+            }
+            num++;
+        }
+
+        if (mzocket->exp_events & RPC_EPOLLOUT)
+        {
+            if (!zfts_zocket_type_zft(mzocket->zock_type))
+            {
+                TEST_FAIL("Cannot invoke EPOLLOUT event for zocket "
+                          "type '%s'",
+                          zfts_zocket_type2str(mzocket->zock_type));
+            }
+
+            owners[num] = mzocket;
+            events[num].fd = mzocket->peer_sock;
+            events[num].event = ZFTS_SOCK_EVENT_DRAIN;
+            events[num].data = &mzocket->tst_recv_data;
+            num++;
+        }
+    }
+
+    if (num > 0)
+    {
+        rpc_zfts_sockets_bulk_invoke(owners[0]->pco_tst, events, num,
+                                     data, ZFTS_TCP_DATA_MAX);
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        mzocket = owners[i];
+
+        if (events[i].event == ZFTS_SOCK_EVENT_SEND)
+        {
+            te_dbuf_append(&mzocket->tst_sent_data,
+                           data, ZFTS_TCP_DATA_MAX);
+        }
+        else if (events[i].event == ZFTS_SOCK_EVENT_CONNECT)
+        {
+            tapi_sockaddr_clone_exact(
+                SA(&events[i].local_addr),
+                &mzocket->lpeers[mzocket->lpeers_count - 1].lpeer_addr);
+        }
     }
 
+    free(events);
+    free(owners);
+
     /*
      * Wait to make sure that packets sent to invoke events
      * have arrived to their destinations.
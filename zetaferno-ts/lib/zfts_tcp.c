@@ -17,6 +17,12 @@
 #include "zfts_tcp.h"
 #include "tapi_sockets.h"
 
+/**
+ * Maximum number of bytes read on Tester at once when checking data with
+ * rolling verifier.
+ */
+#define ZFTS_TCP_VERIFY_READ_MAX (1024 * 1024)
+
 /** Default ZF TCP receive function. */
 static zfts_tcp_recv_func_t def_tcp_recv_func = ZFTS_TCP_RECV_ZFT_ZC_RECV;
 
@@ -411,6 +417,84 @@ zfts_zft_check_connection(rcf_rpc_server *pco_iut,
     zfts_zft_check_receiving(pco_iut, stack, iut_zft, pco_tst, tst_s);
 }
 
+/**
+ * Get 64-bit word of generated data stream (SplitMix64 output).
+ *
+ * @param seed      Seed of the generator.
+ * @param idx       Index of the word in the stream.
+ *
+ * @return Word of data.
+ */
+static uint64_t
+zfts_tcp_verifier_word(uint64_t seed, uint64_t idx)
+{
+    uint64_t z = seed + (idx + 1) * 0x9e3779b97f4a7c15ULL;
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/* See description in zfts_tcp.h */
+void
+zfts_tcp_verifier_init(zfts_tcp_verifier *verif, uint64_t seed)
+{
+    verif->seed = seed;
+    verif->sent = 0;
+    verif->received = 0;
+    verif->bad_offset = UINT64_MAX;
+}
+
+/* See description in zfts_tcp.h */
+void
+zfts_tcp_verifier_fill(const zfts_tcp_verifier *verif,
+                       char *buf, size_t len)
+{
+    uint64_t off = verif->sent;
+    uint64_t word = 0;
+    size_t   i;
+
+    for (i = 0; i < len; i++, off++)
+    {
+        if (i == 0 || off % sizeof(word) == 0)
+            word = zfts_tcp_verifier_word(verif->seed, off / sizeof(word));
+
+        buf[i] = word >> (off % sizeof(word) * 8);
+    }
+}
+
+/* See description in zfts_tcp.h */
+te_bool
+zfts_tcp_verifier_check(zfts_tcp_verifier *verif,
+                        const char *buf, size_t len)
+{
+    uint64_t off = verif->received;
+    uint64_t word = 0;
+    te_bool  ok = TRUE;
+    size_t   i;
+
+    for (i = 0; i < len && off < verif->sent; i++, off++)
+    {
+        if (i == 0 || off % sizeof(word) == 0)
+            word = zfts_tcp_verifier_word(verif->seed, off / sizeof(word));
+
+        if ((uint8_t)buf[i] != (uint8_t)(word >> (off % sizeof(word) * 8)))
+        {
+            if (verif->bad_offset == UINT64_MAX)
+            {
+                verif->bad_offset = off;
+                ERROR("Received data is corrupted at offset %llu",
+                      (unsigned long long)off);
+            }
+            ok = FALSE;
+            break;
+        }
+    }
+
+    verif->received += len;
+    return ok && verif->received <= verif->sent;
+}
+
 /* See description in zfts_tcp.h */
 zfts_tcp_conn *
 zfts_tcp_conns_alloc(int count)
@@ -424,11 +508,65 @@ zfts_tcp_conns_alloc(int count)
     {
         conns[i].iut_zft = RPC_NULL;
         conns[i].tst_s = -1;
+
+        /*
+         * Different seeds make data of every connection and direction
+         * unique, so that misdelivered data is detected too.
+         */
+        zfts_tcp_verifier_init(&conns[i].iut_verif,
+                               ((uint64_t)rand() << 32) ^ (i * 2));
+        zfts_tcp_verifier_init(&conns[i].tst_verif,
+                               ((uint64_t)rand() << 32) ^ (i * 2 + 1));
     }
 
     return conns;
 }
 
+/**
+ * Log distribution of times to TCP connection establishment.
+ *
+ * @param times     Times, nanoseconds (the array is sorted by this
+ *                  function).
+ * @param count     Number of elements in @p times.
+ * @param side      Where times were measured.
+ */
+static void
+zfts_tcp_log_est_times(uint64_t *times, int count, const char *side)
+{
+    qsort(times, count, sizeof(*times), &zfts_time_cmp);
+
+    RING("Time to establish %d TCP connections measured on %s: "
+         "min %.3f ms, median %.3f ms, 90%% %.3f ms, max %.3f ms",
+         count, side, times[0] / 1e6,
+         zfts_time_pml(times, count, 500) / 1e6,
+         zfts_time_pml(times, count, 900) / 1e6, times[count - 1] / 1e6);
+}
+
+/**
+ * Get index of a connection from port of its address.
+ *
+ * @param addr        Address.
+ * @param base_port   The first port of the range from which ports were
+ *                    assigned to connections.
+ * @param count       Number of connections.
+ *
+ * @return Connection index.
+ */
+static int
+zfts_tcp_conn_addr2idx(const struct sockaddr *addr, uint16_t base_port,
+                       int count)
+{
+    int idx = (int)ntohs(te_sockaddr_get_port(addr)) - base_port;
+
+    if (idx < 0 || idx >= count)
+    {
+        TEST_FAIL("Failed to find TCP connection with address %s",
+                  te_sockaddr2str(addr));
+    }
+
+    return idx;
+}
+
 /* See description in zfts_tcp.h */
 void
 zfts_tcp_conns_establish(zfts_tcp_conn *conns,
@@ -444,48 +582,143 @@ zfts_tcp_conns_establish(zfts_tcp_conn *conns,
                          int tst_sndbuf, int tst_rcvbuf,
                          te_bool tst_ndelay, te_bool tst_nonblock)
 {
-    struct sockaddr_storage iut_bind_addr;
-    struct sockaddr_storage tst_bind_addr;
-    te_bool silent_default_orig_iut = pco_iut->silent_default;
-    te_bool silent_default_orig_tst = pco_tst->silent_default;
-    int i;
+    struct sockaddr_storage  iut_base;
+    struct sockaddr_storage  tst_base;
+    struct sockaddr_storage *addrs;
+    rpc_zft_p               *zockets;
+    uint64_t                *times;
+    int                     *fds;
+    uint16_t                 port;
+    rpc_zftl_p               zftl = iut_zftl;
+    int                      tst_s_listening = -1;
+    int                      i;
+    int                      k;
+
+    if (count <= 0)
+        return;
 
-    pco_iut->silent_pass_default = pco_iut->silent_pass = TRUE;
-    pco_tst->silent_pass_default = pco_tst->silent_pass = TRUE;
+    zockets = tapi_calloc(count, sizeof(*zockets));
+    fds = tapi_calloc(count, sizeof(*fds));
+    addrs = tapi_calloc(count, sizeof(*addrs));
+    times = tapi_calloc(count, sizeof(*times));
 
-    for (i = 0; i < count; i++)
+    if (active)
     {
-        if (active || iut_zftl == RPC_NULL)
-            CHECK_RC(tapi_sockaddr_clone(pco_iut, iut_addr, &iut_bind_addr));
+        CHECK_RC(tapi_allocate_port_range(pco_iut, &port, count));
+        tapi_sockaddr_clone_exact(iut_addr, &iut_base);
+        te_sockaddr_set_port(SA(&iut_base), htons(port));
+        CHECK_RC(tapi_sockaddr_clone(pco_tst, tst_addr, &tst_base));
+
+        RING("Establishing %d connections: %s (port incremented for "
+             "every connection) -> %s", count,
+             te_sockaddr2str(CONST_SA(&iut_base)),
+             te_sockaddr2str(CONST_SA(&tst_base)));
+
+        tst_s_listening =
+          rpc_create_and_bind_socket(pco_tst, RPC_SOCK_STREAM,
+                                     RPC_PROTO_DEF, FALSE, FALSE,
+                                     CONST_SA(&tst_base));
+        if (tst_sndbuf >= 0)
+            rpc_setsockopt_int(pco_tst, tst_s_listening,
+                               RPC_SO_SNDBUF, tst_sndbuf);
+        if (tst_rcvbuf >= 0)
+            rpc_setsockopt_int(pco_tst, tst_s_listening,
+                               RPC_SO_RCVBUF, tst_rcvbuf);
+        rpc_listen(pco_tst, tst_s_listening, count);
+
+        /*
+         * Accept connections while they are being established, otherwise
+         * SYNs are dropped once listen backlog is full.
+         */
+        pco_iut->op = RCF_RPC_CALL;
+        rpc_zfts_zft_bulk_establish(pco_iut, stack, attr, RPC_NULL, count,
+                                    CONST_SA(&iut_base),
+                                    CONST_SA(&tst_base),
+                                    ZFTS_TCP_CONNS_TIMEOUT, zockets,
+                                    NULL, NULL, times);
+        rpc_zfts_sockets_bulk_accept(pco_tst, tst_s_listening, count,
+                                     ZFTS_TCP_CONNS_TIMEOUT, fds, addrs);
+        rpc_zfts_zft_bulk_establish(pco_iut, stack, attr, RPC_NULL, count,
+                                    CONST_SA(&iut_base),
+                                    CONST_SA(&tst_base),
+                                    ZFTS_TCP_CONNS_TIMEOUT, zockets,
+                                    NULL, NULL, times);
+        rpc_close(pco_tst, tst_s_listening);
+
+        for (i = 0; i < count; i++)
+        {
+            k = zfts_tcp_conn_addr2idx(SA(&addrs[i]), port, count);
+            conns[k].iut_zft = zockets[k];
+            conns[k].tst_s = fds[i];
+        }
+
+        zfts_tcp_log_est_times(times, count, "IUT");
+    }
+    else
+    {
+        if (zftl == RPC_NULL)
+        {
+            CHECK_RC(tapi_sockaddr_clone(pco_iut, iut_addr, &iut_base));
+            rpc_zftl_listen(pco_iut, stack, CONST_SA(&iut_base), attr,
+                            &zftl);
+        }
         else
-            tapi_sockaddr_clone_exact(iut_addr, &iut_bind_addr);
-
-        CHECK_RC(tapi_sockaddr_clone(pco_tst, tst_addr, &tst_bind_addr));
-
-        RING("Establishing connection %d: %s %s %s", i + 1,
-             te_sockaddr2str(CONST_SA(&iut_bind_addr)),
-             active ? "->" : "<-",
-             te_sockaddr2str(CONST_SA(&tst_bind_addr)));
-
-        zfts_establish_tcp_conn_ext(active, pco_iut, attr, stack,
-                                    iut_zftl, &conns[i].iut_zft,
-                                    SA(&iut_bind_addr),
-                                    pco_tst, &conns[i].tst_s,
-                                    SA(&tst_bind_addr),
-                                    tst_sndbuf, tst_rcvbuf);
-
-        if (tst_ndelay)
-            rpc_setsockopt_int(pco_tst, conns[i].tst_s,
-                               RPC_TCP_NODELAY, 1);
-        if (tst_nonblock)
-            rpc_fcntl(pco_tst, conns[i].tst_s, RPC_F_SETFL,
-                      RPC_O_NONBLOCK);
+        {
+            tapi_sockaddr_clone_exact(iut_addr, &iut_base);
+        }
+
+        CHECK_RC(tapi_allocate_port_range(pco_tst, &port, count));
+        tapi_sockaddr_clone_exact(tst_addr, &tst_base);
+        te_sockaddr_set_port(SA(&tst_base), htons(port));
+
+        RING("Establishing %d connections: %s <- %s (port incremented "
+             "for every connection)", count,
+             te_sockaddr2str(CONST_SA(&iut_base)),
+             te_sockaddr2str(CONST_SA(&tst_base)));
+
+        pco_tst->op = RCF_RPC_CALL;
+        rpc_zfts_sockets_bulk_connect(pco_tst,
+                                      rpc_socket_domain_by_addr(tst_addr),
+                                      count, CONST_SA(&tst_base),
+                                      CONST_SA(&iut_base), tst_sndbuf,
+                                      tst_rcvbuf, ZFTS_TCP_CONNS_TIMEOUT,
+                                      fds, NULL, times);
+        rpc_zfts_zft_bulk_establish(pco_iut, stack, RPC_NULL, zftl, count,
+                                    NULL, NULL, ZFTS_TCP_CONNS_TIMEOUT,
+                                    zockets, NULL, addrs, NULL);
+        rpc_zfts_sockets_bulk_connect(pco_tst,
+                                      rpc_socket_domain_by_addr(tst_addr),
+                                      count, CONST_SA(&tst_base),
+                                      CONST_SA(&iut_base), tst_sndbuf,
+                                      tst_rcvbuf, ZFTS_TCP_CONNS_TIMEOUT,
+                                      fds, NULL, times);
+
+        if (zftl != iut_zftl)
+            ZFTS_FREE(pco_iut, zftl, zftl);
+
+        for (i = 0; i < count; i++)
+        {
+            k = zfts_tcp_conn_addr2idx(SA(&addrs[i]), port, count);
+            conns[k].iut_zft = zockets[i];
+            conns[k].tst_s = fds[k];
+        }
+
+        zfts_tcp_log_est_times(times, count, "Tester");
     }
 
-    pco_iut->silent_pass_default = silent_default_orig_iut;
-    pco_iut->silent_pass = silent_default_orig_iut;
-    pco_tst->silent_pass_default = silent_default_orig_tst;
-    pco_tst->silent_pass = silent_default_orig_tst;
+    if (tst_ndelay || tst_nonblock)
+    {
+        for (i = 0; i < count; i++)
+            fds[i] = conns[i].tst_s;
+
+        rpc_zfts_sockets_bulk_set_flags(pco_tst, fds, count, tst_ndelay,
+                                        tst_nonblock);
+    }
+
+    free(zockets);
+    free(fds);
+    free(addrs);
+    free(times);
 }
 
 /* See description in zfts_tcp.h */
@@ -540,9 +773,6 @@ zfts_tcp_conns_destroy(rcf_rpc_server *pco_iut,
 
             if (conns[i].iut_zft != RPC_NULL)
                 rpc_zft_free(pco_iut, conns[i].iut_zft);
-
-            te_dbuf_free(&conns[i].iut_sent);
-            te_dbuf_free(&conns[i].tst_sent);
         }
 
         free(conns);
@@ -579,27 +809,26 @@ zfts_tcp_conns_read_check_data_tst(rcf_rpc_server *pco_iut,
 {
     int i;
 
-    te_dbuf *received_bufs = NULL;
-
     size_t  received_len = 0;
     te_dbuf tmp_dbuf = TE_DBUF_INIT(100);
     te_bool prev_failed = FALSE;
 
-    received_bufs = tapi_calloc(count, sizeof(*received_bufs));
-
     do {
         received_len = 0;
         for (i = 0; i < count; i++)
         {
-            size_t left_len = conns[i].iut_sent.len - received_bufs[i].len;
+            size_t left_len;
 
+            left_len = zfts_tcp_verifier_pending(&conns[i].iut_verif);
             if (left_len == 0)
                 continue;
 
-            rpc_read_fd2te_dbuf(pco_tst, conns[i].tst_s, 100, left_len,
+            rpc_read_fd2te_dbuf(pco_tst, conns[i].tst_s, 100,
+                                MIN(left_len, ZFTS_TCP_VERIFY_READ_MAX),
                                 &tmp_dbuf);
             received_len += tmp_dbuf.len;
-            te_dbuf_append(&received_bufs[i], tmp_dbuf.ptr, tmp_dbuf.len);
+            zfts_tcp_verifier_check(&conns[i].iut_verif, tmp_dbuf.ptr,
+                                    tmp_dbuf.len);
         }
 
         if (received_len > 0)
@@ -620,15 +849,9 @@ zfts_tcp_conns_read_check_data_tst(rcf_rpc_server *pco_iut,
     {
         RING("Checking data received from IUT for connection %d",
              i + 1);
-        ZFTS_CHECK_RECEIVED_DATA(received_bufs[i].ptr,
-                                 conns[i].iut_sent.ptr,
-                                 received_bufs[i].len,
-                                 conns[i].iut_sent.len,
-                                 " from IUT");
-        te_dbuf_free(&received_bufs[i]);
+        ZFTS_TCP_VERIFIER_CHECK(&conns[i].iut_verif, " from IUT");
     }
 
-    free(received_bufs);
     te_dbuf_free(&tmp_dbuf);
 }
 
@@ -682,26 +905,29 @@ zfts_zft_read_all(rcf_rpc_server *rpcs,
 
 /**
  * Read all the data from IUT zocket for a given TCP
- * connection.
+ * connection and check it.
  *
  * @param pco_iut         RPC server on IUT.
  * @param conn            TCP connection description.
- * @param received_data   Where to save read data.
+ * @param tmp_dbuf        Buffer for read data.
  *
  * @return Amount of data read.
  */
 static size_t
 zfts_tcp_conn_read_data_iut(rcf_rpc_server *pco_iut,
                             zfts_tcp_conn *conn,
-                            te_dbuf *received_data)
+                            te_dbuf *tmp_dbuf)
 {
     size_t received_len = 0;
 
-    if (conn->tst_sent.len == 0)
+    if (conn->tst_verif.sent == 0)
         return 0;
 
+    te_dbuf_reset(tmp_dbuf);
     zfts_zft_read_data(pco_iut, conn->iut_zft,
-                       received_data, &received_len);
+                       tmp_dbuf, &received_len);
+    zfts_tcp_verifier_check(&conn->tst_verif, tmp_dbuf->ptr,
+                            tmp_dbuf->len);
 
     return received_len;
 }
@@ -715,17 +941,15 @@ zfts_tcp_conns_read_check_data_iut(rcf_rpc_server *pco_iut,
 {
     int i;
 
-    te_dbuf *received_bufs = NULL;
-    size_t   received_len;
-
-    received_bufs = tapi_calloc(count, sizeof(*received_bufs));
+    te_dbuf tmp_dbuf = TE_DBUF_INIT(0);
+    size_t  received_len;
 
     do {
         received_len = 0;
         for (i = 0; i < count; i++)
         {
             received_len += zfts_tcp_conn_read_data_iut(pco_iut, &conns[i],
-                                                        &received_bufs[i]);
+                                                        &tmp_dbuf);
         }
 
         if (received_len == 0)
@@ -738,15 +962,10 @@ zfts_tcp_conns_read_check_data_iut(rcf_rpc_server *pco_iut,
     {
         RING("Checking data received from Tester for connection %d",
              i + 1);
-        ZFTS_CHECK_RECEIVED_DATA(received_bufs[i].ptr,
-                                 conns[i].tst_sent.ptr,
-                                 received_bufs[i].len,
-                                 conns[i].tst_sent.len,
-                                 " from Tester");
-        te_dbuf_free(&received_bufs[i]);
+        ZFTS_TCP_VERIFIER_CHECK(&conns[i].tst_verif, " from Tester");
     }
 
-    free(received_bufs);
+    te_dbuf_free(&tmp_dbuf);
 }
 
 /* See description in zfts_tcp.h */
@@ -933,6 +1152,23 @@ zfts_zft_recv_func_dbuf(rcf_rpc_server *rpcs, rpc_zft_p zft_zocket,
     return -1;
 }
 
+/* See description in zfts_tcp.h */
+ssize_t
+zfts_zft_recv_func_verify(rcf_rpc_server *rpcs, rpc_zft_p zft_zocket,
+                          zfts_tcp_recv_func_t func,
+                          zfts_tcp_verifier *verif)
+{
+    te_dbuf dbuf = TE_DBUF_INIT(0);
+    ssize_t rc;
+
+    rc = zfts_zft_recv_func_dbuf(rpcs, zft_zocket, func, &dbuf);
+    if (rc > 0)
+        zfts_tcp_verifier_check(verif, dbuf.ptr, dbuf.len);
+
+    te_dbuf_free(&dbuf);
+    return rc;
+}
+
 /* See description in zfts_tcp.h */
 void
 zfts_set_def_tcp_recv_func(zfts_tcp_recv_func_t recv_func)
@@ -950,12 +1186,12 @@ zfts_zft_recv(rcf_rpc_server *rpcs, rpc_zft_p zft_zocket,
 }
 
 /* See description in zfts_tcp.h */
-size_t
-zfts_zft_recv_dbuf(rcf_rpc_server *rpcs, rpc_zft_p zft_zocket,
-                   te_dbuf *dbuf)
+ssize_t
+zfts_zft_recv_verify(rcf_rpc_server *rpcs, rpc_zft_p zft_zocket,
+                     zfts_tcp_verifier *verif)
 {
-    return zfts_zft_recv_func_dbuf(rpcs, zft_zocket,
-                                   def_tcp_recv_func, dbuf);
+    return zfts_zft_recv_func_verify(rpcs, zft_zocket,
+                                     def_tcp_recv_func, verif);
 }
 
 /* See description in zfts_tcp.h */
@@ -31,6 +31,12 @@
  */
 #define ZFTS_TCP_DATA_MAX 1400
 
+/**
+ * How long to wait for TCP connections established in bulk by
+ * zfts_tcp_conns_establish(), milliseconds.
+ */
+#define ZFTS_TCP_CONNS_TIMEOUT 10000
+
 /** Maximum number of bytes TCP packet headers may require. */
 #define ZFTS_TCP_HDRS_MAX 300
 
@@ -170,6 +176,114 @@ typedef enum {
         zfts_set_def_tcp_recv_func(param_);                 \
     } while (0)
 
+/**
+ * Rolling verifier of data sent in one direction over TCP connection.
+ *
+ * Data is produced by a seeded generator which can regenerate the byte
+ * at any stream offset, so received data is checked as soon as it is
+ * read and nothing is kept in memory, whatever amount of data is
+ * transmitted.
+ */
+typedef struct zfts_tcp_verifier {
+    uint64_t    seed;         /**< Seed of the data generator. */
+    uint64_t    sent;         /**< Number of bytes sent. */
+    uint64_t    received;     /**< Number of bytes received and
+                                   checked. */
+    uint64_t    bad_offset;   /**< Stream offset of the first corrupted
+                                   byte or @c UINT64_MAX. */
+} zfts_tcp_verifier;
+
+/**
+ * Check results of rolling data verification: all the sent data should
+ * be received and nothing should be corrupted, otherwise test fails
+ * with a verdict.
+ *
+ * @param verif_      Verifier (zfts_tcp_verifier *).
+ * @param format_     Format string and arguments appended to verdicts.
+ */
+#define ZFTS_TCP_VERIFIER_CHECK(verif_, format_...) \
+    do {                                                                  \
+        RING("%llu bytes were sent, %llu bytes were received",           \
+             (unsigned long long)(verif_)->sent,                          \
+             (unsigned long long)(verif_)->received);                     \
+                                                                          \
+        if ((verif_)->received < (verif_)->sent)                          \
+            TEST_VERDICT("Less data than expected "                       \
+                         "was received" format_);                         \
+        else if ((verif_)->received > (verif_)->sent)                     \
+            TEST_VERDICT("More data than expected "                       \
+                         "was received" format_);                         \
+        else if ((verif_)->bad_offset != UINT64_MAX)                      \
+        {                                                                 \
+            ERROR("The first corrupted byte is at offset %llu",          \
+                  (unsigned long long)(verif_)->bad_offset);              \
+            TEST_VERDICT("Data received differs "                         \
+                         "from data sent" format_);                       \
+        }                                                                 \
+    } while (0)
+
+/**
+ * Initialize rolling data verifier.
+ *
+ * @param verif     Verifier.
+ * @param seed      Seed of the data generator.
+ */
+extern void zfts_tcp_verifier_init(zfts_tcp_verifier *verif,
+                                   uint64_t seed);
+
+/**
+ * Fill buffer with data which should be sent next, i.e. with generated
+ * bytes starting from the current sent offset. Sent offset is not
+ * changed, zfts_tcp_verifier_sent() should be called after sending.
+ *
+ * @param verif     Verifier.
+ * @param buf       Buffer to fill.
+ * @param len       Length of the buffer.
+ */
+extern void zfts_tcp_verifier_fill(const zfts_tcp_verifier *verif,
+                                   char *buf, size_t len);
+
+/**
+ * Account data which was actually sent after zfts_tcp_verifier_fill().
+ *
+ * @param verif     Verifier.
+ * @param len       Number of bytes sent.
+ */
+static inline void
+zfts_tcp_verifier_sent(zfts_tcp_verifier *verif, size_t len)
+{
+    verif->sent += len;
+}
+
+/**
+ * Get number of bytes sent but not received yet.
+ *
+ * @param verif     Verifier.
+ *
+ * @return Number of bytes.
+ */
+static inline uint64_t
+zfts_tcp_verifier_pending(const zfts_tcp_verifier *verif)
+{
+    return verif->sent > verif->received ?
+                verif->sent - verif->received : 0;
+}
+
+/**
+ * Check next portion of received data against generated data and
+ * advance received offset. The first corrupted offset is remembered
+ * to be reported by ZFTS_TCP_VERIFIER_CHECK(); received data beyond
+ * sent offset is only counted.
+ *
+ * @param verif     Verifier.
+ * @param buf       Received data.
+ * @param len       Length of received data.
+ *
+ * @return @c TRUE if all the data matches, @c FALSE otherwise.
+ */
+extern te_bool zfts_tcp_verifier_check(zfts_tcp_verifier *verif,
+                                       const char *buf, size_t len);
+
 /**
  * Structure describing TCP connection.
  */
@@ -177,9 +291,9 @@ typedef struct {
     rpc_zft_p   iut_zft;    /**< IUT zocket. */
     int         tst_s;      /**< TESTER socket. */
 
-    te_dbuf   iut_sent;     /**< Data sent from IUT in the current bunch. */
-    te_dbuf   tst_sent;     /**< Data sent from TESTER
-                                 in the current bunch. */
+    zfts_tcp_verifier iut_verif;  /**< Verifier of data sent from IUT. */
+    zfts_tcp_verifier tst_verif;  /**< Verifier of data sent from
+                                       TESTER. */
 
     te_bool   recv_overfilled;   /**< Whether receive zocket buffers
                                       are overfilled already or not. */
@@ -411,7 +525,11 @@ extern zfts_tcp_conn *zfts_tcp_conns_alloc(int count);
 
 /**
  * Establish TCP connection for every TCP connection structure
- * in array.
+ * in array. Connections are established concurrently with a few bulk
+ * RPC calls: every actively opened zocket gets its own port and
+ * connects to the same listening socket on Tester, while every Tester
+ * socket connecting to IUT listener gets its own port. Distribution of
+ * times to connection establishment is logged.
  *
  * @param conns         TCP connection structures array.
  * @param count         Number of elements in the array.
@@ -557,20 +675,21 @@ extern size_t zfts_zft_recv(rcf_rpc_server *rpcs, rpc_zft_p zft_zocket,
  * Read data using @b zft_zc_recv() or zft_recv() (default function can
  * be changed with @b zfts_set_def_tcp_recv_func()). This function reads
  * arbitrary amount of data, not necessary all the data which can be read
- * at the moment.
+ * at the moment. Received data is checked with rolling verifier instead
+ * of being accumulated.
  *
- * @note The function jumps to @b cleanup in case of fail, i.e. if any of
- *       Zetaferno functions return a negative value or any internal
- *       problem in used RPCs.
+ * @note Error handling is the same as in zfts_zft_recv_func_dbuf().
  *
  * @param rpcs        RPC server handle.
  * @param zft_zocket  ZF TCP zocket.
- * @param dbuf        te_dbuf to which to append read data.
+ * @param verif       Verifier of data sent by peer.
  *
- * @return Length of received data.
+ * @return Length of received data on success or negative value in case of
+ *         failure.
  */
-extern size_t zfts_zft_recv_dbuf(rcf_rpc_server *rpcs, rpc_zft_p zft_zocket,
-                                 te_dbuf *dbuf);
+extern ssize_t zfts_zft_recv_verify(rcf_rpc_server *rpcs,
+                                    rpc_zft_p zft_zocket,
+                                    zfts_tcp_verifier *verif);
 
 /**
  * Read data using @b rpc_zft_zc_recv() or @b rpc_zft_recv().
@@ -617,6 +736,25 @@ extern ssize_t zfts_zft_recv_func_dbuf(rcf_rpc_server *rpcs,
                                        zfts_tcp_recv_func_t func,
                                        te_dbuf *dbuf);
 
+/**
+ * Read data using @b rpc_zft_zc_recv() or @b rpc_zft_recv() and check
+ * it with rolling verifier instead of accumulating it.
+ *
+ * @note Error handling is the same as in zfts_zft_recv_func_dbuf().
+ *
+ * @param rpcs        RPC server handle.
+ * @param zft_zocket  ZF TCP zocket.
+ * @param func        TCP receive function.
+ * @param verif       Verifier of data sent by peer.
+ *
+ * @return Length of received data on success or negative value in case of
+ *         failure.
+ */
+extern ssize_t zfts_zft_recv_func_verify(rcf_rpc_server *rpcs,
+                                         rpc_zft_p zft_zocket,
+                                         zfts_tcp_recv_func_t func,
+                                         zfts_tcp_verifier *verif);
+
 /**
  * Send data using @b rpc_zft_send.
  *
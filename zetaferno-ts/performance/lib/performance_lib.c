@@ -10,6 +10,8 @@
 
 #define TE_LGR_USER "Performance lib"
 
+#include <limits.h>
+
 #include "performance_lib.h"
 #include "tapi_job.h"
 #include "tapi_job_opt.h"
@@ -378,3 +380,74 @@ zfts_perf_mean_rtt_to_mi(const char *app_name, double mean_rtt)
     te_mi_logger_destroy(logger);
     return 0;
 }
+
+/* See description in performance_lib.h */
+te_errno
+zfts_perf_parse_int_list(const char *str, int **vals, int *num)
+{
+    const char *p = str;
+    char *endptr = NULL;
+    int *arr = NULL;
+    int n = 0;
+    long val;
+
+    while (*p != '\0')
+    {
+        errno = 0;
+        val = strtol(p, &endptr, 10);
+        if (endptr == p || errno != 0 || val < INT_MIN || val > INT_MAX ||
+            (*endptr != ',' && *endptr != '\0'))
+        {
+            ERROR("%s(): list of integers '%s' is malformed", __FUNCTION__,
+                  str);
+            free(arr);
+            return TE_EINVAL;
+        }
+
+        arr = tapi_realloc(arr, (n + 1) * sizeof(*arr));
+        arr[n++] = val;
+
+        p = (*endptr == ',' ? endptr + 1 : endptr);
+    }
+
+    if (n == 0)
+    {
+        ERROR("%s(): list of integers is empty", __FUNCTION__);
+        return TE_EINVAL;
+    }
+
+    *vals = arr;
+    *num = n;
+    return 0;
+}
+
+/* See description in performance_lib.h */
+int
+zfts_perf_drop_free_search(int min, int max, int precision, int max_steps,
+                           zfts_perf_drop_check check, void *opaque)
+{
+    int lo;
+    int hi;
+    int mid;
+    int step;
+
+    if (check(max, opaque))
+        return max;
+    if (!check(min, opaque))
+        return -1;
+
+    lo = min;
+    hi = max;
+    for (step = 0; step < max_steps &&
+                   (int64_t)(hi - lo) * 100 > (int64_t)lo * precision;
+         step++)
+    {
+        mid = lo + (hi - lo) / 2;
+        if (check(mid, opaque))
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
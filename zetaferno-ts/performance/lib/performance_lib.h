@@ -188,6 +188,52 @@ extern te_errno zfts_perf_get_single_result(zfts_perf_app *app,
 extern te_errno zfts_perf_mean_rtt_to_mi(const char *app_name,
                                          double rtt);
 
+/**
+ * Parse a comma-separated list of integer numbers (it is how
+ * sweeping parameters are passed to benchmark tests).
+ *
+ * @param str         String to parse.
+ * @param vals        Where to save pointer to allocated array of numbers
+ *                    (should be released by the caller).
+ * @param num         Where to save number of elements in the array.
+ *
+ * @return Status code.
+ */
+extern te_errno zfts_perf_parse_int_list(const char *str, int **vals,
+                                         int *num);
+
+/**
+ * Check whether a value (e.g. send rate) is handled without drops.
+ *
+ * @param value       Value to check.
+ * @param opaque      Check data.
+ *
+ * @return @c TRUE if nothing was dropped.
+ */
+typedef te_bool (*zfts_perf_drop_check)(int value, void *opaque);
+
+/**
+ * Find the highest value between @p min and @p max which is handled
+ * without drops, assuming that drops do not disappear as the value
+ * grows. @p max is checked first, then @p min, then binary search
+ * narrows the range until its width is within @p precision percent
+ * of the highest drop-free value or @p max_steps values are checked.
+ *
+ * @param min         Minimum value to check.
+ * @param max         Maximum value to check.
+ * @param precision   Search precision, percent.
+ * @param max_steps   Maximum number of binary search steps.
+ * @param check       Check of a value.
+ * @param opaque      Check data.
+ *
+ * @return The highest drop-free value found or @c -1 if there are drops
+ *         already at @p min.
+ */
+extern int zfts_perf_drop_free_search(int min, int max, int precision,
+                                      int max_steps,
+                                      zfts_perf_drop_check check,
+                                      void *opaque);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
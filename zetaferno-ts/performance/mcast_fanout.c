@@ -0,0 +1,356 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-mcast_fanout Multicast fan-out throughput
+ *
+ * @objective Measure aggregate packet rate, per-group fairness and loss
+ *            and cost of a send call when datagrams are sent round-robin
+ *            to a growing number of multicast groups from UDP TX zockets
+ *            allocated in a single stack or in a stack per group.
+ *
+ * @param env           Testing environment:
+ *                      - @ref arg_types_env_peer2peer
+ * @param one_stack     Allocate all zockets in a single stack if @c TRUE,
+ *                      else allocate a stack per zocket.
+ * @param groups        Comma-separated list of numbers of multicast
+ *                      groups.
+ * @param func          UDP send function:
+ *                      - zfut_send
+ *                      - zfut_send_single
+ * @param dgram_size    Size of every datagram.
+ * @param duration      Duration of every measurement, seconds.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME  "performance/mcast_fanout"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+
+/** The first IP multicast address used by the test. */
+#define IP_MULTICAST_FIRST    0xe0000100
+
+/** The last IP multicast address used by the test. */
+#define IP_MULTICAST_LAST     0xefffffff
+
+/** How long Tester waits for the rest of data, seconds */
+#define TST_WAIT_TIME 1
+
+/** Results of a measurement */
+typedef struct fanout_result {
+    double  sent_pps;       /**< Aggregate sent packets per second */
+    double  recv_pps;       /**< Aggregate received packets per second */
+    double  loss;           /**< Lost datagrams, percent */
+    double  fairness;       /**< Jain's fairness index of per-group
+                                 received packets */
+    double  min_group_pps;  /**< Packet rate of the slowest group */
+    double  max_group_pps;  /**< Packet rate of the fastest group */
+    double  send_ns;        /**< Mean cost of a send call, ns */
+} fanout_result;
+
+/**
+ * Compute results of a measurement.
+ *
+ * @param stats       IUT statistics.
+ * @param sent        Datagrams sent to every group.
+ * @param received    Bytes received from every group on Tester.
+ * @param num         Number of groups.
+ * @param dgram_size  Size of every datagram.
+ * @param res         Where to save results.
+ */
+static void
+fanout_compute(const tarpc_zfts_zfut_fanout_stats *stats,
+               const uint64_t *sent, const uint64_t *received, int num,
+               int dgram_size, fanout_result *res)
+{
+    double  sum_sent = 0;
+    double  sum = 0;
+    double  sum_sq = 0;
+    double  pkts;
+    double  sec = (double)stats->elapsed / 1000000000;
+    int     i;
+
+    res->min_group_pps = 0;
+    res->max_group_pps = 0;
+    for (i = 0; i < num; i++)
+    {
+        pkts = (double)(received[i] / dgram_size);
+        sum_sent += sent[i];
+        sum += pkts;
+        sum_sq += pkts * pkts;
+
+        if (i == 0 || pkts / sec < res->min_group_pps)
+            res->min_group_pps = pkts / sec;
+        if (i == 0 || pkts / sec > res->max_group_pps)
+            res->max_group_pps = pkts / sec;
+    }
+
+    res->sent_pps = sum_sent / sec;
+    res->recv_pps = sum / sec;
+    res->loss = sum_sent == 0 ? 0.0 :
+                    (sum_sent > sum ? (sum_sent - sum) * 100 / sum_sent :
+                                      0.0);
+    res->fairness = sum_sq == 0 ? 0.0 : sum * sum / (num * sum_sq);
+    res->send_ns = stats->sends == 0 ? 0.0 :
+                        (double)stats->send_ns / stats->sends;
+}
+
+/**
+ * Report results of a measurement in a MI artifact.
+ *
+ * @param one_stack     Whether all zockets are in a single stack.
+ * @param groups        Number of groups.
+ * @param func          Send function.
+ * @param dgram_size    Size of every datagram.
+ * @param stats         IUT statistics.
+ * @param res           Computed results.
+ */
+static void
+report_fanout(te_bool one_stack, int groups, zfts_send_function func,
+              int dgram_size, const tarpc_zfts_zfut_fanout_stats *stats,
+              const fanout_result *res)
+{
+    te_mi_logger *logger;
+
+    CHECK_RC(te_mi_logger_meas_create("zf_mcast_fanout", &logger));
+
+    te_mi_logger_add_meas_key(logger, NULL, "stacks", "%s",
+                              one_stack ? "one" : "per_group");
+    te_mi_logger_add_meas_key(logger, NULL, "groups", "%d", groups);
+    te_mi_logger_add_meas_key(logger, NULL, "func", "%s",
+                              func == ZFTS_ZFUT_SEND ?
+                                    "zfut_send" : "zfut_send_single");
+    te_mi_logger_add_meas_key(logger, NULL, "dgram_size", "%d",
+                              dgram_size);
+
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_PPS, "sent",
+                          TE_MI_MEAS_AGGR_MEAN, res->sent_pps,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_PPS, "received",
+                          TE_MI_MEAS_AGGR_MEAN, res->recv_pps,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_PPS, "group received",
+                          TE_MI_MEAS_AGGR_MIN, res->min_group_pps,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_PPS, "group received",
+                          TE_MI_MEAS_AGGR_MAX, res->max_group_pps,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "send call",
+                          TE_MI_MEAS_AGGR_MEAN, res->send_ns,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+
+    te_mi_logger_add_comment(logger, NULL, "loss_percent", "%.3f",
+                             res->loss);
+    te_mi_logger_add_comment(logger, NULL, "fairness", "%.4f",
+                             res->fairness);
+    te_mi_logger_add_comment(logger, NULL, "send_again", "%llu",
+                             (unsigned long long)stats->again);
+
+    te_mi_logger_destroy(logger);
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server            *pco_iut = NULL;
+    rcf_rpc_server            *pco_tst = NULL;
+    const struct sockaddr     *iut_addr = NULL;
+    const struct if_nameindex *tst_if = NULL;
+
+    te_bool             one_stack;
+    const char         *groups;
+    zfts_send_function  func;
+    int                 dgram_size;
+    int                 duration;
+
+    rpc_zf_attr_p   attr = RPC_NULL;
+    rpc_zf_stack_p *stacks = NULL;
+    rpc_zfut_p     *iut_zocks = NULL;
+    int            *tst_socks = NULL;
+
+    struct sockaddr_storage *mcast_addrs = NULL;
+    struct sockaddr_storage *iut_addrs = NULL;
+
+    int        *nums = NULL;
+    int         nums_num;
+    int         max_num = 0;
+    int         i;
+    int         j;
+
+    uint64_t   *sent = NULL;
+    uint64_t   *received = NULL;
+
+    tarpc_zfts_zfut_fanout_stats stats;
+    fanout_result                res;
+    te_string                    table = TE_STRING_INIT;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+    TEST_GET_IF(tst_if);
+    TEST_GET_BOOL_PARAM(one_stack);
+    TEST_GET_STRING_PARAM(groups);
+    ZFTS_TEST_GET_ZFUT_FUNCTION(func);
+    TEST_GET_INT_PARAM(dgram_size);
+    TEST_GET_INT_PARAM(duration);
+
+    CHECK_RC(zfts_perf_parse_int_list(groups, &nums, &nums_num));
+    for (i = 0; i < nums_num; i++)
+    {
+        if (nums[i] <= 0)
+            TEST_FAIL("Number of groups must be positive");
+        max_num = MAX(max_num, nums[i]);
+    }
+
+    stacks = tapi_calloc(max_num, sizeof(*stacks));
+    iut_zocks = tapi_calloc(max_num, sizeof(*iut_zocks));
+    tst_socks = tapi_calloc(max_num, sizeof(*tst_socks));
+    mcast_addrs = tapi_calloc(max_num, sizeof(*mcast_addrs));
+    iut_addrs = tapi_calloc(max_num, sizeof(*iut_addrs));
+    sent = tapi_calloc(max_num, sizeof(*sent));
+    received = tapi_calloc(max_num, sizeof(*received));
+    for (i = 0; i < max_num; i++)
+    {
+        stacks[i] = RPC_NULL;
+        iut_zocks[i] = RPC_NULL;
+        tst_socks[i] = -1;
+    }
+
+    CHECK_RC(te_string_append(&table, "%6s %12s %12s %8s %8s %10s\n",
+                              "groups", "sent pps", "recv pps", "loss %",
+                              "fairness", "send ns"));
+
+    TEST_STEP("Allocate ZF stack, or a stack per group if @p one_stack "
+              "is @c FALSE.");
+    rpc_zf_init(pco_iut);
+    rpc_zf_attr_alloc(pco_iut, &attr);
+    for (i = 0; i < max_num; i++)
+    {
+        if (i == 0 || !one_stack)
+            rpc_zf_stack_alloc(pco_iut, attr, &stacks[i]);
+        else
+            stacks[i] = stacks[0];
+    }
+
+    TEST_STEP("Choose the maximum number from @p groups of distinct "
+              "multicast groups; for every group allocate UDP TX zocket "
+              "sending to it and create UDP socket on Tester joined to "
+              "it.");
+    for (i = 0; i < max_num; i++)
+    {
+        SA(&mcast_addrs[i])->sa_family = AF_INET;
+        while (TRUE)
+        {
+            SIN(&mcast_addrs[i])->sin_addr.s_addr =
+                      htonl(rand_range(IP_MULTICAST_FIRST,
+                                       IP_MULTICAST_LAST));
+            for (j = 0; j < i; j++)
+            {
+                if (SIN(&mcast_addrs[i])->sin_addr.s_addr ==
+                        SIN(&mcast_addrs[j])->sin_addr.s_addr)
+                    break;
+            }
+            if (j >= i)
+                break;
+        }
+        tapi_allocate_set_port(pco_tst, SA(&mcast_addrs[i]));
+
+        CHECK_RC(tapi_sockaddr_clone(pco_iut, iut_addr, &iut_addrs[i]));
+        rpc_zfut_alloc(pco_iut, &iut_zocks[i], stacks[i],
+                       SA(&iut_addrs[i]), SA(&mcast_addrs[i]), 0, attr);
+
+        tst_socks[i] = rpc_socket(pco_tst, RPC_PF_INET, RPC_SOCK_DGRAM,
+                                  RPC_IPPROTO_UDP);
+        CHECK_RC(rpc_mcast_join(pco_tst, tst_socks[i],
+                                SA(&mcast_addrs[i]), tst_if->if_index,
+                                TARPC_MCAST_JOIN_LEAVE));
+        rpc_bind(pco_tst, tst_socks[i], SA(&mcast_addrs[i]));
+    }
+
+    TEST_STEP("For every number @b M in @p groups:");
+    for (i = 0; i < nums_num; i++)
+    {
+        TEST_SUBSTEP("Receive datagrams on the first @b M Tester sockets "
+                     "with @b rpc_iomux_flooder() while IUT sends "
+                     "@p dgram_size datagrams round-robin from the first "
+                     "@b M zockets for @p duration using @p func.");
+        memset(received, 0, max_num * sizeof(*received));
+        pco_tst->op = RCF_RPC_CALL;
+        rpc_iomux_flooder(pco_tst, NULL, 0, tst_socks, nums[i],
+                          dgram_size, duration, TST_WAIT_TIME,
+                          FUNC_DEFAULT_IOMUX, NULL, received);
+
+        rpc_zfts_zfut_fanout_bench(pco_iut, stacks, iut_zocks, nums[i],
+                                   func, dgram_size, TE_SEC2MS(duration),
+                                   &stats, sent);
+
+        pco_tst->op = RCF_RPC_WAIT;
+        rpc_iomux_flooder(pco_tst, NULL, 0, tst_socks, nums[i],
+                          dgram_size, duration, TST_WAIT_TIME,
+                          FUNC_DEFAULT_IOMUX, NULL, received);
+
+        if (stats.sends == stats.again)
+            TEST_VERDICT("Nothing was sent to %d groups", nums[i]);
+
+        TEST_SUBSTEP("Report aggregate packet rate, per-group fairness "
+                     "and loss and the cost of a send call.");
+        fanout_compute(&stats, sent, received, nums[i], dgram_size, &res);
+        report_fanout(one_stack, nums[i], func, dgram_size, &stats, &res);
+        CHECK_RC(te_string_append(
+                     &table, "%6d %12.0f %12.0f %8.3f %8.4f %10.1f\n",
+                     nums[i], res.sent_pps, res.recv_pps, res.loss,
+                     res.fairness, res.send_ns));
+    }
+
+    TEST_STEP("Log the summary table.");
+    RING("Multicast fan-out from %s, %d-byte datagrams:\n%s",
+         one_stack ? "one stack" : "a stack per group", dgram_size,
+         table.ptr);
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    for (i = 0; i < max_num; i++)
+    {
+        if (tst_socks != NULL)
+            CLEANUP_RPC_CLOSE(pco_tst, tst_socks[i]);
+        if (iut_zocks != NULL)
+            CLEANUP_RPC_ZFTS_FREE(pco_iut, zfut, iut_zocks[i]);
+    }
+
+    if (stacks != NULL)
+    {
+        for (i = 0; i < max_num; i++)
+        {
+            if (i == 0 || !one_stack)
+                CLEANUP_RPC_ZFTS_FREE(pco_iut, zf_stack, stacks[i]);
+        }
+    }
+
+    CLEANUP_RPC_ZF_ATTR_FREE(pco_iut, attr);
+    CLEANUP_RPC_ZF_DEINIT(pco_iut);
+
+    free(nums);
+    free(stacks);
+    free(iut_zocks);
+    free(tst_socks);
+    free(mcast_addrs);
+    free(iut_addrs);
+    free(sent);
+    free(received);
+    te_string_free(&table);
+
+    TEST_END;
+}
@@ -0,0 +1,356 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-mcast_rx_scaling Multicast receive scaling on UDP RX zockets
+ *
+ * @objective Measure packet rate delivered to UDP RX zockets bound to
+ *            a growing number of multicast groups, and time taken by
+ *            @b zfur_addr_bind() and @b zfur_addr_unbind() per group.
+ *
+ * @param env           Testing environment:
+ *                      - @ref arg_types_env_peer2peer
+ * @param groups        Comma-separated list of numbers of multicast
+ *                      groups.
+ * @param zockets_num   Number of UDP RX zockets the groups are spread
+ *                      across (not more than the number of groups is
+ *                      used).
+ * @param dgram_size    Size of every datagram.
+ * @param duration      Duration of every measurement, seconds.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME  "performance/mcast_rx_scaling"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+
+/** The first IP multicast address used by the test. */
+#define IP_MULTICAST_FIRST    0xe0000100
+
+/** The last IP multicast address used by the test. */
+#define IP_MULTICAST_LAST     0xefffffff
+
+/** How long IUT keeps receiving after Tester stops sending, seconds */
+#define IUT_WAIT_TIME 1
+
+/** Bind or unbind times of a measurement */
+typedef struct bind_times {
+    uint64_t    sum;    /**< Sum of all the calls, ns */
+    uint64_t    max;    /**< The slowest call, ns */
+} bind_times;
+
+/**
+ * Bind or unbind zockets to/from groups spread across them
+ * round-robin.
+ *
+ * @param rpcs        RPC server.
+ * @param zocks       UDP RX zockets.
+ * @param zocks_num   Number of zockets.
+ * @param addrs       Multicast addresses.
+ * @param groups      Number of groups.
+ * @param unbind      Whether to unbind.
+ * @param laddrs      Buffer for addresses of a zocket (@p groups
+ *                    elements).
+ * @param times       Buffer for measurements (@p groups elements).
+ * @param res         Where to save the summary.
+ */
+static void
+bind_groups(rcf_rpc_server *rpcs, const rpc_zfur_p *zocks, int zocks_num,
+            const struct sockaddr_storage *addrs, int groups,
+            te_bool unbind, const struct sockaddr **laddrs,
+            uint64_t *times, bind_times *res)
+{
+    int num;
+    int i;
+    int j;
+
+    memset(res, 0, sizeof(*res));
+    for (i = 0; i < zocks_num; i++)
+    {
+        for (j = i, num = 0; j < groups; j += zocks_num)
+            laddrs[num++] = CONST_SA(&addrs[j]);
+
+        rpc_zfts_zfur_bulk_bind(rpcs, zocks[i], laddrs, NULL, num, unbind,
+                                0, times, NULL);
+        for (j = 0; j < num; j++)
+        {
+            res->sum += times[j];
+            res->max = MAX(res->max, times[j]);
+        }
+    }
+}
+
+/**
+ * Report results of a measurement in a MI artifact.
+ *
+ * @param groups        Number of groups.
+ * @param zocks_num     Number of zockets.
+ * @param dgram_size    Size of every datagram.
+ * @param sent_pps      Packet rate sent by Tester.
+ * @param recv_pps      Packet rate delivered to zockets.
+ * @param stats         IUT statistics.
+ * @param bind          Bind times.
+ * @param unbind        Unbind times.
+ */
+static void
+report_rx(int groups, int zocks_num, int dgram_size, double sent_pps,
+          double recv_pps, const tarpc_zfts_zfur_drain_stats *stats,
+          const bind_times *bind, const bind_times *unbind)
+{
+    te_mi_logger *logger;
+
+    CHECK_RC(te_mi_logger_meas_create("zf_mcast_rx_scaling", &logger));
+
+    te_mi_logger_add_meas_key(logger, NULL, "groups", "%d", groups);
+    te_mi_logger_add_meas_key(logger, NULL, "zockets", "%d", zocks_num);
+    te_mi_logger_add_meas_key(logger, NULL, "dgram_size", "%d",
+                              dgram_size);
+
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_PPS, "sent",
+                          TE_MI_MEAS_AGGR_MEAN, sent_pps,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_PPS, "delivered",
+                          TE_MI_MEAS_AGGR_MEAN, recv_pps,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "bind",
+                          TE_MI_MEAS_AGGR_MEAN,
+                          (double)bind->sum / groups,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "bind",
+                          TE_MI_MEAS_AGGR_MAX, bind->max,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "unbind",
+                          TE_MI_MEAS_AGGR_MEAN,
+                          (double)unbind->sum / groups,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "unbind",
+                          TE_MI_MEAS_AGGR_MAX, unbind->max,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+
+    te_mi_logger_add_comment(logger, NULL, "loss_percent", "%.3f",
+                             sent_pps > recv_pps ?
+                                (sent_pps - recv_pps) * 100 / sent_pps :
+                                0.0);
+    te_mi_logger_add_comment(logger, NULL, "empty_polls_percent", "%.2f",
+                             stats->polls == 0 ? 0.0 :
+                                (double)stats->empty_polls * 100 /
+                                stats->polls);
+
+    te_mi_logger_destroy(logger);
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server        *pco_iut = NULL;
+    rcf_rpc_server        *pco_tst = NULL;
+    const struct sockaddr *tst_addr = NULL;
+
+    const char *groups;
+    int         zockets_num;
+    int         dgram_size;
+    int         duration;
+
+    rpc_zf_attr_p   attr = RPC_NULL;
+    rpc_zf_stack_p  stack = RPC_NULL;
+    rpc_zfur_p     *iut_zocks = NULL;
+    int            *tst_socks = NULL;
+    int             zocks_num = 0;
+
+    struct sockaddr_storage  *mcast_addrs = NULL;
+    struct sockaddr_storage   tst_bind_addr;
+    const struct sockaddr   **laddrs = NULL;
+
+    int        *nums = NULL;
+    int         nums_num;
+    int         max_num = 0;
+    int         i;
+    int         j;
+
+    uint64_t   *times = NULL;
+    uint64_t   *tx_stat = NULL;
+    uint64_t   *dgrams = NULL;
+    uint64_t    sent;
+    double      sent_pps;
+    double      recv_pps;
+
+    tarpc_zfts_zfur_drain_stats stats;
+    bind_times                  bind;
+    bind_times                  unbind;
+    te_string                   table = TE_STRING_INIT;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_ADDR(pco_tst, tst_addr);
+    TEST_GET_STRING_PARAM(groups);
+    TEST_GET_INT_PARAM(zockets_num);
+    TEST_GET_INT_PARAM(dgram_size);
+    TEST_GET_INT_PARAM(duration);
+
+    if (zockets_num <= 0)
+        TEST_FAIL("Number of zockets must be positive");
+
+    CHECK_RC(zfts_perf_parse_int_list(groups, &nums, &nums_num));
+    for (i = 0; i < nums_num; i++)
+    {
+        if (nums[i] <= 0)
+            TEST_FAIL("Number of groups must be positive");
+        max_num = MAX(max_num, nums[i]);
+    }
+
+    iut_zocks = tapi_calloc(zockets_num, sizeof(*iut_zocks));
+    tst_socks = tapi_calloc(max_num, sizeof(*tst_socks));
+    mcast_addrs = tapi_calloc(max_num, sizeof(*mcast_addrs));
+    laddrs = tapi_calloc(max_num, sizeof(*laddrs));
+    times = tapi_calloc(max_num, sizeof(*times));
+    tx_stat = tapi_calloc(max_num, sizeof(*tx_stat));
+    dgrams = tapi_calloc(zockets_num, sizeof(*dgrams));
+    for (i = 0; i < zockets_num; i++)
+        iut_zocks[i] = RPC_NULL;
+    for (i = 0; i < max_num; i++)
+        tst_socks[i] = -1;
+
+    CHECK_RC(te_string_append(&table, "%6s %7s %12s %12s %8s %10s %10s\n",
+                              "groups", "zockets", "sent pps",
+                              "recv pps", "loss %", "bind ns",
+                              "unbind ns"));
+
+    TEST_STEP("Allocate ZF stack.");
+    rpc_zf_init(pco_iut);
+    rpc_zf_attr_alloc(pco_iut, &attr);
+    rpc_zf_stack_alloc(pco_iut, attr, &stack);
+
+    TEST_STEP("Choose the maximum number from @p groups of distinct "
+              "multicast groups; for every group create UDP socket on "
+              "Tester bound to its unicast address (so that multicast "
+              "is sent from the tested interface) and connected to the "
+              "group.");
+    for (i = 0; i < max_num; i++)
+    {
+        SA(&mcast_addrs[i])->sa_family = AF_INET;
+        while (TRUE)
+        {
+            SIN(&mcast_addrs[i])->sin_addr.s_addr =
+                      htonl(rand_range(IP_MULTICAST_FIRST,
+                                       IP_MULTICAST_LAST));
+            for (j = 0; j < i; j++)
+            {
+                if (SIN(&mcast_addrs[i])->sin_addr.s_addr ==
+                        SIN(&mcast_addrs[j])->sin_addr.s_addr)
+                    break;
+            }
+            if (j >= i)
+                break;
+        }
+        tapi_allocate_set_port(pco_iut, SA(&mcast_addrs[i]));
+
+        CHECK_RC(tapi_sockaddr_clone(pco_tst, tst_addr, &tst_bind_addr));
+        tst_socks[i] = rpc_socket(pco_tst, RPC_PF_INET, RPC_SOCK_DGRAM,
+                                  RPC_IPPROTO_UDP);
+        rpc_bind(pco_tst, tst_socks[i], SA(&tst_bind_addr));
+        rpc_connect(pco_tst, tst_socks[i], SA(&mcast_addrs[i]));
+    }
+
+    TEST_STEP("For every number @b M in @p groups:");
+    for (i = 0; i < nums_num; i++)
+    {
+        TEST_SUBSTEP("Allocate MIN(@p zockets_num, @b M) UDP RX zockets "
+                     "and bind them to the first @b M groups spread "
+                     "across the zockets round-robin, measuring every "
+                     "@b zfur_addr_bind() call.");
+        zocks_num = MIN(zockets_num, nums[i]);
+        for (j = 0; j < zocks_num; j++)
+            rpc_zfur_alloc(pco_iut, &iut_zocks[j], stack, attr);
+        bind_groups(pco_iut, iut_zocks, zocks_num, mcast_addrs, nums[i],
+                    FALSE, laddrs, times, &bind);
+
+        TEST_SUBSTEP("Send @p dgram_size datagrams from the first @b M "
+                     "Tester sockets with @b rpc_iomux_flooder() for "
+                     "@p duration while IUT drains all the zockets in "
+                     "an agent-side loop.");
+        pco_iut->op = RCF_RPC_CALL;
+        rpc_zfts_zfur_drain_bench(pco_iut, stack, iut_zocks, zocks_num,
+                                  TE_SEC2MS(duration + IUT_WAIT_TIME),
+                                  &stats, dgrams);
+
+        memset(tx_stat, 0, max_num * sizeof(*tx_stat));
+        rpc_iomux_flooder(pco_tst, tst_socks, nums[i], NULL, 0,
+                          dgram_size, duration, 0, FUNC_DEFAULT_IOMUX,
+                          tx_stat, NULL);
+
+        pco_iut->op = RCF_RPC_WAIT;
+        rpc_zfts_zfur_drain_bench(pco_iut, stack, iut_zocks, zocks_num,
+                                  TE_SEC2MS(duration + IUT_WAIT_TIME),
+                                  &stats, dgrams);
+
+        for (j = 0, sent = 0; j < nums[i]; j++)
+            sent += tx_stat[j] / dgram_size;
+        if (stats.dgrams == 0)
+            TEST_VERDICT("Nothing was received from %d groups", nums[i]);
+
+        TEST_SUBSTEP("Unbind the zockets from the groups measuring every "
+                     "@b zfur_addr_unbind() call and free them.");
+        bind_groups(pco_iut, iut_zocks, zocks_num, mcast_addrs, nums[i],
+                    TRUE, laddrs, times, &unbind);
+        for (j = 0; j < zocks_num; j++)
+            ZFTS_FREE(pco_iut, zfur, iut_zocks[j]);
+
+        TEST_SUBSTEP("Report sent and delivered packet rate and bind and "
+                     "unbind time per group.");
+        sent_pps = (double)sent / duration;
+        recv_pps = (double)stats.dgrams / duration;
+        report_rx(nums[i], zocks_num, dgram_size, sent_pps, recv_pps,
+                  &stats, &bind, &unbind);
+        CHECK_RC(te_string_append(
+                     &table, "%6d %7d %12.0f %12.0f %8.3f %10.0f %10.0f\n",
+                     nums[i], zocks_num, sent_pps, recv_pps,
+                     sent == 0 || sent < stats.dgrams ? 0.0 :
+                        (double)(sent - stats.dgrams) * 100 / sent,
+                     (double)bind.sum / nums[i],
+                     (double)unbind.sum / nums[i]));
+    }
+
+    TEST_STEP("Log the summary table.");
+    RING("Multicast receive on up to %d zockets, %d-byte datagrams:\n%s",
+         zockets_num, dgram_size, table.ptr);
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    for (i = 0; i < max_num; i++)
+    {
+        if (tst_socks != NULL)
+            CLEANUP_RPC_CLOSE(pco_tst, tst_socks[i]);
+    }
+    for (i = 0; i < zocks_num; i++)
+    {
+        if (iut_zocks != NULL)
+            CLEANUP_RPC_ZFTS_FREE(pco_iut, zfur, iut_zocks[i]);
+    }
+
+    CLEANUP_RPC_ZFTS_DESTROY_STACK(pco_iut, attr, stack);
+
+    free(nums);
+    free(iut_zocks);
+    free(tst_socks);
+    free(mcast_addrs);
+    free(laddrs);
+    free(times);
+    free(tx_stat);
+    free(dgrams);
+    te_string_free(&table);
+
+    TEST_END;
+}
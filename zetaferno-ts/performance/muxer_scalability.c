@@ -0,0 +1,429 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-muxer_scalability Muxer scalability
+ *
+ * @objective Measure how cost of @b zf_muxer_wait(), @b zf_muxer_add(),
+ *            @b zf_muxer_mod() and @b zf_muxer_del() depends on number
+ *            of zockets in a muxer set.
+ *
+ * @param env             Testing environment:
+ *                        - @ref arg_types_env_peer2peer
+ * @param set_sizes       Comma-separated list of muxer set sizes.
+ * @param tcp_percent     Percentage of TCP zockets in a muxer set (the
+ *                        rest are UDP RX zockets).
+ * @param active_percent  Percentage of zockets on which events are
+ *                        triggered from Tester.
+ * @param duration        Maximum time to spend retrieving events,
+ *                        milliseconds.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME "performance/muxer_scalability"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+
+/** How long to wait for TCP connections establishment, in ms */
+#define CONNECT_TIMEOUT 10000
+
+/** How long to measure zf_muxer_wait() without events, in ms */
+#define IDLE_DURATION 100
+
+/** Size of data sent from Tester to trigger an event */
+#define EVENT_DATA_LEN 64
+
+/** Results measured for a single muxer set size */
+typedef struct set_results {
+    int         size;           /**< Number of zockets in the set */
+    int         exp_events;     /**< Number of triggered events */
+    uint64_t    add_ns;         /**< Time spent in zf_muxer_add() */
+    uint64_t    mod_ns;         /**< Time spent in zf_muxer_mod() */
+    uint64_t    del_ns;         /**< Time spent in zf_muxer_del() */
+
+    tarpc_zf_muxer_wait_stats  busy;  /**< zf_muxer_wait() statistics
+                                           when events are triggered */
+    tarpc_zf_muxer_wait_stats  idle;  /**< zf_muxer_wait() statistics
+                                           without events */
+} set_results;
+
+/**
+ * Get mean value in nanoseconds.
+ *
+ * @param total     Total value.
+ * @param num       Number of samples.
+ *
+ * @return Mean value.
+ */
+static double
+mean(uint64_t total, uint64_t num)
+{
+    return num == 0 ? 0 : (double)total / num;
+}
+
+/**
+ * Report results measured for a muxer set size in a MI artifact and
+ * in the log.
+ *
+ * @param res       Results.
+ */
+static void
+report_results(const set_results *res)
+{
+    te_mi_logger *logger;
+
+    TEST_ARTIFACT("set_size=%d events=%d/%llu wait_busy=%.0fns "
+                  "wait_max=%lluns wait_idle=%.0fns events_per_call=%.2f "
+                  "add=%.0fns mod=%.0fns del=%.0fns",
+                  res->size, res->exp_events, res->busy.events,
+                  mean(res->busy.events_duration,
+                       res->busy.calls_with_events),
+                  res->busy.max_duration,
+                  mean(res->idle.duration, res->idle.calls),
+                  mean(res->busy.events, res->busy.calls_with_events),
+                  mean(res->add_ns, res->size),
+                  mean(res->mod_ns, res->size),
+                  mean(res->del_ns, res->size));
+
+    CHECK_RC(te_mi_logger_meas_create("zf_muxer", &logger));
+
+    te_mi_logger_add_meas_key(logger, NULL, "set_size", "%d", res->size);
+    te_mi_logger_add_meas_key(logger, NULL, "active", "%d",
+                              res->exp_events);
+
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "zf_muxer_wait with events",
+                          TE_MI_MEAS_AGGR_MEAN,
+                          mean(res->busy.events_duration,
+                               res->busy.calls_with_events),
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "zf_muxer_wait with events",
+                          TE_MI_MEAS_AGGR_MAX, res->busy.max_duration,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "zf_muxer_wait without events",
+                          TE_MI_MEAS_AGGR_MEAN,
+                          mean(res->idle.duration, res->idle.calls),
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "zf_muxer_add", TE_MI_MEAS_AGGR_MEAN,
+                          mean(res->add_ns, res->size),
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "zf_muxer_mod", TE_MI_MEAS_AGGR_MEAN,
+                          mean(res->mod_ns, res->size),
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "zf_muxer_del", TE_MI_MEAS_AGGR_MEAN,
+                          mean(res->del_ns, res->size),
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+
+    te_mi_logger_add_comment(logger, NULL, "events_per_call", "%.2f",
+                             mean(res->busy.events,
+                                  res->busy.calls_with_events));
+    te_mi_logger_add_comment(logger, NULL, "max_events_per_call", "%llu",
+                             res->busy.max_events);
+
+    te_mi_logger_destroy(logger);
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server *pco_iut = NULL;
+    rcf_rpc_server *pco_tst = NULL;
+    const struct sockaddr *iut_addr = NULL;
+    const struct sockaddr *tst_addr = NULL;
+
+    const char *set_sizes;
+    int tcp_percent;
+    int active_percent;
+    int duration;
+
+    int *sizes = NULL;
+    int sizes_num = 0;
+    int max_size;
+    int n_tcp;
+    int n_udp;
+    int act_tcp;
+    int act_udp;
+    int i;
+    int j;
+    uint16_t port;
+    uint16_t tcp_port;
+
+    rpc_zf_attr_p attr = RPC_NULL;
+    rpc_zf_stack_p stack = RPC_NULL;
+    rpc_zf_muxer_set_p muxer_set = RPC_NULL;
+
+    rpc_ptr *urx = NULL;
+    rpc_ptr *zft = NULL;
+    rpc_zf_waitable_p *urx_w = NULL;
+    rpc_zf_waitable_p *zft_w = NULL;
+    int urx_num = 0;
+    int zft_num = 0;
+
+    int tst_listener = -1;
+    int tst_udp = -1;
+    int *tst_socks = NULL;
+    int tst_socks_num = 0;
+
+    struct sockaddr_storage iut_urx_addr;
+    struct sockaddr_storage iut_zft_addr;
+    struct sockaddr_storage tst_bind_addr;
+    struct sockaddr_storage *urx_dsts = NULL;
+    const struct sockaddr **dsts = NULL;
+
+    uint64_t op_ns;
+    set_results res;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+    TEST_GET_ADDR(pco_tst, tst_addr);
+    TEST_GET_STRING_PARAM(set_sizes);
+    TEST_GET_INT_PARAM(tcp_percent);
+    TEST_GET_INT_PARAM(active_percent);
+    TEST_GET_INT_PARAM(duration);
+
+    CHECK_RC(zfts_perf_parse_int_list(set_sizes, &sizes, &sizes_num));
+
+    max_size = 0;
+    for (i = 0; i < sizes_num; i++)
+        max_size = MAX(max_size, sizes[i]);
+
+    urx = tapi_calloc(max_size, sizeof(*urx));
+    zft = tapi_calloc(max_size, sizeof(*zft));
+    urx_w = tapi_calloc(max_size, sizeof(*urx_w));
+    zft_w = tapi_calloc(max_size, sizeof(*zft_w));
+    tst_socks = tapi_calloc(max_size, sizeof(*tst_socks));
+    urx_dsts = tapi_calloc(max_size, sizeof(*urx_dsts));
+    dsts = tapi_calloc(max_size, sizeof(*dsts));
+
+    TEST_STEP("Create UDP socket on Tester which is used to trigger "
+              "events on UDP RX zockets.");
+    tst_udp = rpc_socket(pco_tst, rpc_socket_domain_by_addr(tst_addr),
+                         RPC_SOCK_DGRAM, RPC_PROTO_DEF);
+
+    TEST_STEP("For every value in @p set_sizes:");
+    for (i = 0; i < sizes_num; i++)
+    {
+        memset(&res, 0, sizeof(res));
+        res.size = sizes[i];
+        n_tcp = sizes[i] * tcp_percent / 100;
+        n_udp = sizes[i] - n_tcp;
+        act_tcp = n_tcp * active_percent / 100;
+        act_udp = n_udp * active_percent / 100;
+        if (act_tcp + act_udp == 0)
+        {
+            if (n_udp > 0)
+                act_udp = 1;
+            else
+                act_tcp = 1;
+        }
+        res.exp_events = act_tcp + act_udp;
+
+        TEST_SUBSTEP("Allocate ZF stack with endpoint limits allowing to "
+                     "create the required number of zockets; stop if it "
+                     "is not possible.");
+        rpc_zf_init(pco_iut);
+        rpc_zf_attr_alloc(pco_iut, &attr);
+        rpc_zf_attr_set_int(pco_iut, attr, "max_udp_rx_endpoints",
+                            MAX(n_udp, 1));
+        rpc_zf_attr_set_int(pco_iut, attr, "max_tcp_endpoints",
+                            MAX(n_tcp, 1));
+        RPC_AWAIT_ERROR(pco_iut);
+        if (rpc_zf_stack_alloc(pco_iut, attr, &stack) < 0)
+        {
+            RING_VERDICT("Stack for %d zockets cannot be allocated: %r",
+                         sizes[i], RPC_ERRNO(pco_iut));
+            stack = RPC_NULL;
+            break;
+        }
+
+        TEST_SUBSTEP("Create UDP RX zockets bound to a reserved range "
+                     "of consecutive ports and TCP zockets connected to "
+                     "Tester with bulk RPC calls.");
+        if (n_udp > 0)
+        {
+            CHECK_RC(tapi_allocate_port_range(pco_iut, &port, n_udp));
+            tapi_sockaddr_clone_exact(iut_addr, &iut_urx_addr);
+            te_sockaddr_set_port(SA(&iut_urx_addr), htons(port));
+            rpc_zfts_zockets_bulk_alloc(pco_iut, stack, attr,
+                                        ZFTS_BULK_ZOCKET_URX, n_udp,
+                                        SA(&iut_urx_addr), NULL, 0,
+                                        urx, urx_w);
+            urx_num = n_udp;
+        }
+
+        if (n_tcp > 0)
+        {
+            CHECK_RC(tapi_sockaddr_clone(pco_tst, tst_addr,
+                                         &tst_bind_addr));
+            tst_listener = rpc_create_and_bind_socket(
+                                        pco_tst, RPC_SOCK_STREAM,
+                                        RPC_PROTO_DEF, FALSE, FALSE,
+                                        SA(&tst_bind_addr));
+            rpc_listen(pco_tst, tst_listener, n_tcp);
+
+            CHECK_RC(tapi_allocate_port_range(pco_iut, &tcp_port, n_tcp));
+            tapi_sockaddr_clone_exact(iut_addr, &iut_zft_addr);
+            te_sockaddr_set_port(SA(&iut_zft_addr), htons(tcp_port));
+
+            /*
+             * Accept connections on Tester while IUT is connecting, so
+             * that listen backlog limit does not make SYNs dropped.
+             */
+            pco_iut->op = RCF_RPC_CALL;
+            rpc_zfts_zockets_bulk_alloc(pco_iut, stack, attr,
+                                        ZFTS_BULK_ZOCKET_ZFT_ACT, n_tcp,
+                                        SA(&iut_zft_addr),
+                                        SA(&tst_bind_addr),
+                                        CONNECT_TIMEOUT, zft, zft_w);
+            rpc_zfts_sockets_bulk_accept(pco_tst, tst_listener, n_tcp,
+                                         CONNECT_TIMEOUT, tst_socks, NULL);
+            tst_socks_num = n_tcp;
+            rpc_zfts_zockets_bulk_alloc(pco_iut, stack, attr,
+                                        ZFTS_BULK_ZOCKET_ZFT_ACT, n_tcp,
+                                        SA(&iut_zft_addr),
+                                        SA(&tst_bind_addr),
+                                        CONNECT_TIMEOUT, zft, zft_w);
+            zft_num = n_tcp;
+            RPC_CLOSE(pco_tst, tst_listener);
+        }
+
+        TEST_SUBSTEP("Add all the zockets to a muxer set measuring "
+                     "@b zf_muxer_add() cost.");
+        rpc_zf_muxer_alloc(pco_iut, stack, &muxer_set);
+        rpc_zf_muxer_bulk(pco_iut, muxer_set, ZFTS_MUXER_BULK_ADD,
+                          urx_w, urx_num, RPC_EPOLLIN, &op_ns, NULL);
+        res.add_ns = op_ns;
+        rpc_zf_muxer_bulk(pco_iut, muxer_set, ZFTS_MUXER_BULK_ADD,
+                          zft_w, zft_num, RPC_EPOLLIN, &op_ns, NULL);
+        res.add_ns += op_ns;
+
+        TEST_SUBSTEP("Send data from Tester to @p active_percent of "
+                     "the zockets in a single RPC call.");
+        for (j = 0; j < act_udp; j++)
+        {
+            tapi_sockaddr_clone_exact(SA(&iut_urx_addr), &urx_dsts[j]);
+            te_sockaddr_set_port(SA(&urx_dsts[j]), htons(port + j));
+            dsts[j] = SA(&urx_dsts[j]);
+        }
+        if (act_udp > 0)
+        {
+            int *udp_fds = tapi_calloc(act_udp, sizeof(*udp_fds));
+
+            for (j = 0; j < act_udp; j++)
+                udp_fds[j] = tst_udp;
+            rpc_zfts_sockets_bulk_send(pco_tst, udp_fds, dsts, act_udp,
+                                       EVENT_DATA_LEN);
+            free(udp_fds);
+        }
+        if (act_tcp > 0)
+        {
+            rpc_zfts_sockets_bulk_send(pco_tst, tst_socks, NULL, act_tcp,
+                                       EVENT_DATA_LEN);
+        }
+        TAPI_WAIT_NETWORK;
+
+        TEST_SUBSTEP("Call @b zf_muxer_wait() in a loop until all the "
+                     "events are retrieved, measuring its duration and "
+                     "number of events returned per call.");
+        rpc_zf_muxer_wait_bench(pco_iut, muxer_set, sizes[i],
+                                res.exp_events, duration, &res.busy);
+        if (res.busy.events < (uint64_t)res.exp_events)
+        {
+            ERROR_VERDICT("Not all the events were retrieved for "
+                          "muxer set of %d zockets", sizes[i]);
+        }
+
+        TEST_SUBSTEP("Measure @b zf_muxer_wait() duration when there "
+                     "are no events.");
+        rpc_zf_muxer_wait_bench(pco_iut, muxer_set, sizes[i], INT_MAX,
+                                IDLE_DURATION, &res.idle);
+
+        TEST_SUBSTEP("Re-arm and remove all the zockets measuring "
+                     "@b zf_muxer_mod() and @b zf_muxer_del() cost.");
+        rpc_zf_muxer_bulk(pco_iut, muxer_set, ZFTS_MUXER_BULK_MOD,
+                          urx_w, urx_num, RPC_EPOLLIN, &op_ns, NULL);
+        res.mod_ns = op_ns;
+        rpc_zf_muxer_bulk(pco_iut, muxer_set, ZFTS_MUXER_BULK_MOD,
+                          zft_w, zft_num, RPC_EPOLLIN, &op_ns, NULL);
+        res.mod_ns += op_ns;
+        rpc_zf_muxer_bulk(pco_iut, muxer_set, ZFTS_MUXER_BULK_DEL,
+                          urx_w, urx_num, 0, &op_ns, NULL);
+        res.del_ns = op_ns;
+        rpc_zf_muxer_bulk(pco_iut, muxer_set, ZFTS_MUXER_BULK_DEL,
+                          zft_w, zft_num, 0, &op_ns, NULL);
+        res.del_ns += op_ns;
+
+        report_results(&res);
+
+        TEST_SUBSTEP("Release the muxer set, zockets and Tester "
+                     "sockets.");
+        ZFTS_FREE(pco_iut, zf_muxer, muxer_set);
+        rpc_zfts_zockets_bulk_free(pco_iut, ZFTS_BULK_ZOCKET_URX,
+                                   urx, urx_w, urx_num);
+        urx_num = 0;
+        rpc_zfts_zockets_bulk_free(pco_iut, ZFTS_BULK_ZOCKET_ZFT_ACT,
+                                   zft, zft_w, zft_num);
+        zft_num = 0;
+        rpc_zfts_sockets_bulk_close(pco_tst, tst_socks, tst_socks_num);
+        tst_socks_num = 0;
+        zfts_destroy_stack(pco_iut, attr, stack);
+        attr = RPC_NULL;
+        stack = RPC_NULL;
+    }
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    ZFTS_FREE(pco_iut, zf_muxer, muxer_set);
+    if (urx_num > 0)
+    {
+        CLEANUP_CHECK_RC(rpc_zfts_zockets_bulk_free(pco_iut,
+                                                    ZFTS_BULK_ZOCKET_URX,
+                                                    urx, urx_w, urx_num));
+    }
+    if (zft_num > 0)
+    {
+        CLEANUP_CHECK_RC(rpc_zfts_zockets_bulk_free(
+                                            pco_iut,
+                                            ZFTS_BULK_ZOCKET_ZFT_ACT,
+                                            zft, zft_w, zft_num));
+    }
+    if (tst_socks_num > 0)
+    {
+        CLEANUP_CHECK_RC(rpc_zfts_sockets_bulk_close(pco_tst, tst_socks,
+                                                     tst_socks_num));
+    }
+    CLEANUP_RPC_CLOSE(pco_tst, tst_listener);
+    CLEANUP_RPC_CLOSE(pco_tst, tst_udp);
+    if (attr != RPC_NULL)
+        CLEANUP_RPC_ZFTS_DESTROY_STACK(pco_iut, attr, stack);
+
+    free(sizes);
+    free(urx);
+    free(zft);
+    free(urx_w);
+    free(zft_w);
+    free(tst_socks);
+    free(urx_dsts);
+    free(dsts);
+
+    TEST_END;
+}
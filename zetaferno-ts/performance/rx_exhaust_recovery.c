@@ -0,0 +1,364 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-rx_exhaust_recovery Recovery after receive buffers exhaustion
+ *
+ * @objective Measure how long it takes TCP zockets sharing a stack to
+ *            resume full throughput after receive buffers are exhausted
+ *            on one of them by not completed @b zft_zc_recv() and then
+ *            released in a controlled pattern.
+ *
+ * @param env               Testing environment:
+ *                          - @ref arg_types_env_peer2peer
+ * @param n_bufs            Value of @b n_bufs attribute.
+ * @param zockets_num       Number of TCP zockets (the first one is
+ *                          the victim).
+ * @param hold              How long to hold buffers on the victim,
+ *                          milliseconds.
+ * @param release_bufs      How many buffers of the victim backlog to
+ *                          read at once after releasing held buffers
+ *                          (@c 0 - read the whole backlog at once).
+ * @param release_interval  Interval between backlog reads,
+ *                          microseconds.
+ * @param pkt_size          Size of data sent by Tester in a single
+ *                          call.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME  "performance/rx_exhaust_recovery"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+
+/** Time before exhausting buffers, milliseconds */
+#define BASELINE_TIME 1000
+
+/** Time after releasing buffers, milliseconds */
+#define RECOVERY_TIME 3000
+
+/** Width of a time bucket, milliseconds */
+#define BUCKET_WIDTH 10
+
+/**
+ * Throughput is considered recovered when this number of consecutive
+ * buckets reaches @c RECOVERED_PERCENT of the baseline throughput.
+ */
+#define RECOVERED_BUCKETS 3
+
+/** Percent of the baseline throughput considered as recovered */
+#define RECOVERED_PERCENT 90
+
+/** A bucket with less than this percent of baseline is a stall */
+#define STALL_PERCENT 10
+
+/** Results of a zocket */
+typedef struct zocket_result {
+    double      baseline;   /**< Mean bytes per bucket before
+                                 exhaustion */
+    int         stall;      /**< Stalled buckets after exhaustion */
+    int         recovery;   /**< Buckets from releasing buffers until
+                                 recovery, -1 if not recovered */
+    uint64_t    retrans;    /**< Retransmits made by Tester */
+} zocket_result;
+
+/**
+ * Compute results of a zocket from the time series.
+ *
+ * @param series      Bytes received per bucket.
+ * @param num         Number of zockets.
+ * @param buckets     Number of buckets.
+ * @param idx         Index of the zocket.
+ * @param hold_from   First bucket after exhaustion.
+ * @param release     First bucket after releasing buffers.
+ * @param res         Where to save results.
+ */
+static void
+zocket_result_get(const uint64_t *series, int num, unsigned int buckets,
+                  int idx, unsigned int hold_from, unsigned int release,
+                  zocket_result *res)
+{
+    uint64_t sum = 0;
+    unsigned int good = 0;
+    unsigned int i;
+
+    /* The first bucket is skipped since flooding may start later. */
+    for (i = 1; i < hold_from; i++)
+        sum += series[i * num + idx];
+    res->baseline = hold_from > 1 ? (double)sum / (hold_from - 1) : 0;
+
+    res->stall = 0;
+    res->recovery = -1;
+    /* The last bucket is incomplete. */
+    for (i = hold_from; i + 1 < buckets; i++)
+    {
+        if (series[i * num + idx] * 100 < res->baseline * STALL_PERCENT)
+            res->stall++;
+
+        if (i < release || res->recovery >= 0)
+            continue;
+
+        if (series[i * num + idx] * 100 >=
+            res->baseline * RECOVERED_PERCENT)
+            good++;
+        else
+            good = 0;
+
+        if (good == RECOVERED_BUCKETS)
+            res->recovery = i + 1 - RECOVERED_BUCKETS - release;
+    }
+}
+
+/**
+ * Report results in a MI artifact.
+ *
+ * @param n_bufs            Value of @b n_bufs attribute.
+ * @param num               Number of zockets.
+ * @param hold              Hold time.
+ * @param release_bufs      Buffers read at once.
+ * @param release_interval  Interval between reads.
+ * @param stats             IUT statistics.
+ * @param res               Results of zockets.
+ */
+static void
+report_recovery(int n_bufs, int num, int hold, int release_bufs,
+                int release_interval,
+                const tarpc_zfts_rx_exhaust_stats *stats,
+                const zocket_result *res)
+{
+    te_mi_logger *logger;
+    int max_stall = 0;
+    int max_recovery = 0;
+    uint64_t retrans = 0;
+    int i;
+
+    for (i = 1; i < num; i++)
+    {
+        max_stall = MAX(max_stall, res[i].stall);
+        if (res[i].recovery < 0 || max_recovery < 0)
+            max_recovery = -1;
+        else
+            max_recovery = MAX(max_recovery, res[i].recovery);
+        retrans += res[i].retrans;
+    }
+
+    CHECK_RC(te_mi_logger_meas_create("zf_rx_exhaust_recovery", &logger));
+
+    te_mi_logger_add_meas_key(logger, NULL, "n_bufs", "%d", n_bufs);
+    te_mi_logger_add_meas_key(logger, NULL, "zockets", "%d", num);
+    te_mi_logger_add_meas_key(logger, NULL, "hold", "%d", hold);
+    te_mi_logger_add_meas_key(logger, NULL, "release", "%s",
+                              release_bufs == 0 ? "all" : "gradual");
+    te_mi_logger_add_meas_key(logger, NULL, "release_bufs", "%d",
+                              release_bufs);
+    te_mi_logger_add_meas_key(logger, NULL, "release_interval", "%d",
+                              release_interval);
+
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_THROUGHPUT,
+                          "victim baseline", TE_MI_MEAS_AGGR_MEAN,
+                          res[0].baseline * 8 / BUCKET_WIDTH / 1000,
+                          TE_MI_MEAS_MULTIPLIER_MEGA);
+    if (stats->released)
+    {
+        te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                              "victim backlog release",
+                              TE_MI_MEAS_AGGR_SINGLE, stats->release_ns,
+                              TE_MI_MEAS_MULTIPLIER_NANO);
+    }
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "victim stall", TE_MI_MEAS_AGGR_SINGLE,
+                          res[0].stall * BUCKET_WIDTH,
+                          TE_MI_MEAS_MULTIPLIER_MILLI);
+    if (res[0].recovery >= 0)
+    {
+        te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                              "victim recovery", TE_MI_MEAS_AGGR_SINGLE,
+                              res[0].recovery * BUCKET_WIDTH,
+                              TE_MI_MEAS_MULTIPLIER_MILLI);
+    }
+    if (num > 1)
+    {
+        te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                              "others stall", TE_MI_MEAS_AGGR_MAX,
+                              max_stall * BUCKET_WIDTH,
+                              TE_MI_MEAS_MULTIPLIER_MILLI);
+    }
+    if (num > 1 && max_recovery >= 0)
+    {
+        te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                              "others recovery", TE_MI_MEAS_AGGR_MAX,
+                              max_recovery * BUCKET_WIDTH,
+                              TE_MI_MEAS_MULTIPLIER_MILLI);
+    }
+
+    te_mi_logger_add_comment(logger, NULL, "held_bufs", "%llu",
+                             (unsigned long long)stats->held_bufs);
+    te_mi_logger_add_comment(logger, NULL, "backlog_bufs", "%llu",
+                             (unsigned long long)stats->backlog_bufs);
+    te_mi_logger_add_comment(logger, NULL, "victim_tst_retransmits",
+                             "%llu", (unsigned long long)res[0].retrans);
+    te_mi_logger_add_comment(logger, NULL, "others_tst_retransmits",
+                             "%llu", (unsigned long long)retrans);
+
+    te_mi_logger_destroy(logger);
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server *pco_iut = NULL;
+    rcf_rpc_server *pco_tst = NULL;
+    const struct sockaddr *iut_addr = NULL;
+    const struct sockaddr *tst_addr = NULL;
+
+    int n_bufs;
+    int zockets_num;
+    int hold;
+    int release_bufs;
+    int release_interval;
+    int pkt_size;
+
+    rpc_zf_attr_p attr = RPC_NULL;
+    rpc_zf_stack_p stack = RPC_NULL;
+    rpc_zftl_p iut_zftl = RPC_NULL;
+    zfts_tcp_conn *conns = NULL;
+    rpc_zft_p *zockets = NULL;
+    int *tst_socks = NULL;
+    uint64_t *tst_sent = NULL;
+    struct rpc_tcp_info *tcp_info = NULL;
+    struct rpc_tcp_info info;
+
+    tarpc_zfts_rx_exhaust_stats stats;
+    uint64_t *series = NULL;
+    unsigned int buckets = 0;
+    zocket_result *res = NULL;
+    int time2run;
+    int i;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+    TEST_GET_ADDR(pco_tst, tst_addr);
+    TEST_GET_INT_PARAM(n_bufs);
+    TEST_GET_INT_PARAM(zockets_num);
+    TEST_GET_INT_PARAM(hold);
+    TEST_GET_INT_PARAM(release_bufs);
+    TEST_GET_INT_PARAM(release_interval);
+    TEST_GET_INT_PARAM(pkt_size);
+
+    zockets = tapi_calloc(zockets_num, sizeof(*zockets));
+    tst_socks = tapi_calloc(zockets_num, sizeof(*tst_socks));
+    tst_sent = tapi_calloc(zockets_num, sizeof(*tst_sent));
+    tcp_info = tapi_calloc(zockets_num, sizeof(*tcp_info));
+    res = tapi_calloc(zockets_num, sizeof(*res));
+
+    TEST_STEP("Allocate ZF stack with @b n_bufs set to @p n_bufs.");
+    rpc_zf_init(pco_iut);
+    rpc_zf_attr_alloc(pco_iut, &attr);
+    rpc_zf_attr_set_int(pco_iut, attr, "n_bufs", n_bufs);
+    rpc_zf_stack_alloc(pco_iut, attr, &stack);
+
+    TEST_STEP("Establish @p zockets_num TCP connections between zockets "
+              "on IUT and sockets on Tester.");
+    conns = zfts_tcp_conns_alloc(zockets_num);
+    zfts_tcp_conns_establish2(conns, zockets_num, ZFTS_CONN_OPEN_ACT,
+                              pco_iut, attr, stack, &iut_zftl, iut_addr,
+                              pco_tst, tst_addr, -1, -1, TRUE, FALSE);
+    for (i = 0; i < zockets_num; i++)
+    {
+        zockets[i] = conns[i].iut_zft;
+        tst_socks[i] = conns[i].tst_s;
+        rpc_getsockopt(pco_tst, tst_socks[i], RPC_TCP_INFO, &tcp_info[i]);
+    }
+
+    TEST_STEP("Flood all the connections from Tester with @p pkt_size "
+              "writes.");
+    time2run = (BASELINE_TIME + hold + RECOVERY_TIME) / 1000 + 1;
+    pco_tst->op = RCF_RPC_CALL;
+    rpc_iomux_flooder(pco_tst, tst_socks, zockets_num, NULL, 0, pkt_size,
+                      time2run, 1, FUNC_DEFAULT_IOMUX, tst_sent, NULL);
+
+    TEST_STEP("On IUT drain all the zockets for a while, then receive "
+              "data on the first zocket with @b zft_zc_recv() without "
+              "completing it and stop reading it for @p hold. After that "
+              "release held buffers and read the backlog according to "
+              "@p release_bufs and @p release_interval, continuing to "
+              "drain all the zockets and recording bytes received per "
+              "time bucket.");
+    rpc_zfts_rx_exhaust_bench(pco_iut, stack, zockets, zockets_num,
+                              BASELINE_TIME, hold, release_bufs,
+                              release_interval, RECOVERY_TIME,
+                              BUCKET_WIDTH, &stats, &series, &buckets);
+
+    pco_tst->op = RCF_RPC_WAIT;
+    rpc_iomux_flooder(pco_tst, tst_socks, zockets_num, NULL, 0, pkt_size,
+                      time2run, 1, FUNC_DEFAULT_IOMUX, tst_sent, NULL);
+
+    TEST_STEP("Get number of retransmits made by Tester on every "
+              "connection.");
+    for (i = 0; i < zockets_num; i++)
+    {
+        rpc_getsockopt(pco_tst, tst_socks[i], RPC_TCP_INFO, &info);
+        res[i].retrans = info.tcpi_total_retrans -
+                         tcp_info[i].tcpi_total_retrans;
+    }
+
+    TEST_STEP("Compute stall duration and time until throughput reaches "
+              "the baseline again for the victim and for other zockets; "
+              "report them as MI measurements.");
+    for (i = 0; i < zockets_num; i++)
+    {
+        zocket_result_get(series, zockets_num, buckets, i,
+                          BASELINE_TIME / BUCKET_WIDTH,
+                          (BASELINE_TIME + hold) / BUCKET_WIDTH, &res[i]);
+        if (res[i].baseline == 0)
+            TEST_VERDICT("No data was received before exhaustion");
+        if (res[i].recovery < 0)
+        {
+            WARN("Throughput of zocket %d did not recover in %d ms",
+                 i, RECOVERY_TIME);
+        }
+        RING("Zocket %d%s: baseline %.1f Mbps, stalled for %d ms, "
+             "recovered in %d ms, Tester retransmits %llu", i,
+             i == 0 ? " (victim)" : "",
+             res[i].baseline * 8 / BUCKET_WIDTH / 1000,
+             res[i].stall * BUCKET_WIDTH,
+             res[i].recovery < 0 ? -1 : res[i].recovery * BUCKET_WIDTH,
+             (unsigned long long)res[i].retrans);
+    }
+
+    report_recovery(n_bufs, zockets_num, hold, release_bufs,
+                    release_interval, &stats, res);
+
+    if (!stats.released)
+        TEST_VERDICT("Backlog of the victim zocket was not drained");
+    if (res[0].recovery < 0)
+        TEST_VERDICT("Throughput of the victim zocket did not recover");
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    zfts_tcp_conns_destroy(pco_iut, pco_tst, conns, zockets_num);
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zftl, iut_zftl);
+    CLEANUP_RPC_ZFTS_DESTROY_STACK(pco_iut, attr, stack);
+
+    free(zockets);
+    free(tst_socks);
+    free(tst_sent);
+    free(tcp_info);
+    free(series);
+    free(res);
+
+    TEST_END;
+}
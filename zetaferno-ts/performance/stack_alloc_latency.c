@@ -0,0 +1,352 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-stack_alloc_latency Latency of ZF stack allocation and release
+ *
+ * @objective Measure how long @b zf_stack_alloc() and @b zf_stack_free()
+ *            take, which dominates startup time of a ZF application,
+ *            depending on number of hugepages, endpoint limits set in
+ *            ZF attributes, number of stacks already allocated and
+ *            number of threads allocating stacks concurrently.
+ *
+ * @param env           Testing environment:
+ *                      - @ref arg_types_env_iut_only
+ * @param attrs         Grid of ZF attribute values to check, e.g.
+ *                      @c "max_udp_rx_endpoints=1,64;max_tcp_endpoints=1,64"
+ *                      (every combination of values is checked).
+ * @param nr_hugepages  Comma-separated list of values to set for
+ *                      /proc/sys/vm/nr_hugepages (@c -1 means keeping
+ *                      the current value).
+ * @param live_stacks   Comma-separated list of numbers of stacks kept
+ *                      allocated during a measurement.
+ * @param threads       Comma-separated list of numbers of threads
+ *                      allocating and releasing stacks concurrently.
+ * @param iterations    Number of stacks every thread allocates and
+ *                      releases in a measurement.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME  "performance/stack_alloc_latency"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+
+/** Parameters of a measurement shared by all points of a sweep */
+typedef struct alloc_ctx {
+    int threads_num;    /**< Number of threads */
+    int iterations;     /**< Iterations of every thread */
+    int live_stacks;    /**< Number of stacks to keep allocated */
+} alloc_ctx;
+
+/**
+ * Add a histogram to another one.
+ *
+ * @param dst       Histogram to update.
+ * @param src       Histogram to add.
+ */
+static void
+hist_merge(tarpc_zfts_reactor_hist *dst, const tarpc_zfts_reactor_hist *src)
+{
+    unsigned int i;
+
+    dst->calls += src->calls;
+    dst->ticks += src->ticks;
+    dst->max = MAX(dst->max, src->max);
+    for (i = 0; i < TE_ARRAY_LEN(dst->buckets); i++)
+        dst->buckets[i] += src->buckets[i];
+}
+
+/**
+ * Estimate a percentile of a histogram: it is the upper bound of the
+ * bucket where the percentile falls, but not more than the maximum.
+ *
+ * @param hist      Histogram.
+ * @param pct       Percentile.
+ * @param tsc_hz    Frequency of TSC.
+ *
+ * @return The percentile, microseconds.
+ */
+static double
+hist_percentile_us(const tarpc_zfts_reactor_hist *hist, double pct,
+                   uint64_t tsc_hz)
+{
+    uint64_t     count = 0;
+    double       ticks = hist->max;
+    unsigned int i;
+
+    for (i = 0; i < TE_ARRAY_LEN(hist->buckets); i++)
+    {
+        count += hist->buckets[i];
+        if (count >= hist->calls * pct / 100)
+        {
+            ticks = MIN((double)(1ULL << i) * 2, (double)hist->max);
+            break;
+        }
+    }
+
+    return ticks * 1000000 / tsc_hz;
+}
+
+/**
+ * Measure latency of stack allocation and release; it is called for
+ * every point of attributes sweep.
+ *
+ * @param rpcs        IUT RPC server.
+ * @param attr        Attributes object with the point values.
+ * @param point       Point of the sweep.
+ * @param values      Where to save reported values.
+ * @param num         Maximum/reported number of values.
+ * @param opaque      Measurement parameters.
+ *
+ * @return Status code.
+ */
+static te_errno
+alloc_bench(rcf_rpc_server *rpcs, rpc_zf_attr_p attr,
+            const zfts_attr_sweep_point *point,
+            zfts_attr_sweep_value *values, unsigned int *num, void *opaque)
+{
+    alloc_ctx                    *ctx = opaque;
+    tarpc_zfts_stack_alloc_stats *stats;
+    tarpc_zfts_reactor_hist       alloc;
+    tarpc_zfts_reactor_hist       free_hist;
+    uint64_t                      failed = 0;
+    uint64_t                      tsc_hz = 0;
+    int                           live_allocated = 0;
+    int                           rc;
+    int                           i;
+
+    te_string str = TE_STRING_INIT;
+    char      name[64];
+
+    stats = tapi_calloc(ctx->threads_num, sizeof(*stats));
+
+    RPC_AWAIT_ERROR(rpcs);
+    rc = rpc_zfts_stack_alloc_free_bench(rpcs, attr, ctx->threads_num,
+                                         ctx->iterations, ctx->live_stacks,
+                                         stats, &live_allocated, &tsc_hz);
+    if (rc < 0)
+    {
+        RING_VERDICT("Stack allocation benchmark failed with %s: %r",
+                     point->zf_attr, RPC_ERRNO(rpcs));
+        free(stats);
+        return RPC_ERRNO(rpcs);
+    }
+
+    memset(&alloc, 0, sizeof(alloc));
+    memset(&free_hist, 0, sizeof(free_hist));
+    for (i = 0; i < ctx->threads_num; i++)
+    {
+        hist_merge(&alloc, &stats[i].alloc);
+        hist_merge(&free_hist, &stats[i].free);
+        failed += stats[i].failed;
+
+        snprintf(name, sizeof(name), "thread %d zf_stack_alloc()", i);
+        zfts_reactor_hist2str(&str, name, &stats[i].alloc, tsc_hz);
+        snprintf(name, sizeof(name), "thread %d zf_stack_free()", i);
+        zfts_reactor_hist2str(&str, name, &stats[i].free, tsc_hz);
+        if (stats[i].failed != 0)
+        {
+            te_string_append(&str, "thread %d failed allocations: %llu\n",
+                             i, (unsigned long long)stats[i].failed);
+        }
+    }
+    RING("Stack allocation with %s, %d live stacks, %d threads:\n%s",
+         point->zf_attr, live_allocated, ctx->threads_num, str.ptr);
+    te_string_free(&str);
+    free(stats);
+
+    if (live_allocated < ctx->live_stacks)
+    {
+        RING_VERDICT("Not all live stacks could be allocated with %s",
+                     point->zf_attr);
+    }
+
+    if (alloc.calls == 0 || tsc_hz == 0)
+    {
+        RING_VERDICT("No stack could be allocated with %s",
+                     point->zf_attr);
+        return TE_ENOMEM;
+    }
+
+    values[0].name = "alloc";
+    values[0].type = TE_MI_MEAS_LATENCY;
+    values[0].aggr = TE_MI_MEAS_AGGR_MEAN;
+    values[0].multiplier = TE_MI_MEAS_MULTIPLIER_MICRO;
+    values[0].val = (double)alloc.ticks / alloc.calls * 1000000 / tsc_hz;
+
+    values[1].name = "alloc";
+    values[1].type = TE_MI_MEAS_LATENCY;
+    values[1].aggr = TE_MI_MEAS_AGGR_MAX;
+    values[1].multiplier = TE_MI_MEAS_MULTIPLIER_MICRO;
+    values[1].val = (double)alloc.max * 1000000 / tsc_hz;
+
+    values[2].name = "alloc_p50_us";
+    values[2].comment = TRUE;
+    values[2].val = hist_percentile_us(&alloc, 50, tsc_hz);
+
+    values[3].name = "alloc_p99_us";
+    values[3].comment = TRUE;
+    values[3].val = hist_percentile_us(&alloc, 99, tsc_hz);
+
+    values[4].name = "free";
+    values[4].type = TE_MI_MEAS_LATENCY;
+    values[4].aggr = TE_MI_MEAS_AGGR_MEAN;
+    values[4].multiplier = TE_MI_MEAS_MULTIPLIER_MICRO;
+    values[4].val = free_hist.calls == 0 ? 0 :
+                    (double)free_hist.ticks / free_hist.calls *
+                    1000000 / tsc_hz;
+
+    values[5].name = "failed_allocs";
+    values[5].comment = TRUE;
+    values[5].val = failed;
+
+    values[6].name = "live_allocated";
+    values[6].comment = TRUE;
+    values[6].val = live_allocated;
+
+    *num = 7;
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server *pco_iut = NULL;
+
+    const char *attrs;
+    const char *nr_hugepages;
+    const char *live_stacks;
+    const char *threads;
+    int         iterations;
+
+    zfts_attr_sweep_dim *dims = NULL;
+    unsigned int         dims_num = 0;
+    zfts_attr_sweep      sweep = ZFTS_ATTR_SWEEP_INIT;
+    zfts_attr_sweep_key  keys[3];
+    alloc_ctx            ctx;
+
+    int    *huge_vals = NULL;
+    int     huge_num;
+    int    *live_vals = NULL;
+    int     live_num;
+    int    *thr_vals = NULL;
+    int     thr_num;
+    int     old_nr_hugepages = -1;
+    te_bool sweep_failed = FALSE;
+    int     hugepages;
+    int     i;
+    int     j;
+    int     k;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_STRING_PARAM(attrs);
+    TEST_GET_STRING_PARAM(nr_hugepages);
+    TEST_GET_STRING_PARAM(live_stacks);
+    TEST_GET_STRING_PARAM(threads);
+    TEST_GET_INT_PARAM(iterations);
+
+    CHECK_RC(zfts_attr_sweep_parse(attrs, &dims, &dims_num));
+    CHECK_RC(zfts_perf_parse_int_list(nr_hugepages, &huge_vals,
+                                      &huge_num));
+    CHECK_RC(zfts_perf_parse_int_list(live_stacks, &live_vals, &live_num));
+    CHECK_RC(zfts_perf_parse_int_list(threads, &thr_vals, &thr_num));
+
+    sweep.meas_name = "zf_stack_alloc_latency";
+    sweep.mode = ZFTS_ATTR_SWEEP_SET_INT;
+    sweep.dims = dims;
+    sweep.dims_num = dims_num;
+    sweep.cb = alloc_bench;
+    sweep.opaque = &ctx;
+    sweep.keys = keys;
+    sweep.keys_num = TE_ARRAY_LEN(keys);
+
+    keys[0].name = "nr_hugepages";
+    keys[1].name = "live_stacks";
+    keys[2].name = "threads";
+
+    TEST_STEP("For every value from @p nr_hugepages:");
+    for (i = 0; i < huge_num; i++)
+    {
+        TEST_SUBSTEP("Set /proc/sys/vm/nr_hugepages to the value unless "
+                     "it is negative; get the number of hugepages the "
+                     "kernel actually has.");
+        if (huge_vals[i] >= 0)
+        {
+            CHECK_RC(tapi_cfg_sys_set_int(
+                         pco_iut->ta, huge_vals[i],
+                         old_nr_hugepages < 0 ? &old_nr_hugepages : NULL,
+                         "vm/nr_hugepages"));
+        }
+        CHECK_RC(tapi_cfg_sys_get_int(pco_iut->ta, &hugepages,
+                                      "vm/nr_hugepages"));
+        if (huge_vals[i] >= 0 && hugepages != huge_vals[i])
+        {
+            WARN("Only %d hugepages of %d requested are available",
+                 hugepages, huge_vals[i]);
+        }
+
+        TEST_SUBSTEP("For every number of live stacks from "
+                     "@p live_stacks, every number of threads from "
+                     "@p threads and every combination of attribute "
+                     "values from @p attrs, allocate the live stacks "
+                     "and let every thread allocate and release a stack "
+                     "@p iterations times concurrently, timing every "
+                     "call; then release the live stacks.");
+        TEST_SUBSTEP("Report mean, median, 99th percentile and maximum "
+                     "of allocation latency and mean release latency, "
+                     "log histograms of every thread.");
+        for (j = 0; j < live_num; j++)
+        {
+            for (k = 0; k < thr_num; k++)
+            {
+                if (live_vals[j] < 0 || thr_vals[k] <= 0)
+                    continue;
+
+                ctx.threads_num = thr_vals[k];
+                ctx.iterations = iterations;
+                ctx.live_stacks = live_vals[j];
+
+                keys[0].val = hugepages;
+                keys[1].val = live_vals[j];
+                keys[2].val = thr_vals[k];
+
+                if (zfts_attr_sweep_run(pco_iut, &sweep) != 0)
+                    sweep_failed = TRUE;
+            }
+        }
+    }
+
+    if (sweep_failed)
+        TEST_VERDICT("Not all stack configurations could be checked");
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    CLEANUP_CHECK_RC(zfts_attr_sweep_cleanup(pco_iut, &sweep));
+
+    if (old_nr_hugepages >= 0)
+    {
+        CLEANUP_CHECK_RC(tapi_cfg_sys_set_int(pco_iut->ta,
+                                              old_nr_hugepages, NULL,
+                                              "vm/nr_hugepages"));
+    }
+
+    zfts_attr_sweep_dims_free(dims, dims_num);
+    free(huge_vals);
+    free(live_vals);
+    free(thr_vals);
+
+    TEST_END;
+}
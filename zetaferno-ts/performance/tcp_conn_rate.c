@@ -0,0 +1,244 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-tcp_conn_rate TCP connection setup and teardown rate
+ *
+ * @objective Measure how many TCP connections per second can be opened
+ *            and closed on IUT in a sustained loop, and how connection
+ *            setup time and @b tcp_wait_for_time_wait affect it.
+ *
+ * @param env                     Testing environment:
+ *                                - @ref arg_types_env_peer2peer
+ * @param active                  If @c TRUE, IUT opens connections
+ *                                actively, otherwise it accepts them.
+ * @param tcp_wait_for_time_wait  Value of @b tcp_wait_for_time_wait
+ *                                attribute.
+ * @param concurrency             Maximum number of connections being
+ *                                opened at the same time.
+ * @param duration                How long to open and close
+ *                                connections, milliseconds.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME  "performance/tcp_conn_rate"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+
+/** Maximum number of connection setup time samples */
+#define MAX_SAMPLES 100000
+
+/**
+ * Report measured rates in a MI artifact.
+ *
+ * @param active                  Whether IUT opened connections.
+ * @param tcp_wait_for_time_wait  Value of the attribute.
+ * @param concurrency             Concurrency.
+ * @param stats                   IUT statistics.
+ * @param times                   Sorted connection setup times.
+ * @param times_num               Number of setup times.
+ */
+static void
+report_rate(te_bool active, int tcp_wait_for_time_wait, int concurrency,
+            const tarpc_zfts_tcp_churn_stats *stats,
+            const uint64_t *times, unsigned int times_num)
+{
+    te_mi_logger *logger;
+
+    CHECK_RC(te_mi_logger_meas_create("zf_tcp_conn_rate", &logger));
+
+    te_mi_logger_add_meas_key(logger, NULL, "open", "%s",
+                              active ? "active" : "passive");
+    te_mi_logger_add_meas_key(logger, NULL, "tcp_wait_for_time_wait",
+                              "%d", tcp_wait_for_time_wait);
+    te_mi_logger_add_meas_key(logger, NULL, "concurrency", "%d",
+                              concurrency);
+
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_RPS,
+                          "connections", TE_MI_MEAS_AGGR_SINGLE,
+                          (double)stats->established * 1000000000 /
+                          stats->elapsed, TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_RPS,
+                          "teardowns", TE_MI_MEAS_AGGR_SINGLE,
+                          (double)stats->closed * 1000000000 /
+                          stats->elapsed, TE_MI_MEAS_MULTIPLIER_PLAIN);
+    if (stats->closed > 0)
+    {
+        te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                              "teardown calls", TE_MI_MEAS_AGGR_MEAN,
+                              (double)stats->teardown_ns / stats->closed,
+                              TE_MI_MEAS_MULTIPLIER_NANO);
+    }
+    if (times_num > 0)
+    {
+        te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                              "setup", TE_MI_MEAS_AGGR_MEDIAN,
+                              zfts_time_pml(times, times_num, 500),
+                              TE_MI_MEAS_MULTIPLIER_NANO);
+        te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                              "setup p99", TE_MI_MEAS_AGGR_SINGLE,
+                              zfts_time_pml(times, times_num, 990),
+                              TE_MI_MEAS_MULTIPLIER_NANO);
+        te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                              "setup", TE_MI_MEAS_AGGR_MAX,
+                              times[times_num - 1],
+                              TE_MI_MEAS_MULTIPLIER_NANO);
+    }
+    te_mi_logger_add_comment(logger, NULL, "alloc_fails", "%llu",
+                             (unsigned long long)stats->alloc_fails);
+
+    te_mi_logger_destroy(logger);
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server *pco_iut = NULL;
+    rcf_rpc_server *pco_tst = NULL;
+    const struct sockaddr *iut_addr = NULL;
+    const struct sockaddr *tst_addr = NULL;
+
+    te_bool active;
+    int tcp_wait_for_time_wait;
+    int concurrency;
+    int duration;
+
+    rpc_zf_attr_p attr = RPC_NULL;
+    rpc_zf_stack_p stack = RPC_NULL;
+    rpc_zftl_p iut_zftl = RPC_NULL;
+    int tst_s = -1;
+
+    struct sockaddr_storage tst_bind_addr;
+    tarpc_zfts_tcp_churn_stats iut_stats;
+    tarpc_zfts_tcp_churn_stats tst_stats;
+    uint64_t *times = NULL;
+    unsigned int times_num = MAX_SAMPLES;
+    const struct sockaddr *tst_laddr = NULL;
+    const struct sockaddr *tst_raddr = NULL;
+    double cps;
+    double teardown_rate;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+    TEST_GET_ADDR(pco_tst, tst_addr);
+    TEST_GET_BOOL_PARAM(active);
+    TEST_GET_INT_PARAM(tcp_wait_for_time_wait);
+    TEST_GET_INT_PARAM(concurrency);
+    TEST_GET_INT_PARAM(duration);
+
+    times = tapi_calloc(MAX_SAMPLES, sizeof(*times));
+
+    TEST_STEP("Allocate ZF stack with @b tcp_wait_for_time_wait set to "
+              "@p tcp_wait_for_time_wait.");
+    rpc_zf_init(pco_iut);
+    rpc_zf_attr_alloc(pco_iut, &attr);
+    rpc_zf_attr_set_int(pco_iut, attr, "tcp_wait_for_time_wait",
+                        tcp_wait_for_time_wait);
+    rpc_zf_stack_alloc(pco_iut, attr, &stack);
+
+    if (active)
+    {
+        TEST_STEP("If @p active is @c TRUE, create listening socket on "
+                  "Tester and let Tester accept connections and close "
+                  "them after IUT closes them.");
+        tst_s = rpc_socket(pco_tst, rpc_socket_domain_by_addr(tst_addr),
+                           RPC_SOCK_STREAM, RPC_PROTO_DEF);
+        rpc_bind(pco_tst, tst_s, tst_addr);
+        rpc_listen(pco_tst, tst_s, concurrency);
+        rpc_fcntl(pco_tst, tst_s, RPC_F_SETFL, RPC_O_NONBLOCK);
+    }
+    else
+    {
+        TEST_STEP("If @p active is @c FALSE, create listening zocket on "
+                  "IUT and let Tester open up to @p concurrency "
+                  "connections to it at the same time, closing them after "
+                  "IUT closes them.");
+        rpc_zftl_listen(pco_iut, stack, iut_addr, attr, &iut_zftl);
+
+        tapi_sockaddr_clone_exact(tst_addr, &tst_bind_addr);
+        te_sockaddr_set_port(SA(&tst_bind_addr), 0);
+        tst_laddr = SA(&tst_bind_addr);
+        tst_raddr = iut_addr;
+    }
+
+    pco_tst->op = RCF_RPC_CALL;
+    rpc_zfts_sockets_churn(pco_tst, tst_s, tst_laddr, tst_raddr, duration,
+                           concurrency, &tst_stats,
+                           active ? NULL : times,
+                           active ? NULL : &times_num);
+
+    TEST_STEP("On IUT, open (or accept) and close connections in a loop "
+              "for @p duration, closing every connection with "
+              "zft_shutdown_tx() and zft_free() once it is established.");
+    rpc_zfts_tcp_churn(pco_iut, stack, attr, iut_zftl,
+                       active ? tst_addr : NULL, duration, concurrency,
+                       &iut_stats, active ? times : NULL,
+                       active ? &times_num : NULL);
+
+    pco_tst->op = RCF_RPC_WAIT;
+    rpc_zfts_sockets_churn(pco_tst, tst_s, tst_laddr, tst_raddr, duration,
+                           concurrency, &tst_stats,
+                           active ? NULL : times,
+                           active ? NULL : &times_num);
+
+    TEST_STEP("Compute connections per second, teardown rate and "
+              "percentiles of connection setup time; report them as "
+              "MI measurements.");
+    if (iut_stats.elapsed == 0 || iut_stats.established == 0)
+        TEST_VERDICT("No connections were established on IUT");
+
+    cps = (double)iut_stats.established * 1000000000 / iut_stats.elapsed;
+    teardown_rate = (double)iut_stats.closed * 1000000000 /
+                    iut_stats.elapsed;
+
+    if (iut_stats.failed > 0 || tst_stats.failed > 0)
+    {
+        WARN("%llu connections failed on IUT, %llu on Tester",
+             (unsigned long long)iut_stats.failed,
+             (unsigned long long)tst_stats.failed);
+    }
+    if (iut_stats.alloc_fails > 0)
+    {
+        RING("Zocket allocation failed %llu times, probably because of "
+             "endpoints kept by closing connections",
+             (unsigned long long)iut_stats.alloc_fails);
+    }
+
+    if (times_num > 0)
+        qsort(times, times_num, sizeof(*times), &zfts_time_cmp);
+    report_rate(active, tcp_wait_for_time_wait, concurrency, &iut_stats,
+                times, times_num);
+
+    TEST_ARTIFACT("%s open, tcp_wait_for_time_wait=%d: %.0f conn/s, "
+                  "%.0f teardowns/s, alloc_fails=%llu, setup p99 %llu ns",
+                  active ? "Active" : "Passive", tcp_wait_for_time_wait,
+                  cps, teardown_rate,
+                  (unsigned long long)iut_stats.alloc_fails,
+                  times_num > 0 ?
+                    (unsigned long long)zfts_time_pml(times, times_num, 990) :
+                    0ULL);
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    CLEANUP_RPC_CLOSE(pco_tst, tst_s);
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zftl, iut_zftl);
+    CLEANUP_RPC_ZFTS_DESTROY_STACK(pco_iut, attr, stack);
+
+    free(times);
+
+    TEST_END;
+}
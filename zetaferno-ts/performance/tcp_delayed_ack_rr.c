@@ -0,0 +1,252 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-tcp_delayed_ack_rr Delayed ACK impact on TCP request/response
+ *
+ * @objective Measure transactions per second, segments sent by IUT per
+ *            transaction and transaction latency of a request/response
+ *            workload over TCP zocket with @b tcp_delayed_ack attribute
+ *            enabled or disabled.
+ *
+ * @param env               Testing environment:
+ *                          - @ref arg_types_env_peer2peer
+ * @param tcp_delayed_ack   Value of @b tcp_delayed_ack attribute.
+ * @param req_size          Request size (sent by IUT).
+ * @param resp_size         Response size (sent by Tester).
+ * @param depth             Maximum number of outstanding requests.
+ * @param duration          How long to send requests, milliseconds.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME  "performance/tcp_delayed_ack_rr"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+#include "tapi_tcp.h"
+#include "tapi_cfg_if.h"
+
+/** Maximum number of latency samples */
+#define MAX_SAMPLES 200000
+
+/** Segments sent by IUT, counted by CSAP callback */
+typedef struct seg_counts {
+    unsigned int total;     /**< All the captured segments */
+    unsigned int ack_only;  /**< Segments without payload */
+    te_bool      failed;    /**< Set if a segment could not be parsed */
+} seg_counts;
+
+/**
+ * CSAP callback counting captured segments with and without payload.
+ *
+ * @param pkt           Captured segment.
+ * @param user_data     Pointer to @ref seg_counts.
+ */
+static void
+count_segs_cb(asn_value *pkt, void *user_data)
+{
+    seg_counts   *counts = (seg_counts *)user_data;
+    unsigned int  payload_len;
+    te_errno      rc;
+
+    rc = tapi_tcp_get_hdrs_payload_len(pkt, NULL, &payload_len);
+    if (rc != 0)
+    {
+        ERROR("Failed to get payload length of a captured segment: %r",
+              rc);
+        counts->failed = TRUE;
+    }
+    else
+    {
+        counts->total++;
+        if (payload_len == 0)
+            counts->ack_only++;
+    }
+
+    asn_free_value(pkt);
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server *pco_iut = NULL;
+    rcf_rpc_server *pco_tst = NULL;
+    const struct if_nameindex *tst_if = NULL;
+    const struct sockaddr *iut_addr = NULL;
+    const struct sockaddr *tst_addr = NULL;
+
+    int tcp_delayed_ack;
+    int req_size;
+    int resp_size;
+    int depth;
+    int duration;
+
+    rpc_zf_attr_p attr = RPC_NULL;
+    rpc_zf_stack_p stack = RPC_NULL;
+    rpc_zft_p iut_zft = RPC_NULL;
+    int tst_s = -1;
+    int val;
+
+    csap_handle_t csap = CSAP_INVALID_HANDLE;
+    int sid;
+    tapi_tad_trrecv_cb_data cb_data;
+    seg_counts segs;
+    unsigned int captured = 0;
+
+    tarpc_zfts_tcp_rr_stats iut_stats;
+    tarpc_zfts_tcp_rr_stats tst_stats;
+    uint64_t *times = NULL;
+    unsigned int times_num = MAX_SAMPLES;
+    double tps;
+
+    te_mi_logger *logger;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_IF(tst_if);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+    TEST_GET_ADDR(pco_tst, tst_addr);
+    TEST_GET_INT_PARAM(tcp_delayed_ack);
+    TEST_GET_INT_PARAM(req_size);
+    TEST_GET_INT_PARAM(resp_size);
+    TEST_GET_INT_PARAM(depth);
+    TEST_GET_INT_PARAM(duration);
+
+    times = tapi_calloc(MAX_SAMPLES, sizeof(*times));
+
+    CHECK_RC(tapi_cfg_if_feature_set_all_parents(pco_tst->ta,
+                                                 tst_if->if_name,
+                                                 "rx-gro", 0));
+
+    TEST_STEP("Allocate ZF stack with @b tcp_delayed_ack set to "
+              "@p tcp_delayed_ack.");
+    rpc_zf_init(pco_iut);
+    rpc_zf_attr_alloc(pco_iut, &attr);
+    rpc_zf_attr_set_int(pco_iut, attr, "tcp_delayed_ack", tcp_delayed_ack);
+    rpc_zf_stack_alloc(pco_iut, attr, &stack);
+
+    TEST_STEP("Establish TCP connection between a zocket on IUT and "
+              "a socket on Tester; set @c TCP_NODELAY on the Tester "
+              "socket so that every response is sent at once.");
+    zfts_establish_tcp_conn(TRUE, pco_iut, attr, stack, &iut_zft,
+                            iut_addr, pco_tst, &tst_s, tst_addr);
+    val = 1;
+    rpc_setsockopt(pco_tst, tst_s, RPC_TCP_NODELAY, &val);
+
+    TEST_STEP("Create CSAP on Tester capturing headers of segments sent "
+              "by IUT.");
+    CHECK_RC(rcf_ta_create_session(pco_tst->ta, &sid));
+    CHECK_RC(tapi_tcp_ip4_eth_csap_create(pco_tst->ta, sid,
+                                          tst_if->if_name,
+                                          TAD_ETH_RECV_DEF |
+                                          TAD_ETH_RECV_NO_PROMISC,
+                                          NULL, NULL,
+                                          SIN(tst_addr)->sin_addr.s_addr,
+                                          SIN(iut_addr)->sin_addr.s_addr,
+                                          SIN(tst_addr)->sin_port,
+                                          SIN(iut_addr)->sin_port,
+                                          &csap));
+    CHECK_RC(tapi_tad_trrecv_start(pco_tst->ta, sid, csap, NULL,
+                                   TAD_TIMEOUT_INF, 0,
+                                   RCF_TRRECV_PACKETS_NO_PAYLOAD));
+
+    TEST_STEP("Run request/response server on Tester and client on IUT "
+              "for @p duration, keeping up to @p depth requests "
+              "outstanding.");
+    pco_tst->op = RCF_RPC_CALL;
+    rpc_zfts_sockets_rr_server(pco_tst, tst_s, req_size, resp_size,
+                               duration, &tst_stats);
+
+    rpc_zfts_tcp_rr_client(pco_iut, stack, iut_zft, req_size, resp_size,
+                           depth, duration, &iut_stats, times,
+                           &times_num);
+
+    pco_tst->op = RCF_RPC_WAIT;
+    rpc_zfts_sockets_rr_server(pco_tst, tst_s, req_size, resp_size,
+                               duration, &tst_stats);
+
+    TEST_STEP("Count all the captured segments and segments without "
+              "payload (ACK-only).");
+    memset(&segs, 0, sizeof(segs));
+    memset(&cb_data, 0, sizeof(cb_data));
+    cb_data.callback = &count_segs_cb;
+    cb_data.user_data = &segs;
+    CHECK_RC(tapi_tad_trrecv_stop(pco_tst->ta, sid, csap, &cb_data,
+                                  &captured));
+    if (segs.failed)
+        TEST_FAIL("Failed to process captured segments");
+
+    if (iut_stats.transactions == 0 || times_num == 0)
+        TEST_VERDICT("No transactions were completed");
+
+    TEST_STEP("Report transactions per second, segments sent by IUT per "
+              "transaction and latency percentiles.");
+    qsort(times, times_num, sizeof(*times), &zfts_time_cmp);
+
+    tps = (double)iut_stats.transactions * 1000000000 / iut_stats.elapsed;
+
+    CHECK_RC(te_mi_logger_meas_create("zf_tcp_delayed_ack_rr", &logger));
+    te_mi_logger_add_meas_key(logger, NULL, "tcp_delayed_ack", "%d",
+                              tcp_delayed_ack);
+    te_mi_logger_add_meas_key(logger, NULL, "req_size", "%d", req_size);
+    te_mi_logger_add_meas_key(logger, NULL, "resp_size", "%d", resp_size);
+    te_mi_logger_add_meas_key(logger, NULL, "depth", "%d", depth);
+
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_RPS, "transactions",
+                          TE_MI_MEAS_AGGR_SINGLE, tps,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "transaction", TE_MI_MEAS_AGGR_MEDIAN,
+                          zfts_time_pml(times, times_num, 500),
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "transaction p99", TE_MI_MEAS_AGGR_SINGLE,
+                          zfts_time_pml(times, times_num, 990),
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "transaction p99.9", TE_MI_MEAS_AGGR_SINGLE,
+                          zfts_time_pml(times, times_num, 999),
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "transaction", TE_MI_MEAS_AGGR_MAX,
+                          times[times_num - 1],
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_comment(logger, NULL, "iut_segs_per_transaction",
+                             "%.3f",
+                             (double)segs.total / iut_stats.transactions);
+    te_mi_logger_add_comment(logger, NULL, "acks_per_transaction", "%.3f",
+                             (double)segs.ack_only /
+                             iut_stats.transactions);
+    te_mi_logger_destroy(logger);
+
+    TEST_ARTIFACT("tcp_delayed_ack=%d: %.0f transactions/s, %.3f "
+                  "ACK-only segments per transaction, p99 latency %llu ns",
+                  tcp_delayed_ack, tps,
+                  (double)segs.ack_only / iut_stats.transactions,
+                  (unsigned long long)zfts_time_pml(times, times_num, 990));
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    if (csap != CSAP_INVALID_HANDLE)
+        CLEANUP_CHECK_RC(tapi_tad_csap_destroy(pco_tst->ta, sid, csap));
+
+    CLEANUP_RPC_CLOSE(pco_tst, tst_s);
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zft, iut_zft);
+    CLEANUP_RPC_ZFTS_DESTROY_STACK(pco_iut, attr, stack);
+
+    free(times);
+
+    TEST_END;
+}
@@ -0,0 +1,246 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-tcp_msg_more Efficiency of coalescing small TCP writes with MSG_MORE
+ *
+ * @objective Compare sending small writes over TCP zocket with and
+ *            without @c MSG_MORE flag: number of segments and bytes per
+ *            segment on the wire, CPU cost per byte and time data waits
+ *            in the send queue.
+ *
+ * @param env           Testing environment:
+ *                      - @ref arg_types_env_peer2peer
+ * @param send_func     TCP send function:
+ *                      - zft_send
+ *                      - zft_send_single
+ * @param write_size    Size of every write.
+ * @param flush_every   Every this write is made without @c MSG_MORE
+ *                      when @c MSG_MORE is used.
+ * @param duration      Duration of every measurement, seconds.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME  "performance/tcp_msg_more"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+#include "tapi_tcp.h"
+#include "tapi_cfg_if.h"
+
+/** Size of buffer used by Tester to receive data */
+#define TST_BUF_SIZE 65536
+
+/** How long Tester waits for the rest of data, seconds */
+#define TST_WAIT_TIME 1
+
+/**
+ * Report results of a measurement in a MI artifact.
+ *
+ * @param send_func     Send function.
+ * @param write_size    Size of every write.
+ * @param more          Whether @c MSG_MORE was used.
+ * @param flush_every   How often writes without @c MSG_MORE were made.
+ * @param stats         IUT statistics.
+ * @param segs          Number of segments captured on Tester.
+ */
+static void
+report_send(zfts_tcp_send_func_t send_func, int write_size, te_bool more,
+            int flush_every, const tarpc_zfts_tcp_send_bench_stats *stats,
+            unsigned int segs)
+{
+    te_mi_logger *logger;
+
+    CHECK_RC(te_mi_logger_meas_create("zf_tcp_msg_more", &logger));
+
+    te_mi_logger_add_meas_key(logger, NULL, "send_func", "%s",
+                              send_func == ZFTS_TCP_SEND_ZFT_SEND ?
+                                    "zft_send" : "zft_send_single");
+    te_mi_logger_add_meas_key(logger, NULL, "write_size", "%d",
+                              write_size);
+    te_mi_logger_add_meas_key(logger, NULL, "msg_more", "%s",
+                              more ? "yes" : "no");
+    te_mi_logger_add_meas_key(logger, NULL, "flush_every", "%d",
+                              more ? flush_every : 1);
+
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_THROUGHPUT,
+                          "sent", TE_MI_MEAS_AGGR_MEAN,
+                          (double)stats->bytes * 8 * 1000 /
+                          stats->elapsed, TE_MI_MEAS_MULTIPLIER_MEGA);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_PPS,
+                          "segments", TE_MI_MEAS_AGGR_MEAN,
+                          (double)segs * 1000000000 / stats->elapsed,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "send call per byte", TE_MI_MEAS_AGGR_MEAN,
+                          (double)stats->send_ns / stats->bytes,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "send and reactor per byte",
+                          TE_MI_MEAS_AGGR_MEAN,
+                          (double)(stats->send_ns + stats->reactor_ns) /
+                          stats->bytes, TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "hold time", TE_MI_MEAS_AGGR_MEAN,
+                          (double)stats->hold_ns / stats->writes,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+
+    te_mi_logger_add_comment(logger, NULL, "bytes_per_segment", "%.1f",
+                             segs == 0 ? 0.0 :
+                                (double)stats->bytes / segs);
+    te_mi_logger_add_comment(logger, NULL, "send_again", "%llu",
+                             (unsigned long long)stats->again);
+
+    te_mi_logger_destroy(logger);
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server *pco_iut = NULL;
+    rcf_rpc_server *pco_tst = NULL;
+    const struct if_nameindex *tst_if = NULL;
+    const struct sockaddr *iut_addr = NULL;
+    const struct sockaddr *tst_addr = NULL;
+
+    zfts_tcp_send_func_t send_func;
+    int write_size;
+    int flush_every;
+    int duration;
+
+    rpc_zf_attr_p attr = RPC_NULL;
+    rpc_zf_stack_p stack = RPC_NULL;
+    rpc_zft_p iut_zft = RPC_NULL;
+    int tst_s = -1;
+    int mss;
+
+    csap_handle_t csap = CSAP_INVALID_HANDLE;
+    int sid;
+    unsigned int segs;
+    uint64_t received;
+    int mode;
+    te_bool more;
+
+    tarpc_zfts_tcp_send_bench_stats stats;
+    te_string table = TE_STRING_INIT;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_IF(tst_if);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+    TEST_GET_ADDR(pco_tst, tst_addr);
+    TEST_GET_ENUM_PARAM(send_func, ZFTS_TCP_SEND_FUNCS);
+    TEST_GET_INT_PARAM(write_size);
+    TEST_GET_INT_PARAM(flush_every);
+    TEST_GET_INT_PARAM(duration);
+
+    CHECK_RC(tapi_cfg_if_feature_set_all_parents(pco_tst->ta,
+                                                 tst_if->if_name,
+                                                 "rx-gro", 0));
+
+    CHECK_RC(te_string_append(&table, "%8s %10s %12s %10s %12s %10s\n",
+                              "MSG_MORE", "Mbps", "segments", "B/seg",
+                              "ns/byte", "hold ns"));
+
+    TEST_STEP("Allocate ZF stack and establish TCP connection between "
+              "a zocket on IUT and a socket on Tester.");
+    zfts_create_stack(pco_iut, &attr, &stack);
+    zfts_establish_tcp_conn(TRUE, pco_iut, attr, stack, &iut_zft,
+                            iut_addr, pco_tst, &tst_s, tst_addr);
+    mss = rpc_zft_get_mss(pco_iut, iut_zft);
+
+    TEST_STEP("Create CSAP on Tester to count TCP segments sent from "
+              "IUT.");
+    CHECK_RC(rcf_ta_create_session(pco_tst->ta, &sid));
+    CHECK_RC(tapi_tcp_ip4_eth_csap_create(pco_tst->ta, sid,
+                                          tst_if->if_name,
+                                          TAD_ETH_RECV_DEF |
+                                          TAD_ETH_RECV_NO_PROMISC,
+                                          NULL, NULL,
+                                          SIN(tst_addr)->sin_addr.s_addr,
+                                          SIN(iut_addr)->sin_addr.s_addr,
+                                          SIN(tst_addr)->sin_port,
+                                          SIN(iut_addr)->sin_port,
+                                          &csap));
+
+    TEST_STEP("Send @p write_size writes from IUT for @p duration first "
+              "without @c MSG_MORE and then with @c MSG_MORE on all "
+              "writes except every @p flush_every one, while Tester "
+              "receives data and CSAP counts segments.");
+    for (mode = 0; mode < 2; mode++)
+    {
+        more = (mode == 1);
+
+        CHECK_RC(tapi_tad_trrecv_start(pco_tst->ta, sid, csap, NULL,
+                                       TAD_TIMEOUT_INF, 0,
+                                       RCF_TRRECV_COUNT));
+
+        pco_tst->op = RCF_RPC_CALL;
+        rpc_iomux_flooder(pco_tst, NULL, 0, &tst_s, 1, TST_BUF_SIZE,
+                          duration, TST_WAIT_TIME, FUNC_DEFAULT_IOMUX,
+                          NULL, &received);
+
+        rpc_zfts_tcp_send_bench(pco_iut, stack, iut_zft, write_size,
+                                send_func == ZFTS_TCP_SEND_ZFT_SEND_SINGLE,
+                                more, flush_every, mss,
+                                TE_SEC2MS(duration), &stats);
+        ZFTS_WAIT_NETWORK(pco_iut, stack);
+
+        pco_tst->op = RCF_RPC_WAIT;
+        rpc_iomux_flooder(pco_tst, NULL, 0, &tst_s, 1, TST_BUF_SIZE,
+                          duration, TST_WAIT_TIME, FUNC_DEFAULT_IOMUX,
+                          NULL, &received);
+
+        CHECK_RC(tapi_tad_trrecv_stop(pco_tst->ta, sid, csap, NULL,
+                                      &segs));
+
+        if (stats.writes == 0)
+            TEST_VERDICT("Nothing was sent from IUT");
+        if (received != stats.bytes)
+        {
+            WARN("Tester received %llu bytes instead of %llu",
+                 (unsigned long long)received,
+                 (unsigned long long)stats.bytes);
+        }
+
+        report_send(send_func, write_size, more, flush_every, &stats,
+                    segs);
+        CHECK_RC(te_string_append(
+                     &table, "%8s %10.1f %12u %10.1f %12.3f %10.1f\n",
+                     more ? "yes" : "no",
+                     (double)stats.bytes * 8 * 1000 / stats.elapsed,
+                     segs, segs == 0 ? 0.0 : (double)stats.bytes / segs,
+                     (double)(stats.send_ns + stats.reactor_ns) /
+                     stats.bytes,
+                     (double)stats.hold_ns / stats.writes));
+    }
+
+    TEST_STEP("Log the summary table.");
+    RING("Writes of %d bytes, MSS %d, flush every %d writes:\n%s",
+         write_size, mss, flush_every, table.ptr);
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    if (csap != CSAP_INVALID_HANDLE)
+        CLEANUP_CHECK_RC(tapi_tad_csap_destroy(pco_tst->ta, sid, csap));
+
+    CLEANUP_RPC_CLOSE(pco_tst, tst_s);
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zft, iut_zft);
+    CLEANUP_RPC_ZFTS_DESTROY_STACK(pco_iut, attr, stack);
+
+    te_string_free(&table);
+
+    TEST_END;
+}
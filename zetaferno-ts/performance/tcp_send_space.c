@@ -0,0 +1,262 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-tcp_send_space TCP send buffer sizing and throughput
+ *
+ * @objective Relate TCP send buffer limits to achieved throughput:
+ *            stream data over TCP zocket with various values of stack
+ *            attributes limiting send buffers and report how available
+ *            send space changes over time, how often sending stalls
+ *            and which throughput is achieved.
+ *
+ * @param env           Testing environment:
+ *                      - @ref arg_types_env_peer2peer
+ * @param attrs         Grid of ZF attribute values to check, e.g.
+ *                      @c "n_bufs=2048,4096" or @c "tx_ring_max=128,256"
+ *                      (every combination of values is checked).
+ * @param write_size    Size of every write.
+ * @param sample_every  Sample send space after this number of send
+ *                      attempts.
+ * @param duration      Duration of every measurement, seconds.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME  "performance/tcp_send_space"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+
+/** Size of buffer used by Tester to receive data */
+#define TST_BUF_SIZE 65536
+
+/** How long Tester waits for the rest of data, seconds */
+#define TST_WAIT_TIME 1
+
+/** Maximum number of send space samples per measurement */
+#define MAX_SAMPLES 128
+
+/** Test context shared by the measurements */
+typedef struct space_ctx {
+    rcf_rpc_server         *pco_tst;        /**< Tester RPC server */
+    const struct sockaddr  *iut_addr;       /**< IUT address */
+    const struct sockaddr  *tst_addr;       /**< Tester address */
+    rpc_zf_stack_p          stack;          /**< ZF stack */
+    rpc_zft_p               iut_zft;        /**< IUT zocket */
+    int                     tst_s;          /**< Tester socket */
+    int                     write_size;     /**< Size of every write */
+    int                     sample_every;   /**< Sampling interval, send
+                                                 attempts */
+    int                     duration;       /**< Duration, seconds */
+
+    tarpc_zfts_send_space_sample   *samples;    /**< Send space
+                                                     samples */
+    te_string                       series;     /**< Samples formatted
+                                                     for MI */
+} space_ctx;
+
+/**
+ * Stream data with a stack configuration; it is called for every point
+ * of attributes sweep.
+ *
+ * @param rpcs        IUT RPC server.
+ * @param attr        Attributes object with the point values.
+ * @param point       Point of the sweep.
+ * @param values      Where to save reported values.
+ * @param num         Maximum/reported number of values.
+ * @param opaque      Test context.
+ *
+ * @return Status code.
+ */
+static te_errno
+space_bench(rcf_rpc_server *rpcs, rpc_zf_attr_p attr,
+            const zfts_attr_sweep_point *point,
+            zfts_attr_sweep_value *values, unsigned int *num, void *opaque)
+{
+    space_ctx                      *ctx = opaque;
+    tarpc_zfts_tcp_send_space_stats stats;
+    unsigned int                    samples_num = MAX_SAMPLES;
+    uint64_t                        received;
+    unsigned int                    i;
+
+    rpc_zf_stack_alloc(rpcs, attr, &ctx->stack);
+    zfts_establish_tcp_conn(TRUE, rpcs, attr, ctx->stack, &ctx->iut_zft,
+                            ctx->iut_addr, ctx->pco_tst, &ctx->tst_s,
+                            ctx->tst_addr);
+
+    ctx->pco_tst->op = RCF_RPC_CALL;
+    rpc_iomux_flooder(ctx->pco_tst, NULL, 0, &ctx->tst_s, 1, TST_BUF_SIZE,
+                      ctx->duration, TST_WAIT_TIME, FUNC_DEFAULT_IOMUX,
+                      NULL, &received);
+
+    rpc_zfts_tcp_send_space_bench(rpcs, ctx->stack, ctx->iut_zft,
+                                  ctx->write_size, ctx->sample_every,
+                                  TE_SEC2MS(ctx->duration), &stats,
+                                  ctx->samples, &samples_num);
+    ZFTS_WAIT_NETWORK(rpcs, ctx->stack);
+
+    ctx->pco_tst->op = RCF_RPC_WAIT;
+    rpc_iomux_flooder(ctx->pco_tst, NULL, 0, &ctx->tst_s, 1, TST_BUF_SIZE,
+                      ctx->duration, TST_WAIT_TIME, FUNC_DEFAULT_IOMUX,
+                      NULL, &received);
+
+    if (stats.writes == 0)
+        TEST_VERDICT("Nothing was sent from IUT with %s", point->zf_attr);
+    if (received != stats.bytes)
+    {
+        WARN("Tester received %llu bytes instead of %llu",
+             (unsigned long long)received,
+             (unsigned long long)stats.bytes);
+    }
+
+    ZFTS_FREE(rpcs, zft, ctx->iut_zft);
+    RPC_CLOSE(ctx->pco_tst, ctx->tst_s);
+    ZFTS_FREE(rpcs, zf_stack, ctx->stack);
+
+    te_string_reset(&ctx->series);
+    for (i = 0; i < samples_num; i++)
+    {
+        CHECK_RC(te_string_append(&ctx->series, "%s%llu:%llu",
+                                  i == 0 ? "" : " ",
+                                  (unsigned long long)
+                                    (ctx->samples[i].time / 1000000),
+                                  (unsigned long long)
+                                    ctx->samples[i].space));
+    }
+
+    values[0].name = "sent";
+    values[0].type = TE_MI_MEAS_THROUGHPUT;
+    values[0].aggr = TE_MI_MEAS_AGGR_MEAN;
+    values[0].multiplier = TE_MI_MEAS_MULTIPLIER_MEGA;
+    values[0].val = (double)stats.bytes * 8 * 1000 / stats.elapsed;
+
+    values[1].name = "stalls";
+    values[1].type = TE_MI_MEAS_RPS;
+    values[1].aggr = TE_MI_MEAS_AGGR_MEAN;
+    values[1].multiplier = TE_MI_MEAS_MULTIPLIER_PLAIN;
+    values[1].val = (double)stats.stalls * 1000000000 / stats.elapsed;
+
+    values[2].name = "stall_time_percent";
+    values[2].comment = TRUE;
+    values[2].val = (double)stats.stall_ns * 100 / stats.elapsed;
+
+    values[3].name = "send_again";
+    values[3].comment = TRUE;
+    values[3].val = stats.again;
+
+    values[4].name = "mean_send_space";
+    values[4].comment = TRUE;
+    values[4].val = stats.samples == 0 ? 0.0 :
+                    (double)stats.space_sum / stats.samples;
+
+    values[5].name = "min_send_space";
+    values[5].comment = TRUE;
+    values[5].val = stats.min_space;
+
+    values[6].name = "send_space_ms_series";
+    values[6].comment = TRUE;
+    values[6].str = ctx->series.ptr == NULL ? "" : ctx->series.ptr;
+    *num = 7;
+
+    if (stats.stalls > 0)
+    {
+        values[7].name = "stall";
+        values[7].type = TE_MI_MEAS_LATENCY;
+        values[7].aggr = TE_MI_MEAS_AGGR_MEAN;
+        values[7].multiplier = TE_MI_MEAS_MULTIPLIER_NANO;
+        values[7].val = (double)stats.stall_ns / stats.stalls;
+        *num = 8;
+    }
+
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server *pco_iut = NULL;
+    rcf_rpc_server *pco_tst = NULL;
+    const struct sockaddr *iut_addr = NULL;
+    const struct sockaddr *tst_addr = NULL;
+
+    const char *attrs;
+    int write_size;
+    int sample_every;
+    int duration;
+
+    space_ctx ctx = { .stack = RPC_NULL, .iut_zft = RPC_NULL,
+                      .tst_s = -1, .series = TE_STRING_INIT };
+
+    zfts_attr_sweep_dim *dims = NULL;
+    unsigned int         dims_num = 0;
+    zfts_attr_sweep      sweep = ZFTS_ATTR_SWEEP_INIT;
+    zfts_attr_sweep_key  key;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+    TEST_GET_ADDR(pco_tst, tst_addr);
+    TEST_GET_STRING_PARAM(attrs);
+    TEST_GET_INT_PARAM(write_size);
+    TEST_GET_INT_PARAM(sample_every);
+    TEST_GET_INT_PARAM(duration);
+
+    CHECK_RC(zfts_attr_sweep_parse(attrs, &dims, &dims_num));
+
+    ctx.pco_tst = pco_tst;
+    ctx.iut_addr = iut_addr;
+    ctx.tst_addr = tst_addr;
+    ctx.write_size = write_size;
+    ctx.sample_every = sample_every;
+    ctx.duration = duration;
+    ctx.samples = tapi_calloc(MAX_SAMPLES, sizeof(*ctx.samples));
+
+    TEST_STEP("For every combination of attribute values from "
+              "@p attrs:");
+    TEST_SUBSTEP("Allocate ZF stack with the attribute values and "
+                 "establish TCP connection between a zocket on IUT and "
+                 "a socket on Tester.");
+    TEST_SUBSTEP("Send @p write_size writes from IUT as fast as "
+                 "possible for @p duration while Tester receives "
+                 "data, sampling @b zft_send_space() every "
+                 "@p sample_every send attempts.");
+    TEST_SUBSTEP("Close the connection and free the stack.");
+    TEST_SUBSTEP("Report throughput, stalls and send space time "
+                 "series.");
+    sweep.meas_name = "zf_tcp_send_space";
+    sweep.mode = ZFTS_ATTR_SWEEP_SET_INT;
+    sweep.dims = dims;
+    sweep.dims_num = dims_num;
+    sweep.cb = space_bench;
+    sweep.opaque = &ctx;
+    sweep.keys = &key;
+    sweep.keys_num = 1;
+    key.name = "write_size";
+    key.val = write_size;
+    CHECK_RC(zfts_attr_sweep_run(pco_iut, &sweep));
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    CLEANUP_RPC_CLOSE(pco_tst, ctx.tst_s);
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zft, ctx.iut_zft);
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zf_stack, ctx.stack);
+    CLEANUP_CHECK_RC(zfts_attr_sweep_cleanup(pco_iut, &sweep));
+
+    zfts_attr_sweep_dims_free(dims, dims_num);
+    free(ctx.samples);
+    te_string_free(&ctx.series);
+
+    TEST_END;
+}
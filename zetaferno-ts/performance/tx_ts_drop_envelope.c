@@ -0,0 +1,318 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-tx_ts_drop_envelope Drop-free envelope of UDP TX packet reports
+ *
+ * @objective Find the highest UDP send rate at which no packet reports
+ *            with TX timestamps are dropped, for various burst sizes
+ *            and values of attributes limiting the queue of reports.
+ *
+ * @param env               Testing environment:
+ *                          - @ref arg_types_env_peer2peer
+ * @param attrs             Grid of ZF attribute values to check, e.g.
+ *                          @c "tx_ring_max=64,128,256" (every
+ *                          combination of values is checked;
+ *                          @b tx_timestamping is always enabled).
+ * @param bursts            Comma-separated list of burst sizes (number
+ *                          of packets sent back-to-back).
+ * @param rate_min          Minimum send rate to check, packets per
+ *                          second.
+ * @param rate_max          Maximum send rate to check, packets per
+ *                          second.
+ * @param drain_interval    Interval between retrieving packet reports,
+ *                          microseconds.
+ * @param duration          Duration of sending at a given rate,
+ *                          milliseconds.
+ * @param pkt_size          UDP payload size.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME  "performance/tx_ts_drop_envelope"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+
+/**
+ * Binary search stops when the difference between the highest
+ * drop-free rate and the lowest rate with drops is within this
+ * percentage of the former.
+ */
+#define RATE_PRECISION 5
+
+/** Maximum number of rates checked by binary search */
+#define MAX_STEPS 12
+
+/** Number of reports kept in the collector ring */
+#define RING_SIZE 1024
+
+/** Result of sending at a given rate */
+typedef struct run_result {
+    double                  pps;    /**< Achieved rate */
+    tarpc_zfts_tx_ts_stats  stats;  /**< Collector statistics */
+} run_result;
+
+/** Test context shared by the checks */
+typedef struct envelope_ctx {
+    rcf_rpc_server         *pco_iut;        /**< IUT RPC server */
+    const struct sockaddr  *iut_addr;       /**< IUT address */
+    const struct sockaddr  *tst_addr;       /**< Tester address */
+    rpc_zf_stack_p          stack;          /**< ZF stack */
+    rpc_zfut_p              utx;            /**< UDP TX zocket */
+    rpc_zfts_tx_ts_coll_p   coll;           /**< Collector while it is
+                                                 active, so that it can
+                                                 be stopped in cleanup
+                                                 if sending fails */
+    int                     burst;          /**< Burst size */
+    int                     rate_min;       /**< Minimum rate to check */
+    int                     rate_max;       /**< Maximum rate to check */
+    int                     pkt_size;       /**< Payload size */
+    int                     duration;       /**< Sending duration, ms */
+    int                     drain_interval; /**< Reports retrieving
+                                                 interval, us */
+    run_result              best;           /**< Results of the fastest
+                                                 drop-free run */
+} envelope_ctx;
+
+/**
+ * Send packets at a given rate with a fresh collector and get its
+ * statistics; it is a check of drop-free rate search.
+ *
+ * @param rate        Packets per second.
+ * @param opaque      Test context; results of the fastest drop-free run
+ *                    are updated in it.
+ *
+ * @return @c TRUE if no reports were dropped.
+ */
+static te_bool
+run_rate(int rate, void *opaque)
+{
+    envelope_ctx   *ctx = opaque;
+    run_result      res;
+    uint64_t        sent;
+    uint64_t        elapsed;
+
+    rpc_zfts_tx_ts_collector_start(ctx->pco_iut, ctx->stack, ctx->utx,
+                                   RING_SIZE, FALSE, &ctx->coll);
+    rpc_zfts_tx_ts_paced_send(ctx->pco_iut, ctx->coll, rate, ctx->burst,
+                              ctx->pkt_size, ctx->duration,
+                              ctx->drain_interval, &sent, NULL, &elapsed);
+    rpc_zfts_tx_ts_collector_stats(ctx->pco_iut, ctx->coll, &res.stats);
+    rpc_zfts_tx_ts_collector_stop(ctx->pco_iut, ctx->coll);
+    ctx->coll = RPC_NULL;
+
+    res.pps = elapsed == 0 ? 0 :
+              (double)sent * 1000000000 / elapsed;
+
+    RING("rate=%d burst=%d: sent=%llu pps=%.0f reports=%llu dropped=%llu "
+         "lost=%llu", rate, ctx->burst, (unsigned long long)sent, res.pps,
+         (unsigned long long)res.stats.reports,
+         (unsigned long long)res.stats.dropped,
+         (unsigned long long)res.stats.lost);
+
+    if (res.stats.dropped != 0 || res.stats.lost != 0 ||
+        res.stats.reports != sent)
+        return FALSE;
+
+    if (res.pps > ctx->best.pps)
+        ctx->best = res;
+    return TRUE;
+}
+
+/**
+ * Find drop-free envelope point for a stack configuration; it is called
+ * for every point of attributes sweep.
+ *
+ * @param rpcs        IUT RPC server.
+ * @param attr        Attributes object with the point values.
+ * @param point       Point of the sweep.
+ * @param values      Where to save reported values.
+ * @param num         Maximum/reported number of values.
+ * @param opaque      Test context.
+ *
+ * @return Status code.
+ */
+static te_errno
+envelope_bench(rcf_rpc_server *rpcs, rpc_zf_attr_p attr,
+               const zfts_attr_sweep_point *point,
+               zfts_attr_sweep_value *values, unsigned int *num,
+               void *opaque)
+{
+    envelope_ctx *ctx = opaque;
+
+    rpc_zf_attr_set_int(rpcs, attr, "tx_timestamping", 1);
+    RPC_AWAIT_ERROR(rpcs);
+    if (rpc_zf_stack_alloc(rpcs, attr, &ctx->stack) < 0)
+    {
+        RING_VERDICT("Stack with %s cannot be allocated: %r",
+                     point->zf_attr, RPC_ERRNO(rpcs));
+        ctx->stack = RPC_NULL;
+        return RPC_ERRNO(rpcs);
+    }
+    rpc_zfut_alloc(rpcs, &ctx->utx, ctx->stack, ctx->iut_addr,
+                   ctx->tst_addr, 0, attr);
+
+    memset(&ctx->best, 0, sizeof(ctx->best));
+    if (zfts_perf_drop_free_search(ctx->rate_min, ctx->rate_max,
+                                   RATE_PRECISION, MAX_STEPS, run_rate,
+                                   ctx) < 0)
+    {
+        WARN("Reports are dropped already at %d pps with %s and "
+             "burst %d", ctx->rate_min, point->zf_attr, ctx->burst);
+    }
+
+    rpc_zfut_free(rpcs, ctx->utx);
+    ctx->utx = RPC_NULL;
+    rpc_zf_stack_free(rpcs, ctx->stack);
+    ctx->stack = RPC_NULL;
+
+    values[0].name = "drop-free rate";
+    values[0].type = TE_MI_MEAS_PPS;
+    values[0].aggr = TE_MI_MEAS_AGGR_SINGLE;
+    values[0].multiplier = TE_MI_MEAS_MULTIPLIER_PLAIN;
+    values[0].val = ctx->best.pps;
+    *num = 1;
+
+    if (ctx->best.stats.delay_num > 0)
+    {
+        values[1].name = "report delay";
+        values[1].type = TE_MI_MEAS_LATENCY;
+        values[1].aggr = TE_MI_MEAS_AGGR_MEAN;
+        values[1].multiplier = TE_MI_MEAS_MULTIPLIER_NANO;
+        values[1].val = (double)ctx->best.stats.delay_sum /
+                        ctx->best.stats.delay_num;
+
+        values[2].name = "report delay";
+        values[2].type = TE_MI_MEAS_LATENCY;
+        values[2].aggr = TE_MI_MEAS_AGGR_MAX;
+        values[2].multiplier = TE_MI_MEAS_MULTIPLIER_NANO;
+        values[2].val = ctx->best.stats.delay_max;
+        *num = 3;
+    }
+
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server *pco_iut = NULL;
+    rcf_rpc_server *pco_tst = NULL;
+    const struct sockaddr *iut_addr = NULL;
+    const struct sockaddr *tst_addr = NULL;
+
+    const char *attrs;
+    const char *bursts;
+    int rate_min;
+    int rate_max;
+    int drain_interval;
+    int duration;
+    int pkt_size;
+
+    envelope_ctx ctx = { .stack = RPC_NULL, .utx = RPC_NULL,
+                         .coll = RPC_NULL };
+    int tst_s = -1;
+
+    zfts_attr_sweep_dim *dims = NULL;
+    unsigned int         dims_num = 0;
+    zfts_attr_sweep      sweep = ZFTS_ATTR_SWEEP_INIT;
+    zfts_attr_sweep_key  key;
+    te_bool              sweep_failed = FALSE;
+
+    int *bsizes = NULL;
+    int bsizes_num;
+    int i;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+    TEST_GET_ADDR(pco_tst, tst_addr);
+    TEST_GET_STRING_PARAM(attrs);
+    TEST_GET_STRING_PARAM(bursts);
+    TEST_GET_INT_PARAM(rate_min);
+    TEST_GET_INT_PARAM(rate_max);
+    TEST_GET_INT_PARAM(drain_interval);
+    TEST_GET_INT_PARAM(duration);
+    TEST_GET_INT_PARAM(pkt_size);
+
+    CHECK_RC(zfts_attr_sweep_parse(attrs, &dims, &dims_num));
+    CHECK_RC(zfts_perf_parse_int_list(bursts, &bsizes, &bsizes_num));
+    if (rate_min <= 0 || rate_max < rate_min)
+        TEST_FAIL("Invalid rate range");
+
+    ctx.pco_iut = pco_iut;
+    ctx.iut_addr = iut_addr;
+    ctx.tst_addr = tst_addr;
+    ctx.rate_min = rate_min;
+    ctx.rate_max = rate_max;
+    ctx.pkt_size = pkt_size;
+    ctx.duration = duration;
+    ctx.drain_interval = drain_interval;
+
+    TEST_STEP("Create UDP socket on Tester, bind it to @p tst_addr.");
+    tst_s = rpc_socket(pco_tst, rpc_socket_domain_by_addr(tst_addr),
+                       RPC_SOCK_DGRAM, RPC_PROTO_DEF);
+    rpc_bind(pco_tst, tst_s, tst_addr);
+
+    TEST_STEP("For every value in @p bursts and every combination of "
+              "attribute values from @p attrs:");
+    TEST_SUBSTEP("Allocate ZF stack with @b tx_timestamping enabled and "
+                 "the attribute values; allocate UDP TX zocket sending "
+                 "to @p tst_addr.");
+    TEST_SUBSTEP("Find the highest rate between @p rate_min and "
+                 "@p rate_max at which paced sending of bursts for "
+                 "@p duration with reports retrieved every "
+                 "@p drain_interval does not result in dropped reports, "
+                 "using binary search.");
+    TEST_SUBSTEP("Release the zocket and the stack.");
+    sweep.meas_name = "zf_tx_timestamps";
+    sweep.mode = ZFTS_ATTR_SWEEP_SET_INT;
+    sweep.dims = dims;
+    sweep.dims_num = dims_num;
+    sweep.cb = envelope_bench;
+    sweep.opaque = &ctx;
+    sweep.keys = &key;
+    sweep.keys_num = 1;
+    key.name = "burst";
+
+    for (i = 0; i < bsizes_num; i++)
+    {
+        ctx.burst = bsizes[i];
+        key.val = bsizes[i];
+        if (zfts_attr_sweep_run(pco_iut, &sweep) != 0)
+            sweep_failed = TRUE;
+    }
+
+    if (sweep_failed)
+        TEST_VERDICT("Not all stack configurations could be checked");
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    CLEANUP_RPC_CLOSE(pco_tst, tst_s);
+    if (ctx.coll != RPC_NULL)
+    {
+        RPC_AWAIT_ERROR(pco_iut);
+        if (rpc_zfts_tx_ts_collector_stop(pco_iut, ctx.coll) != 0)
+            MACRO_TEST_ERROR;
+    }
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zfut, ctx.utx);
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zf_stack, ctx.stack);
+    CLEANUP_CHECK_RC(zfts_attr_sweep_cleanup(pco_iut, &sweep));
+
+    zfts_attr_sweep_dims_free(dims, dims_num);
+    free(bsizes);
+
+    TEST_END;
+}
@@ -0,0 +1,266 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-udp_forward Zero-copy UDP forwarding
+ *
+ * @objective Measure forwarded packet rate, drops and forwarding
+ *            latency of a relay which receives datagrams on UDP RX
+ *            zocket with @b zfur_zc_recv() and sends the same buffers
+ *            from UDP TX zocket of the same stack.
+ *
+ * @param env           Testing environment:
+ *                      - @ref arg_types_env_peer2peer
+ * @param func          UDP send function:
+ *                      - zfut_send
+ *                      - zfut_send_single
+ * @param dgram_size    Size of every datagram.
+ * @param rates         Comma-separated list of rates at which Tester
+ *                      sends datagrams, packets per second (@c 0 means
+ *                      as fast as possible).
+ * @param duration      Duration of every measurement, seconds.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME  "performance/udp_forward"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+
+/** Maximum number of latency samples */
+#define MAX_SAMPLES 100000
+
+/** How long IUT keeps forwarding after Tester stops sending, seconds */
+#define IUT_WAIT_TIME 1
+
+/**
+ * Report results of a measurement in a MI artifact.
+ *
+ * @param func          Send function.
+ * @param dgram_size    Size of every datagram.
+ * @param rate          Requested rate.
+ * @param iut           IUT statistics.
+ * @param tst           Tester statistics.
+ * @param times         Sorted latency samples.
+ * @param times_num     Number of samples (must be positive).
+ */
+static void
+report_forward(zfts_send_function func, int dgram_size, int rate,
+               const tarpc_zfts_zfur_forward_stats *iut,
+               const tarpc_zfts_udp_ts_stats *tst,
+               const uint64_t *times, unsigned int times_num)
+{
+    te_mi_logger *logger;
+    double        sec = (double)tst->elapsed / 1000000000;
+
+    CHECK_RC(te_mi_logger_meas_create("zf_udp_forward", &logger));
+
+    te_mi_logger_add_meas_key(logger, NULL, "func", "%s",
+                              func == ZFTS_ZFUT_SEND ?
+                                    "zfut_send" : "zfut_send_single");
+    te_mi_logger_add_meas_key(logger, NULL, "dgram_size", "%d",
+                              dgram_size);
+    te_mi_logger_add_meas_key(logger, NULL, "rate", "%d", rate);
+
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_PPS, "offered",
+                          TE_MI_MEAS_AGGR_MEAN, tst->sent / sec,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_PPS, "forwarded",
+                          TE_MI_MEAS_AGGR_MEAN, iut->forwarded / sec,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "forwarding",
+                          TE_MI_MEAS_AGGR_MEAN,
+                          (double)tst->lat_sum / tst->received,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "forwarding",
+                          TE_MI_MEAS_AGGR_MEDIAN,
+                          zfts_time_pml(times, times_num, 500),
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "forwarding p99", TE_MI_MEAS_AGGR_SINGLE,
+                          zfts_time_pml(times, times_num, 990),
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "forwarding",
+                          TE_MI_MEAS_AGGR_MAX, tst->lat_max,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+
+    te_mi_logger_add_comment(logger, NULL, "rx_lost", "%llu",
+                             tst->sent > iut->received ?
+                                (unsigned long long)
+                                    (tst->sent - iut->received) : 0ULL);
+    te_mi_logger_add_comment(logger, NULL, "iut_dropped", "%llu",
+                             (unsigned long long)iut->dropped);
+    te_mi_logger_add_comment(logger, NULL, "partial_sends", "%llu",
+                             (unsigned long long)iut->partial);
+    te_mi_logger_add_comment(logger, NULL, "send_again", "%llu",
+                             (unsigned long long)iut->again);
+    te_mi_logger_add_comment(logger, NULL, "stall_time_percent", "%.2f",
+                             (double)iut->stall_ns * 100 / iut->elapsed);
+    te_mi_logger_add_comment(logger, NULL, "reordered", "%llu",
+                             (unsigned long long)tst->reordered);
+
+    te_mi_logger_destroy(logger);
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server        *pco_iut = NULL;
+    rcf_rpc_server        *pco_tst = NULL;
+    const struct sockaddr *iut_addr = NULL;
+    const struct sockaddr *tst_addr = NULL;
+
+    zfts_send_function  func;
+    int                 dgram_size;
+    const char         *rates;
+    int                 duration;
+
+    rpc_zf_attr_p   attr = RPC_NULL;
+    rpc_zf_stack_p  stack = RPC_NULL;
+    rpc_zfur_p      iut_urx = RPC_NULL;
+    rpc_zfut_p      iut_utx = RPC_NULL;
+    int             tst_snd = -1;
+    int             tst_rcv = -1;
+
+    struct sockaddr_storage iut_tx_addr;
+    struct sockaddr_storage tst_rx_addr;
+
+    int        *vals = NULL;
+    int         vals_num;
+    int         i;
+
+    tarpc_zfts_zfur_forward_stats iut_stats;
+    tarpc_zfts_udp_ts_stats       tst_stats;
+    uint64_t                     *times = NULL;
+    unsigned int                  times_num;
+    te_string                     table = TE_STRING_INIT;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+    TEST_GET_ADDR(pco_tst, tst_addr);
+    ZFTS_TEST_GET_ZFUT_FUNCTION(func);
+    TEST_GET_INT_PARAM(dgram_size);
+    TEST_GET_STRING_PARAM(rates);
+    TEST_GET_INT_PARAM(duration);
+
+    CHECK_RC(zfts_perf_parse_int_list(rates, &vals, &vals_num));
+    times = tapi_calloc(MAX_SAMPLES, sizeof(*times));
+
+    CHECK_RC(te_string_append(&table,
+                              "%10s %12s %12s %8s %8s %10s %10s\n",
+                              "rate", "offered pps", "fwd pps",
+                              "rx lost", "dropped", "median ns",
+                              "p99 ns"));
+
+    TEST_STEP("Allocate ZF stack, UDP RX zocket bound to @p iut_addr and "
+              "@p tst_addr and UDP TX zocket sending from another IUT "
+              "port to another Tester port.");
+    rpc_zf_init(pco_iut);
+    rpc_zf_attr_alloc(pco_iut, &attr);
+    rpc_zf_stack_alloc(pco_iut, attr, &stack);
+
+    rpc_zfur_alloc(pco_iut, &iut_urx, stack, attr);
+    rpc_zfur_addr_bind(pco_iut, iut_urx, SA(iut_addr), tst_addr, 0);
+
+    CHECK_RC(tapi_sockaddr_clone(pco_iut, iut_addr, &iut_tx_addr));
+    CHECK_RC(tapi_sockaddr_clone(pco_tst, tst_addr, &tst_rx_addr));
+    rpc_zfut_alloc(pco_iut, &iut_utx, stack, SA(&iut_tx_addr),
+                   SA(&tst_rx_addr), 0, attr);
+
+    TEST_STEP("Create UDP socket on Tester sending to the RX zocket and "
+              "UDP socket receiving forwarded datagrams.");
+    tst_snd = rpc_socket(pco_tst, rpc_socket_domain_by_addr(tst_addr),
+                         RPC_SOCK_DGRAM, RPC_PROTO_DEF);
+    rpc_bind(pco_tst, tst_snd, tst_addr);
+    rpc_connect(pco_tst, tst_snd, iut_addr);
+
+    tst_rcv = rpc_socket(pco_tst, rpc_socket_domain_by_addr(tst_addr),
+                         RPC_SOCK_DGRAM, RPC_PROTO_DEF);
+    rpc_bind(pco_tst, tst_rcv, SA(&tst_rx_addr));
+
+    TEST_STEP("For every rate in @p rates:");
+    for (i = 0; i < vals_num; i++)
+    {
+        TEST_SUBSTEP("Run the forwarding loop on IUT while Tester sends "
+                     "timestamped datagrams at the rate for @p duration "
+                     "and receives them back.");
+        pco_iut->op = RCF_RPC_CALL;
+        rpc_zfts_zfur_forward_bench(pco_iut, stack, iut_urx, iut_utx,
+                                    func,
+                                    TE_SEC2MS(duration + IUT_WAIT_TIME),
+                                    &iut_stats);
+
+        times_num = MAX_SAMPLES;
+        rpc_zfts_sockets_udp_ts_flooder(pco_tst, tst_snd, tst_rcv,
+                                        dgram_size, vals[i],
+                                        TE_SEC2MS(duration), &tst_stats,
+                                        times, &times_num);
+
+        pco_iut->op = RCF_RPC_WAIT;
+        rpc_zfts_zfur_forward_bench(pco_iut, stack, iut_urx, iut_utx,
+                                    func,
+                                    TE_SEC2MS(duration + IUT_WAIT_TIME),
+                                    &iut_stats);
+
+        if (tst_stats.received == 0 || times_num == 0)
+            TEST_VERDICT("No datagrams were forwarded");
+        if (tst_stats.received > iut_stats.forwarded)
+        {
+            WARN("Tester received %llu datagrams while IUT forwarded "
+                 "only %llu", (unsigned long long)tst_stats.received,
+                 (unsigned long long)iut_stats.forwarded);
+        }
+
+        TEST_SUBSTEP("Report forwarded packet rate, drops and latency "
+                     "percentiles.");
+        qsort(times, times_num, sizeof(*times), &zfts_time_cmp);
+        report_forward(func, dgram_size, vals[i], &iut_stats, &tst_stats,
+                       times, times_num);
+        CHECK_RC(te_string_append(
+                     &table, "%10d %12.0f %12.0f %8llu %8llu %10llu "
+                     "%10llu\n", vals[i],
+                     (double)tst_stats.sent * 1000000000 /
+                        tst_stats.elapsed,
+                     (double)iut_stats.forwarded * 1000000000 /
+                        tst_stats.elapsed,
+                     tst_stats.sent > iut_stats.received ?
+                        (unsigned long long)
+                            (tst_stats.sent - iut_stats.received) : 0ULL,
+                     (unsigned long long)iut_stats.dropped,
+                     (unsigned long long)zfts_time_pml(times, times_num, 500),
+                     (unsigned long long)zfts_time_pml(times, times_num,
+                                                       990)));
+    }
+
+    TEST_STEP("Log the summary table.");
+    RING("Forwarding %d-byte datagrams with %s:\n%s", dgram_size,
+         func == ZFTS_ZFUT_SEND ? "zfut_send" : "zfut_send_single",
+         table.ptr);
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    CLEANUP_RPC_CLOSE(pco_tst, tst_snd);
+    CLEANUP_RPC_CLOSE(pco_tst, tst_rcv);
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zfur, iut_urx);
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zfut, iut_utx);
+    CLEANUP_RPC_ZFTS_DESTROY_STACK(pco_iut, attr, stack);
+
+    free(vals);
+    free(times);
+    te_string_free(&table);
+
+    TEST_END;
+}
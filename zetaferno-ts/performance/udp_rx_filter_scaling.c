@@ -0,0 +1,494 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-udp_rx_filter_scaling UDP RX filter table scaling with multiple binds
+ *
+ * @objective Bind a single UDP RX zocket to a growing number of
+ *            (laddr, raddr) tuples and measure how @b zfur_addr_bind()
+ *            and @b zfur_addr_unbind() latency and receive packet rate
+ *            with and without non-matching traffic depend on the number
+ *            of bound tuples; find the number of tuples at which binding
+ *            fails because hardware filters run out.
+ *
+ * @param env           Testing environment:
+ *                      - @ref arg_types_env_peer2peer
+ * @param tuples        Maximum number of tuples to bind.
+ * @param step          Number of tuples bound between measurements.
+ * @param with_raddr    Bind to full (laddr, raddr) tuples if @c TRUE,
+ *                      else bind to local addresses only.
+ * @param senders       Number of Tester sockets sending matching
+ *                      traffic, and the same number sending
+ *                      non-matching traffic.
+ * @param dgram_size    Size of every datagram.
+ * @param duration      Duration of every traffic measurement, seconds.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME  "performance/udp_rx_filter_scaling"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+
+/** How long IUT keeps receiving after Tester stops sending, seconds */
+#define IUT_WAIT_TIME 1
+
+/** Results of a single step of the table growth */
+typedef struct filter_step {
+    int         size;           /**< Number of bound tuples */
+    int         added;          /**< Tuples bound during the step */
+    uint64_t    bind_sum;       /**< Sum of bind times, ns */
+    uint64_t    bind_max;       /**< The slowest bind, ns */
+    uint64_t    unbind_sum;     /**< Sum of unbind times, ns */
+    uint64_t    unbind_max;     /**< The slowest unbind, ns */
+    double      match_pps;      /**< Delivered rate of matching traffic */
+    double      match_loss;     /**< Loss of matching traffic, percent */
+    double      mixed_pps;      /**< Delivered rate of matching traffic
+                                     sent together with non-matching */
+    double      nomatch_pps;    /**< Rate of non-matching traffic sent
+                                     by Tester */
+} filter_step;
+
+/**
+ * Get address of the i-th tuple: port of @p base incremented by @p i.
+ *
+ * @param base      Base address.
+ * @param i         Tuple index.
+ * @param addr      Where to save the address.
+ */
+static void
+tuple_addr(const struct sockaddr *base, int i,
+           struct sockaddr_storage *addr)
+{
+    tapi_sockaddr_clone_exact(base, addr);
+    te_sockaddr_set_port(SA(addr),
+                         htons(ntohs(te_sockaddr_get_port(base)) + i));
+}
+
+/**
+ * Sum times of successful bind or unbind calls.
+ *
+ * @param times     Times, ns.
+ * @param num       Number of times.
+ * @param sum       Where to add the sum.
+ * @param max       Where to update the maximum.
+ */
+static void
+times_add(const uint64_t *times, int num, uint64_t *sum, uint64_t *max)
+{
+    int i;
+
+    for (i = 0; i < num; i++)
+    {
+        *sum += times[i];
+        *max = MAX(*max, times[i]);
+    }
+}
+
+/**
+ * Flood IUT from Tester sockets for a while draining the zocket on IUT.
+ *
+ * @param pco_iut       IUT RPC server.
+ * @param pco_tst       Tester RPC server.
+ * @param stack         ZF stack.
+ * @param urx           UDP RX zocket.
+ * @param socks         Tester sockets.
+ * @param num           Number of Tester sockets.
+ * @param match_num     Number of the first sockets sending matching
+ *                      traffic.
+ * @param dgram_size    Size of every datagram.
+ * @param duration      How long to send, seconds.
+ * @param tx_stat       Buffer for Tester statistics (@p num elements).
+ * @param match_sent    Where to save number of matching datagrams sent.
+ * @param nomatch_sent  Where to save number of non-matching datagrams
+ *                      sent.
+ *
+ * @return Number of datagrams received on IUT.
+ */
+static uint64_t
+flood(rcf_rpc_server *pco_iut, rcf_rpc_server *pco_tst,
+      rpc_zf_stack_p stack, rpc_zfur_p urx, int *socks, int num,
+      int match_num, int dgram_size, int duration, uint64_t *tx_stat,
+      uint64_t *match_sent, uint64_t *nomatch_sent)
+{
+    tarpc_zfts_zfur_drain_stats stats;
+    uint64_t                    dgrams;
+    int                         i;
+
+    pco_iut->op = RCF_RPC_CALL;
+    rpc_zfts_zfur_drain_bench(pco_iut, stack, &urx, 1,
+                              TE_SEC2MS(duration + IUT_WAIT_TIME),
+                              &stats, &dgrams);
+
+    memset(tx_stat, 0, num * sizeof(*tx_stat));
+    rpc_iomux_flooder(pco_tst, socks, num, NULL, 0, dgram_size, duration,
+                      0, FUNC_DEFAULT_IOMUX, tx_stat, NULL);
+
+    pco_iut->op = RCF_RPC_WAIT;
+    rpc_zfts_zfur_drain_bench(pco_iut, stack, &urx, 1,
+                              TE_SEC2MS(duration + IUT_WAIT_TIME),
+                              &stats, &dgrams);
+
+    *match_sent = 0;
+    *nomatch_sent = 0;
+    for (i = 0; i < num; i++)
+    {
+        if (i < match_num)
+            *match_sent += tx_stat[i] / dgram_size;
+        else
+            *nomatch_sent += tx_stat[i] / dgram_size;
+    }
+
+    if (stats.dgrams > *match_sent)
+    {
+        TEST_VERDICT("IUT zocket received more datagrams than matching "
+                     "ones were sent");
+    }
+
+    return stats.dgrams;
+}
+
+/**
+ * Report results of a step in a MI artifact.
+ *
+ * @param with_raddr    Whether full tuples are bound.
+ * @param dgram_size    Size of every datagram.
+ * @param st            Results of the step.
+ * @param failed_at     Number of tuples at which binding failed, or
+ *                      @c -1.
+ */
+static void
+report_step(te_bool with_raddr, int dgram_size, const filter_step *st,
+            int failed_at)
+{
+    te_mi_logger *logger;
+
+    CHECK_RC(te_mi_logger_meas_create("zf_udp_rx_filter_scaling",
+                                      &logger));
+
+    te_mi_logger_add_meas_key(logger, NULL, "tuples", "%d", st->size);
+    te_mi_logger_add_meas_key(logger, NULL, "with_raddr", "%s",
+                              with_raddr ? "TRUE" : "FALSE");
+    te_mi_logger_add_meas_key(logger, NULL, "dgram_size", "%d",
+                              dgram_size);
+
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "bind",
+                          TE_MI_MEAS_AGGR_MEAN,
+                          (double)st->bind_sum / st->added,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "bind",
+                          TE_MI_MEAS_AGGR_MAX, st->bind_max,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "unbind",
+                          TE_MI_MEAS_AGGR_MEAN,
+                          (double)st->unbind_sum / st->added,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "unbind",
+                          TE_MI_MEAS_AGGR_MAX, st->unbind_max,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_PPS, "matching",
+                          TE_MI_MEAS_AGGR_MEAN, st->match_pps,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_PPS,
+                          "matching with non-matching",
+                          TE_MI_MEAS_AGGR_MEAN, st->mixed_pps,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_PPS,
+                          "non-matching sent", TE_MI_MEAS_AGGR_MEAN,
+                          st->nomatch_pps, TE_MI_MEAS_MULTIPLIER_PLAIN);
+
+    te_mi_logger_add_comment(logger, NULL, "matching_loss_percent",
+                             "%.3f", st->match_loss);
+    if (failed_at >= 0)
+    {
+        te_mi_logger_add_comment(logger, NULL, "bind_failed_at", "%d",
+                                 failed_at);
+    }
+
+    te_mi_logger_destroy(logger);
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server        *pco_iut = NULL;
+    rcf_rpc_server        *pco_tst = NULL;
+    const struct sockaddr *iut_addr = NULL;
+    const struct sockaddr *tst_addr = NULL;
+
+    int     tuples;
+    int     step;
+    te_bool with_raddr;
+    int     senders;
+    int     dgram_size;
+    int     duration;
+
+    rpc_zf_attr_p   attr = RPC_NULL;
+    rpc_zf_stack_p  stack = RPC_NULL;
+    rpc_zfur_p      urx = RPC_NULL;
+    int            *match_socks = NULL;
+    int            *nomatch_socks = NULL;
+    int            *flood_socks = NULL;
+    int            *sinks = NULL;
+    int             match_num = 0;
+
+    struct sockaddr_storage   iut_base;
+    struct sockaddr_storage   tst_base;
+    struct sockaddr_storage  *laddrs = NULL;
+    struct sockaddr_storage  *raddrs = NULL;
+    struct sockaddr_storage   addr;
+    const struct sockaddr   **lptrs = NULL;
+    const struct sockaddr   **rptrs = NULL;
+    uint16_t                  port;
+
+    filter_step *steps = NULL;
+    int          steps_num = 0;
+    int          size = 0;
+    int          failed_at = -1;
+    te_errno     failed_errno = 0;
+    uint64_t    *times = NULL;
+    uint64_t    *tx_stat = NULL;
+    uint64_t     match_sent;
+    uint64_t     nomatch_sent;
+    uint64_t     dgrams;
+    int          count;
+    int          done;
+    int          rc;
+    int          i;
+    int          j;
+
+    te_string table = TE_STRING_INIT;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+    TEST_GET_ADDR(pco_tst, tst_addr);
+    TEST_GET_INT_PARAM(tuples);
+    TEST_GET_INT_PARAM(step);
+    TEST_GET_BOOL_PARAM(with_raddr);
+    TEST_GET_INT_PARAM(senders);
+    TEST_GET_INT_PARAM(dgram_size);
+    TEST_GET_INT_PARAM(duration);
+
+    if (tuples <= 0 || step <= 0 || senders <= 0)
+        TEST_FAIL("Numbers of tuples, step and senders must be positive");
+
+    laddrs = tapi_calloc(tuples, sizeof(*laddrs));
+    raddrs = tapi_calloc(tuples, sizeof(*raddrs));
+    lptrs = tapi_calloc(tuples, sizeof(*lptrs));
+    rptrs = tapi_calloc(tuples, sizeof(*rptrs));
+    times = tapi_calloc(step, sizeof(*times));
+    steps = tapi_calloc((tuples + step - 1) / step, sizeof(*steps));
+    match_socks = tapi_calloc(senders, sizeof(*match_socks));
+    nomatch_socks = tapi_calloc(senders, sizeof(*nomatch_socks));
+    flood_socks = tapi_calloc(senders * 2, sizeof(*flood_socks));
+    tx_stat = tapi_calloc(senders * 2, sizeof(*tx_stat));
+    sinks = tapi_calloc(senders, sizeof(*sinks));
+    for (i = 0; i < senders; i++)
+    {
+        match_socks[i] = -1;
+        nomatch_socks[i] = -1;
+        sinks[i] = -1;
+    }
+
+    TEST_STEP("Choose @p tuples tuples: local port is incremented for "
+              "every tuple, remote port is incremented too if "
+              "@p with_raddr is @c TRUE; @p senders more ports are "
+              "reserved on both hosts for non-matching traffic.");
+    CHECK_RC(tapi_allocate_port_range(pco_iut, &port, tuples + senders));
+    tapi_sockaddr_clone_exact(iut_addr, &iut_base);
+    te_sockaddr_set_port(SA(&iut_base), htons(port));
+    CHECK_RC(tapi_allocate_port_range(pco_tst, &port, tuples + senders));
+    tapi_sockaddr_clone_exact(tst_addr, &tst_base);
+    te_sockaddr_set_port(SA(&tst_base), htons(port));
+
+    for (i = 0; i < tuples; i++)
+    {
+        tuple_addr(SA(&iut_base), i, &laddrs[i]);
+        tuple_addr(SA(&tst_base), i, &raddrs[i]);
+        lptrs[i] = CONST_SA(&laddrs[i]);
+        rptrs[i] = CONST_SA(&raddrs[i]);
+    }
+
+    TEST_STEP("Create @p senders Tester sockets sending non-matching "
+              "traffic to IUT ports which are never bound; bind kernel "
+              "UDP sockets on IUT to these ports so that the traffic is "
+              "silently consumed outside of ZF.");
+    for (i = 0; i < senders; i++)
+    {
+        tuple_addr(SA(&iut_base), tuples + i, &addr);
+        sinks[i] = rpc_socket(pco_iut, RPC_PF_INET, RPC_SOCK_DGRAM,
+                              RPC_IPPROTO_UDP);
+        rpc_bind(pco_iut, sinks[i], SA(&addr));
+
+        nomatch_socks[i] = rpc_socket(pco_tst, RPC_PF_INET,
+                                      RPC_SOCK_DGRAM, RPC_IPPROTO_UDP);
+        rpc_connect(pco_tst, nomatch_socks[i], SA(&addr));
+    }
+
+    TEST_STEP("Allocate ZF stack and UDP RX zocket.");
+    rpc_zf_init(pco_iut);
+    rpc_zf_attr_alloc(pco_iut, &attr);
+    rpc_zf_stack_alloc(pco_iut, attr, &stack);
+    rpc_zfur_alloc(pco_iut, &urx, stack, attr);
+
+    CHECK_RC(te_string_append(&table, "%7s %9s %9s %12s %8s %12s %12s\n",
+                              "tuples", "bind ns", "unbind ns",
+                              "match pps", "loss %", "mixed pps",
+                              "nomatch pps"));
+
+    TEST_STEP("Until @p tuples tuples are bound or binding fails:");
+    while (size < tuples && failed_at < 0)
+    {
+        filter_step *st = &steps[steps_num];
+
+        TEST_SUBSTEP("Bind the zocket to the next @p step tuples with a "
+                     "single RPC call measuring every "
+                     "@b zfur_addr_bind() call; if some call fails, "
+                     "remember the number of tuples bound so far.");
+        count = MIN(step, tuples - size);
+        RPC_AWAIT_ERROR(pco_iut);
+        rc = rpc_zfts_zfur_bulk_bind(pco_iut, urx, lptrs + size,
+                                     with_raddr ? rptrs + size : NULL,
+                                     count, FALSE, 0, times, &done);
+        if (rc < 0)
+        {
+            failed_at = size + done;
+            failed_errno = RPC_ERRNO(pco_iut);
+        }
+        if (done == 0)
+            break;
+
+        memset(st, 0, sizeof(*st));
+        st->added = done;
+        times_add(times, done, &st->bind_sum, &st->bind_max);
+        size += done;
+        st->size = size;
+        steps_num++;
+
+        TEST_SUBSTEP("Create up to @p senders Tester sockets sending to "
+                     "tuples spread evenly across the bound ones.");
+        match_num = MIN(senders, size);
+        for (j = 0; j < match_num; j++)
+        {
+            i = (int)((int64_t)j * size / match_num);
+            match_socks[j] = rpc_socket(pco_tst, RPC_PF_INET,
+                                        RPC_SOCK_DGRAM, RPC_IPPROTO_UDP);
+            if (with_raddr)
+                rpc_bind(pco_tst, match_socks[j], rptrs[i]);
+            rpc_connect(pco_tst, match_socks[j], lptrs[i]);
+        }
+        memcpy(flood_socks, match_socks, match_num * sizeof(*flood_socks));
+        memcpy(flood_socks + match_num, nomatch_socks,
+               senders * sizeof(*flood_socks));
+
+        TEST_SUBSTEP("Flood IUT with matching traffic for @p duration "
+                     "draining the zocket in an agent-side loop.");
+        dgrams = flood(pco_iut, pco_tst, stack, urx, flood_socks,
+                       match_num,
+                       match_num, dgram_size, duration, tx_stat,
+                       &match_sent, &nomatch_sent);
+        st->match_pps = (double)dgrams / duration;
+        st->match_loss = match_sent == 0 ? 0.0 :
+                            (double)(match_sent - dgrams) * 100 /
+                            match_sent;
+
+        TEST_SUBSTEP("Flood IUT with matching and non-matching traffic "
+                     "together for @p duration.");
+        dgrams = flood(pco_iut, pco_tst, stack, urx, flood_socks,
+                       match_num + senders, match_num, dgram_size,
+                       duration, tx_stat, &match_sent, &nomatch_sent);
+        st->mixed_pps = (double)dgrams / duration;
+        st->nomatch_pps = (double)nomatch_sent / duration;
+
+        for (j = 0; j < match_num; j++)
+            RPC_CLOSE(pco_tst, match_socks[j]);
+    }
+
+    if (size == 0)
+    {
+        TEST_VERDICT("Failed to bind UDP RX zocket to any tuple: %r",
+                     failed_errno);
+    }
+    if (failed_at >= 0)
+    {
+        TEST_ARTIFACT("Binding failed after %d tuples with %r",
+                      failed_at, failed_errno);
+    }
+
+    TEST_STEP("Unbind the zocket from all the tuples step by step in "
+              "the reverse order measuring every @b zfur_addr_unbind() "
+              "call.");
+    for (i = steps_num - 1; i >= 0; i--)
+    {
+        filter_step *st = &steps[i];
+
+        rpc_zfts_zfur_bulk_bind(pco_iut, urx,
+                                lptrs + st->size - st->added,
+                                with_raddr ?
+                                    rptrs + st->size - st->added : NULL,
+                                st->added, TRUE, 0, times, NULL);
+        times_add(times, st->added, &st->unbind_sum, &st->unbind_max);
+    }
+
+    TEST_STEP("Report bind and unbind latency and receive packet rates "
+              "for every number of bound tuples.");
+    for (i = 0; i < steps_num; i++)
+    {
+        filter_step *st = &steps[i];
+
+        report_step(with_raddr, dgram_size, st,
+                    i == steps_num - 1 ? failed_at : -1);
+        CHECK_RC(te_string_append(
+                     &table, "%7d %9.0f %9.0f %12.0f %8.3f %12.0f %12.0f\n",
+                     st->size, (double)st->bind_sum / st->added,
+                     (double)st->unbind_sum / st->added, st->match_pps,
+                     st->match_loss, st->mixed_pps, st->nomatch_pps));
+    }
+
+    RING("UDP RX filter table scaling, %s tuples, %d-byte datagrams%s:"
+         "\n%s", with_raddr ? "full" : "local address", dgram_size,
+         failed_at >= 0 ? ", binding failed" : "", table.ptr);
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    for (i = 0; i < senders; i++)
+    {
+        if (match_socks != NULL)
+            CLEANUP_RPC_CLOSE(pco_tst, match_socks[i]);
+        if (nomatch_socks != NULL)
+            CLEANUP_RPC_CLOSE(pco_tst, nomatch_socks[i]);
+        if (sinks != NULL)
+            CLEANUP_RPC_CLOSE(pco_iut, sinks[i]);
+    }
+
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zfur, urx);
+    CLEANUP_RPC_ZFTS_DESTROY_STACK(pco_iut, attr, stack);
+
+    free(laddrs);
+    free(raddrs);
+    free(lptrs);
+    free(rptrs);
+    free(times);
+    free(steps);
+    free(match_socks);
+    free(nomatch_socks);
+    free(flood_socks);
+    free(tx_stat);
+    free(sinks);
+    te_string_free(&table);
+
+    TEST_END;
+}
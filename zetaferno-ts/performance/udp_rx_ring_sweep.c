@@ -0,0 +1,366 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-udp_rx_ring_sweep Drop-free UDP receive rate and burst for RX ring sizes
+ *
+ * @objective Find the highest rate of UDP datagrams received on a UDP RX
+ *            zocket without drops and the largest burst which is
+ *            absorbed while the application does not poll the stack,
+ *            for various values of @b rx_ring_max, @b n_bufs and
+ *            similar attributes.
+ *
+ * @param env           Testing environment:
+ *                      - @ref arg_types_env_peer2peer
+ * @param attrs         Grid of ZF attribute values to check, e.g.
+ *                      @c "rx_ring_max=512,1024;n_bufs=4096,16384"
+ *                      (every combination of values is checked).
+ * @param rate_min      Minimum send rate to check, datagrams per second.
+ * @param rate_max      Maximum send rate to check, datagrams per second.
+ * @param burst_max     Maximum burst size to check.
+ * @param dgram_size    UDP payload size.
+ * @param duration      Duration of sending at a given rate,
+ *                      milliseconds.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME  "performance/udp_rx_ring_sweep"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+
+/**
+ * Binary search stops when the difference between the highest
+ * drop-free value and the lowest value with drops is within this
+ * percentage of the former.
+ */
+#define SEARCH_PRECISION 5
+
+/** Maximum number of values checked by binary search */
+#define MAX_STEPS 12
+
+/** How long IUT keeps receiving after Tester stops sending, ms */
+#define IUT_WAIT_TIME 1000
+
+/** How long IUT receives a burst after it is sent, ms */
+#define BURST_DRAIN_TIME 500
+
+/** Limit of time of sending a burst, ms */
+#define BURST_SEND_TIME 10000
+
+/** Results of checking a stack configuration */
+typedef struct ring_result {
+    double      pps;        /**< The highest drop-free receive rate */
+    int         burst;      /**< The largest absorbed burst */
+    uint64_t    capacity;   /**< Datagrams received from the burst of
+                                 @p burst_max datagrams */
+} ring_result;
+
+/** Test context shared by the checks */
+typedef struct ring_ctx {
+    rcf_rpc_server         *pco_iut;    /**< IUT RPC server */
+    rcf_rpc_server         *pco_tst;    /**< Tester RPC server */
+    const struct sockaddr  *iut_addr;   /**< IUT address */
+    const struct sockaddr  *tst_addr;   /**< Tester address */
+    rpc_zf_stack_p          stack;      /**< ZF stack */
+    rpc_zfur_p              urx;        /**< UDP RX zocket */
+    int                     tst_s;      /**< Tester socket */
+    int                     dgram_size; /**< Datagram size */
+    int                     rate_min;   /**< Minimum rate to check */
+    int                     rate_max;   /**< Maximum rate to check */
+    int                     burst_max;  /**< Maximum burst to check */
+    int                     duration;   /**< Sending duration, ms */
+    double                  pps;        /**< The highest drop-free
+                                             receive rate achieved */
+} ring_ctx;
+
+/**
+ * Send datagrams from Tester at a given rate for @b duration while IUT
+ * receives them; it is a check of drop-free rate search.
+ *
+ * @param rate        Datagrams per second.
+ * @param opaque      Test context; the highest drop-free receive rate
+ *                    is updated in it.
+ *
+ * @return @c TRUE if all the sent datagrams were received.
+ */
+static te_bool
+run_rate(int rate, void *opaque)
+{
+    ring_ctx                   *ctx = opaque;
+    tarpc_zfts_zfur_drain_stats rx_stats;
+    tarpc_zfts_udp_paced_stats  tx_stats;
+    uint64_t                    dgrams;
+    double                      pps;
+
+    ctx->pco_iut->op = RCF_RPC_CALL;
+    rpc_zfts_zfur_drain_bench(ctx->pco_iut, ctx->stack, &ctx->urx, 1,
+                              ctx->duration + IUT_WAIT_TIME, &rx_stats,
+                              &dgrams);
+
+    rpc_zfts_sockets_udp_paced_send(ctx->pco_tst, ctx->tst_s,
+                                    ctx->dgram_size, rate, 0,
+                                    ctx->duration, &tx_stats);
+
+    ctx->pco_iut->op = RCF_RPC_WAIT;
+    rpc_zfts_zfur_drain_bench(ctx->pco_iut, ctx->stack, &ctx->urx, 1,
+                              ctx->duration + IUT_WAIT_TIME, &rx_stats,
+                              &dgrams);
+
+    pps = tx_stats.elapsed == 0 ? 0 :
+          (double)dgrams * 1000000000 / tx_stats.elapsed;
+
+    RING("rate=%d: sent=%llu received=%llu pps=%.0f", rate,
+         (unsigned long long)tx_stats.sent, (unsigned long long)dgrams,
+         pps);
+
+    if (tx_stats.sent == 0 || dgrams != tx_stats.sent)
+        return FALSE;
+
+    ctx->pps = MAX(ctx->pps, pps);
+    return TRUE;
+}
+
+/**
+ * Send a burst of datagrams from Tester while IUT does not poll the
+ * stack, then receive the datagrams on IUT.
+ *
+ * @param ctx         Test context.
+ * @param burst       Number of datagrams to send.
+ * @param received    Where to save number of received datagrams.
+ *
+ * @return @c TRUE if all the datagrams were received.
+ */
+static te_bool
+run_burst(ring_ctx *ctx, int burst, uint64_t *received)
+{
+    tarpc_zfts_zfur_drain_stats rx_stats;
+    tarpc_zfts_udp_paced_stats  tx_stats;
+
+    rpc_zfts_sockets_udp_paced_send(ctx->pco_tst, ctx->tst_s,
+                                    ctx->dgram_size, 0, burst,
+                                    BURST_SEND_TIME, &tx_stats);
+    rpc_zfts_zfur_drain_bench(ctx->pco_iut, ctx->stack, &ctx->urx, 1,
+                              BURST_DRAIN_TIME, &rx_stats, received);
+
+    RING("burst=%d: sent=%llu received=%llu", burst,
+         (unsigned long long)tx_stats.sent,
+         (unsigned long long)*received);
+
+    if (tx_stats.sent != (uint64_t)burst)
+    {
+        TEST_VERDICT("Tester failed to send a burst of %d datagrams",
+                     burst);
+    }
+
+    return *received == (uint64_t)burst;
+}
+
+/**
+ * Find the highest drop-free receive rate and the largest absorbed burst
+ * for the current stack configuration.
+ *
+ * @param ctx         Test context.
+ * @param res         Where to save results.
+ */
+static void
+check_config(ring_ctx *ctx, ring_result *res)
+{
+    int         burst_max = ctx->burst_max;
+    uint64_t    received;
+    int         lo;
+    int         hi;
+    int         mid;
+    int         step;
+
+    memset(res, 0, sizeof(*res));
+
+    ctx->pps = 0;
+    zfts_perf_drop_free_search(ctx->rate_min, ctx->rate_max,
+                               SEARCH_PRECISION, MAX_STEPS, run_rate, ctx);
+    res->pps = ctx->pps;
+
+    /*
+     * Burst of the maximum size shows how many datagrams the stack can
+     * hold at all; the largest absorbed burst cannot exceed it, so it is
+     * the first value checked by binary search.
+     */
+    if (run_burst(ctx, burst_max, &res->capacity))
+    {
+        res->burst = burst_max;
+        return;
+    }
+
+    lo = 0;
+    hi = burst_max;
+    mid = res->capacity;
+    for (step = 0; step < MAX_STEPS && mid > lo && mid < hi; step++)
+    {
+        if (run_burst(ctx, mid, &received))
+            lo = mid;
+        else
+            hi = mid;
+
+        if (hi - lo <= 1 || (hi - lo) * 100 <= lo * SEARCH_PRECISION)
+            break;
+        mid = lo + (hi - lo) / 2;
+    }
+    res->burst = lo;
+}
+
+/**
+ * Check a stack configuration; it is called for every point of
+ * attributes sweep.
+ *
+ * @param rpcs        IUT RPC server.
+ * @param attr        Attributes object with the point values.
+ * @param point       Point of the sweep.
+ * @param values      Where to save reported values.
+ * @param num         Maximum/reported number of values.
+ * @param opaque      Test context.
+ *
+ * @return Status code.
+ */
+static te_errno
+ring_bench(rcf_rpc_server *rpcs, rpc_zf_attr_p attr,
+           const zfts_attr_sweep_point *point,
+           zfts_attr_sweep_value *values, unsigned int *num, void *opaque)
+{
+    ring_ctx    *ctx = opaque;
+    ring_result  res;
+
+    RPC_AWAIT_ERROR(rpcs);
+    if (rpc_zf_stack_alloc(rpcs, attr, &ctx->stack) < 0)
+    {
+        RING_VERDICT("Stack with %s cannot be allocated: %r",
+                     point->zf_attr, RPC_ERRNO(rpcs));
+        ctx->stack = RPC_NULL;
+        return RPC_ERRNO(rpcs);
+    }
+    rpc_zfur_alloc(rpcs, &ctx->urx, ctx->stack, attr);
+    rpc_zfur_addr_bind(rpcs, ctx->urx, SA(ctx->iut_addr), ctx->tst_addr,
+                       0);
+
+    check_config(ctx, &res);
+
+    rpc_zfur_free(rpcs, ctx->urx);
+    ctx->urx = RPC_NULL;
+    rpc_zf_stack_free(rpcs, ctx->stack);
+    ctx->stack = RPC_NULL;
+
+    values[0].name = "drop-free rate";
+    values[0].type = TE_MI_MEAS_PPS;
+    values[0].aggr = TE_MI_MEAS_AGGR_SINGLE;
+    values[0].multiplier = TE_MI_MEAS_MULTIPLIER_PLAIN;
+    values[0].val = res.pps;
+
+    values[1].name = "absorbed_burst";
+    values[1].comment = TRUE;
+    values[1].val = res.burst;
+
+    values[2].name = "burst_capacity";
+    values[2].comment = TRUE;
+    values[2].val = res.capacity;
+
+    values[3].name = "dgram_size";
+    values[3].comment = TRUE;
+    values[3].val = ctx->dgram_size;
+
+    *num = 4;
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server        *pco_iut = NULL;
+    rcf_rpc_server        *pco_tst = NULL;
+    const struct sockaddr *iut_addr = NULL;
+    const struct sockaddr *tst_addr = NULL;
+
+    const char *attrs;
+    int         rate_min;
+    int         rate_max;
+    int         burst_max;
+    int         dgram_size;
+    int         duration;
+
+    ring_ctx             ctx = { .tst_s = -1, .stack = RPC_NULL,
+                                 .urx = RPC_NULL };
+    zfts_attr_sweep_dim *dims = NULL;
+    unsigned int         dims_num = 0;
+    zfts_attr_sweep      sweep = ZFTS_ATTR_SWEEP_INIT;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+    TEST_GET_ADDR(pco_tst, tst_addr);
+    TEST_GET_STRING_PARAM(attrs);
+    TEST_GET_INT_PARAM(rate_min);
+    TEST_GET_INT_PARAM(rate_max);
+    TEST_GET_INT_PARAM(burst_max);
+    TEST_GET_INT_PARAM(dgram_size);
+    TEST_GET_INT_PARAM(duration);
+
+    CHECK_RC(zfts_attr_sweep_parse(attrs, &dims, &dims_num));
+
+    ctx.pco_iut = pco_iut;
+    ctx.pco_tst = pco_tst;
+    ctx.iut_addr = iut_addr;
+    ctx.tst_addr = tst_addr;
+    ctx.dgram_size = dgram_size;
+    ctx.rate_min = rate_min;
+    ctx.rate_max = rate_max;
+    ctx.burst_max = burst_max;
+    ctx.duration = duration;
+
+    TEST_STEP("Create UDP socket on Tester, bind it to @p tst_addr and "
+              "connect it to @p iut_addr.");
+    ctx.tst_s = rpc_socket(pco_tst, rpc_socket_domain_by_addr(tst_addr),
+                           RPC_SOCK_DGRAM, RPC_PROTO_DEF);
+    rpc_bind(pco_tst, ctx.tst_s, tst_addr);
+    rpc_connect(pco_tst, ctx.tst_s, iut_addr);
+
+    TEST_STEP("For every combination of attribute values from @p attrs:");
+    TEST_SUBSTEP("Allocate ZF stack with the attribute values; allocate "
+                 "UDP RX zocket bound to @p iut_addr.");
+    TEST_SUBSTEP("Find the highest rate between @p rate_min and "
+                 "@p rate_max at which all datagrams sent by Tester for "
+                 "@p duration are received on IUT, using binary search.");
+    TEST_SUBSTEP("Send a burst of @p burst_max datagrams from Tester "
+                 "while IUT does not poll the stack, then receive "
+                 "datagrams on IUT; find the largest burst which is "
+                 "received completely, using binary search.");
+    TEST_SUBSTEP("Release the zocket and the stack.");
+    sweep.meas_name = "zf_udp_rx_ring";
+    sweep.mode = ZFTS_ATTR_SWEEP_SET_INT;
+    sweep.dims = dims;
+    sweep.dims_num = dims_num;
+    sweep.cb = ring_bench;
+    sweep.opaque = &ctx;
+    if (zfts_attr_sweep_run(pco_iut, &sweep) != 0)
+        TEST_VERDICT("Not all stack configurations could be checked");
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    CLEANUP_RPC_CLOSE(pco_tst, ctx.tst_s);
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zfur, ctx.urx);
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zf_stack, ctx.stack);
+    CLEANUP_CHECK_RC(zfts_attr_sweep_cleanup(pco_iut, &sweep));
+
+    zfts_attr_sweep_dims_free(dims, dims_num);
+
+    TEST_END;
+}
@@ -0,0 +1,274 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-udp_tx_max_payload Packet rate and goodput around the frame boundary
+ *
+ * @objective Measure packet rate and goodput of UDP TX zocket when
+ *            datagrams are sized relative to the maximum payload
+ *            fitting in one frame (@b zfut_get_mss()), to show the cost
+ *            of crossing the frame boundary.
+ *
+ * @param env           Testing environment:
+ *                      - @ref arg_types_env_peer2peer
+ * @param func          Transmitting function:
+ *                      - @b zfut_send_single()
+ *                      - @b zfut_send()
+ * @param mss_offsets   Comma-separated list of offsets added to MSS to
+ *                      get datagram sizes (@c 0 fills exactly one frame).
+ * @param duration      Duration of every measurement, seconds.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME  "performance/udp_tx_max_payload"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+
+/** How long Tester keeps receiving after IUT stops sending, seconds */
+#define TST_WAIT_TIME 1
+
+/** UDP header length */
+#define UDP_HEADER_LEN 8
+
+/** Results of a measurement */
+typedef struct payload_result {
+    int     frames;         /**< Frames per datagram */
+    int     wire_bytes;     /**< Frame bytes per datagram */
+    double  pps;            /**< Datagrams sent per second */
+    double  fps;            /**< Frames sent per second */
+    double  goodput;        /**< Sent payload, bits per second */
+    double  recv_goodput;   /**< Received payload, bits per second */
+    double  efficiency;     /**< Payload share of frame bytes, percents */
+} payload_result;
+
+/**
+ * Compute results of a measurement.
+ *
+ * A datagram exceeding MSS is sent as IP fragments: every fragment
+ * carries all the headers except UDP one, and fragment payload is
+ * a multiple of 8 bytes.
+ *
+ * @param size          Datagram size.
+ * @param mss           Value returned by @b zfut_get_mss().
+ * @param header_size   Value returned by @b zfut_get_header_size().
+ * @param sent          Bytes sent by IUT.
+ * @param received      Bytes received by Tester.
+ * @param duration      Duration of the measurement, seconds.
+ * @param res           Where to save the results.
+ */
+static void
+payload_compute(int size, int mss, int header_size, uint64_t sent,
+                uint64_t received, int duration, payload_result *res)
+{
+    int frag_payload = (mss + UDP_HEADER_LEN) & ~7;
+
+    if (size <= mss)
+        res->frames = 1;
+    else
+        res->frames = (size + UDP_HEADER_LEN + frag_payload - 1) /
+                      frag_payload;
+
+    res->wire_bytes = res->frames * (header_size - UDP_HEADER_LEN) +
+                      size + UDP_HEADER_LEN;
+    res->pps = (double)sent / size / duration;
+    res->fps = res->pps * res->frames;
+    res->goodput = (double)sent * 8 / duration;
+    res->recv_goodput = (double)received * 8 / duration;
+    res->efficiency = 100.0 * size / res->wire_bytes;
+}
+
+/**
+ * Report results of a measurement to MI log.
+ *
+ * @param func          Transmitting function.
+ * @param mss_offset    Offset of the datagram size from MSS.
+ * @param size          Datagram size.
+ * @param mss           Value returned by @b zfut_get_mss().
+ * @param header_size   Value returned by @b zfut_get_header_size().
+ * @param errors        Number of @c EAGAIN errors.
+ * @param res           Results of the measurement.
+ */
+static void
+report_payload(zfts_send_function func, int mss_offset, int size, int mss,
+               int header_size, uint64_t errors, const payload_result *res)
+{
+    te_mi_logger *logger;
+
+    CHECK_RC(te_mi_logger_meas_create("zf_udp_tx_max_payload", &logger));
+
+    te_mi_logger_add_meas_key(logger, NULL, "func", "%s",
+                              func == ZFTS_ZFUT_SEND ?
+                                    "zfut_send" : "zfut_send_single");
+    te_mi_logger_add_meas_key(logger, NULL, "mss_offset", "%d",
+                              mss_offset);
+    te_mi_logger_add_meas_key(logger, NULL, "dgram_size", "%d", size);
+
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_PPS, "datagrams",
+                          TE_MI_MEAS_AGGR_MEAN, res->pps,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_PPS, "frames",
+                          TE_MI_MEAS_AGGR_MEAN, res->fps,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_THROUGHPUT, "goodput",
+                          TE_MI_MEAS_AGGR_MEAN, res->goodput / 1000000,
+                          TE_MI_MEAS_MULTIPLIER_MEGA);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_THROUGHPUT,
+                          "received goodput", TE_MI_MEAS_AGGR_MEAN,
+                          res->recv_goodput / 1000000,
+                          TE_MI_MEAS_MULTIPLIER_MEGA);
+
+    te_mi_logger_add_comment(logger, NULL, "mss", "%d", mss);
+    te_mi_logger_add_comment(logger, NULL, "header_size", "%d",
+                             header_size);
+    te_mi_logger_add_comment(logger, NULL, "frames_per_datagram", "%d",
+                             res->frames);
+    te_mi_logger_add_comment(logger, NULL, "payload_efficiency_percent",
+                             "%.2f", res->efficiency);
+    te_mi_logger_add_comment(logger, NULL, "send_again", "%llu",
+                             (unsigned long long)errors);
+
+    te_mi_logger_destroy(logger);
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server        *pco_iut = NULL;
+    rcf_rpc_server        *pco_tst = NULL;
+    const struct sockaddr *iut_addr = NULL;
+    const struct sockaddr *tst_addr = NULL;
+
+    zfts_send_function  func;
+    const char         *mss_offsets;
+    int                 duration;
+
+    rpc_zf_attr_p   attr = RPC_NULL;
+    rpc_zf_stack_p  stack = RPC_NULL;
+    rpc_zfut_p      utx = RPC_NULL;
+    int             tst_s = -1;
+    int             mss;
+    int             header_size;
+
+    payload_result  res;
+    uint64_t        sent;
+    uint64_t        errors;
+    uint64_t        received;
+    int            *offs = NULL;
+    int             offs_num;
+    int             size;
+    int             i;
+
+    te_string table = TE_STRING_INIT;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+    TEST_GET_ADDR(pco_tst, tst_addr);
+    ZFTS_TEST_GET_ZFUT_FUNCTION(func);
+    TEST_GET_STRING_PARAM(mss_offsets);
+    TEST_GET_INT_PARAM(duration);
+
+    CHECK_RC(zfts_perf_parse_int_list(mss_offsets, &offs, &offs_num));
+
+    CHECK_RC(te_string_append(&table, "%6s %6s %6s %12s %12s %14s %7s\n",
+                              "offset", "size", "frames", "pps", "fps",
+                              "goodput, bps", "eff, %"));
+
+    TEST_STEP("Allocate ZF stack and UDP TX zocket sending from "
+              "@p iut_addr to @p tst_addr; bind UDP socket on Tester to "
+              "@p tst_addr.");
+    rpc_zf_init(pco_iut);
+    rpc_zf_attr_alloc(pco_iut, &attr);
+    rpc_zf_stack_alloc(pco_iut, attr, &stack);
+    rpc_zfut_alloc(pco_iut, &utx, stack, iut_addr, tst_addr, 0, attr);
+
+    tst_s = rpc_socket(pco_tst, rpc_socket_domain_by_addr(tst_addr),
+                       RPC_SOCK_DGRAM, RPC_PROTO_DEF);
+    rpc_bind(pco_tst, tst_s, tst_addr);
+
+    TEST_STEP("Get MSS and protocol headers size of the zocket.");
+    mss = rpc_zfut_get_mss(pco_iut, utx);
+    header_size = rpc_zfut_get_header_size(pco_iut, utx);
+    RING("MSS %d, headers size %d, frame size %d", mss, header_size,
+         mss + header_size);
+
+    TEST_STEP("For every offset in @p mss_offsets:");
+    for (i = 0; i < offs_num; i++)
+    {
+        size = mss + offs[i];
+        if (size <= 0)
+            continue;
+
+        if (func == ZFTS_ZFUT_SEND_SINGLE && size > mss)
+        {
+            TEST_SUBSTEP("Skip sizes above MSS with @b zfut_send_single() "
+                         "since it does not fragment datagrams.");
+            CHECK_RC(te_string_append(&table, "%6d %6d %6s %12s\n",
+                                      offs[i], size, "-", "n/a"));
+            continue;
+        }
+
+        TEST_SUBSTEP("Receive datagrams on Tester with "
+                     "@b rpc_iomux_flooder() while IUT sends datagrams "
+                     "of MSS plus the offset bytes for @p duration "
+                     "with @p func, letting the agent size them from "
+                     "@b zfut_get_mss().");
+        received = 0;
+        pco_tst->op = RCF_RPC_CALL;
+        rpc_iomux_flooder(pco_tst, NULL, 0, &tst_s, 1, size, duration,
+                          TST_WAIT_TIME, FUNC_DEFAULT_IOMUX, NULL,
+                          &received);
+
+        rpc_zfut_flooder_fill_frame(pco_iut, stack, utx, func, offs[i], 1,
+                                    TE_SEC2MS(duration), &sent, &errors,
+                                    &size, NULL);
+
+        pco_tst->op = RCF_RPC_WAIT;
+        rpc_iomux_flooder(pco_tst, NULL, 0, &tst_s, 1, size, duration,
+                          TST_WAIT_TIME, FUNC_DEFAULT_IOMUX, NULL,
+                          &received);
+
+        if (sent == 0)
+            TEST_VERDICT("Nothing was sent with %d-byte datagrams", size);
+
+        TEST_SUBSTEP("Report datagram and frame rates, sent and received "
+                     "goodput and the payload share of frame bytes.");
+        payload_compute(size, mss, header_size, sent, received, duration,
+                        &res);
+        report_payload(func, offs[i], size, mss, header_size, errors,
+                       &res);
+        CHECK_RC(te_string_append(
+                     &table, "%6d %6d %6d %12.0f %12.0f %14.0f %7.2f\n",
+                     offs[i], size, res.frames, res.pps, res.fps,
+                     res.goodput, res.efficiency));
+    }
+
+    TEST_STEP("Log the summary table.");
+    RING("Sending with %s around the frame boundary, MSS %d:\n%s",
+         func == ZFTS_ZFUT_SEND ? "zfut_send" : "zfut_send_single", mss,
+         table.ptr);
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    CLEANUP_RPC_CLOSE(pco_tst, tst_s);
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zfut, utx);
+    CLEANUP_RPC_ZFTS_DESTROY_STACK(pco_iut, attr, stack);
+
+    free(offs);
+    te_string_free(&table);
+
+    TEST_END;
+}
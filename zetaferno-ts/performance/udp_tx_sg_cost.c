@@ -0,0 +1,229 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-udp_tx_sg_cost Cost of scatter-gather UDP send
+ *
+ * @objective Measure per-datagram cost and achieved packet rate of
+ *            @b zfut_send() with a datagram of fixed size split into
+ *            a varying number of vectors, and compare it with
+ *            @b zfut_send_single() and with copying the vectors to
+ *            a contiguous buffer before sending it, including datagram
+ *            sizes around @b zfut_get_mss().
+ *
+ * @param env           Testing environment:
+ *                      - @ref arg_types_env_peer2peer
+ * @param sizes         Comma-separated list of datagram sizes.
+ * @param mss_offsets   Comma-separated list of offsets added to the
+ *                      value returned by @b zfut_get_mss() to get more
+ *                      datagram sizes.
+ * @param iovcnts       Comma-separated list of numbers of vectors.
+ * @param duration      Duration of every measurement, seconds.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME  "performance/udp_tx_sg_cost"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+
+/**
+ * Run a measurement and report its results.
+ *
+ * @param pco_iut       IUT RPC server.
+ * @param stack         ZF stack.
+ * @param utx           UDP TX zocket.
+ * @param mode          How a datagram is passed to a send call.
+ * @param size          Size of every datagram.
+ * @param iovcnt        Number of vectors.
+ * @param mss           Value returned by @b zfut_get_mss().
+ * @param duration      Duration of the measurement, seconds.
+ * @param table         Summary table to append a row to.
+ */
+static void
+measure(rcf_rpc_server *pco_iut, rpc_zf_stack_p stack, rpc_zfut_p utx,
+        zfts_sg_mode mode, int size, int iovcnt, int mss, int duration,
+        te_string *table)
+{
+    tarpc_zfts_zfut_sg_stats stats;
+    te_mi_logger            *logger;
+    double                   pps;
+    double                   dgram_ns;
+    double                   send_ns;
+
+    rpc_zfts_zfut_sg_bench(pco_iut, stack, utx, mode, size, iovcnt,
+                           TE_SEC2MS(duration), &stats);
+    if (stats.sent == 0)
+    {
+        TEST_VERDICT("Nothing was sent in %s mode with %d-byte datagrams",
+                     zfts_sg_mode2str(mode), size);
+    }
+
+    pps = (double)stats.sent * 1000000000 / stats.elapsed;
+    dgram_ns = (double)(stats.send_ns + stats.copy_ns) / stats.sent;
+    send_ns = (double)stats.send_ns / stats.sends;
+
+    CHECK_RC(te_mi_logger_meas_create("zf_udp_tx_sg_cost", &logger));
+
+    te_mi_logger_add_meas_key(logger, NULL, "mode", "%s",
+                              zfts_sg_mode2str(mode));
+    te_mi_logger_add_meas_key(logger, NULL, "dgram_size", "%d", size);
+    te_mi_logger_add_meas_key(logger, NULL, "iovcnt", "%d", iovcnt);
+
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_PPS, "sent",
+                          TE_MI_MEAS_AGGR_MEAN, pps,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "datagram",
+                          TE_MI_MEAS_AGGR_MEAN, dgram_ns,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY, "send call",
+                          TE_MI_MEAS_AGGR_MEAN, send_ns,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+
+    te_mi_logger_add_comment(logger, NULL, "mss", "%d", mss);
+    te_mi_logger_add_comment(logger, NULL, "copy_ns_per_datagram", "%.1f",
+                             (double)stats.copy_ns / stats.sent);
+    te_mi_logger_add_comment(logger, NULL, "send_again", "%llu",
+                             (unsigned long long)stats.again);
+
+    te_mi_logger_destroy(logger);
+
+    CHECK_RC(te_string_append(table, "%10s %6d %6d %12.0f %10.1f %10.1f\n",
+                              zfts_sg_mode2str(mode), size, iovcnt, pps,
+                              dgram_ns, send_ns));
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server        *pco_iut = NULL;
+    rcf_rpc_server        *pco_tst = NULL;
+    const struct sockaddr *iut_addr = NULL;
+    const struct sockaddr *tst_addr = NULL;
+
+    const char *sizes;
+    const char *mss_offsets;
+    const char *iovcnts;
+    int         duration;
+
+    rpc_zf_attr_p   attr = RPC_NULL;
+    rpc_zf_stack_p  stack = RPC_NULL;
+    rpc_zfut_p      utx = RPC_NULL;
+    int             tst_s = -1;
+    int             mss;
+
+    int        *size_vals = NULL;
+    int         sizes_num;
+    int        *off_vals = NULL;
+    int         offs_num;
+    int        *iov_vals = NULL;
+    int         iovs_num;
+    int         size;
+    int         i;
+    int         j;
+
+    te_string table = TE_STRING_INIT;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+    TEST_GET_ADDR(pco_tst, tst_addr);
+    TEST_GET_STRING_PARAM(sizes);
+    TEST_GET_STRING_PARAM(mss_offsets);
+    TEST_GET_STRING_PARAM(iovcnts);
+    TEST_GET_INT_PARAM(duration);
+
+    CHECK_RC(zfts_perf_parse_int_list(sizes, &size_vals, &sizes_num));
+    CHECK_RC(zfts_perf_parse_int_list(mss_offsets, &off_vals, &offs_num));
+    CHECK_RC(zfts_perf_parse_int_list(iovcnts, &iov_vals, &iovs_num));
+
+    CHECK_RC(te_string_append(&table, "%10s %6s %6s %12s %10s %10s\n",
+                              "mode", "size", "iovcnt", "pps",
+                              "ns/dgram", "send ns"));
+
+    TEST_STEP("Allocate ZF stack and UDP TX zocket sending from "
+              "@p iut_addr to @p tst_addr; bind UDP socket on Tester to "
+              "@p tst_addr so that datagrams are accepted.");
+    rpc_zf_init(pco_iut);
+    rpc_zf_attr_alloc(pco_iut, &attr);
+    rpc_zf_stack_alloc(pco_iut, attr, &stack);
+    rpc_zfut_alloc(pco_iut, &utx, stack, iut_addr, tst_addr, 0, attr);
+
+    tst_s = rpc_socket(pco_tst, rpc_socket_domain_by_addr(tst_addr),
+                       RPC_SOCK_DGRAM, RPC_PROTO_DEF);
+    rpc_bind(pco_tst, tst_s, tst_addr);
+
+    TEST_STEP("Get MSS with @b zfut_get_mss().");
+    mss = rpc_zfut_get_mss(pco_iut, utx);
+
+    TEST_STEP("For every datagram size from @p sizes and MSS plus every "
+              "offset from @p mss_offsets:");
+    for (i = 0; i < sizes_num + offs_num; i++)
+    {
+        size = i < sizes_num ? size_vals[i] : mss + off_vals[i - sizes_num];
+        if (size <= 0)
+            continue;
+
+        TEST_SUBSTEP("Send datagrams with @b zfut_send_single() for "
+                     "@p duration if the size does not exceed MSS "
+                     "(it does not support bigger datagrams).");
+        if (size <= mss)
+        {
+            measure(pco_iut, stack, utx, ZFTS_SG_SINGLE, size, 1, mss,
+                    duration, &table);
+        }
+        else
+        {
+            CHECK_RC(te_string_append(&table, "%10s %6d %6d %12s\n",
+                                      "single", size, 1, "n/a"));
+        }
+
+        TEST_SUBSTEP("For every number of vectors in @p iovcnts not "
+                     "greater than the size, send datagrams with "
+                     "@b zfut_send() passing the vectors for @p duration; "
+                     "if there is more than one vector, also send "
+                     "datagrams copying the vectors to a contiguous "
+                     "buffer first.");
+        for (j = 0; j < iovs_num; j++)
+        {
+            if (iov_vals[j] <= 0 || iov_vals[j] > size)
+                continue;
+
+            measure(pco_iut, stack, utx, ZFTS_SG_IOV, size, iov_vals[j],
+                    mss, duration, &table);
+            if (iov_vals[j] > 1)
+            {
+                measure(pco_iut, stack, utx, ZFTS_SG_LINEARISE, size,
+                        iov_vals[j], mss, duration, &table);
+            }
+        }
+    }
+
+    TEST_STEP("Log the summary table.");
+    RING("Scatter-gather send cost, MSS %d:\n%s", mss, table.ptr);
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    CLEANUP_RPC_CLOSE(pco_tst, tst_s);
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zfut, utx);
+    CLEANUP_RPC_ZFTS_DESTROY_STACK(pco_iut, attr, stack);
+
+    free(size_vals);
+    free(off_vals);
+    free(iov_vals);
+    te_string_free(&table);
+
+    TEST_END;
+}
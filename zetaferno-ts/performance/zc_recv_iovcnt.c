@@ -0,0 +1,239 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2016 - 2022 Xilinx, Inc. All rights reserved. */
+/*
+ * Zetaferno Direct API Test Suite
+ * Zetaferno performance tests
+ */
+
+/**
+ * @page performance-zc_recv_iovcnt Zero-copy receive cost depending on iovcnt
+ *
+ * @objective Measure how many bytes are received per reactor call and
+ *            how much receive calls and @b zc_recv_done calls cost when
+ *            a saturated zocket is drained with zero-copy receive at
+ *            various @b iovcnt values, compared with copying data to
+ *            user buffers.
+ *
+ * @param env         Testing environment:
+ *                    - @ref arg_types_env_peer2peer
+ * @param udp         If @c TRUE, use UDP RX zocket, otherwise TCP zocket.
+ * @param iovcnts     Comma-separated list of @b iovcnt values (up to
+ *                    @c 64).
+ * @param pkt_size    Size of data sent by Tester in a single call.
+ * @param duration    Duration of every measurement, seconds.
+ *
+ * @type Performance.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME  "performance/zc_recv_iovcnt"
+
+#include "zf_test.h"
+#include "rpc_zf.h"
+#include "performance_lib.h"
+#include "te_mi_log.h"
+
+/** How long to read the rest of TCP data after flooding, milliseconds */
+#define DRAIN_TIME 500
+
+/**
+ * Report results of a measurement in a MI artifact.
+ *
+ * @param udp       Whether UDP zocket was used.
+ * @param copy      Whether data was copied.
+ * @param iovcnt    Number of vectors.
+ * @param stats     Statistics.
+ */
+static void
+report_recv(te_bool udp, te_bool copy, int iovcnt,
+            const tarpc_zfts_recv_bench_stats *stats)
+{
+    te_mi_logger *logger;
+
+    CHECK_RC(te_mi_logger_meas_create("zf_zc_recv", &logger));
+
+    te_mi_logger_add_meas_key(logger, NULL, "zocket", "%s",
+                              udp ? "zfur" : "zft");
+    te_mi_logger_add_meas_key(logger, NULL, "mode", "%s",
+                              copy ? "copy" : "zero-copy");
+    te_mi_logger_add_meas_key(logger, NULL, "iovcnt", "%d", iovcnt);
+
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_THROUGHPUT,
+                          "received", TE_MI_MEAS_AGGR_MEAN,
+                          (double)stats->bytes * 8 * 1000 /
+                          stats->elapsed, TE_MI_MEAS_MULTIPLIER_MEGA);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "reactor call", TE_MI_MEAS_AGGR_MEAN,
+                          (double)stats->reactor_ns / stats->reactor_calls,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                          "receive call", TE_MI_MEAS_AGGR_MEAN,
+                          (double)stats->recv_ns / stats->recv_calls,
+                          TE_MI_MEAS_MULTIPLIER_NANO);
+    if (stats->done_calls > 0)
+    {
+        te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_LATENCY,
+                              "zc_recv_done call", TE_MI_MEAS_AGGR_MEAN,
+                              (double)stats->done_ns / stats->done_calls,
+                              TE_MI_MEAS_MULTIPLIER_NANO);
+    }
+
+    te_mi_logger_add_comment(logger, NULL, "bytes_per_reactor_call",
+                             "%.1f", (double)stats->bytes /
+                             stats->reactor_calls);
+    te_mi_logger_add_comment(logger, NULL, "bufs_per_recv_call", "%.2f",
+                             (double)stats->bufs /
+                             (stats->recv_calls - stats->empty_calls));
+    te_mi_logger_add_comment(logger, NULL, "empty_recv_calls", "%llu",
+                             (unsigned long long)stats->empty_calls);
+
+    te_mi_logger_destroy(logger);
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server *pco_iut = NULL;
+    rcf_rpc_server *pco_tst = NULL;
+    const struct sockaddr *iut_addr = NULL;
+    const struct sockaddr *tst_addr = NULL;
+
+    te_bool udp;
+    const char *iovcnts;
+    int pkt_size;
+    int duration;
+
+    rpc_zf_attr_p attr = RPC_NULL;
+    rpc_zf_stack_p stack = RPC_NULL;
+    rpc_zfur_p iut_zfur = RPC_NULL;
+    rpc_zft_p iut_zft = RPC_NULL;
+    rpc_ptr iut_z;
+    int tst_s = -1;
+
+    int *iovs = NULL;
+    int iovs_num;
+    int i;
+    int mode;
+    te_bool copy;
+    uint64_t tst_sent;
+
+    tarpc_zfts_recv_bench_stats stats;
+    tarpc_zfts_recv_bench_stats drain_stats;
+    te_string table = TE_STRING_INIT;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_PCO(pco_tst);
+    TEST_GET_ADDR(pco_iut, iut_addr);
+    TEST_GET_ADDR(pco_tst, tst_addr);
+    TEST_GET_BOOL_PARAM(udp);
+    TEST_GET_STRING_PARAM(iovcnts);
+    TEST_GET_INT_PARAM(pkt_size);
+    TEST_GET_INT_PARAM(duration);
+
+    CHECK_RC(zfts_perf_parse_int_list(iovcnts, &iovs, &iovs_num));
+
+    CHECK_RC(te_string_append(&table, "%9s %6s %12s %10s %10s %10s\n",
+                              "mode", "iovcnt", "B/reactor", "recv ns",
+                              "done ns", "Mbps"));
+
+    TEST_STEP("Allocate ZF stack.");
+    rpc_zf_init(pco_iut);
+    rpc_zf_attr_alloc(pco_iut, &attr);
+    rpc_zf_stack_alloc(pco_iut, attr, &stack);
+
+    if (udp)
+    {
+        TEST_STEP("If @p udp is @c TRUE, create UDP RX zocket bound to "
+                  "@p iut_addr and UDP socket on Tester connected to it.");
+        rpc_zfur_alloc(pco_iut, &iut_zfur, stack, attr);
+        rpc_zfur_addr_bind(pco_iut, iut_zfur, SA(iut_addr), tst_addr, 0);
+        iut_z = iut_zfur;
+
+        tst_s = rpc_socket(pco_tst, rpc_socket_domain_by_addr(tst_addr),
+                           RPC_SOCK_DGRAM, RPC_PROTO_DEF);
+        rpc_bind(pco_tst, tst_s, tst_addr);
+        rpc_connect(pco_tst, tst_s, iut_addr);
+    }
+    else
+    {
+        TEST_STEP("If @p udp is @c FALSE, establish TCP connection "
+                  "between a zocket on IUT and a socket on Tester.");
+        zfts_establish_tcp_conn(TRUE, pco_iut, attr, stack, &iut_zft,
+                                iut_addr, pco_tst, &tst_s, tst_addr);
+        iut_z = iut_zft;
+    }
+
+    TEST_STEP("For every value in @p iovcnts, first with zero-copy "
+              "receive and then with copying to user buffers:");
+    for (i = 0; i < iovs_num; i++)
+    {
+        for (mode = 0; mode < 2; mode++)
+        {
+            copy = (mode == 1);
+
+            TEST_SUBSTEP("Flood the zocket from Tester with @p pkt_size "
+                         "writes and drain it on IUT for @p duration "
+                         "with an agent-side loop.");
+            pco_tst->op = RCF_RPC_CALL;
+            rpc_iomux_flooder(pco_tst, &tst_s, 1, NULL, 0, pkt_size,
+                              duration + 1, 0, FUNC_DEFAULT_IOMUX,
+                              &tst_sent, NULL);
+
+            rpc_zfts_recv_bench(pco_iut, stack, iut_z, copy, iovs[i],
+                                TE_SEC2MS(duration), &stats);
+
+            pco_tst->op = RCF_RPC_WAIT;
+            rpc_iomux_flooder(pco_tst, &tst_s, 1, NULL, 0, pkt_size,
+                              duration + 1, 0, FUNC_DEFAULT_IOMUX,
+                              &tst_sent, NULL);
+
+            if (!udp)
+            {
+                TEST_SUBSTEP("For TCP read the rest of data so that "
+                             "the next measurement starts with the "
+                             "same state.");
+                rpc_zfts_recv_bench(pco_iut, stack, iut_z, FALSE,
+                                    iovs[i], DRAIN_TIME, &drain_stats);
+            }
+
+            if (stats.bytes == 0 || stats.recv_calls == stats.empty_calls)
+            {
+                TEST_VERDICT("No data was received with %s and "
+                             "iovcnt %d", copy ? "copy" : "zero-copy",
+                             iovs[i]);
+            }
+
+            TEST_SUBSTEP("Report bytes per reactor call, average cost of "
+                         "receive and zc_recv_done calls.");
+            report_recv(udp, copy, iovs[i], &stats);
+            CHECK_RC(te_string_append(
+                         &table, "%9s %6d %12.1f %10.1f %10.1f %10.1f\n",
+                         copy ? "copy" : "zero-copy", iovs[i],
+                         (double)stats.bytes / stats.reactor_calls,
+                         (double)stats.recv_ns / stats.recv_calls,
+                         stats.done_calls == 0 ? 0.0 :
+                            (double)stats.done_ns / stats.done_calls,
+                         (double)stats.bytes * 8 * 1000 / stats.elapsed));
+        }
+    }
+
+    TEST_STEP("Log the summary table.");
+    RING("%s receive cost depending on iovcnt:\n%s",
+         udp ? "UDP" : "TCP", table.ptr);
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    CLEANUP_RPC_CLOSE(pco_tst, tst_s);
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zfur, iut_zfur);
+    CLEANUP_RPC_ZFTS_FREE(pco_iut, zft, iut_zft);
+    CLEANUP_RPC_ZFTS_DESTROY_STACK(pco_iut, attr, stack);
+
+    free(iovs);
+    te_string_free(&table);
+
+    TEST_END;
+}
@@ -111,7 +111,7 @@ main(int argc, char *argv[])
 
     do {
         data_len = rand_range(1, ZFTS_TCP_DATA_MAX);
-        te_fill_buf(data, data_len);
+        zfts_tcp_verifier_fill(&conns[1].tst_verif, data, data_len);
         RPC_AWAIT_IUT_ERROR(pco_tst);
         rc = rpc_send(pco_tst, conns[1].tst_s,
                       data, data_len, RPC_MSG_DONTWAIT);
@@ -125,7 +125,7 @@ main(int argc, char *argv[])
                              "buffer", RPC_ERRNO(pco_tst));
         }
 
-        te_dbuf_append(&conns[1].tst_sent, data, rc);
+        zfts_tcp_verifier_sent(&conns[1].tst_verif, rc);
 
         RPC_AWAIT_ERROR(pco_iut);
         rc = rpc_zf_process_events(pco_iut, stack);
@@ -138,7 +138,7 @@ main(int argc, char *argv[])
 
     do {
         data_len = rand_range(1, ZFTS_TCP_DATA_MAX);
-        te_fill_buf(data, data_len);
+        zfts_tcp_verifier_fill(&conns[1].iut_verif, data, data_len);
 
         sndiov2.iov_base = data;
         sndiov2.iov_len = sndiov2.iov_rlen = data_len;
@@ -159,7 +159,7 @@ main(int argc, char *argv[])
 
             break;
         }
-        te_dbuf_append(&conns[1].iut_sent, data, rc);
+        zfts_tcp_verifier_sent(&conns[1].iut_verif, rc);
     } while (TRUE);
 
     /*- Completely read all data on the second connection. */
@@ -29,8 +29,6 @@
 #include "zf_test.h"
 #include "rpc_zf.h"
 
-#include "te_dbuf.h"
-
 /** Maximum number of bytes to send at once. */
 #define MAX_DATA_SIZE 4000
 
@@ -56,8 +54,8 @@ main(int argc, char *argv[])
     size_t  pkt_len;
     int     i;
 
-    te_dbuf recv_data = TE_DBUF_INIT(0);
-    te_bool recv_failed;
+    zfts_tcp_verifier tst_verif;
+    te_bool           recv_failed;
 
     zfts_conn_open_method open_method;
 
@@ -83,13 +81,13 @@ main(int argc, char *argv[])
      * send all data at once. */
     rpc_setsockopt_int(pco_tst, tst_s, RPC_TCP_NODELAY, 1);
 
+    zfts_tcp_verifier_init(&tst_verif, rand());
+
     /*- In a loop @c LOOP_ITERS times: */
     for (i = 0; i < LOOP_ITERS; i++)
     {
         RING("Iteration %d", i + 1);
 
-        te_fill_buf(send_buf, MAX_DATA_SIZE);
-
         /*-- Block in @p rpc_zf_wait_for_event waiting for
          * the incoming event. */
         pco_iut->op = RCF_RPC_CALL;
@@ -98,7 +96,9 @@ main(int argc, char *argv[])
         /*-- Send data from Tester, use random
          * data length [1; @c MAX_DATA_SIZE]. */
         pkt_len = rand_range(1, MAX_DATA_SIZE);
+        zfts_tcp_verifier_fill(&tst_verif, send_buf, pkt_len);
         rpc_send(pco_tst, tst_s, send_buf, pkt_len, 0);
+        zfts_tcp_verifier_sent(&tst_verif, pkt_len);
 
         /*-- Get an event on ZF reactor. */
         RPC_AWAIT_ERROR(pco_iut);
@@ -108,20 +108,18 @@ main(int argc, char *argv[])
                          RPC_ERRNO(pco_iut));
 
         /*-- Read and check the data. */
-
-        te_dbuf_free(&recv_data);
-
         recv_failed = FALSE;
         do {
             RPC_AWAIT_ERROR(pco_iut);
-            rc = zfts_zft_recv_dbuf(pco_iut, iut_zft, &recv_data);
+            rc = zfts_zft_recv_verify(pco_iut, iut_zft, &tst_verif);
             if (rc <= 0)
             {
                 if (rc < 0 && RPC_ERRNO(pco_iut) != RPC_EAGAIN)
                     TEST_VERDICT("Receive function failed with unexpected "
                                  "errno %r", RPC_ERRNO(pco_iut));
 
-                if (recv_failed || recv_data.len >= pkt_len)
+                if (recv_failed ||
+                    zfts_tcp_verifier_pending(&tst_verif) == 0)
                 {
                     break;
                 }
@@ -139,16 +137,13 @@ main(int argc, char *argv[])
             rpc_zf_process_events(pco_iut, stack);
         } while (TRUE);
 
-        ZFTS_CHECK_RECEIVED_DATA(recv_data.ptr, send_buf,
-                                 recv_data.len, pkt_len,
-                                 " from IUT");
+        ZFTS_TCP_VERIFIER_CHECK(&tst_verif, " from IUT");
     }
 
     TEST_SUCCESS;
 
 cleanup:
 
-    te_dbuf_free(&recv_data);
     CLEANUP_RPC_ZFTS_FREE(pco_iut, zftl, iut_zftl);
     CLEANUP_RPC_ZFTS_FREE(pco_iut, zft, iut_zft);
     CLEANUP_RPC_ZFTS_DESTROY_STACK(pco_iut, attr, stack);
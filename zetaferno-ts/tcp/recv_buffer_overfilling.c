@@ -124,7 +124,6 @@ main(int argc, char *argv[])
     RING("Overfilling tester tx buffers");
     do {
         data_len = rand_range(1, max_len);
-        te_fill_buf(data, data_len);
 
         /*
          * If @p gradual is @c TRUE, each time we try to select the next
@@ -146,6 +145,7 @@ main(int argc, char *argv[])
 
         next_i = (i + 1) % zft_num;
 
+        zfts_tcp_verifier_fill(&conns[i].tst_verif, data, data_len);
         RPC_AWAIT_IUT_ERROR(pco_tst);
         pco_tst->silent_pass = TRUE;
         rc = rpc_send(pco_tst, conns[i].tst_s, data, data_len, 0);
@@ -159,7 +159,7 @@ main(int argc, char *argv[])
         }
         else
         {
-            te_dbuf_append(&conns[i].tst_sent, data, rc);
+            zfts_tcp_verifier_sent(&conns[i].tst_verif, rc);
         }
 
         RPC_AWAIT_ERROR(pco_iut);
@@ -176,7 +176,7 @@ main(int argc, char *argv[])
         RING("Sending data from IUT through %d connection", i + 1);
 
         data_len = rand_range(1, max_len);
-        te_fill_buf(data, data_len);
+        zfts_tcp_verifier_fill(&conns[i].iut_verif, data, data_len);
 
         sndiov.iov_base = data;
         sndiov.iov_len = sndiov.iov_rlen = data_len;
@@ -186,7 +186,7 @@ main(int argc, char *argv[])
         if (rc < 0)
             TEST_VERDICT("zft_send() failed with errno %r",
                          RPC_ERRNO(pco_iut));
-        te_dbuf_append(&conns[i].iut_sent, data, rc);
+        zfts_tcp_verifier_sent(&conns[i].iut_verif, rc);
     }
     rpc_zf_process_events(pco_iut, stack);
 
@@ -108,7 +108,7 @@ sender2str(zfts_tcp_sender_rpcs sender)
  * @param pco_iut     IUT RPC server.
  * @param pco_tst     TESTER RPC server.
  * @param send_from   From which peer to send data.
- * @param data        Data to send.
+ * @param data        Buffer for data to send.
  * @param data_len    Length of data.
  * @param silent      Disable RPC logging.
  */
@@ -134,6 +134,7 @@ tcp_conn_send(zfts_tcp_conn *conn,
     {
         rpc_iovec sndiov;
 
+        zfts_tcp_verifier_fill(&conn->iut_verif, data, data_len);
         sndiov.iov_base = data;
         sndiov.iov_len = sndiov.iov_rlen = data_len;
 
@@ -143,10 +144,11 @@ tcp_conn_send(zfts_tcp_conn *conn,
         if (rc < 0)
             TEST_VERDICT("zft_send() failed with errno %r",
                          RPC_ERRNO(pco_iut));
-        te_dbuf_append(&conn->iut_sent, data, rc);
+        zfts_tcp_verifier_sent(&conn->iut_verif, rc);
     }
     else
     {
+        zfts_tcp_verifier_fill(&conn->tst_verif, data, data_len);
         RPC_AWAIT_ERROR(pco_tst);
         pco_tst->silent_pass = silent;
         rc = rpc_send(pco_tst, conn->tst_s, data, data_len, 0);
@@ -156,7 +158,7 @@ tcp_conn_send(zfts_tcp_conn *conn,
             TEST_FAIL("send() returned %d instead of %d",
                       rc, (int)data_len);
 
-        te_dbuf_append(&conn->tst_sent, data, data_len);
+        zfts_tcp_verifier_sent(&conn->tst_verif, data_len);
     }
 }
 
@@ -169,15 +171,14 @@ tcp_conn_send(zfts_tcp_conn *conn,
  * @param pco_iut     IUT RPC server.
  * @param pco_tst     TESTER RPC server.
  * @param sender      Whether data was sent from IUT or from TESTER.
- * @param sent_buf    Data which was sent, to be compared with that
- *                    which was received.
+ * @param verif       Verifier of data sent by @p sender.
  */
 static void
 check_receive(zfts_tcp_conn *conn,
               rcf_rpc_server *pco_iut,
               rcf_rpc_server *pco_tst,
               zfts_tcp_sender_rpcs sender,
-              te_dbuf *sent_buf)
+              zfts_tcp_verifier *verif)
 {
     te_dbuf received_buf = TE_DBUF_INIT(0);
 
@@ -188,13 +189,13 @@ check_receive(zfts_tcp_conn *conn,
     }
     else
     {
-        rpc_read_fd2te_dbuf(pco_tst, conn->tst_s, 0, sent_buf->len,
+        rpc_read_fd2te_dbuf(pco_tst, conn->tst_s, 0,
+                            zfts_tcp_verifier_pending(verif),
                             &received_buf);
     }
 
-    ZFTS_CHECK_RECEIVED_DATA(received_buf.ptr, sent_buf->ptr,
-                             received_buf.len, sent_buf->len,
-                             " from %s", sender2str(sender));
+    zfts_tcp_verifier_check(verif, received_buf.ptr, received_buf.len);
+    ZFTS_TCP_VERIFIER_CHECK(verif, " from %s", sender2str(sender));
 
     te_dbuf_free(&received_buf);
 }
@@ -213,15 +214,15 @@ tcp_conn_receive(zfts_tcp_conn *conn,
                  rcf_rpc_server *pco_iut,
                  rcf_rpc_server *pco_tst)
 {
-    if (conn->iut_sent.len > 0)
+    if (zfts_tcp_verifier_pending(&conn->iut_verif) > 0)
         check_receive(conn, pco_iut, pco_tst,
                       ZFTS_TCP_SENDER_IUT,
-                      &conn->iut_sent);
+                      &conn->iut_verif);
 
-    if (conn->tst_sent.len > 0)
+    if (zfts_tcp_verifier_pending(&conn->tst_verif) > 0)
         check_receive(conn, pco_iut, pco_tst,
                       ZFTS_TCP_SENDER_TESTER,
-                      &conn->tst_sent);
+                      &conn->tst_verif);
 }
 
 int
@@ -306,13 +307,15 @@ main(int argc, char *argv[])
             char   *data;
             size_t  data_len;
 
-            data = te_make_buf(data_size_min, data_size_max, &data_len);
+            data_len = rand_range(data_size_min, data_size_max);
+            data = tapi_malloc(data_len);
 
             l = 0;
             while (TRUE)
             {
                 i = rand_range(0, zft_num - 1);
-                if (conns[i].iut_sent.len + conns[i].tst_sent.len <=
+                if (zfts_tcp_verifier_pending(&conns[i].iut_verif) +
+                    zfts_tcp_verifier_pending(&conns[i].tst_verif) <=
                     MAX_BYTES_PER_CONN - data_len)
                     break;
                 l++;
@@ -334,12 +337,7 @@ main(int argc, char *argv[])
         ZFTS_WAIT_NETWORK(pco_iut, stack);
 
         for (i = 0; i < zft_num; i++)
-        {
             tcp_conn_receive(&conns[i], pco_iut, pco_tst);
-
-            te_dbuf_reset(&conns[i].iut_sent);
-            te_dbuf_reset(&conns[i].tst_sent);
-        }
     }
 
     TEST_SUCCESS;
@@ -73,11 +73,11 @@ main(int argc, char *argv[])
     char      recv_buf[MAX_CHUNK_LEN];
     int       send_len;
     int       iut_chunk_len;
-    te_dbuf   tst_sent = TE_DBUF_INIT(0);
-    te_dbuf   iut_received = TE_DBUF_INIT(0);
     te_dbuf   aux_dbuf = TE_DBUF_INIT(0);
     int       i;
 
+    zfts_tcp_verifier tst_verif;
+
     rpc_iovec     iovs[ZFTS_IOVCNT];
     rpc_zft_msg   msg;
 
@@ -108,6 +108,8 @@ main(int argc, char *argv[])
      * send all data at once. */
     rpc_setsockopt_int(pco_tst, tst_s, RPC_TCP_NODELAY, 1);
 
+    zfts_tcp_verifier_init(&tst_verif, rand());
+
     /*- In a loop @c LOOP_ITERS times: */
     for (i = 0; i < LOOP_ITERS; i++)
     {
@@ -118,9 +120,9 @@ main(int argc, char *argv[])
        /*-- Send some data from Tester, random volume
         * [@c MIN_TST_SEND; @c MAX_TST_SEND] on each iteration. */
         send_len = rand_range(MIN_TST_SEND, MAX_TST_SEND);
-        te_fill_buf(tst_send_buf, send_len);
+        zfts_tcp_verifier_fill(&tst_verif, tst_send_buf, send_len);
         rpc_send(pco_tst, tst_s, tst_send_buf, send_len, 0);
-        te_dbuf_append(&tst_sent, tst_send_buf, send_len);
+        zfts_tcp_verifier_sent(&tst_verif, send_len);
 
         /*-- Wait for @b rpc_zf_wait_for_event() termination on IUT,
          * process events. */
@@ -181,7 +183,10 @@ main(int argc, char *argv[])
                 }
                 else
                 {
-                    rpc_iov_append2dbuf(iovs, msg.iovcnt, &iut_received);
+                    zfts_tcp_verifier_check(
+                            &tst_verif,
+                            rpc_iov2dbuf(iovs, msg.iovcnt, &aux_dbuf),
+                            total_recv_len);
                     rpc_zft_zc_recv_done(pco_iut, iut_zft, &msg);
                     rpc_zf_process_events(pco_iut, stack);
                 }
@@ -194,9 +199,10 @@ main(int argc, char *argv[])
              * chunk length, copy chunk data and call
              * @b zft_zc_recv_done_some() with selected chunk length.
              */
-            memcpy(recv_buf, rpc_iov2dbuf(iovs, msg.iovcnt, &aux_dbuf),
-                   iut_chunk_len);
-            te_dbuf_append(&iut_received, recv_buf, iut_chunk_len);
+            zfts_tcp_verifier_check(&tst_verif,
+                                    rpc_iov2dbuf(iovs, msg.iovcnt,
+                                                 &aux_dbuf),
+                                    iut_chunk_len);
             RPC_AWAIT_ERROR(pco_iut);
             rc = rpc_zft_zc_recv_done_some(pco_iut, iut_zft,
                                            &msg, iut_chunk_len);
@@ -243,7 +249,9 @@ main(int argc, char *argv[])
         if (msg.iovcnt <= 0)
             break;
 
-        rpc_iov_append2dbuf(iovs, msg.iovcnt, &iut_received);
+        zfts_tcp_verifier_check(&tst_verif,
+                                rpc_iov2dbuf(iovs, msg.iovcnt, &aux_dbuf),
+                                rpc_iov_data_len(iovs, msg.iovcnt));
         rpc_zft_zc_recv_done(pco_iut, iut_zft, &msg);
         rpc_zf_process_events(pco_iut, stack);
 
@@ -251,17 +259,13 @@ main(int argc, char *argv[])
     }
 
     /*- Check all read data. */
-    ZFTS_CHECK_RECEIVED_DATA(iut_received.ptr, tst_sent.ptr,
-                             iut_received.len, tst_sent.len,
-                             " from Tester");
+    ZFTS_TCP_VERIFIER_CHECK(&tst_verif, " from Tester");
 
     TEST_SUCCESS;
 
 cleanup:
 
     te_dbuf_free(&aux_dbuf);
-    te_dbuf_free(&tst_sent);
-    te_dbuf_free(&iut_received);
 
     CLEANUP_RPC_ZFTS_FREE(pco_iut, zftl, iut_zftl);
     CLEANUP_RPC_ZFTS_FREE(pco_iut, zft, iut_zft);
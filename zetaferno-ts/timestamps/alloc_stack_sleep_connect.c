@@ -57,6 +57,7 @@ main(int argc, char *argv[])
     rpc_zf_attr_p attr = RPC_NULL;
     rpc_zf_stack_p stack = RPC_NULL;
     rpc_zft_p iut_zft = RPC_NULL;
+    rpc_zfts_tx_ts_coll_p coll = RPC_NULL;
     rpc_zftl_p iut_zftl = RPC_NULL;
     int tst_s = -1;
 
@@ -113,6 +114,13 @@ main(int argc, char *argv[])
               "zocket.");
     ts_tx_muxer_configure(pco_iut, stack, iut_zft, &muxer_set, &waitable);
 
+    TEST_STEP("Start on-demand collector of TX packet reports for "
+              "the IUT zocket, it is used to call "
+              "@b zft_get_tx_timestamps() on the agent.");
+    rpc_zfts_tx_ts_collector_start(pco_iut, stack, iut_zft,
+                                   TS_TX_COLLECTOR_RING_SIZE, TRUE,
+                                   &coll);
+
     TEST_STEP("Check that @c EPOLLERR is reported now because "
               "TX timestamp is available for SYN packet.");
     ts_tx_muxer_check(pco_iut, muxer_set, iut_zft, 0, RPC_EPOLLERR,
@@ -138,7 +146,7 @@ main(int argc, char *argv[])
 
     TEST_STEP("Obtain all the TX timestamp reports with "
               "@b zft_get_tx_timestamps().");
-    ts_get_tx_reports(pco_iut, iut_zft, &reports,
+    ts_get_tx_reports(pco_iut, coll, &reports,
                       MAX_REPORTS, MAX_REPORTS, FALSE);
     if (te_vec_size(&reports) == 0)
         TEST_VERDICT("No timestamp reports was received");
@@ -191,6 +199,7 @@ cleanup:
 
     CLEANUP_RPC_CLOSE(pco_tst, tst_s);
 
+    CLEANUP_TS_TX_COLLECTOR_STOP(pco_iut, coll);
     CLEANUP_RPC_ZFTS_FREE(pco_iut, zft, iut_zft);
     CLEANUP_RPC_ZFTS_FREE(pco_iut, zftl, iut_zftl);
     ZFTS_FREE(pco_iut, zf_muxer, muxer_set);
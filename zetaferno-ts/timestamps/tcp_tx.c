@@ -104,6 +104,7 @@ main(int argc, char *argv[])
     rpc_zf_attr_p attr = RPC_NULL;
     rpc_zf_stack_p stack = RPC_NULL;
     rpc_zft_p iut_zft = RPC_NULL;
+    rpc_zfts_tx_ts_coll_p coll = RPC_NULL;
     rpc_zftl_p iut_zftl = RPC_NULL;
     int tst_s = -1;
 
@@ -182,7 +183,7 @@ main(int argc, char *argv[])
 
     CHECK_RC(tapi_tad_trrecv_start(pco_tst->ta, 0, csap,
                                    NULL, TAD_TIMEOUT_INF, 0,
-                                   RCF_TRRECV_PACKETS));
+                                   RCF_TRRECV_PACKETS_NO_PAYLOAD));
 
     SLEEP(2);
 
@@ -210,6 +211,13 @@ main(int argc, char *argv[])
               "zocket.");
     ts_tx_muxer_configure(pco_iut, stack, iut_zft, &muxer_set, &waitable);
 
+    TEST_STEP("Start on-demand collector of TX packet reports for "
+              "the IUT zocket, it is used to call "
+              "@b zft_get_tx_timestamps() on the agent.");
+    rpc_zfts_tx_ts_collector_start(pco_iut, stack, iut_zft,
+                                   TS_TX_COLLECTOR_RING_SIZE, TRUE,
+                                   &coll);
+
     TEST_STEP("Check that @c EPOLLERR is reported now because "
               "TX timestamp is available for SYN packet.");
     ts_tx_muxer_check(pco_iut, muxer_set, iut_zft, 0, RPC_EPOLLERR,
@@ -335,7 +343,7 @@ main(int argc, char *argv[])
 
         if (dropped && !dropped_encountered)
         {
-            ts_get_tx_reports(pco_iut, iut_zft, &all_reports, 1, 1,
+            ts_get_tx_reports(pco_iut, coll, &all_reports, 1, 1,
                               TRUE);
 
             reports_num = te_vec_size(&all_reports);
@@ -406,7 +414,7 @@ main(int argc, char *argv[])
               "zero packet reports. Append all retrieved reports to the "
               "same array.");
 
-    ts_get_tx_reports(pco_iut, iut_zft, &all_reports, 1, MAX_REPORTS,
+    ts_get_tx_reports(pco_iut, coll, &all_reports, 1, MAX_REPORTS,
                       FALSE);
 
     if (te_vec_size(&all_reports) == 0)
@@ -427,7 +435,7 @@ main(int argc, char *argv[])
 
     memset(&user_data, 0, sizeof(user_data));
     user_data.reports = &all_reports;
-    user_data.ms_adjust = ts_get_clock_adjustment(pco_iut, pco_tst);
+    user_data.ns_adjust = ts_get_clock_adjustment(pco_iut, pco_tst);
     user_data.msg_more = msg_more;
     user_data.mss = mss;
 
@@ -436,6 +444,8 @@ main(int argc, char *argv[])
     if (pkts_num == 0)
         TEST_VERDICT("CSAP has not captured any packets");
 
+    ts_tcp_tx_process_pkts(&user_data);
+
     if (user_data.failed)
         TEST_STOP;
 
@@ -492,6 +502,7 @@ cleanup:
 
     CLEANUP_RPC_CLOSE(pco_tst, tst_s);
 
+    CLEANUP_TS_TX_COLLECTOR_STOP(pco_iut, coll);
     CLEANUP_RPC_ZFTS_FREE(pco_iut, zft, iut_zft);
     CLEANUP_RPC_ZFTS_FREE(pco_iut, zftl, iut_zftl);
     CLEANUP_RPC_ZFTS_FREE(pco_iut, zf_waitable, waitable);
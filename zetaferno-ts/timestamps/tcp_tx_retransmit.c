@@ -113,6 +113,7 @@ main(int argc, char *argv[])
     rpc_zf_stack_p stack = RPC_NULL;
     rpc_zft_handle_p iut_zft_handle = RPC_NULL;
     rpc_zft_p iut_zft = RPC_NULL;
+    rpc_zfts_tx_ts_coll_p coll = RPC_NULL;
     rpc_zftl_p iut_zftl = RPC_NULL;
     int tst_s = -1;
     int tst_s_listener = -1;
@@ -167,7 +168,7 @@ main(int argc, char *argv[])
 
     CHECK_RC(tapi_tad_trrecv_start(pco_gw->ta, 0, csap,
                                    NULL, TAD_TIMEOUT_INF, 0,
-                                   RCF_TRRECV_PACKETS));
+                                   RCF_TRRECV_PACKETS_NO_PAYLOAD));
     SLEEP(2);
 
     TEST_STEP("Allocate ZF attributes and stack, enabling "
@@ -252,6 +253,13 @@ main(int argc, char *argv[])
               "zocket.");
     ts_tx_muxer_configure(pco_iut, stack, iut_zft, &muxer_set, &waitable);
 
+    TEST_STEP("Start on-demand collector of TX packet reports for "
+              "the IUT zocket, it is used to call "
+              "@b zft_get_tx_timestamps() on the agent.");
+    rpc_zfts_tx_ts_collector_start(pco_iut, stack, iut_zft,
+                                   TS_TX_COLLECTOR_RING_SIZE, TRUE,
+                                   &coll);
+
     TEST_STEP("Check that @c EPOLLERR is reported now because "
               "TX timestamp is available for SYN packet.");
     ts_tx_muxer_check(pco_iut, muxer_set, iut_zft, 0, RPC_EPOLLERR,
@@ -377,7 +385,7 @@ main(int argc, char *argv[])
 
     TEST_STEP("Obtain all the reports about sent packets on IUT zocket "
               "with @b zft_get_tx_timestamps()");
-    ts_get_tx_reports(pco_iut, iut_zft, &all_reports, 1, MAX_REPORTS,
+    ts_get_tx_reports(pco_iut, coll, &all_reports, 1, MAX_REPORTS,
                       FALSE);
 
     memset(&cb_data, 0, sizeof(cb_data));
@@ -386,7 +394,7 @@ main(int argc, char *argv[])
 
     memset(&user_data, 0, sizeof(user_data));
     user_data.reports = &all_reports;
-    user_data.ms_adjust = ts_get_clock_adjustment(pco_iut, pco_gw);
+    user_data.ns_adjust = ts_get_clock_adjustment(pco_iut, pco_gw);
 
     TEST_STEP("Process packets captured by the CSAP and check that "
               "every packet has a matching packet report. Check that "
@@ -398,6 +406,8 @@ main(int argc, char *argv[])
     if (pkts_num == 0)
         TEST_VERDICT("CSAP has not captured any packets");
 
+    ts_tcp_tx_process_pkts(&user_data);
+
     reports_num = te_vec_size(user_data.reports);
     RING("%u packets were captured (not counting empty ACKs), "
          "%u packet reports were obtained",
@@ -456,6 +466,7 @@ cleanup:
     CLEANUP_RPC_CLOSE(pco_tst, tst_s);
     CLEANUP_RPC_CLOSE(pco_tst, tst_s_listener);
 
+    CLEANUP_TS_TX_COLLECTOR_STOP(pco_iut, coll);
     CLEANUP_RPC_ZFTS_FREE(pco_iut, zft, iut_zft);
     CLEANUP_RPC_ZFT_HANDLE_FREE(pco_iut, iut_zft_handle);
     CLEANUP_RPC_ZFTS_FREE(pco_iut, zftl, iut_zftl);
@@ -36,7 +36,7 @@ tx_zocket_is_udp(rcf_rpc_server *rpcs, rpc_ptr z)
 
 /* See description in timestamps.h */
 void
-ts_get_tx_reports(rcf_rpc_server *rpcs, rpc_ptr z,
+ts_get_tx_reports(rcf_rpc_server *rpcs, rpc_zfts_tx_ts_coll_p coll,
                   te_vec *reports_vec,
                   int min_num, int max_num,
                   te_bool single_call)
@@ -45,49 +45,34 @@ ts_get_tx_reports(rcf_rpc_server *rpcs, rpc_ptr z,
     int rc;
     int reports_num;
 
-    te_bool udp;
-    char *func_name;
-
-    udp = tx_zocket_is_udp(rpcs, z);
-    if (udp)
-        func_name = "zfut_get_tx_timestamps";
-    else
-        func_name = "zft_get_tx_timestamps";
+    if (max_num > TS_TX_COLLECTOR_RING_SIZE)
+        TEST_FAIL("%s(): too many reports are requested", __FUNCTION__);
 
-    reports = tapi_calloc(max_num, sizeof(*reports));
+    reports = tapi_calloc(TS_TX_COLLECTOR_RING_SIZE, sizeof(*reports));
 
     while (TRUE)
     {
-        reports_num = rand_range(min_num, max_num);
+        /*
+         * The collector ring is emptied after every call, so it can
+         * always take reports retrieved by the next one.
+         */
         RPC_AWAIT_ERROR(rpcs);
-        if (udp)
-        {
-            rc = rpc_zfut_get_tx_timestamps(rpcs, z, reports,
-                                            &reports_num);
-        }
-        else
-        {
-            rc = rpc_zft_get_tx_timestamps(rpcs, z, reports,
-                                           &reports_num);
-        }
-
+        rc = rpc_zfts_tx_ts_collector_drain(rpcs, coll, min_num, max_num,
+                                            single_call);
         if (rc < 0)
         {
             free(reports);
-            TEST_VERDICT("%s() failed with error " RPC_ERROR_FMT,
-                         func_name, RPC_ERROR_ARGS(rpcs));
-        }
-        else if (reports_num < 0)
-        {
-            free(reports);
-            TEST_VERDICT("%s() returned negative number of reports",
-                         func_name);
+            TEST_VERDICT("Failed to get TX packet reports, error "
+                         RPC_ERROR_FMT, RPC_ERROR_ARGS(rpcs));
         }
-        else if (reports_num == 0)
+        else if (rc == 0)
         {
             break;
         }
 
+        reports_num = rpc_zfts_tx_ts_collector_read(
+                                    rpcs, coll, reports,
+                                    TS_TX_COLLECTOR_RING_SIZE);
         CHECK_RC(te_vec_append_array(reports_vec, reports, reports_num));
 
         if (single_call)
@@ -233,232 +218,405 @@ ts_tcp_tx_csap_cb(asn_value *pkt, void *user_data)
         }                                                       \
     } while (0)
 
-#define CB_ERROR(_args...) \
-    do {                          \
-        ERROR_VERDICT(_args);     \
-        data->failed = TRUE;      \
-        goto cleanup;             \
-    } while (0)
-
     ts_tcp_tx_csap_data *data = (ts_tcp_tx_csap_data *)user_data;
-    tarpc_zf_pkt_report *report;
-    unsigned int exp_flags;
-    uint32_t flags;
-    uint32_t seqn;
+    ts_tcp_tx_pkt descr;
+    asn_value *tcp_pdu;
+    asn_value *ip_pdu;
+    uint32_t tcp_hlen;
+    uint32_t ip_hlen;
+    uint32_t ip_len;
+    uint32_t sec;
+    uint32_t usec;
     unsigned int payload_len;
-    struct timeval tv;
-    int64_t tx_ts_ms;
-    int64_t rx_ts_ms;
-    tarpc_timespec rx_ts;
 
-    CB_CHECK_RC(asn_read_uint32(pkt, &flags, "pdus.0.#tcp.flags"));
-    CB_CHECK_RC(asn_read_uint32(pkt, &seqn, "pdus.0.#tcp.seqn.#plain"));
-    CB_CHECK_RC(tapi_tcp_get_hdrs_payload_len(pkt, NULL, &payload_len));
-    CB_CHECK_RC(tapi_tad_get_pkt_rx_ts(pkt, &tv));
+    if (data->pkts.element_size == 0)
+        data->pkts = (te_vec)TE_VEC_INIT(ts_tcp_tx_pkt);
 
-    rx_ts_ms = TS_TIMEVAL2MS(tv) + data->ms_adjust;
-    rx_ts.tv_sec = rx_ts_ms / 1000LLU;
-    rx_ts.tv_nsec = (rx_ts_ms % 1000LLU) * 1000000LLU;
+    memset(&descr, 0, sizeof(descr));
 
-    RING("Packet with SEQN %u, payload length %u and flags 0x%x was "
-         "captured at " TE_PRINTF_TS_FMT, seqn, payload_len, flags,
-         TE_PRINTF_TS_VAL(rx_ts));
+    /*
+     * Locate TCP and IPv4 PDUs once and read all the required fields
+     * relative to them: this callback is called for every captured
+     * packet, and there may be hundreds of thousands of them. Payload
+     * length is computed from IPv4 and TCP header lengths, so CSAP
+     * may be started without reporting payload. Only TCP/IPv4 CSAPs
+     * are supported for this reason.
+     */
+    CB_CHECK_RC(asn_get_descendent(pkt, &tcp_pdu, "pdus.0.#tcp"));
+    if (asn_get_descendent(pkt, &ip_pdu, "pdus.1.#ip4") != 0)
+    {
+        if (!data->unexp_fail)
+        {
+            ERROR_VERDICT("Captured TCP packet is not IPv4, its payload "
+                          "length cannot be computed");
+        }
+        data->failed = TRUE;
+        data->unexp_fail = TRUE;
+        goto cleanup;
+    }
+
+    CB_CHECK_RC(asn_read_uint32(tcp_pdu, &descr.flags, "flags.#plain"));
+    CB_CHECK_RC(asn_read_uint32(tcp_pdu, &descr.seqn, "seqn.#plain"));
+    CB_CHECK_RC(asn_read_uint32(tcp_pdu, &tcp_hlen, "hlen.#plain"));
+    CB_CHECK_RC(asn_read_uint32(ip_pdu, &ip_hlen, "h-length.#plain"));
+    CB_CHECK_RC(asn_read_uint32(ip_pdu, &ip_len, "total-length.#plain"));
+
+    CB_CHECK_RC(asn_read_uint32(pkt, &sec, "received.seconds"));
+    CB_CHECK_RC(asn_read_uint32(pkt, &usec, "received.micro-seconds"));
+
+    if (ip_len < (ip_hlen + tcp_hlen) * 4)
+        CB_CHECK_RC(TE_RC(TE_TAPI, TE_EINVAL));
+    payload_len = ip_len - (ip_hlen + tcp_hlen) * 4;
 
     /*
      * Packets with zero payload (like ACK to SYN-ACK) are ignored
      * unless it is SYN or FIN.
      */
-    if (!(flags & (TCP_SYN_FLAG | TCP_FIN_FLAG)) && payload_len == 0)
+    if (!(descr.flags & (TCP_SYN_FLAG | TCP_FIN_FLAG)) && payload_len == 0)
         goto cleanup;
 
+    descr.len = payload_len;
+    descr.idx = data->pkts_cnt;
+    descr.ts_ns = (int64_t)sec * 1000000000LL + (int64_t)usec * 1000LL +
+                  data->ns_adjust;
+
+    CB_CHECK_RC(TE_VEC_APPEND(&data->pkts, descr));
     data->pkts_cnt++;
 
-    if (data->failed)
-        goto cleanup;
+cleanup:
 
-    if (data->cur_id >= te_vec_size(data->reports))
-    {
-        CB_ERROR("CSAP captured more packets than there are packet "
-                 "reports");
-    }
+    asn_free_value(pkt);
+#undef CB_CHECK_RC
+}
 
-    report = (tarpc_zf_pkt_report *)te_vec_get(data->reports,
-                                               data->cur_id);
+/**
+ * Comparison function for sorting captured packets by capture time.
+ *
+ * @param a       The first packet.
+ * @param b       The second packet.
+ *
+ * @return Negative, zero or positive value as required by qsort().
+ */
+static int
+tcp_tx_pkt_cmp(const void *a, const void *b)
+{
+    const ts_tcp_tx_pkt *pa = (const ts_tcp_tx_pkt *)a;
+    const ts_tcp_tx_pkt *pb = (const ts_tcp_tx_pkt *)b;
 
-    if (report->flags & TARPC_ZF_PKT_REPORT_TCP_RETRANS)
-    {
-        data->retrans_cnt++;
-        if (report->flags & TARPC_ZF_PKT_REPORT_TCP_SYN)
-            data->syn_retrans++;
-        else if (report->flags & TARPC_ZF_PKT_REPORT_TCP_FIN)
-            data->fin_retrans++;
-        else
-            data->data_retrans++;
-    }
+    if (pa->ts_ns != pb->ts_ns)
+        return (pa->ts_ns < pb->ts_ns ? -1 : 1);
 
-    if (data->cur_id > 0 && ts_cmp(&data->prev_ts, &report->timestamp) > 0)
-    {
-        ERROR("Report %u has smaller timestamp than the previous one",
-              data->cur_id);
-        CB_ERROR("The next packet report has smaller TX timestamp");
-    }
+    if (pa->idx != pb->idx)
+        return (pa->idx < pb->idx ? -1 : 1);
+
+    return 0;
+}
+
+/**
+ * Check whether a captured packet may be the one described by
+ * a packet report with DROPPED flag.
+ *
+ * @param pkt       Captured packet.
+ * @param report    Packet report.
+ *
+ * @return @c TRUE if the packet matches the report, @c FALSE otherwise.
+ */
+static te_bool
+tcp_tx_pkt_match(const ts_tcp_tx_pkt *pkt,
+                 const tarpc_zf_pkt_report *report)
+{
+    const unsigned int key_flags = TARPC_ZF_PKT_REPORT_TCP_SYN |
+                                   TARPC_ZF_PKT_REPORT_TCP_FIN |
+                                   TARPC_ZF_PKT_REPORT_TCP_RETRANS;
+
+    if ((pkt->exp_flags & key_flags) != (report->flags & key_flags))
+        return FALSE;
+
+    if (pkt->offset != report->start &&
+        !((pkt->flags & TCP_SYN_FLAG) && report->start == UINT_MAX))
+        return FALSE;
 
-    exp_flags = TARPC_ZF_PKT_REPORT_CLOCK_SET | TARPC_ZF_PKT_REPORT_IN_SYNC;
-    if (flags & TCP_SYN_FLAG)
+    return (pkt->len == report->bytes);
+}
+
+/* See description in timestamps.h */
+void
+ts_tcp_tx_process_pkts(ts_tcp_tx_csap_data *data)
+{
+#define CB_ERROR(_args...) \
+    do {                          \
+        ERROR_VERDICT(_args);     \
+        data->failed = TRUE;      \
+        goto cleanup;             \
+    } while (0)
+
+    /*
+     * TS_DEF_PRECISION is in microseconds. Timestamps are compared in
+     * nanoseconds, so the allowed difference is 0.5 s. Previously
+     * milliseconds were compared to TS_DEF_PRECISION, which allowed
+     * a difference of 500 s.
+     */
+    const int64_t precision = (int64_t)TS_DEF_PRECISION * 1000LL;
+
+    ts_tcp_tx_pkt *pkts;
+    ts_tcp_tx_pkt *pkt;
+    tarpc_zf_pkt_report *report;
+    unsigned int pkts_num;
+    unsigned int reports_num;
+    unsigned int exp_flags;
+    unsigned int i;
+    unsigned int j;
+    unsigned int best;
+    int64_t best_diff;
+    int64_t tx_ts;
+    int64_t diff;
+
+    pkts_num = te_vec_size(&data->pkts);
+    reports_num = te_vec_size(data->reports);
+    if (pkts_num == 0 || data->failed)
+        goto cleanup;
+
+    pkts = (ts_tcp_tx_pkt *)te_vec_get(&data->pkts, 0);
+    qsort(pkts, pkts_num, sizeof(*pkts), &tcp_tx_pkt_cmp);
+
+    /*
+     * The first pass: compute data offset and expected report flags
+     * for every captured packet.
+     */
+    for (i = 0; i < pkts_num; i++)
     {
-        if (!data->syn_encountered)
+        pkt = &pkts[i];
+
+        exp_flags = TARPC_ZF_PKT_REPORT_CLOCK_SET |
+                    TARPC_ZF_PKT_REPORT_IN_SYNC;
+        if (pkt->flags & TCP_SYN_FLAG)
         {
-            data->init_seqn = seqn;
+            if (!data->syn_encountered)
+            {
+                data->init_seqn = pkt->seqn;
+            }
+            else
+            {
+                if (data->init_seqn != pkt->seqn)
+                {
+                    CB_ERROR("Another SYN with a different SEQN "
+                             "is encountered");
+                }
+                exp_flags |= TARPC_ZF_PKT_REPORT_TCP_RETRANS;
+            }
+
+            pkt->offset = 0;
+            exp_flags |= TARPC_ZF_PKT_REPORT_TCP_SYN;
+            data->syn_encountered = TRUE;
+        }
+        else if (i == 0)
+        {
+            CB_ERROR("The first packet is not SYN");
         }
         else
         {
-            if (data->init_seqn != seqn)
-            {
-                CB_ERROR("Another SYN with a different SEQN "
-                         "is encountered");
-            }
-            exp_flags |= TARPC_ZF_PKT_REPORT_TCP_RETRANS;
+            /*
+             * SYN occupies 1 SEQN though it does not carry any data,
+             * take it into account when calculating data offset for
+             * the next packets.
+            */
+            pkt->offset = pkt->seqn - data->init_seqn - 1;
         }
 
-        data->cur_offset = 0;
-        exp_flags |= TARPC_ZF_PKT_REPORT_TCP_SYN;
-        data->syn_encountered = TRUE;
-    }
-    else if (data->cur_id == 0)
-    {
-        CB_ERROR("The first packet is not SYN");
-    }
-    else
-    {
-        /*
-         * SYN occupies 1 SEQN though it does not carry any data,
-         * take it into account when calculating data offset for
-         * the next packets.
-        */
-        data->cur_offset = seqn - data->init_seqn - 1;
-    }
+        if (data->fin_encountered &&
+            (pkt->offset + pkt->len > data->max_offset ||
+             (pkt->offset == data->max_offset &&
+              !(pkt->flags & TCP_FIN_FLAG))))
+        {
+            CB_ERROR("Another packet was captured after FIN packet");
+        }
 
-    if (data->fin_encountered &&
-        (data->cur_offset + payload_len > data->max_offset ||
-         (data->cur_offset == data->max_offset &&
-          !(flags & TCP_FIN_FLAG))))
-    {
-        CB_ERROR("Another packet was captured after FIN packet");
-    }
+        if (pkt->offset < data->max_offset)
+            exp_flags |= TARPC_ZF_PKT_REPORT_TCP_RETRANS;
 
-    if (data->cur_offset < data->max_offset)
-        exp_flags |= TARPC_ZF_PKT_REPORT_TCP_RETRANS;
+        data->max_offset = MAX(pkt->offset + pkt->len, data->max_offset);
+        if (pkt->len > 0)
+            data->max_data_off = MAX(data->max_data_off, pkt->offset);
 
-    data->max_offset = MAX(data->cur_offset + payload_len,
-                           data->max_offset);
-    if (payload_len > 0)
-    {
-        data->max_data_off = MAX(data->max_data_off,
-                                 data->cur_offset);
-    }
+        if (pkt->flags & TCP_FIN_FLAG)
+        {
+            exp_flags |= TARPC_ZF_PKT_REPORT_TCP_FIN;
 
-    if (flags & TCP_FIN_FLAG)
-    {
-        exp_flags |= TARPC_ZF_PKT_REPORT_TCP_FIN;
+            if (data->fin_encountered)
+                exp_flags |= TARPC_ZF_PKT_REPORT_TCP_RETRANS;
 
-        if (data->fin_encountered)
-            exp_flags |= TARPC_ZF_PKT_REPORT_TCP_RETRANS;
+            data->fin_encountered = TRUE;
+        }
 
-        data->fin_encountered = TRUE;
-    }
+        if (!(pkt->flags & (TCP_FIN_FLAG | TCP_SYN_FLAG)) &&
+            data->msg_more && (int)pkt->len < data->mss &&
+            !data->less_mss_detected)
+        {
+            data->first_less_mss = pkt->offset;
+            data->less_mss_detected = TRUE;
+        }
 
-    if (!(flags & (TCP_FIN_FLAG | TCP_SYN_FLAG)) && data->msg_more &&
-        (int)payload_len < data->mss && !data->less_mss_detected)
-    {
-        data->first_less_mss = data->cur_offset;
-        data->less_mss_detected = TRUE;
+        pkt->exp_flags = exp_flags;
     }
 
-    if (report->flags & TARPC_ZF_PKT_REPORT_DROPPED)
+    /*
+     * The second pass: match packet reports to captured packets.
+     * Without DROPPED flag a report should describe the next captured
+     * packet. With DROPPED flag the closest in time matching packet
+     * is searched for, and all the packets before it are considered
+     * as having their reports dropped.
+     */
+    for (i = 0, j = 0; data->cur_id < reports_num; data->cur_id++, j++)
     {
-        /*
-         * FIXME: this code may not work well if TCP
-         * retransmit is encountered. However to fix
-         * this, probably switching to a different
-         * approach is required where all the packets
-         * are obtained from CSAP firstly and then
-         * are somehow matched to packet reports,
-         * instead of matching packet by packet.
-         */
+        report = (tarpc_zf_pkt_report *)te_vec_get(data->reports,
+                                                   data->cur_id);
 
-        if (data->cur_offset < report->start)
+        if (report->flags & TARPC_ZF_PKT_REPORT_TCP_RETRANS)
         {
-            /* Skip a packet for which report was dropped */
-            data->drop_pkts++;
-            goto cleanup;
+            data->retrans_cnt++;
+            if (report->flags & TARPC_ZF_PKT_REPORT_TCP_SYN)
+                data->syn_retrans++;
+            else if (report->flags & TARPC_ZF_PKT_REPORT_TCP_FIN)
+                data->fin_retrans++;
+            else
+                data->data_retrans++;
         }
-        if (data->drop_pkts == 0)
+
+        if (data->cur_id > 0 &&
+            ts_cmp(&data->prev_ts, &report->timestamp) > 0)
         {
-            CB_ERROR("DROPPED flag is set but no other reports are missed "
-                     "before the current report");
+            ERROR("Report %u has smaller timestamp than the previous one",
+                  data->cur_id);
+            CB_ERROR("The next packet report has smaller TX timestamp");
         }
 
-        data->drop_pkts = 0;
-        data->drop_cnt++;
-        exp_flags |= TARPC_ZF_PKT_REPORT_DROPPED;
-    }
+        if (j >= pkts_num)
+            break;
 
-    if (report->flags != exp_flags)
-    {
-        ERROR("Packet report %u has unexpected flags", data->cur_id);
-        CB_ERROR("Packet report has unexpected flags %s instead of %s",
-                 zf_pkt_report_flags_rpc2str(report->flags),
-                 zf_pkt_report_flags_rpc2str(exp_flags));
-    }
+        tx_ts = report->timestamp.tv_sec * 1000000000LL +
+                report->timestamp.tv_nsec;
 
-    if (data->cur_offset != report->start)
-    {
-        ERROR("Packet report %u has unexpected 'start' field value %u "
-              "instead of %u", data->cur_id, report->start,
-              data->cur_offset);
-        if ((flags & TCP_SYN_FLAG) && report->start == UINT_MAX)
+        exp_flags = pkts[j].exp_flags;
+        if (report->flags & TARPC_ZF_PKT_REPORT_DROPPED)
         {
-            if (!data->syn_start_verdict)
+            best = pkts_num;
+            best_diff = 0;
+            for (i = j; i < pkts_num && pkts[i].ts_ns <= tx_ts + precision;
+                 i++)
             {
-                RING_VERDICT("'start' field of the report of "
-                             "SYN packet is set to UINT_MAX "
-                             "instead of zero");
-                data->syn_start_verdict = TRUE;
+                if (!tcp_tx_pkt_match(&pkts[i], report))
+                    continue;
+
+                diff = llabs(pkts[i].ts_ns - tx_ts);
+                if (best == pkts_num || diff < best_diff)
+                {
+                    best = i;
+                    best_diff = diff;
+                }
             }
+
+            if (best == pkts_num)
+            {
+                ERROR("No captured packet matches packet report %u",
+                      data->cur_id);
+                CB_ERROR("No captured packet matches packet report with "
+                         "DROPPED flag");
+            }
+
+            if (best == j)
+            {
+                CB_ERROR("DROPPED flag is set but no other reports are "
+                         "missed before the current report");
+            }
+
+            data->drop_pkts += best - j;
+            data->drop_cnt++;
+            j = best;
+            exp_flags = pkts[j].exp_flags | TARPC_ZF_PKT_REPORT_DROPPED;
         }
-        else
+
+        pkt = &pkts[j];
+        data->cur_offset = pkt->offset;
+
+        if (report->flags != exp_flags)
         {
-            CB_ERROR("Packet report has unexpected 'start' field value");
+            ERROR("Packet report %u has unexpected flags", data->cur_id);
+            CB_ERROR("Packet report has unexpected flags %s instead of %s",
+                     zf_pkt_report_flags_rpc2str(report->flags),
+                     zf_pkt_report_flags_rpc2str(exp_flags));
         }
-    }
 
-    if (payload_len != report->bytes)
-    {
-        ERROR("Packet report %u has unexpected 'bytes' field value %u "
-              "instead of %u", data->cur_id, report->bytes,
-              payload_len);
-        CB_ERROR("Packet report has unexpected value of 'bytes' field");
+        if (pkt->offset != report->start)
+        {
+            ERROR("Packet report %u has unexpected 'start' field value %u "
+                  "instead of %u", data->cur_id, report->start,
+                  pkt->offset);
+            if ((pkt->flags & TCP_SYN_FLAG) && report->start == UINT_MAX)
+            {
+                if (!data->syn_start_verdict)
+                {
+                    RING_VERDICT("'start' field of the report of "
+                                 "SYN packet is set to UINT_MAX "
+                                 "instead of zero");
+                    data->syn_start_verdict = TRUE;
+                }
+            }
+            else
+            {
+                CB_ERROR("Packet report has unexpected 'start' field "
+                         "value");
+            }
+        }
+
+        if (pkt->len != report->bytes)
+        {
+            ERROR("Packet report %u has unexpected 'bytes' field value %u "
+                  "instead of %u", data->cur_id, report->bytes,
+                  pkt->len);
+            CB_ERROR("Packet report has unexpected value of 'bytes' "
+                     "field");
+        }
+
+        diff = pkt->ts_ns - tx_ts;
+        if (llabs(diff) > precision)
+        {
+            ERROR("Packet report %u has timestamp " TE_PRINTF_TS_FMT
+                  ", packet was captured %lld ns later",
+                  data->cur_id, TE_PRINTF_TS_VAL(report->timestamp),
+                  (long long int)diff);
+            CB_ERROR("TX timestamp of a packet report does not match RX "
+                     "timestamp reported by CSAP");
+        }
+
+        if (data->delta_num == 0 || diff < data->delta_min)
+            data->delta_min = diff;
+        if (data->delta_num == 0 || diff > data->delta_max)
+            data->delta_max = diff;
+        data->delta_sum += diff;
+        data->delta_num++;
+
+        memcpy(&data->prev_ts, &report->timestamp, sizeof(data->prev_ts));
     }
 
-    tx_ts_ms = TS_TIMESPEC2MS(report->timestamp);
-    if (llabs(tx_ts_ms - rx_ts_ms) > TS_DEF_PRECISION)
+    if (j < pkts_num)
     {
-        ERROR("Packet report %u has timestamp " TE_PRINTF_TS_FMT
-              ", RX timestamp is " TE_PRINTF_TS_FMT,
-              data->cur_id,
-              TE_PRINTF_TS_VAL(report->timestamp),
-              TE_PRINTF_TS_VAL(rx_ts));
-        CB_ERROR("TX timestamp of a packet report does not match RX "
-                 "timestamp reported by CSAP");
+        CB_ERROR("CSAP captured more packets than there are packet "
+                 "reports");
     }
 
-    memcpy(&data->prev_ts, &report->timestamp, sizeof(data->prev_ts));
-    data->cur_id++;
-
 cleanup:
 
-    asn_free_value(pkt);
-#undef CB_CHECK_RC
+    if (data->delta_num > 0)
+    {
+        RING("%u captured packets were matched to packet reports, "
+             "capture time minus TX timestamp: min %lld ns, "
+             "mean %lld ns, max %lld ns", data->delta_num,
+             (long long int)data->delta_min,
+             (long long int)(data->delta_sum / data->delta_num),
+             (long long int)data->delta_max);
+    }
+
+    te_vec_free(&data->pkts);
 #undef CB_ERROR
 }
 
@@ -469,7 +627,7 @@ ts_get_clock_adjustment(rcf_rpc_server *rpcs1,
 {
     tarpc_timeval tv1;
     tarpc_timeval tv2;
-    int64_t ms_adjust;
+    int64_t ns_adjust;
 
     /*
      * Clocks on different hosts may be not synchronized, so
@@ -478,11 +636,12 @@ ts_get_clock_adjustment(rcf_rpc_server *rpcs1,
      */
     rpc_gettimeofday(rpcs1, &tv1, NULL);
     rpc_gettimeofday(rpcs2, &tv2, NULL);
-    ms_adjust = TS_TIMEVAL2MS(tv1) - TS_TIMEVAL2MS(tv2);
-    RING("Adjustment between clocks on %s and %s is %lld ms",
-         rpcs1->name, rpcs2->name, (long long int)ms_adjust);
+    ns_adjust = (int64_t)(tv1.tv_sec - tv2.tv_sec) * 1000000000LL +
+                (int64_t)(tv1.tv_usec - tv2.tv_usec) * 1000LL;
+    RING("Adjustment between clocks on %s and %s is %lld ns",
+         rpcs1->name, rpcs2->name, (long long int)ns_adjust);
 
-    return ms_adjust;
+    return ns_adjust;
 }
 
 /* See description in timestamps.h */
@@ -20,6 +20,31 @@
 /** Default timestamps precision in us. */
 #define TS_DEF_PRECISION 500000
 
+/**
+ * Ring size of TX reports collector passed to ts_get_tx_reports(),
+ * the maximum number of reports retrieved by a single call must not
+ * exceed it.
+ */
+#define TS_TX_COLLECTOR_RING_SIZE 1024
+
+/**
+ * Stop TX reports collector in cleanup section, if it was started.
+ *
+ * @param rpcs_     RPC server.
+ * @param coll_     RPC pointer to the collector.
+ */
+#define CLEANUP_TS_TX_COLLECTOR_STOP(rpcs_, coll_) \
+    do {                                                            \
+        if (coll_ != RPC_NULL)                                      \
+        {                                                           \
+            RPC_AWAIT_IUT_ERROR(rpcs_);                             \
+            if (rpc_zfts_tx_ts_collector_stop(rpcs_, coll_) != 0)   \
+                MACRO_TEST_ERROR;                                   \
+            else                                                    \
+                coll_ = RPC_NULL;                                   \
+        }                                                           \
+    } while (0)
+
 /**
  * Convert struct timeval or tarpc_timeval to milliseconds since epoch.
  *
@@ -110,11 +135,15 @@ typedef struct ts_udp_tx_pkt_descr {
 } ts_udp_tx_pkt_descr;
 
 /**
- * Obtain all available reports about sent packets by repeatedly calling
- * @b zfut_get_tx_timestamps() or @b zft_get_tx_timestamps().
+ * Obtain all available reports about sent packets with an on-demand
+ * TX reports collector which repeatedly calls
+ * @b zfut_get_tx_timestamps() or @b zft_get_tx_timestamps() on
+ * the agent.
  *
  * @param rpcs          RPC server.
- * @param z             TCP or UDP TX zocket.
+ * @param coll          Collector started for TCP or UDP TX zocket with
+ *                      @c TS_TX_COLLECTOR_RING_SIZE ring in on-demand
+ *                      mode.
  * @param reports_vec   TE vector to which to append retrieved reports.
  * @param min_num       Minimum number of reports to retrieve by a single
  *                      function call.
@@ -123,7 +152,8 @@ typedef struct ts_udp_tx_pkt_descr {
  * @param single_call   If @c TRUE, call @b zfut_get_tx_timestamps()
  *                      only the single time.
  */
-extern void ts_get_tx_reports(rcf_rpc_server *rpcs, rpc_ptr z,
+extern void ts_get_tx_reports(rcf_rpc_server *rpcs,
+                              rpc_zfts_tx_ts_coll_p coll,
                               te_vec *reports_vec,
                               int min_num, int max_num,
                               te_bool single_call);
@@ -143,15 +173,33 @@ extern void ts_zfut_check_tx_reports(te_vec *reports_vec, te_vec *pkts_vec,
                                      int precision,
                                      unsigned int *dropped_cnt);
 
-/** Auxiliary data passed to CSAP callback processing TCP TX packets */
+/** Compact description of a TCP packet captured by CSAP */
+typedef struct ts_tcp_tx_pkt {
+    uint32_t seqn;              /**< SEQN */
+    uint32_t len;               /**< Payload length */
+    uint32_t flags;             /**< TCP flags */
+    unsigned int idx;           /**< Index in the order of capturing */
+    int64_t ts_ns;              /**< Capture timestamp adjusted to IUT
+                                     clock, in ns */
+
+    unsigned int offset;        /**< Offset in the stream of TCP data
+                                     (computed when matching) */
+    unsigned int exp_flags;     /**< Expected packet report flags
+                                     (computed when matching) */
+} ts_tcp_tx_pkt;
+
+/**
+ * Auxiliary data passed to CSAP callback capturing TCP TX packets and
+ * then to ts_tcp_tx_process_pkts() matching them to packet reports.
+ */
 typedef struct ts_tcp_tx_csap_data {
     /* Input fields - should be set before processing captured packets */
 
     te_vec *reports;            /**< Array of packet reports to check
                                      against captured packets */
 
-    int64_t ms_adjust;          /**< Adjustment to match Tester clocks to
-                                     IUT clocks, in ms */
+    int64_t ns_adjust;          /**< Adjustment to match Tester clocks to
+                                     IUT clocks, in ns */
 
     te_bool msg_more;           /**< If @c TRUE, @c MSG_MORE flag was used
                                      when sending data */
@@ -218,10 +266,28 @@ typedef struct ts_tcp_tx_csap_data {
                                      no specific verdict is printed) */
     te_bool failed;             /**< Set to @c TRUE if processing of
                                      captured packets failed */
+
+    te_vec pkts;                /**< Captured packets (vector of
+                                     @ref ts_tcp_tx_pkt), filled by
+                                     ts_tcp_tx_csap_cb() */
+
+    unsigned int delta_num;     /**< Number of matched packets */
+    int64_t delta_min;          /**< Minimum difference between capture
+                                     and TX timestamps, ns */
+    int64_t delta_max;          /**< Maximum difference between capture
+                                     and TX timestamps, ns */
+    int64_t delta_sum;          /**< Sum of differences between capture
+                                     and TX timestamps, ns */
 } ts_tcp_tx_csap_data;
 
 /**
- * Callback for processing packets captured by CSAP.
+ * Callback for capturing packets by CSAP. It only saves compact
+ * description of every packet in @ref ts_tcp_tx_csap_data, captured
+ * packets should be matched to packet reports with
+ * ts_tcp_tx_process_pkts() after that. It expects packets captured
+ * by TCP/IPv4 CSAP (a verdict is printed and processing fails if
+ * a packet is not IPv4); payload is not required, so CSAP may be
+ * started in @c RCF_TRRECV_PACKETS_NO_PAYLOAD mode.
  *
  * @param pkt           Description of captured TCP packet.
  * @param user_data     Pointer to @ref ts_tcp_tx_csap_data.
@@ -229,12 +295,29 @@ typedef struct ts_tcp_tx_csap_data {
 extern void ts_tcp_tx_csap_cb(asn_value *pkt, void *user_data);
 
 /**
- * Compute time adjustment (in ms) between clocks on two hosts.
+ * Match TCP packets captured by ts_tcp_tx_csap_cb() to packet reports.
+ * Packets are sorted by capture time and processed together with
+ * reports in a single pass. A report with @c ZF_PKT_REPORT_DROPPED flag
+ * is matched to the captured packet having the same data offset, length
+ * and SYN/FIN/retransmit state which is the closest to it in time; all
+ * the packets skipped before it are considered as having their reports
+ * dropped. Differences between capture and TX timestamps are computed
+ * in nanoseconds.
+ *
+ * Verdicts are printed and @b failed field is set in case of mismatch.
+ * Captured packets are released.
+ *
+ * @param data          Pointer to @ref ts_tcp_tx_csap_data.
+ */
+extern void ts_tcp_tx_process_pkts(ts_tcp_tx_csap_data *data);
+
+/**
+ * Compute time adjustment (in ns) between clocks on two hosts.
  *
  * @param rpcs1     RPC server on the first host.
  * @param rpcs2     RPC server on the second host.
  *
- * @return Difference in ms between clocks on the first host and
+ * @return Difference in ns between clocks on the first host and
  *         clocks on the second host.
  */
 extern int64_t ts_get_clock_adjustment(rcf_rpc_server *rpcs1,
@@ -57,6 +57,7 @@ main(int argc, char *argv[])
     rpc_zf_attr_p attr = RPC_NULL;
     rpc_zf_stack_p stack = RPC_NULL;
     rpc_zfut_p iut_z = RPC_NULL;
+    rpc_zfts_tx_ts_coll_p coll = RPC_NULL;
     int tst_s = -1;
 
     int pkts_num;
@@ -98,6 +99,13 @@ main(int argc, char *argv[])
               "@b iut_addr and connect it to @b tst_addr.");
     rpc_zfut_alloc(pco_iut, &iut_z, stack, iut_addr, tst_addr, 0, attr);
 
+    TEST_STEP("Start on-demand collector of TX packet reports for "
+              "the IUT zocket, it is used to call "
+              "@b zfut_get_tx_timestamps() on the agent.");
+    rpc_zfts_tx_ts_collector_start(pco_iut, stack, iut_z,
+                                   TS_TX_COLLECTOR_RING_SIZE, TRUE,
+                                   &coll);
+
     TEST_STEP("Create UDP socket on Tester, bind it to @p tst_addr.");
     tst_s = rpc_socket(pco_tst, rpc_socket_domain_by_addr(tst_addr),
                        RPC_SOCK_DGRAM, RPC_PROTO_DEF);
@@ -137,7 +145,7 @@ main(int argc, char *argv[])
               "is @c TRUE, pass less report structures to it than "
               "@p pkts_num each time, so that reports will be "
               "obtained via multiple calls.");
-    ts_get_tx_reports(pco_iut, iut_z, &reports_vec,
+    ts_get_tx_reports(pco_iut, coll, &reports_vec,
                       (multiple_reports ? 1 : pkts_num),
                       (multiple_reports ? pkts_num - 1 : pkts_num),
                       FALSE);
@@ -167,6 +175,7 @@ cleanup:
 
     CLEANUP_RPC_CLOSE(pco_tst, tst_s);
 
+    CLEANUP_TS_TX_COLLECTOR_STOP(pco_iut, coll);
     CLEANUP_RPC_ZFTS_FREE(pco_iut, zfut, iut_z);
     CLEANUP_RPC_ZFTS_FREE(pco_iut, zf_waitable, waitable);
     ZFTS_FREE(pco_iut, zf_muxer, muxer_set);
@@ -68,6 +68,7 @@ main(int argc, char *argv[])
     rpc_zf_attr_p attr = RPC_NULL;
     rpc_zf_stack_p stack = RPC_NULL;
     rpc_zfut_p iut_z = RPC_NULL;
+    rpc_zfts_tx_ts_coll_p coll = RPC_NULL;
     int tst_s = -1;
 
     int pkts_num;
@@ -109,6 +110,13 @@ main(int argc, char *argv[])
               "@b iut_addr and connect it to @b tst_addr.");
     rpc_zfut_alloc(pco_iut, &iut_z, stack, iut_addr, tst_addr, 0, attr);
 
+    TEST_STEP("Start on-demand collector of TX packet reports for "
+              "the IUT zocket, it is used to call "
+              "@b zfut_get_tx_timestamps() on the agent.");
+    rpc_zfts_tx_ts_collector_start(pco_iut, stack, iut_z,
+                                   TS_TX_COLLECTOR_RING_SIZE, TRUE,
+                                   &coll);
+
     TEST_STEP("Create UDP socket on Tester, bind it to @p tst_addr.");
     tst_s = rpc_socket(pco_tst, rpc_socket_domain_by_addr(tst_addr),
                        RPC_SOCK_DGRAM, RPC_PROTO_DEF);
@@ -148,7 +156,7 @@ main(int argc, char *argv[])
             CHECK_RC(te_vec_append(&pkts_vec, &pkt));
         }
 
-        ts_get_tx_reports(pco_iut, iut_z, &reports_vec, 1, 1, TRUE);
+        ts_get_tx_reports(pco_iut, coll, &reports_vec, 1, 1, TRUE);
         reports_num = te_vec_size(&reports_vec);
         if (reports_num != j + 1)
         {
@@ -167,7 +175,7 @@ main(int argc, char *argv[])
               "@b zfut_get_tx_timestamps() in a loop until zero reports "
               "is retrieved. Append all the retrieved reports to the same "
               "array.");
-    ts_get_tx_reports(pco_iut, iut_z, &reports_vec, 1, MAX_REPORTS, FALSE);
+    ts_get_tx_reports(pco_iut, coll, &reports_vec, 1, MAX_REPORTS, FALSE);
 
     TEST_STEP("Now check that reports were retieved in order for all "
               "the sent UDP packets, with TX timestamps matching their "
@@ -192,6 +200,7 @@ cleanup:
 
     CLEANUP_RPC_CLOSE(pco_tst, tst_s);
 
+    CLEANUP_TS_TX_COLLECTOR_STOP(pco_iut, coll);
     CLEANUP_RPC_ZFTS_FREE(pco_iut, zfut, iut_z);
     CLEANUP_RPC_ZFTS_FREE(pco_iut, zf_waitable, waitable);
     ZFTS_FREE(pco_iut, zf_muxer, muxer_set);